@@ -45,6 +45,7 @@
 #include "BaseModVisit.h"
 #include "surfRegister.h"
 #include "objectRegister.h"
+#include "buildDepend.h"
 #include "InputControl.h"
 #include "MatrixBase.h"
 #include "Matrix.h"
@@ -151,6 +152,7 @@ main(int argc,char* argv[])
   // Definitions section 
   int MCIndex(0);
   const int multi=IParam.getValue<int>("multi");
+  ModelSupport::buildDepend BDep;
   try
     {
       while(MCIndex<multi)
@@ -166,7 +168,11 @@ main(int argc,char* argv[])
 	      // 	  (SimPtr->getDataBase(),IterVal);
 	    }
 
+	  // Report the components with changed inputs
+	  if (MCIndex)
+	    BDep.hasChanged(SimPtr->getDataBase());
 	  SimPtr->resetAll();
+	  SimPtr->getDataBase().clearReadSet();
 
 	  bibSystem::makeBib BibObj;
 	  World::createOuterObjects(*SimPtr);
@@ -183,6 +189,8 @@ main(int argc,char* argv[])
 	  ModelSupport::setDefaultPhysics(*SimPtr,IParam);
 	  const int renumCellWork=tallySelection(*SimPtr,IParam);
 	  SimPtr->masterRotation();
+	  if (IParam.flag("bvh"))
+	    SimPtr->createBVH();
 	  if (createVTK(IParam,SimPtr,Oname))
 	    {
 	      delete SimPtr;
@@ -208,6 +216,7 @@ main(int argc,char* argv[])
 	  tallyModification(*SimPtr,IParam);
 
 	  // Ensure we done loop
+	  BDep.record(SimPtr->getDataBase());
 	  do
 	    {
 	      SimProcess::writeIndexSim(*SimPtr,Oname,MCIndex);
@@ -62,6 +62,7 @@
 #include "surfIndex.h"
 #include "surfRegister.h"
 #include "objectRegister.h"
+#include "buildDepend.h"
 #include "Code.h"
 #include "varList.h"
 #include "FuncDataBase.h"
@@ -154,6 +155,7 @@ main(int argc,char* argv[])
       
       int MCIndex(0);
       const int multi=IParam.getValue<int>("multi");
+      ModelSupport::buildDepend BDep;
 
       ELog::EM<<"FULLBUILD : variable hash:"
 	      <<SimPtr->getDataBase().variableHash()
@@ -170,7 +172,11 @@ main(int argc,char* argv[])
 		mainSystem::incRunTimeVariable
 		  (SimPtr->getDataBase(),IterVal);
 	    }
+	  // Report the components with changed inputs
+	  if (MCIndex)
+	    BDep.hasChanged(SimPtr->getDataBase());
 	  SimPtr->resetAll();
+	  SimPtr->getDataBase().clearReadSet();
 	  World::createOuterObjects(*SimPtr);
 
 	  moderatorSystem::makeTS2 TS2Obj;
@@ -195,6 +201,8 @@ main(int argc,char* argv[])
 	      ModelSupport::setDefRotation(IParam);
 	    }
 	  SimPtr->masterRotation();
+	  if (IParam.flag("bvh"))
+	    SimPtr->createBVH();
 	  if (createVTK(IParam,SimPtr,Oname))
 	    {
 	      delete SimPtr;
@@ -225,6 +233,7 @@ main(int argc,char* argv[])
 	  tallyModification(*SimPtr,IParam);
 
 	  // Ensure we done loop
+	  BDep.record(SimPtr->getDataBase());
 	  do
 	    {
 	      SimProcess::writeIndexSim(*SimPtr,Oname,MCIndex);
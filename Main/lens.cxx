@@ -45,6 +45,7 @@
 #include "BaseModVisit.h"
 #include "surfRegister.h"
 #include "objectRegister.h"
+#include "buildDepend.h"
 #include "InputControl.h"
 #include "MatrixBase.h"
 #include "Matrix.h"
@@ -156,6 +157,7 @@ main(int argc,char* argv[])
 
   int MCIndex(0);
   const int multi=IParam.getValue<int>("multi");
+  ModelSupport::buildDepend BDep;
   try
     {
       while(MCIndex<multi)
@@ -166,7 +168,11 @@ main(int argc,char* argv[])
 	      ELog::FM.setActive(4);    
 	      ELog::RN.setActive(0);    
 	    }
+	  // Report the components with changed inputs
+	  if (MCIndex)
+	    BDep.hasChanged(SimPtr->getDataBase());
 	  SimPtr->resetAll();
+	  SimPtr->getDataBase().clearReadSet();
 	  lensSystem::makeLens lensObj;
 	  World::createOuterObjects(*SimPtr);
 	  lensObj.build(SimPtr,IParam);
@@ -180,6 +186,8 @@ main(int argc,char* argv[])
 	  lensObj.createTally(*SimPtr,IParam);
 	  ModelSupport::setDefaultPhysics(*SimPtr,IParam);
 
+	  if (IParam.flag("bvh"))
+	    SimPtr->createBVH();
 	  if (createVTK(IParam,SimPtr,Oname))
 	    {
 	      delete SimPtr;
@@ -222,6 +230,7 @@ main(int argc,char* argv[])
 	    SimPtr->setEnergy(IParam.getValue<double>("ECut"));
 
 	  // Ensure we done loop
+	  BDep.record(SimPtr->getDataBase());
 	  do
 	    {
 	      SimProcess::writeIndexSim(*SimPtr,Oname,MCIndex);
@@ -46,6 +46,7 @@
 #include "BaseModVisit.h"
 #include "surfRegister.h"
 #include "objectRegister.h"
+#include "buildDepend.h"
 #include "InputControl.h"
 #include "MatrixBase.h"
 #include "Matrix.h"
@@ -146,6 +147,7 @@ main(int argc,char* argv[])
   // Definitions section 
   int MCIndex(0);
   const int multi=IParam.getValue<int>("multi");
+  ModelSupport::buildDepend BDep;
 
   try
     {
@@ -158,7 +160,11 @@ main(int argc,char* argv[])
 	      ELog::RN.setActive(0);    
 	    }
 
+	  // Report the components with changed inputs
+	  if (MCIndex)
+	    BDep.hasChanged(SimPtr->getDataBase());
 	  SimPtr->resetAll();
+	  SimPtr->getDataBase().clearReadSet();
 
 	  delftSystem::makeDelft RObj(IParam.getValue<std::string>("modType"));
 	  World::createOuterObjects(*SimPtr);
@@ -173,6 +179,8 @@ main(int argc,char* argv[])
 	  SimPtr->removeDeadCells();            // Generic
 	  SimPtr->removeDeadSurfaces(0);         
 
+	  if (IParam.flag("bvh"))
+	    SimPtr->createBVH();
 	  if (createVTK(IParam,SimPtr,Oname))
 	    {
 	      delete SimPtr;
@@ -200,6 +208,7 @@ main(int argc,char* argv[])
 	  tallyModification(*SimPtr,IParam);
 
 	  // Ensure we done loop
+	  BDep.record(SimPtr->getDataBase());
 	  do
 	    {
 	      SimProcess::writeIndexSim(*SimPtr,Oname,MCIndex);
@@ -174,6 +174,8 @@ main(int argc,char* argv[])
       // outer void to zero
       // RENUMBER:
       mainSystem::renumberCells(*SimPtr,IParam);
+      if (IParam.flag("bvh"))
+	SimPtr->createBVH();
       
       SimProcess::writeIndexSim(*SimPtr,Oname,0);
 
@@ -67,6 +67,7 @@
 #include "surfIndex.h"
 #include "surfRegister.h"
 #include "objectRegister.h"
+#include "buildDepend.h"
 #include "Quadratic.h"
 #include "Plane.h"
 #include "Cylinder.h"
@@ -150,6 +151,7 @@ main(int argc,char* argv[])
   // Definitions section 
   int MCIndex(0);
   const int multi=IParam.getValue<int>("multi");
+  ModelSupport::buildDepend BDep;
   try
     {
       while(MCIndex<multi)
@@ -164,7 +166,11 @@ main(int argc,char* argv[])
 		  (SimPtr->getDataBase(),IterVal);
 	    }
 
+	  // Report the components with changed inputs
+	  if (MCIndex)
+	    BDep.hasChanged(SimPtr->getDataBase());
 	  SimPtr->resetAll();
+	  SimPtr->getDataBase().clearReadSet();
 	  SimPtr->readMaster(Fname);
 	  //	  TMRSystem::removeTallyWindows(*SimPtr);
 	  SimPtr->removeComplements();
@@ -173,6 +179,8 @@ main(int argc,char* argv[])
 	  SimPtr->processCellsImp();
 	  SimPtr->getPC().setCells("imp",1,0);            // Set a zero cell
 
+	  if (IParam.flag("bvh"))
+	    SimPtr->createBVH();
 	  if (createVTK(IParam,SimPtr,Oname))
 	    {
 	      delete SimPtr;
@@ -207,6 +215,7 @@ main(int argc,char* argv[])
 
 
 	  // Ensure we done loop
+	  BDep.record(SimPtr->getDataBase());
 	  do
 	    {
 	      SimProcess::writeIndexSim(*SimPtr,Oname,MCIndex);
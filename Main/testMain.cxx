@@ -111,6 +111,7 @@
 #include "testBoost.h"
 #include "testBoundary.h"
 #include "testBoxLine.h"
+#include "testBuildDepend.h"
 #include "testCone.h"
 #include "testContained.h"
 #include "testConvex.h"
@@ -166,11 +167,13 @@
 #include "testSurfEqual.h"
 #include "testSurfExpand.h"
 #include "testSurIntersect.h"
+#include "testSurfHash.h"
 #include "testSurfRegister.h"
 #include "testSVD.h"
 #include "testTally.h"
 #include "testVec3D.h"
 #include "testVarNameOrder.h"
+#include "testVisit.h"
 #include "testVolumes.h"
 #include "testWorkData.h"
 #include "testWrapper.h"
@@ -405,9 +408,10 @@ globalTest(const int type,const int extra)
       "testRules",
       "testSimulation",
       "testSource",
-      "testTally"
+      "testTally",
+      "testVisit"
     };
-  const int TSize(12);
+  const int TSize(13);
 
   if (type==0)
     {
@@ -494,6 +498,12 @@ globalTest(const int type,const int extra)
 	  testTally A;
 	  X=A.applyTest(extra);
 	}
+      cnt++;
+      if(index==cnt)
+	{
+	  testVisit A;
+	  X=A.applyTest(extra);
+	}
 
     } while (!X && type!=index && index<TSize);
     
@@ -857,6 +867,8 @@ processTest(const int type,const int extra)
       std::cout<<"testSurfRegister    (17)"<<std::endl;
       std::cout<<"testVolumes         (18)"<<std::endl;
       std::cout<<"testWrapper         (19)"<<std::endl;
+      std::cout<<"testSurfHash        (20)"<<std::endl;
+      std::cout<<"testBuildDepend     (21)"<<std::endl;
     }
   
   if(type==1 || type<0)
@@ -983,6 +995,19 @@ processTest(const int type,const int extra)
       const int X=A.applyTest(extra);
       if (X) return X;
     }
+  if(type==20 || type<0)
+    {
+      testSurfHash A;
+      const int X=A.applyTest(extra);
+      if (X) return X;
+    }
+
+  if(type==21 || type<0)
+    {
+      testBuildDepend A;
+      const int X=A.applyTest(extra);
+      if (X) return X;
+    }
 
   return 0;
 }
@@ -59,6 +59,7 @@
 #include "Qhull.h"
 #include "Simulation.h"
 #include "ModelSupport.h"
+#include "RuleBuild.h"
 #include "generateSurf.h"
 #include "support.h"
 #include "stringCombine.h"
@@ -176,11 +177,18 @@ BeRef::createObjects(Simulation& System)
   ELog::RegMethod RegA("BeRef","createObjects");
 
   std::string Out;
-  
-  Out=ModelSupport::getComposite(SMap,refIndex," -7 5 -6 ");
-  System.addCell(MonteCarlo::Qhull(cellIndex++,refMat,0.0,Out));
-  Out=ModelSupport::getComposite(SMap,refIndex," -17 15 -16 (7:-5:6)");
-  System.addCell(MonteCarlo::Qhull(cellIndex++,wallMat,0.0,Out));
+
+  // Inner : -7 5 -6
+  ModelSupport::RuleBuild Inner(SMap,refIndex);
+  Inner.inter(-7).inter(5).inter(-6);
+  System.addCell(MonteCarlo::Qhull(cellIndex++,refMat,0.0,Inner.getRule()));
+
+  // Wall : -17 15 -16 (7:-5:6)
+  ModelSupport::RuleBuild Wall(SMap,refIndex);
+  ModelSupport::RuleBuild Ex(SMap,refIndex);
+  Ex.inter(7).unite(-5).unite(6);
+  Wall.inter(-17).inter(15).inter(-16).inter(Ex);
+  System.addCell(MonteCarlo::Qhull(cellIndex++,wallMat,0.0,Wall.getRule()));
 
   Out=ModelSupport::getComposite(SMap,refIndex," -17 15 -16 ");
   addOuterSurf(Out);
@@ -27,6 +27,7 @@
 #include <cmath>
 #include <vector>
 #include <list>
+#include <set>
 #include <map>
 #include <algorithm>
 #include <functional>
@@ -58,14 +59,15 @@
 #include "FuncDataBase.h"
 
 
-FuncDataBase::FuncDataBase()
+FuncDataBase::FuncDataBase() :
+  readFlag(0)
   /*!
     Standard Constructor
   */
 {}
 
 FuncDataBase::FuncDataBase(const FuncDataBase& A) :
-  VList(A.VList),Build(A.Build)
+  VList(A.VList),Build(A.Build),readFlag(A.readFlag),ReadSet(A.ReadSet)
   /*!
     Standard Copy Constructor
     \param A :: FuncDataBase to copy
@@ -84,6 +86,8 @@ FuncDataBase::operator=(const FuncDataBase& A)
     {
       VList=A.VList;
       Build=A.Build;
+      readFlag=A.readFlag;
+      ReadSet=A.ReadSet;
     }
   return *this;
 }
@@ -97,12 +101,17 @@ FuncDataBase::~FuncDataBase()
 const FItem*
 FuncDataBase::findItem(const std::string& Key) const
   /*!
-    Finds a variable item
+    Finds a variable item. While recording [clearReadSet]
+    the name is kept in the read set [found or not] so 
+    that the build of a component can be tied to the
+    variables it depends on.
     \param Key :: string to search
     \return FItem pointer (or 0 on failure to find)
   */
 {
-   return VList.findVar(Key);
+  if (readFlag)
+    ReadSet.insert(Key);
+  return VList.findVar(Key);
 }
 
 int
@@ -42,6 +42,9 @@ class FuncDataBase
 
   varList VList;           ///< Variable list
   Code Build;              ///< Current total-bytecode
+  mutable int readFlag;    ///< Record the variables read
+  /// Names of the variables found since clearReadSet
+  mutable std::set<std::string> ReadSet;
 
   size_t compileExpression(const std::string&,const size_t);
   size_t compileFunctionParams(const std::string&,const size_t,const size_t);
@@ -98,6 +101,13 @@ class FuncDataBase
 
   int hasVariable(const std::string&) const;
 
+  /// Access variables read since the last clear
+  const std::set<std::string>& getReadSet() const { return ReadSet; }
+  /// Start a new record of read variables
+  void clearReadSet() const { ReadSet.clear(); readFlag=1; }
+  /// Stop recording read variables [keeps the record]
+  void stopReadSet() const { readFlag=0; }
+
   void writeAll(const std::string&) const; 
   void processXML(const std::string&);
   void writeXML(const std::string&) const;
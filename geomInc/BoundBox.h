@@ -0,0 +1,90 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   geomInc/BoundBox.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef Geometry_BoundBox_h
+#define Geometry_BoundBox_h
+
+namespace Geometry
+{
+
+/*!
+  \class BoundBox
+  \brief Axis aligned bounding box
+  \version 1.0
+  \date November 2013
+  \author S. Ansell
+
+  Holds a low/high corner pair. The default box is
+  unbounded (it contains everything). Each axis is
+  treated independently so that a box can be limited
+  in only one or two directions.
+ */
+
+class BoundBox
+{
+ private:
+
+  static const double largeValue;   ///< Unbounded limit
+
+  Vec3D LowPt;         ///< Low corner
+  Vec3D HighPt;        ///< High corner
+
+ public:
+
+  BoundBox();
+  BoundBox(const Vec3D&,const Vec3D&);
+  BoundBox(const BoundBox&);
+  BoundBox& operator=(const BoundBox&);
+  ~BoundBox() {}  ///< Destructor
+
+  /// Access low point
+  const Vec3D& getLow() const { return LowPt; }
+  /// Access high point
+  const Vec3D& getHigh() const { return HighPt; }
+  Vec3D getCentre() const;
+
+  void setUnbounded();
+  void setEmpty();
+  void setLow(const size_t,const double);
+  void setHigh(const size_t,const double);
+
+  bool isUnbounded() const;
+  bool isBounded() const;
+  bool isEmpty() const;
+  bool isValid(const Vec3D&) const;
+  bool overlap(const BoundBox&) const;
+  size_t longestAxis() const;
+
+  void addPoint(const Vec3D&);
+  void merge(const BoundBox&);
+  void intersect(const BoundBox&);
+  void grow(const double);
+
+  void write(std::ostream&) const;
+};
+
+
+std::ostream&
+operator<<(std::ostream&,const BoundBox&);
+
+}   // NAMESPACE Geometry
+
+#endif
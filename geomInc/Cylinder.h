@@ -86,6 +86,7 @@ class Cylinder : public Quadratic
   const Geometry::Vec3D& getCentre() const { return Centre; }   ///< Return centre point       
   const Geometry::Vec3D& getNormal() const { return Normal; }   ///< Return Central line
   double getRadius() const { return Radius; }  ///< Get Radius      
+  int getNvec() const { return Nvec; }         ///< Get axis [0 general]
   void setBaseEqn();
 
   void mirror(const Geometry::Plane&);
@@ -0,0 +1,89 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   geomInc/SenseCache.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef Geometry_SenseCache_h
+#define Geometry_SenseCache_h
+
+namespace Geometry
+{
+
+  class Surface;
+
+/*!
+  \class SenseCache
+  \brief Memo of surface sides for one point
+  \version 1.0
+  \date November 2013
+  \author S. Ansell
+
+  Holds a point and the result of Surface::side
+  for each surface tested at that point. The table
+  is indexed by the dense surface index and each
+  entry is stamped with the point generation, so
+  moving to a new point does not clear the table.
+  Each entry also keeps the generation of the surface
+  index [Surface::getGeneration], so an entry of a 
+  surface that has moved, or of a deleted surface whose
+  index is reused, is evaluated again. A cache must not
+  be shared between threads.
+*/
+
+class SenseCache
+{
+ private:
+
+  Vec3D Pt;                           ///< Current point
+  int active;                         ///< Point set
+  unsigned int stamp;                 ///< Current generation
+  std::vector<unsigned int> Stamp;    ///< Generation of each entry
+  std::vector<size_t> Gen;            ///< Surface generation of entry
+  std::vector<int> Side;              ///< Side [-1,0,1]
+  size_t nEval;                       ///< Surface evaluations
+  size_t nCall;                       ///< Side requests
+
+  void newStamp();
+
+ public:
+
+  SenseCache();
+  SenseCache(const SenseCache&);
+  SenseCache& operator=(const SenseCache&);
+  ~SenseCache() {}   ///< Destructor
+
+  void setPoint(const Vec3D&);
+  void clear();
+  /// Access point
+  const Vec3D& getPoint() const { return Pt; }
+  /// Is a point set
+  int isActive() const { return active; }
+
+  int side(const Surface*);
+
+  /// Number of Surface::side calls
+  size_t getEval() const { return nEval; }
+  /// Number of side requests
+  size_t getCall() const { return nCall; }
+  void resetCount();
+};
+
+}  // NAMESPACE Geometry
+
+#endif
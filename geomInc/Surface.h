@@ -22,6 +22,11 @@
 #ifndef Geometry_Surface_h
 #define Geometry_Surface_h
 
+namespace boost
+{
+  class mutex;
+}
+
 namespace Geometry
 {
   class Vec3D;
@@ -43,14 +48,26 @@ class Surface
 {
  private:
   
+  static size_t nextIndex;                ///< Next new dense index
+
   int Name;        ///< Surface number (MNCPX identifier)
   int TransN;      ///< Transform number (-ve means applied)
+  size_t SIndex;   ///< Dense index [unique to live surfaces]
+  size_t SGen;     ///< Generation of the dense index
+  mutable int inCell;  ///< Surface used by a cell [box/tree]
+
+  static boost::mutex& indexLock();
+  static std::vector<size_t>& freeIndex();
+  static std::vector<size_t>& genIndex();
+  void allocIndex();
+  static void releaseIndex(const size_t);
 
   //  double eqnValue(const Geometry::Vec3D&) const;
 
  protected:
   
   void processSetHead(std::string&);
+  void markMoved();
 
  public:
 
@@ -77,6 +94,14 @@ class Surface
   int getName() const { return Name; }             ///< Get Name
   void setTrans(const int N) { TransN=N; }         ///< Set Transform number
   int getTrans() const { return TransN; }          ///< Get Transform number
+  /// Dense index for per-surface lookup tables
+  size_t getIndex() const { return SIndex; }
+  /// Generation of the index [changes on a move or a new surface]
+  size_t getGeneration() const { return SGen; }
+  /// Flag the surface as used by a cell box
+  void setInCell() const { inCell=1; }
+  static size_t getCellMove();
+  static void takeMoved(std::vector<int>&);
 
   // Processes Name/TransNumber
   std::string stripID(const std::string&);
@@ -0,0 +1,112 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   geomInc/surfHash.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef ModelSupport_surfHash_h
+#define ModelSupport_surfHash_h
+
+namespace Geometry
+{
+  class Surface;
+}
+
+namespace ModelSupport
+{
+
+/*!
+  \class surfHash
+  \brief Bucket index of surfaces by canonical coefficients
+  \version 1.0
+  \date November 2013
+  \author S. Ansell
+
+  Each surface gets three features which are the same
+  [within hashTol] for equal and for reversed surfaces
+  (e.g. |D| and |n_x|,|n_y| of a plane). The features are
+  quantized to a bucket. Searches test the bucket of the
+  surface and the next bucket on an axis if the feature
+  is within hashTol of the bucket edge. The index
+  only gives candidates : equality is still tested by the
+  surface operator==.
+
+  Surfaces whose coefficients are still to be set are 
+  held as loose and are always candidates. Each bucket 
+  is a map of the surfaces so that searches return the
+  buckets themselves. A surface moved in place must be 
+  added again [surfIndex does this from Surface::takeMoved].
+
+  In equation mode the key follows cmpSurfaces: planes
+  use the plane features, other quadratics are keyed 
+  on their equation irrespective of type and the 
+  remaining surfaces share one bucket.
+*/
+
+class surfHash
+{
+ public:
+
+  /// Surfaces in a bucket [number order]
+  typedef std::map<int,Geometry::Surface*> STYPE;
+
+ private:
+
+  /// Bucket key [surface type : quantized features]
+  typedef std::pair<int,Triple<long int> > KTYPE;
+  /// Buckets of surfaces
+  typedef std::map<KTYPE,STYPE> BTYPE;
+
+  static const double quantum;       ///< Bucket width
+  static const double hashTol;       ///< Max feature change of equal surfs
+
+  int eqnFlag;                       ///< Key on quadratic equation
+  BTYPE Buckets;                     ///< Surfaces in each bucket
+  std::map<int,KTYPE> SurfKey;       ///< Key of each hashed surface
+  STYPE Loose;                       ///< Surfaces always tested
+
+  static int features(const Geometry::Surface*,double*);
+  static int eqnFeatures(const Geometry::Surface*,double*);
+  int keyFeatures(const Geometry::Surface*,double*) const;
+  void findKeys(const int,const double*,std::vector<KTYPE>&) const;
+
+ public:
+
+  explicit surfHash(const int =0);
+  surfHash(const surfHash&);
+  surfHash& operator=(const surfHash&);
+  ~surfHash() {}         ///< Destructor
+
+  void clear();
+  void build(const STYPE&);
+  void addSurface(Geometry::Surface*);
+  void addLoose(Geometry::Surface*);
+  void removeSurface(const int);
+
+  int findCandidates(const Geometry::Surface*,
+		     std::vector<const STYPE*>&) const;
+
+  /// Number of hashed surfaces
+  size_t size() const { return SurfKey.size(); }
+  /// Number of buckets
+  size_t nBuckets() const { return Buckets.size(); }
+};
+
+}
+
+#endif
@@ -29,6 +29,7 @@ namespace Geometry
 
 namespace ModelSupport
 {
+  class surfHash;
 
 /*!
   \class surfIndex 
@@ -36,6 +37,10 @@ namespace ModelSupport
   \author S. Ansell
   \date December 2009
   \brief Storage for all the surfaces in the problem
+
+  The surfaces are also held in a bucket index [surfHash]
+  for equal/opposite surface searches. Surfaces moved in 
+  place are re-keyed before the next search.
 */
 
 class surfIndex
@@ -49,6 +54,7 @@ class surfIndex
   int uniqNum;                      ///< uniq number
   STYPE SMap;                       ///< Index of kept surfaces
   std::map<int,int> holdMap;        ///< Hold/Write map :: surfaceN : write/no-write flag
+  surfHash* HashPtr;                ///< Index for equal surfaces
   
   surfIndex();
 
@@ -58,6 +64,7 @@ class surfIndex
   ////\endcond SINGLETON
 
   int processSurfaces(const std::string&);
+  void updateHash() const;
 
   
  public:
@@ -84,6 +91,7 @@ class surfIndex
   int checkSurface(const int,const Geometry::Vec3D&) const; 
   void deleteSurface(const int);
   void renumber(const int,const int);
+  void rehash();
 
   Geometry::Surface* getSurf(const int) const; 
   
@@ -95,6 +103,8 @@ class surfIndex
 
   /// access to map
   const STYPE& surMap() const { return SMap; }
+  void equalCandidates(const Geometry::Surface*,
+		       std::vector<const STYPE*>&) const;
   void setKeep(const int,const int);
 
   bool mapValid() const;
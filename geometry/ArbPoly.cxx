@@ -198,6 +198,7 @@ ArbPoly::setSurface(const std::string& Pstr)
     \return 0 on success, -ve of failure
   */
 {
+  markMoved();
   std::string Line=this->stripID(Pstr);
 
   int nx;
@@ -267,6 +268,7 @@ ArbPoly::rotate(const Geometry::Matrix<double>& MA)
     \param MA direct rotation matrix (3x3)
   */
 {
+  markMoved();
   for_each(CVec.begin(),CVec.end(),
 	   boost::bind(&Vec3D::rotate<double>,_1,MA));
 
@@ -284,6 +286,7 @@ ArbPoly::mirror(const Geometry::Plane& MP)
     \param MP :: Mirror point
    */
 {
+  markMoved();
   for_each(CVec.begin(),CVec.end(),
 	   boost::bind(&Plane::mirrorPt,MP,_1));
 
@@ -300,6 +303,7 @@ ArbPoly::displace(const Geometry::Vec3D& Sp)
     \param Sp :: point value of displacement
   */
 {
+  markMoved();
   std::vector<Vec3D>::iterator vc;
   for(vc=CVec.begin();vc!=CVec.end();vc++)
     (*vc)+=Sp;
@@ -0,0 +1,332 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   geometry/BoundBox.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "GTKreport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "BoundBox.h"
+
+namespace Geometry
+{
+
+std::ostream&
+operator<<(std::ostream& OX,const BoundBox& A)
+  /*!
+    Standard output stream
+    \param OX :: Output stream
+    \param A :: BoundBox to write
+    \return Stream State
+   */
+{
+  A.write(OX);
+  return OX;
+}
+
+const double BoundBox::largeValue(1e38);
+
+BoundBox::BoundBox() :
+  LowPt(-largeValue,-largeValue,-largeValue),
+  HighPt(largeValue,largeValue,largeValue)
+  /*!
+    Constructor : Unbounded box
+  */
+{}
+
+BoundBox::BoundBox(const Vec3D& A,const Vec3D& B) :
+  LowPt(std::min(A[0],B[0]),std::min(A[1],B[1]),std::min(A[2],B[2])),
+  HighPt(std::max(A[0],B[0]),std::max(A[1],B[1]),std::max(A[2],B[2]))
+  /*!
+    Constructor from two opposite corners
+    \param A :: Corner point
+    \param B :: Opposite corner point
+  */
+{}
+
+BoundBox::BoundBox(const BoundBox& A) :
+  LowPt(A.LowPt),HighPt(A.HighPt)
+  /*!
+    Copy constructor
+    \param A :: BoundBox to copy
+  */
+{}
+
+BoundBox&
+BoundBox::operator=(const BoundBox& A)
+  /*!
+    Assignment operator
+    \param A :: BoundBox to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      LowPt=A.LowPt;
+      HighPt=A.HighPt;
+    }
+  return *this;
+}
+
+Vec3D
+BoundBox::getCentre() const
+  /*!
+    Centre of the box. Unbounded directions are
+    taken as zero.
+    \return centre point
+  */
+{
+  Vec3D Out;
+  for(size_t i=0;i<3;i++)
+    {
+      if (LowPt[i]> -largeValue && HighPt[i]<largeValue)
+	Out[i]=(LowPt[i]+HighPt[i])/2.0;
+      else if (LowPt[i]> -largeValue)
+	Out[i]=LowPt[i];
+      else if (HighPt[i]<largeValue)
+	Out[i]=HighPt[i];
+    }
+  return Out;
+}
+
+void
+BoundBox::setUnbounded()
+  /*!
+    Set the box to contain everything
+  */
+{
+  LowPt=Vec3D(-largeValue,-largeValue,-largeValue);
+  HighPt=Vec3D(largeValue,largeValue,largeValue);
+  return;
+}
+
+void
+BoundBox::setEmpty()
+  /*!
+    Set the box to contain nothing (low > high)
+    ready for addPoint/merge.
+  */
+{
+  LowPt=Vec3D(largeValue,largeValue,largeValue);
+  HighPt=Vec3D(-largeValue,-largeValue,-largeValue);
+  return;
+}
+
+void
+BoundBox::setLow(const size_t index,const double V)
+  /*!
+    Set a low limit
+    \param index :: axis index [0-2]
+    \param V :: Value
+  */
+{
+  if (index>2)
+    throw ColErr::IndexError<size_t>(index,3,"BoundBox::setLow");
+  LowPt[index]=V;
+  return;
+}
+
+void
+BoundBox::setHigh(const size_t index,const double V)
+  /*!
+    Set a high limit
+    \param index :: axis index [0-2]
+    \param V :: Value
+  */
+{
+  if (index>2)
+    throw ColErr::IndexError<size_t>(index,3,"BoundBox::setHigh");
+  HighPt[index]=V;
+  return;
+}
+
+bool
+BoundBox::isUnbounded() const
+  /*!
+    Determine if the box is unbounded in any direction
+    \return true if any limit is at infinity
+  */
+{
+  for(size_t i=0;i<3;i++)
+    if (LowPt[i]<= -largeValue || HighPt[i]>=largeValue)
+      return 1;
+  return 0;
+}
+
+bool
+BoundBox::isBounded() const
+  /*!
+    Determine if the box has at least one finite limit
+    \return true if any limit is finite
+  */
+{
+  for(size_t i=0;i<3;i++)
+    if (LowPt[i]> -largeValue || HighPt[i]<largeValue)
+      return 1;
+  return 0;
+}
+
+bool
+BoundBox::isEmpty() const
+  /*!
+    Determine if the box contains no volume
+    \return true if low > high on any axis
+  */
+{
+  return (LowPt[0]>HighPt[0] ||
+	  LowPt[1]>HighPt[1] ||
+	  LowPt[2]>HighPt[2]);
+}
+
+bool
+BoundBox::isValid(const Vec3D& Pt) const
+  /*!
+    Determine if a point is within the box [inclusive]
+    \param Pt :: Point to test
+    \return true if Pt is inside/on the box
+  */
+{
+  return (Pt.X()>=LowPt.X() && Pt.X()<=HighPt.X() &&
+	  Pt.Y()>=LowPt.Y() && Pt.Y()<=HighPt.Y() &&
+	  Pt.Z()>=LowPt.Z() && Pt.Z()<=HighPt.Z());
+}
+
+bool
+BoundBox::overlap(const BoundBox& A) const
+  /*!
+    Determine if two boxes overlap [inclusive]
+    \param A :: Box to test
+    \return true if the boxes share a region
+  */
+{
+  for(size_t i=0;i<3;i++)
+    if (A.HighPt[i]<LowPt[i] || A.LowPt[i]>HighPt[i])
+      return 0;
+  return 1;
+}
+
+size_t
+BoundBox::longestAxis() const
+  /*!
+    Get the axis with the largest extent
+    \return axis index [0-2]
+  */
+{
+  size_t index(0);
+  double maxLen(HighPt[0]-LowPt[0]);
+  for(size_t i=1;i<3;i++)
+    {
+      const double L=HighPt[i]-LowPt[i];
+      if (L>maxLen)
+	{
+	  maxLen=L;
+	  index=i;
+	}
+    }
+  return index;
+}
+
+void
+BoundBox::addPoint(const Vec3D& Pt)
+  /*!
+    Extend the box to include a point
+    \param Pt :: Point to add
+  */
+{
+  for(size_t i=0;i<3;i++)
+    {
+      if (Pt[i]<LowPt[i]) LowPt[i]=Pt[i];
+      if (Pt[i]>HighPt[i]) HighPt[i]=Pt[i];
+    }
+  return;
+}
+
+void
+BoundBox::merge(const BoundBox& A)
+  /*!
+    Extend the box to the union of this and A
+    \param A :: Box to merge
+  */
+{
+  for(size_t i=0;i<3;i++)
+    {
+      LowPt[i]=std::min(LowPt[i],A.LowPt[i]);
+      HighPt[i]=std::max(HighPt[i],A.HighPt[i]);
+    }
+  return;
+}
+
+void
+BoundBox::intersect(const BoundBox& A)
+  /*!
+    Reduce the box to the common region of this and A
+    \param A :: Box to intersect
+  */
+{
+  for(size_t i=0;i<3;i++)
+    {
+      LowPt[i]=std::max(LowPt[i],A.LowPt[i]);
+      HighPt[i]=std::min(HighPt[i],A.HighPt[i]);
+    }
+  return;
+}
+
+void
+BoundBox::grow(const double D)
+  /*!
+    Expand the finite limits of the box by D
+    \param D :: Distance to move each face outwards
+  */
+{
+  for(size_t i=0;i<3;i++)
+    {
+      if (LowPt[i]> -largeValue) LowPt[i]-=D;
+      if (HighPt[i]<largeValue) HighPt[i]+=D;
+    }
+  return;
+}
+
+void
+BoundBox::write(std::ostream& OX) const
+  /*!
+    Write out the box
+    \param OX :: Output stream
+  */
+{
+  OX<<"["<<LowPt<<"] : ["<<HighPt<<"]";
+  return;
+}
+
+}  // NAMESPACE Geometry
@@ -171,6 +171,7 @@ Cone::setSurface(const std::string& Pstr)
   */
 {
   ELog::RegMethod RegA("Cone","setSurface");
+  markMoved();
 
   std::string Line=this->stripID(Pstr);
 
@@ -246,6 +247,7 @@ Cone::rotate(const Geometry::Matrix<double>& R)
     \param R :: Matrix for rotation. 
   */
 {
+  markMoved();
   Centre.rotate(R);
   Normal.rotate(R);
   setBaseEqn();
@@ -260,6 +262,7 @@ Cone::displace(const Geometry::Vec3D& A)
     \param A :: Geometry::Vec3D to add
   */
 {
+  markMoved();
   Centre+=A;
   setBaseEqn();
   return;
@@ -286,6 +289,7 @@ Cone::setCentre(const Geometry::Vec3D& A)
     \param A :: New Centre point
   */
 {
+  markMoved();
   Centre=A;
   setBaseEqn();
   return;
@@ -298,6 +302,7 @@ Cone::setNormal(const Geometry::Vec3D& A)
     \param A :: New Normal direction
   */
 {
+  markMoved();
   if (A.abs()>Geometry::zeroTol)
     {
       Normal=A;
@@ -315,6 +320,7 @@ Cone::setAngle(const double A)
     Resets the base equation
   */
 {
+  markMoved();
   alpha=A;
   cangle=cos(M_PI*alpha/180.0);
   setBaseEqn();
@@ -329,6 +335,7 @@ Cone::setTanAngle(const double A)
     \param A :: Tan of the angle  (for MCNPX)
   */
 {
+  markMoved();
   cangle=1.0/sqrt(A*A+1.0);        // convert tan(theta) to cos(theta)
   alpha=acos(cangle)*180.0/M_PI;
   setBaseEqn();
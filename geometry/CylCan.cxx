@@ -171,6 +171,7 @@ CylCan::setCylCan(const Geometry::Vec3D& A,const Geometry::Vec3D& B,
     \retval -1 :: Failed
   */
 {
+  markMoved();
   Vec3D uVec=B;
   const double L=uVec.makeUnit();
   if (L<Geometry::zeroTol || R<=0)
@@ -197,6 +198,7 @@ CylCan::setCylCan(const Geometry::Vec3D& A,const Geometry::Vec3D& D,
     \retval -1 :: Failed
   */
 {
+  markMoved();
   if (R<=Geometry::zeroTol || L<=Geometry::zeroTol ||
       D.abs()<=Geometry::zeroTol)
     return -1;
@@ -219,6 +221,7 @@ CylCan::setSurface(const std::string& Pstr)
      \return 0 on success, -ve of failure
   */
 {
+  markMoved();
   std::string Line=Pstr;
   
   int nx;
@@ -254,6 +257,7 @@ CylCan::rotate(const Geometry::Matrix<double>& MA)
     \param MA direct rotation matrix (3x3)
   */
 {
+  markMoved();
   OPt.rotate(MA);
   unitD.rotate(MA);
   makeSides();
@@ -268,6 +272,7 @@ CylCan::displace(const Geometry::Vec3D& Sp)
     \param Sp :: point value of displacement
   */
 {
+  markMoved();
   OPt+=Sp;
   makeSides();
   return;
@@ -282,6 +287,7 @@ CylCan::mirror(const Geometry::Plane& MP)
     \param MP :: Mirror point
    */
 {
+  markMoved();
   MP.mirrorPt(OPt);
   MP.mirrorAxis(unitD);
   
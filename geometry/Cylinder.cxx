@@ -188,6 +188,7 @@ Cylinder::setSurface(const std::string& Pstr)
   */
 {
   ELog::RegMethod RegA("Cylinder","setSurface");
+  markMoved();
 
   enum { errDesc=-1, errAxis=-2,
 	 errCent=-3, errRadius=-4};
@@ -250,6 +251,7 @@ Cylinder::setCylinder(const Geometry::Vec3D& Cpoint,
     \retval 0 :: success / -ve on failure
   */
 {
+  markMoved();
   if (R<=0)
     return -1;
   
@@ -380,6 +382,7 @@ Cylinder::setCentre(const Geometry::Vec3D& A)
     \param A :: centre point 
   */
 {
+  markMoved();
   Centre=A;
   setBaseEqn();
   return;
@@ -393,6 +396,7 @@ Cylinder::setNorm(const Geometry::Vec3D& A)
     \param A :: Vector along the centre line 
   */
 {
+  markMoved();
   Normal=A;
   Normal.makeUnit();
   setBaseEqn();
@@ -406,6 +410,7 @@ Cylinder::setRadius(const double R)
     \param R :: New radius (forced +ve)
   */
 {
+  markMoved();
   Radius=fabs(R);
   setBaseEqn();
   return;
@@ -441,6 +446,7 @@ Cylinder::mirror(const Geometry::Plane& MP)
     \param MP :: Mirror point
    */
 {
+  markMoved();
   MP.mirrorAxis(Normal);
   MP.mirrorPt(Centre);
   setBaseEqn();
@@ -122,6 +122,7 @@ General::setSurface(const std::string& Pstr)
     \return 0 on success, neg of failure
   */
 {
+  markMoved();
   std::string Line=Pstr;
   std::string item;
   if (!StrFunc::section(Line,item) || item.length()!=2 ||
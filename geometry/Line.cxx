@@ -315,7 +315,7 @@ Line::intersect(std::vector<Geometry::Vec3D>& VecOut,
      \return Number of points found. 
   */
 {
-  const std::vector<double> BN=Sur.copyBaseEqn();
+  const std::vector<double>& BN=Sur.copyBaseEqn();
   // Debug
   //  copy(BN.begin(),BN.end(),std::ostream_iterator<double>(std::cout," :: "));
   //  std::cout<<std::endl;
@@ -208,6 +208,7 @@ MBrect::setCorner(const Geometry::Vec3D& A)
     \param A :: New corner position
   */
 {
+  markMoved();
   Corner=A;
   makeSides();
   return;
@@ -223,6 +224,7 @@ MBrect::setMBrect(const Geometry::Vec3D& A,const Geometry::Vec3D& B)
     \retval 0 :: success
   */
 {
+  markMoved();
   Corner=A;
   Geometry::Vec3D X=B-A;
   for(int i=0;i<3;i++)
@@ -249,6 +251,7 @@ MBrect::setMBrect(const Geometry::Vec3D& A,const Geometry::Vec3D& L1,
     \retval -1 :: vectors are in a plane
   */
 {
+  markMoved();
   // first check that L1,L2,L3 are in a plane
   if (fabs(L1.dotProd(L2*L3))<Geometry::zeroTol)
     {
@@ -276,6 +279,7 @@ MBrect::setSurface(const std::string& Pstr)
      \return 0 on success, -ve of failure
   */
 {
+  markMoved();
   std::string Line=Pstr;
 
   int nx;
@@ -333,6 +337,7 @@ MBrect::rotate(const Geometry::Matrix<double>& MA)
     \param MA direct rotation matrix (3x3)
   */
 {
+  markMoved();
   Corner.rotate(MA);
   for(int i=0;i<3;i++)
     LVec[i].rotate(MA);
@@ -349,6 +354,7 @@ MBrect::displace(const Geometry::Vec3D& Sp)
     \param Sp :: point value of displacement
   */
 {
+  markMoved();
   Corner+=Sp;
   for(int i=0;i<3;i++)
     LVec[i]+=Sp;
@@ -366,6 +372,7 @@ MBrect::mirror(const Geometry::Plane& MP)
     \param MP :: Mirror point
    */
 {
+  markMoved();
   MP.mirrorPt(Corner);
   for(int i=0;i<3;i++)
     MP.mirrorPt(LVec[i]);
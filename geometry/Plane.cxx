@@ -212,6 +212,7 @@ Plane::setSurface(const std::string& Pstr)
      \return 0 on success, -ve of failure
   */
 {
+  markMoved();
   // Two types of plane string p[x-z]  and p
   std::string Line=Pstr;
   std::string item;
@@ -273,6 +274,7 @@ Plane::setPlane(const Geometry::Vec3D& P,const Geometry::Vec3D& N)
     \retval 0 :: success
   */
 {
+  markMoved();
   NormV=N;
   NormV.makeUnit();
   Dist=P.dotProd(NormV);
@@ -292,6 +294,7 @@ Plane::setPlane(const Geometry::Vec3D& PA,const Geometry::Vec3D& PB,
   */
 {
   ELog::RegMethod RegA("Plane","setPlane");
+  markMoved();
   const Geometry::Vec3D LA=PC-PA;
   const Geometry::Vec3D LB=PB-PA;
   NormV=LA*LB;
@@ -309,6 +312,7 @@ Plane::setPlane(const Plane& A)
     \retval 0 :: success
   */
 {
+  markMoved();
   if (this!=&A)
     {
       NormV=A.NormV;
@@ -327,6 +331,7 @@ Plane::setPlane(const Geometry::Vec3D& N,const double D)
     \retval 0 :: success
   */
 {
+  markMoved();
   NormV=N;
   NormV.makeUnit();
   Dist=D;
@@ -341,6 +346,7 @@ Plane::setNormal(const Vec3D& Pt)
     \param Pt :: Normal vector
    */
 {
+  markMoved();
   if (Pt.abs()>Geometry::zeroTol)
     {
       NormV=Pt;
@@ -357,6 +363,7 @@ Plane::setDistance(const double D)
     \param D :: Distance to set
    */
 {
+  markMoved();
   Dist=D;
   setBaseEqn();
   return;
@@ -399,6 +406,7 @@ Plane::mirror(const Geometry::Plane& MP)
     \param MP :: Mirror point
    */
 {
+  markMoved();
   MP.mirrorAxis(NormV);
   setBaseEqn();
   return;
@@ -414,6 +422,7 @@ Plane::mirrorSelf()
     and the distance
    */
 {
+  markMoved();
   NormV*=-1.0;
   Dist*=-1.0;
   setBaseEqn();
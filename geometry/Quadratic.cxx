@@ -362,6 +362,7 @@ Quadratic::displace(const Geometry::Vec3D& Pt)
     \param Pt :: Point to add to surface coordinate
   */
 {
+  markMoved();
   BaseEqn[9]+= Pt[0]*(Pt[0]*BaseEqn[0]-BaseEqn[6])+
                Pt[1]*(Pt[1]*BaseEqn[1]-BaseEqn[7])+
                Pt[2]*(Pt[2]*BaseEqn[2]-BaseEqn[8])+
@@ -381,6 +382,7 @@ Quadratic::rotate(const Geometry::Matrix<double>& MX)
     \param MX :: Matrix for rotation (not inverted like MCNPX)
    */
 {
+  markMoved();
   Geometry::Matrix<double> MA=MX;
   MA.Invert();
   const double a(MA[0][0]),b(MA[0][1]),c(MA[0][2]);
@@ -437,6 +439,7 @@ Quadratic::mirror(const Geometry::Plane& P)
   */
 {
   ELog::RegMethod RegA("Quadratic","mirror");
+  markMoved();
 
   const Geometry::Vec3D NormV=P.getNormal();
   const double nx(NormV[0]);
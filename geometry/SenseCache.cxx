@@ -0,0 +1,170 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   geometry/SenseCache.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "GTKreport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "Surface.h"
+#include "SenseCache.h"
+
+namespace Geometry
+{
+
+SenseCache::SenseCache() :
+  active(0),stamp(1),nEval(0),nCall(0)
+  /*!
+    Constructor
+  */
+{}
+
+SenseCache::SenseCache(const SenseCache& A) :
+  Pt(A.Pt),active(A.active),stamp(A.stamp),Stamp(A.Stamp),
+  Gen(A.Gen),Side(A.Side),nEval(A.nEval),nCall(A.nCall)
+  /*!
+    Copy constructor
+    \param A :: SenseCache to copy
+  */
+{}
+
+SenseCache&
+SenseCache::operator=(const SenseCache& A)
+  /*!
+    Assignment operator
+    \param A :: SenseCache to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      Pt=A.Pt;
+      active=A.active;
+      stamp=A.stamp;
+      Stamp=A.Stamp;
+      Gen=A.Gen;
+      Side=A.Side;
+      nEval=A.nEval;
+      nCall=A.nCall;
+    }
+  return *this;
+}
+
+void
+SenseCache::newStamp()
+  /*!
+    Move to a new generation : on wrap round
+    the stamps are cleared
+  */
+{
+  stamp++;
+  if (!stamp)
+    {
+      std::fill(Stamp.begin(),Stamp.end(),0);
+      stamp=1;
+    }
+  return;
+}
+
+void
+SenseCache::setPoint(const Vec3D& A)
+  /*!
+    Set the point. If the point is exactly the same
+    as the current point the memo is kept [moved surfaces
+    are found by their generation].
+    \param A :: Point for all following tests
+  */
+{
+  if (active && 
+      A.X()==Pt.X() && A.Y()==Pt.Y() && A.Z()==Pt.Z())
+    return;
+  newStamp();
+  Pt=A;
+  active=1;
+  return;
+}
+
+void
+SenseCache::clear()
+  /*!
+    Invalidate the memo and the point
+  */
+{
+  newStamp();
+  active=0;
+  return;
+}
+
+int
+SenseCache::side(const Surface* SPtr)
+  /*!
+    Get the side of a surface at the current point
+    \param SPtr :: Surface to test
+    \return Surface::side(Pt)
+  */
+{
+  nCall++;
+  const size_t index=SPtr->getIndex();
+  if (index>=Stamp.size())
+    {
+      Stamp.resize(index+1,0);
+      Gen.resize(index+1,0);
+      Side.resize(index+1,0);
+    }
+  const size_t gen=SPtr->getGeneration();
+  if (Stamp[index]!=stamp || Gen[index]!=gen)
+    {
+      Stamp[index]=stamp;
+      Gen[index]=gen;
+      Side[index]=SPtr->side(Pt);
+      nEval++;
+    }
+  return Side[index];
+}
+
+void
+SenseCache::resetCount()
+  /*!
+    Zero the evaluation counters
+  */
+{
+  nEval=0;
+  nCall=0;
+  return;
+}
+
+}  // NAMESPACE Geometry
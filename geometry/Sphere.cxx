@@ -152,6 +152,7 @@ Sphere::setSurface(const std::string& Pstr)
     \return : 0 on success, neg of failure 
   */
 {
+  markMoved();
   std::string Line=Pstr;
   std::string item;
   if (!StrFunc::section(Line,item) || 
@@ -199,6 +200,7 @@ Sphere::setSphere(const Geometry::Vec3D& Cpoint,const double R)
     \retval 0 :: success / -ve on failure
   */
 {
+  markMoved();
   if (R<=0)
     return -1;
   
@@ -283,6 +285,7 @@ Sphere::mirror(const Geometry::Plane& MP)
     \param MP :: Mirror point
    */
 {
+  markMoved();
   MP.mirrorPt(Centre);
   setBaseEqn();
   return;
@@ -295,6 +298,7 @@ Sphere::setCentre(const Geometry::Vec3D& A)
     \param A :: New Centre Point
   */
 {
+  markMoved();
   Centre=A;
   setBaseEqn();
   return;
@@ -307,6 +311,7 @@ Sphere::setRadius(const double R)
     \param R :: New Radius
   */
 {
+  markMoved();
   Radius=R;
   setBaseEqn();
   return;
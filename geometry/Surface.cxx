@@ -26,9 +26,12 @@
 #include <complex>
 #include <cmath>
 #include <vector>
+#include <set>
 #include <map>
 #include <string>
 #include <algorithm>
+#include <boost/thread/mutex.hpp>
+#include <boost/atomic.hpp>
 
 #include "Exception.h"
 #include "GTKreport.h"
@@ -63,41 +66,185 @@ operator<<(std::ostream& OX,const Surface& A)
   return OX;
 }
 
+size_t Surface::nextIndex(0);
+
+/// Moves of surfaces used by a cell [read without the lock]
+static boost::atomic<size_t> cellMoveCount(0);
+
+boost::mutex&
+Surface::indexLock()
+  /*!
+    Lock on the dense index list and the generations.
+    Like the list it is never deleted.
+    \return mutex
+  */
+{
+  static boost::mutex* MPtr=new boost::mutex;
+  return *MPtr;
+}
+
+std::vector<size_t>&
+Surface::freeIndex()
+  /*!
+    Released dense indexes. The list is never deleted
+    as surfaces held by singletons are deleted during
+    static destruction.
+    \return list of free indexes
+  */
+{
+  static std::vector<size_t>* FPtr=new std::vector<size_t>;
+  return *FPtr;
+}
+
+std::vector<size_t>&
+Surface::genIndex()
+  /*!
+    Last generation given out for each dense index. 
+    Like the free list it is never deleted.
+    \return generation of each index
+  */
+{
+  static std::vector<size_t>* GPtr=new std::vector<size_t>;
+  return *GPtr;
+}
+
+static std::set<int>&
+movedSurf()
+  /*!
+    Names of surfaces moved in place since the last 
+    takeMoved. Like the free list it is never deleted.
+    \return set of surface names
+  */
+{
+  static std::set<int>* MPtr=new std::set<int>;
+  return *MPtr;
+}
+
+void
+Surface::allocIndex()
+  /*!
+    Get a dense index that is not used by a live surface.
+    Released indexes are reused so the range stays close
+    to the number of surfaces. The index generation goes
+    up, so a memo of the old surface is not used for 
+    the new one.
+  */
+{
+  boost::mutex::scoped_lock Lock(indexLock());
+  std::vector<size_t>& FI=freeIndex();
+  std::vector<size_t>& GI=genIndex();
+  if (FI.empty())
+    {
+      SIndex=nextIndex++;
+      GI.push_back(0);
+    }
+  else
+    {
+      SIndex=FI.back();
+      FI.pop_back();
+    }
+  SGen= ++GI[SIndex];
+  return;
+}
+
+void
+Surface::releaseIndex(const size_t Index)
+  /*!
+    Return a dense index for reuse
+    \param Index :: index to release
+  */
+{
+  boost::mutex::scoped_lock Lock(indexLock());
+  freeIndex().push_back(Index);
+  return;
+}
+
+void
+Surface::markMoved()
+  /*!
+    Record that this surface is about to be moved in place.
+    Called by every mutator [displace/rotate/mirror/set*] 
+    and by assignment. The index generation goes up and the 
+    name is kept for the equal surface index [takeMoved].
+    Only a surface used by a cell counts in getCellMove.
+  */
+{
+  boost::mutex::scoped_lock Lock(indexLock());
+  SGen= ++genIndex()[SIndex];
+  movedSurf().insert(Name);
+  if (inCell)
+    cellMoveCount++;
+  return;
+}
+
+size_t
+Surface::getCellMove()
+  /*!
+    Count of moves of surfaces used by a cell. 
+    Temporary surfaces do not count.
+    \return move count
+  */
+{
+  return cellMoveCount.load();
+}
+
+void
+Surface::takeMoved(std::vector<int>& Out)
+  /*!
+    Get the names of the surfaces moved since the last
+    call and clear the record
+    \param Out :: Surface names [in order]
+  */
+{
+  boost::mutex::scoped_lock Lock(indexLock());
+  std::set<int>& MS=movedSurf();
+  Out.assign(MS.begin(),MS.end());
+  MS.clear();
+  return;
+}
+
 Surface::Surface() : 
-  Name(-1),TransN(0)
+  Name(-1),TransN(0),SIndex(0),SGen(0),inCell(0)
   /*!
     Constructor
   */
-{}
+{
+  allocIndex();
+}
 
 Surface::Surface(const int N,const int T) : 
-  Name(N),TransN(T)
+  Name(N),TransN(T),SIndex(0),SGen(0),inCell(0)
   /*!
     Constructor
     \param N :: Name 
     \param T :: Transform
   */
-{}
+{
+  allocIndex();
+}
 
 Surface::Surface(const Surface& A) : 
-  Name(A.Name),TransN(A.TransN)
+  Name(A.Name),TransN(A.TransN),SIndex(0),SGen(0),inCell(0)
   /*!
-    Copy constructor
+    Copy constructor [new dense index]
     \param A :: Surface to copy
   */
-{}
+{
+  allocIndex();
+}
 
 
 Surface&
 Surface::operator=(const Surface& A)
   /*!
-    Assignment operator
+    Assignment operator [dense index is not copied]
     \param A :: Surface to copy
     \return *this
   */
 {
   if (this!=&A)
     {
+      markMoved();
       Name=A.Name;
       TransN=A.TransN;
     }
@@ -108,7 +255,9 @@ Surface::~Surface()
   /*!
     Destructor
   */
-{}
+{
+  releaseIndex(SIndex);
+}
 
 void
 Surface::processSetHead(std::string& Line)
@@ -149,6 +149,7 @@ Torus::setCentre(const Geometry::Vec3D& A)
     \param A :: New Centre point
   */
 {
+  markMoved();
   Centre=A;
   return;
 }
@@ -164,6 +165,7 @@ Torus::setNormal(const Vec3D& N)
     \param N :: Normal Vector
    */
 {
+  markMoved();
   if (N.abs()>Geometry::zeroTol)
     {
       Normal=N;
@@ -182,6 +184,7 @@ Torus::setIRad(const double D)
     \param D :: Radius
    */
 {
+  markMoved();
   Iradius=D;
   return;
 }
@@ -193,6 +196,7 @@ Torus::setORad(const double D)
     \param D :: Radius
    */
 {
+  markMoved();
   Oradius=D;
   return;
 }
@@ -209,6 +213,7 @@ Torus::setSurface(const std::string& Pstr)
     \return : 0 on success, neg of failure 
   */
 {
+  markMoved();
   enum { errDesc=-1, errAxis=-2,
 	 errCent=-3, errNormal=-4};
 
@@ -251,6 +256,7 @@ Torus::rotate(const Geometry::Matrix<double>& R)
     \param R :: Matrix for rotation. 
   */
 {
+  markMoved();
   Centre.rotate(R);
   Normal.rotate(R);
   setNormal(Normal);            // Trick to get quaterion set correctly
@@ -265,6 +271,7 @@ Torus::displace(const Geometry::Vec3D& A)
     \param A :: Point to add
   */
 {
+  markMoved();
   Centre+=A;
   return;
 }
@@ -279,6 +286,7 @@ Torus::mirror(const Geometry::Plane& MP)
     \param MP :: Mirror point
    */
 {
+  markMoved();
   MP.mirrorPt(Centre);
   MP.mirrorAxis(Normal);
   return;
@@ -0,0 +1,362 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   geometry/surfHash.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <vector>
+#include <map>
+#include <set>
+#include <list>
+#include <string>
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "GTKreport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Triple.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "Surface.h"
+#include "Quadratic.h"
+#include "Cylinder.h"
+#include "Cone.h"
+#include "General.h"
+#include "Plane.h"
+#include "Sphere.h"
+#include "surfaceFactory.h"
+#include "surfHash.h"
+
+namespace ModelSupport
+{
+
+const double surfHash::quantum(1e-3);
+const double surfHash::hashTol(1e-5);
+
+surfHash::surfHash(const int eFlag) :
+  eqnFlag(eFlag)
+  /*!
+    Constructor
+    \param eFlag :: Key on the quadratic equation [cmpSurfaces]
+  */
+{}
+
+surfHash::surfHash(const surfHash& A) :
+  eqnFlag(A.eqnFlag),Buckets(A.Buckets),SurfKey(A.SurfKey),Loose(A.Loose)
+  /*!
+    Copy constructor
+    \param A :: surfHash to copy
+  */
+{}
+
+surfHash&
+surfHash::operator=(const surfHash& A)
+  /*!
+    Assignment operator
+    \param A :: surfHash to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      eqnFlag=A.eqnFlag;
+      Buckets=A.Buckets;
+      SurfKey=A.SurfKey;
+      Loose=A.Loose;
+    }
+  return *this;
+}
+
+void
+surfHash::clear()
+  /*!
+    Remove all the surfaces
+  */
+{
+  Buckets.clear();
+  SurfKey.clear();
+  Loose.clear();
+  return;
+}
+
+int
+surfHash::features(const Geometry::Surface* SPtr,double* F)
+  /*!
+    Calculate the canonical features of a surface. These
+    are unchanged [within hashTol] between surfaces that
+    are equal by the surface operator== and between
+    opposite planes. Types without features only use
+    the type.
+    \param SPtr :: Surface 
+    \param F :: Features [3]
+    \return surface type index / -1 if all quadratics must be tested
+  */
+{
+  F[0]=F[1]=F[2]=0.0;
+  const std::string CName=SPtr->className();
+  // Quadratic matches any derived surface
+  if (CName=="Quadratic")
+    return -1;
+
+  const Geometry::Plane* PPtr=
+    dynamic_cast<const Geometry::Plane*>(SPtr);
+  const Geometry::Cylinder* CPtr=
+    dynamic_cast<const Geometry::Cylinder*>(SPtr);
+  const Geometry::Sphere* SphPtr=
+    dynamic_cast<const Geometry::Sphere*>(SPtr);
+  const Geometry::Cone* KPtr=
+    dynamic_cast<const Geometry::Cone*>(SPtr);
+  const Geometry::General* GPtr=
+    dynamic_cast<const Geometry::General*>(SPtr);
+  if (PPtr)
+    {
+      F[0]=fabs(PPtr->getDistance());
+      F[1]=fabs(PPtr->getNormal()[0]);
+      F[2]=fabs(PPtr->getNormal()[1]);
+    }
+  else if (CPtr)
+    {
+      F[0]=CPtr->getRadius();
+      F[1]=fabs(CPtr->getNormal()[0]);
+      F[2]=fabs(CPtr->getNormal()[1]);
+    }
+  else if (SphPtr)
+    {
+      F[0]=SphPtr->getRadius();
+      F[1]=SphPtr->getCentre()[0];
+      F[2]=SphPtr->getCentre()[1];
+    }
+  else if (KPtr)
+    {
+      F[0]=KPtr->getCosAngle();
+      F[1]=KPtr->getCentre()[0];
+      F[2]=KPtr->getCentre()[1];
+    }
+  else if (GPtr)
+    {
+      const std::vector<double>& BE=GPtr->copyBaseEqn();
+      for(size_t i=0;i<3 && i<BE.size();i++)
+	F[i]=fabs(BE[i]);
+    }
+  return Geometry::surfaceFactory::Instance().getIndex(CName);
+}
+
+int
+surfHash::eqnFeatures(const Geometry::Surface* SPtr,double* F)
+  /*!
+    Calculate the features used by cmpSurfaces. Planes are
+    compared as planes. All other quadratics are equal if
+    the equations are equal [to a sign] so the constant 
+    and linear terms are used. Other surfaces are never 
+    equal and share a bucket.
+    \param SPtr :: Surface 
+    \param F :: Features [3]
+    \return 0 for planes / 1 for quadratics / 2 for others
+  */
+{
+  F[0]=F[1]=F[2]=0.0;
+  const Geometry::Plane* PPtr=
+    dynamic_cast<const Geometry::Plane*>(SPtr);
+  if (PPtr)
+    {
+      F[0]=fabs(PPtr->getDistance());
+      F[1]=fabs(PPtr->getNormal()[0]);
+      F[2]=fabs(PPtr->getNormal()[1]);
+      return 0;
+    }
+  const Geometry::Quadratic* QPtr=
+    dynamic_cast<const Geometry::Quadratic*>(SPtr);
+  if (!QPtr) return 2;
+
+  const std::vector<double>& BE=QPtr->copyBaseEqn();
+  if (BE.size()>9)
+    {
+      F[0]=fabs(BE[9]);
+      F[1]=fabs(BE[6]);
+      F[2]=fabs(BE[7]);
+    }
+  return 1;
+}
+
+int
+surfHash::keyFeatures(const Geometry::Surface* SPtr,double* F) const
+  /*!
+    Calculate the key features in the current mode
+    \param SPtr :: Surface 
+    \param F :: Features [3]
+    \return surface type index / -1 if all quadratics must be tested
+  */
+{
+  return (eqnFlag) ? eqnFeatures(SPtr,F) : features(SPtr,F);
+}
+
+void
+surfHash::findKeys(const int typeIndex,const double* F,
+		   std::vector<KTYPE>& Keys) const
+  /*!
+    Determine the bucket keys that can hold a surface 
+    with features F [within hashTol]. The first key is 
+    the bucket of F.
+    \param typeIndex :: Surface type
+    \param F :: Features [3]
+    \param Keys :: Output keys
+  */
+{
+  Keys.clear();
+  std::vector<long int> Cell[3];
+  for(size_t i=0;i<3;i++)
+    {
+      const double QV=F[i]/quantum;
+      const double QFloor=(fabs(QV)<1e15) ? 
+	floor(QV) : ((QV>0.0) ? 1e15 : -1e15);
+      const long int index=static_cast<long int>(QFloor);
+      Cell[i].push_back(index);
+      if (F[i]-QFloor*quantum<hashTol)
+	Cell[i].push_back(index-1);
+      if ((QFloor+1.0)*quantum-F[i]<hashTol)
+	Cell[i].push_back(index+1);
+    }
+  for(size_t i=0;i<Cell[0].size();i++)
+    for(size_t j=0;j<Cell[1].size();j++)
+      for(size_t k=0;k<Cell[2].size();k++)
+	Keys.push_back(KTYPE(typeIndex,Triple<long int>
+			     (Cell[0][i],Cell[1][j],Cell[2][k])));
+  return;
+}
+
+void
+surfHash::build(const STYPE& SMap)
+  /*!
+    Rebuild the index from all the surfaces
+    \param SMap :: Surface map
+  */
+{
+  ELog::RegMethod RegA("surfHash","build");
+  clear();
+  STYPE::const_iterator mc;
+  for(mc=SMap.begin();mc!=SMap.end();mc++)
+    addSurface(mc->second);
+  return;
+}
+
+void
+surfHash::addSurface(Geometry::Surface* SPtr)
+  /*!
+    Add a surface with its current coefficients.
+    An existing entry for the surface number is replaced.
+    \param SPtr :: Surface
+  */
+{
+  const int SN=SPtr->getName();
+  removeSurface(SN);
+
+  double F[3];
+  const int typeIndex=keyFeatures(SPtr,F);
+  if (typeIndex<0)
+    {
+      Loose.insert(STYPE::value_type(SN,SPtr));
+      return;
+    }
+  std::vector<KTYPE> Keys;
+  findKeys(typeIndex,F,Keys);
+  Buckets[Keys.front()].insert(STYPE::value_type(SN,SPtr));
+  SurfKey.insert(std::map<int,KTYPE>::value_type(SN,Keys.front()));
+  return;
+}
+
+void
+surfHash::addLoose(Geometry::Surface* SPtr)
+  /*!
+    Add a surface that is always a candidate
+    [e.g. a surface that is still to be set]
+    \param SPtr :: Surface
+  */
+{
+  const int SN=SPtr->getName();
+  removeSurface(SN);
+  Loose.insert(STYPE::value_type(SN,SPtr));
+  return;
+}
+
+void
+surfHash::removeSurface(const int SN)
+  /*!
+    Remove a surface number [if present]
+    \param SN :: Surface number
+  */
+{
+  Loose.erase(SN);
+  std::map<int,KTYPE>::iterator mc=SurfKey.find(SN);
+  if (mc!=SurfKey.end())
+    {
+      BTYPE::iterator bc=Buckets.find(mc->second);
+      if (bc!=Buckets.end())
+	{
+	  bc->second.erase(SN);
+	  if (bc->second.empty())
+	    Buckets.erase(bc);
+	}
+      SurfKey.erase(mc);
+    }
+  return;
+}
+
+int
+surfHash::findCandidates(const Geometry::Surface* SPtr,
+			 std::vector<const STYPE*>& Out) const
+  /*!
+    Find the buckets that can hold a surface equal or 
+    opposite to SPtr. The loose surfaces are added as 
+    the last set. The buckets are not copied.
+    \param SPtr :: Surface to find
+    \param Out :: Candidate surface sets
+    \return 1 if Out is filled / 0 if all surfaces must be tested
+  */
+{
+  Out.clear();
+  double F[3];
+  const int typeIndex=keyFeatures(SPtr,F);
+  if (typeIndex<0)
+    return 0;
+
+  std::vector<KTYPE> Keys;
+  findKeys(typeIndex,F,Keys);
+  std::vector<KTYPE>::const_iterator kc;
+  for(kc=Keys.begin();kc!=Keys.end();kc++)
+    {
+      BTYPE::const_iterator bc=Buckets.find(*kc);
+      if (bc!=Buckets.end())
+	Out.push_back(&bc->second);
+    }
+  if (!Loose.empty())
+    Out.push_back(&Loose);
+  return 1;
+}
+
+} // NAMESPACE ModelSupport
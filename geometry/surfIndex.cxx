@@ -26,6 +26,7 @@
 #include <cmath>
 #include <vector>
 #include <map>
+#include <set>
 #include <list>
 #include <stack>
 #include <string>
@@ -62,6 +63,7 @@
 #include "surfEqual.h"
 #include "surfaceFactory.h"
 #include "surfRegister.h"
+#include "surfHash.h"
 #include "surfIndex.h"
 
 #include "Debug.h"
@@ -69,7 +71,8 @@
 namespace ModelSupport
 {
 
-surfIndex::surfIndex() : uniqNum(1)
+surfIndex::surfIndex() : 
+  uniqNum(1),HashPtr(new surfHash)
   /*!
     Constructor
   */
@@ -94,6 +97,7 @@ surfIndex::~surfIndex()
   STYPE::iterator mc;
   for(mc=SMap.begin();mc!=SMap.end();mc++)
     delete mc->second;
+  delete HashPtr;
 }
 
 void
@@ -106,6 +110,7 @@ surfIndex::reset()
   for(mc=SMap.begin();mc!=SMap.end();mc++)
     delete mc->second;
   SMap.erase(SMap.begin(),SMap.end());
+  HashPtr->clear();
   return;
 }
 
@@ -144,7 +149,10 @@ surfIndex::addSurface(Geometry::Surface* SPtr)
   Geometry::Surface* NewPtr=ModelSupport::equalSurface(SPtr);
   // Now find if we have copy
   if (NewPtr==SPtr)
-    SMap.insert(STYPE::value_type(SPtr->getName(),SPtr));
+    {
+      SMap.insert(STYPE::value_type(SPtr->getName(),SPtr));
+      HashPtr->addSurface(SPtr);
+    }
   else
     delete SPtr;
 
@@ -183,6 +191,7 @@ surfIndex::insertSurface(Geometry::Surface* SPtr)
       (SPtr->getName(),"SPtr name");
 
   SMap.insert(STYPE::value_type(SPtr->getName(),SPtr));
+  HashPtr->addSurface(SPtr);
 
   return;
 }
@@ -198,14 +207,24 @@ surfIndex::findOpposite(const Geometry::Surface* SPtr)  const
 
   const Geometry::Plane* PPtr=
     dynamic_cast<const Geometry::Plane*>(SPtr);
+  int Out(0);
   if (PPtr)
     {
+      std::vector<const STYPE*> CVec;
+      equalCandidates(PPtr,CVec);
+      // First in number order over all the sets
+      std::vector<const STYPE*>::const_iterator vc;
       STYPE::const_iterator mc;
-      for(mc=SMap.begin();mc!=SMap.end();mc++)
-	if (ModelSupport::oppositeSurfaces(PPtr,mc->second)) 
-	  return mc->first;
+      for(vc=CVec.begin();vc!=CVec.end();vc++)
+	for(mc=(*vc)->begin();mc!=(*vc)->end() && 
+	      (!Out || mc->first<Out);mc++)
+	  if (ModelSupport::oppositeSurfaces(PPtr,mc->second)) 
+	    {
+	      Out=mc->first;
+	      break;
+	    }
     }
-  return 0;
+  return Out;
 }
 
 void
@@ -220,6 +239,7 @@ surfIndex::removeOpposite(const int SN)
   STYPE::iterator sc=SMap.find(SN);
   if (sc!=SMap.end())
     {
+      HashPtr->removeSurface(SN);
       delete sc->second;
       SMap.erase(sc);
     }
@@ -246,6 +266,7 @@ surfIndex::removeEqualSurface(const int SNum)
   
   if (NewPtr!=vc->second)
     {
+      HashPtr->removeSurface(SNum);
       delete vc->second;
       SMap.erase(vc);
     }
@@ -289,11 +310,14 @@ surfIndex::createSurf(const int surfN)
       delete mp->second;
       outPtr=new T(surfN,0);
       mp->second=outPtr;
+      HashPtr->addLoose(outPtr);
       ELog::EM<<"Reasigned exiting surface"<<surfN<<ELog::endWarn;
       return outPtr;
     }
+  // Caller sets the surface : so always a candidate
   outPtr=new T(surfN,0);
   SMap.insert(STYPE::value_type(surfN,outPtr));
+  HashPtr->addLoose(outPtr);
   return outPtr;
 }
 
@@ -376,6 +400,7 @@ surfIndex::createSurface(const int SN,const int TN,const std::string& SLine)
         {
 	  SMap.insert(STYPE::value_type(SN,SPtr));
 	}
+      HashPtr->addSurface(SPtr);
     }
   catch (const ColErr::ExBase& A)
     {
@@ -398,6 +423,7 @@ surfIndex::deleteSurface(const int surfN)
   if (mf==SMap.end())
     throw ColErr::InContainerError<int>(surfN,"surfN");
 
+  HashPtr->removeSurface(surfN);
   delete mf->second;
   SMap.erase(mf);
 
@@ -449,12 +475,65 @@ surfIndex::renumber(const int origNum,const int newNum)
       return;
     }
   Geometry::Surface* SPtr=mc->second;
+  HashPtr->removeSurface(origNum);
   SMap.erase(mc);
   SPtr->setName(newNum);
   insertSurface(SPtr);
   return;
 }
 
+void
+surfIndex::rehash()
+  /*!
+    Rebuild the equal surface index from all the surfaces
+  */
+{
+  std::vector<int> Moved;
+  Geometry::Surface::takeMoved(Moved);
+  HashPtr->build(SMap);
+  return;
+}
+
+void
+surfIndex::updateHash() const
+  /*!
+    Add the surfaces moved in place since the last search
+    to the index again [with their new coefficients]
+  */
+{
+  std::vector<int> Moved;
+  Geometry::Surface::takeMoved(Moved);
+  std::vector<int>::const_iterator vc;
+  for(vc=Moved.begin();vc!=Moved.end();vc++)
+    {
+      STYPE::const_iterator mc=SMap.find(*vc);
+      if (mc!=SMap.end())
+	HashPtr->addSurface(mc->second);
+    }
+  return;
+}
+
+void
+surfIndex::equalCandidates(const Geometry::Surface* SPtr,
+			   std::vector<const STYPE*>& CVec) const
+  /*!
+    Get the sets of surfaces that can be equal/opposite to SPtr.
+    Each set is in number order. The sets are held by the
+    index and are valid until the next surface change.
+    \param SPtr :: Surface to find
+    \param CVec :: Candidate sets / full surface map if SPtr 
+    cannot be hashed
+  */
+{
+  updateHash();
+  if (!HashPtr->findCandidates(SPtr,CVec))
+    {
+      CVec.clear();
+      CVec.push_back(&SMap);
+    }
+  return;
+}
+
 int
 surfIndex::calcRenumber(const int allowedSurf,
 			std::vector<std::pair<int,int> >& ChangeList) const
@@ -789,30 +868,46 @@ int
 surfIndex::findEqualSurf(const int sBegin,const int sEnd,
 			 std::map<int,Geometry::Surface*>& EQMap) const
   /*!
-    Loop [long] though and find equal surfaces
+    Find the surfaces in the range that are equal to a surface 
+    outside the range or to a later surface in the range.
+    The first such surface in map order is kept. Only the surfaces
+    in the same equation bucket are tested.
     \param sBegin :: begining number
-    \param sBegin :: end number
+    \param sEnd :: end number
     \param EQMap :: Map of equal surfaces
     \return number found
    */
 {
+  ELog::RegMethod RegA("surfIndex","findEqualSurf");
+
   typedef std::map<int,Geometry::Surface*> EQTYPE;
+
+  surfHash EqnHash(1);
+  EqnHash.build(SMap);
+
+  std::vector<const STYPE*> CVec;
+  std::vector<const STYPE*>::const_iterator vc;
   STYPE::const_iterator mc;
   STYPE::const_iterator nc;
-  for(mc=SMap.begin();mc!=SMap.end();mc++)
+  for(mc=SMap.lower_bound(sBegin);
+      mc!=SMap.end() && mc->first<sEnd;mc++)
     {
-      if (mc->first>=sBegin && mc->first<sEnd)
-	{
-	  for(nc=SMap.begin();nc!=SMap.end();nc++)
-	    {
-	      if ((nc->first<sBegin || nc->first>mc->first) &&
-		  ModelSupport::cmpSurfaces(mc->second,nc->second))
-		{
-		  EQMap.insert(EQTYPE::value_type(mc->first,nc->second));
-		  break;
-		}		  
-	    }
-	}
+      EqnHash.findCandidates(mc->second,CVec);
+      // First in number order over all the buckets
+      Geometry::Surface* EqPtr(0);
+      for(vc=CVec.begin();vc!=CVec.end();vc++)
+	for(nc=(*vc)->begin();nc!=(*vc)->end() && 
+	      (!EqPtr || nc->first<EqPtr->getName());nc++)
+	  {
+	    if ((nc->first<sBegin || nc->first>mc->first) &&
+		ModelSupport::cmpSurfaces(mc->second,nc->second))
+	      {
+		EqPtr=nc->second;
+		break;
+	      }		  
+	  }
+      if (EqPtr)
+	EQMap.insert(EQTYPE::value_type(mc->first,EqPtr));
     }
   return static_cast<int>(EQMap.size());
 }
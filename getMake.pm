@@ -17,7 +17,7 @@ sub new
 	"-Wno-comment -fexceptions",
 
     boostInc => "-I/opt/local/include",
-    boostLib => "-L/opt/local/lib -lboost_regex",
+    boostLib => "-L/opt/local/lib -lboost_regex -lboost_thread -lboost_system -lz",
     
     masterProg => [ ],        ## Executables
     nocompile => [ ],         ## Not to be compiled
@@ -0,0 +1,70 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   include/CellQueue.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#ifndef ModelSupport_CellQueue_h
+#define ModelSupport_CellQueue_h
+
+namespace boost
+{
+  class mutex;
+}
+
+namespace ModelSupport
+{
+
+/*!
+  \class CellQueue
+  \version 1.0
+  \author S. Ansell
+  \date June 2013
+  \brief Work queue of cells for a thread pool
+
+  The items are handed out largest estimated cost
+  first [equal costs in index order] so that the long
+  cells are not left to the end of a pass. Each thread
+  takes the next item until the queue is empty.
+*/
+
+class CellQueue
+{
+ private:
+
+  boost::mutex* MPtr;              ///< Lock of the next item
+  std::vector<size_t> Order;       ///< Item index in cost order
+  size_t nextItem;                 ///< Next item to hand out
+
+  ///\cond NOWRITTEN
+  CellQueue(const CellQueue&);
+  CellQueue& operator=(const CellQueue&);
+  ///\endcond NOWRITTEN
+
+ public:
+
+  explicit CellQueue(const std::vector<size_t>&);
+  ~CellQueue();
+
+  int next(size_t&);
+  size_t nThread(const size_t) const;
+};
+
+}
+
+#endif
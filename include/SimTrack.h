@@ -39,6 +39,11 @@ namespace ModelSupport
   \author S. Ansell
   \date April 2011
   \brief Keys track optimization units
+
+  The first thread to use the tracker [the main thread]
+  has the strict instance : simulations must be added
+  before use. Each other thread has its own instance
+  that adds a simulation on first use.
 */
 
 class SimTrack
@@ -47,9 +52,10 @@ class SimTrack
 
   /// Storage of the findCell Ptr
   typedef std::map<unsigned long int,MonteCarlo::Object*> fcTYPE;
+  const int autoAdd;  ///< Add unknown simulations on use
   fcTYPE findCell;   ///< Find cell Map
 
-  SimTrack();
+  explicit SimTrack(const int);
 
   ///\cond SINGLETON
   SimTrack(const SimTrack&);
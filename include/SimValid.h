@@ -22,6 +22,7 @@
 #ifndef SimValid_h
 #define SimValid_h
 
+class MTRand;
 
 namespace ModelSupport
 {
@@ -62,6 +63,24 @@ struct simPoint
 
 };
 
+/*!
+  \struct validBlock
+  \brief Fixed block of tracks with its own random stream
+  \author S. Ansell
+  \version 1.0
+  \date November 2013
+ */
+
+struct validBlock
+{
+  size_t index;                    ///< Block index [random stream]
+  size_t startN;                   ///< First track
+  size_t endN;                     ///< One past last track
+  unsigned int seed;               ///< Common seed
+  int status;                      ///< 1 if all tracks valid
+  std::string Log;                 ///< Failure log
+};
+
 /*!
   \class SimValid
   \brief Applies simple test to a simulation to check validity
@@ -74,7 +93,15 @@ class SimValid
 {
  private:
 
+  static const size_t blockSize;  ///< Tracks in a block
+
   Geometry::Vec3D Centre;  // Centre for tracks
+  size_t nThread;          ///< Number of threads [0/1 : serial]
+
+  void runBlock(const Simulation&,MonteCarlo::Object*,
+		const int,MTRand&,validBlock&) const;
+  void runGroup(const Simulation&,MonteCarlo::Object*,const int,
+		std::vector<validBlock>&,const size_t,const size_t) const;
   
  public:
   
@@ -85,6 +112,8 @@ class SimValid
 
   /// Set the centre
   void setCentre(const Geometry::Vec3D C) { Centre=C;} 
+  /// Set the number of threads
+  void setThreads(const size_t N) { nThread=N; }
   // MAIN RUN:
   int run(const Simulation&,const size_t) const;
 
@@ -22,9 +22,12 @@
 #ifndef Simulation_h
 #define Simulation_h
 
+class Rule;
+
 namespace Geometry
 {
   class Transform;
+  class SenseCache;
 }
 
 namespace tallySystem
@@ -42,12 +45,19 @@ namespace physicsSystem
   class PhysicsCards;
 }
 
+namespace ELog
+{
+  struct ThreadHold;
+}
+
 class AlterSurfBase;
 class RemoveCell;
 
 namespace ModelSupport
 {
   class ObjSurfMap;
+  class ObjBVH;
+  class CellQueue;
 }
 
 namespace MonteCarlo
@@ -55,6 +65,7 @@ namespace MonteCarlo
 	class Object;
   class Material;
   class Qhull;
+  class RuleBDD;
 }
 
 /*!
@@ -82,10 +93,13 @@ class Simulation
   std::string inputFile;                ///< Input file
   std::string cmdLine;                  ///< Command line : historical recall 
   int CNum;                             ///< Number of complementary components
+  int compCheck;                        ///< Check complements with Algebra
+  size_t nThread;                       ///< Threads of the cell passes
   FuncDataBase DB;                      ///< DataBase of variables
   AlterSurfBase* ASurfPtr;              ///< AlterSurface pointer
   RemoveCell* RCellPtr;                 ///< RemoveCell pointer
   ModelSupport::ObjSurfMap* OSMPtr;     ///< Object surface map [if required]
+  ModelSupport::ObjBVH* BVHPtr;         ///< Cell box tree [if required]
   MonteCarlo::Object* curObjPtr;        ///< Last find pointer
 
   TransTYPE TList;        ///< Transforms List (key=Transform)
@@ -95,7 +109,7 @@ class Simulation
 
   TallyTYPE TItem;  ///< Tally Items
   physicsSystem::PhysicsCards* PhysPtr;   ///< Physics Cards
-  
+
   // METHODS:
 
   void deleteObjects();
@@ -122,7 +136,21 @@ class Simulation
   int checkInsert(const MonteCarlo::Qhull&);       ///< Inserts (and test) new hull into Olist map 
   int removeNullSurfaces();
   int removeComplement(MonteCarlo::Qhull&) const;
+  int removeComplement(MonteCarlo::RuleBDD&,MonteCarlo::Qhull&) const;
+  int checkComplement(MonteCarlo::RuleBDD&,const MonteCarlo::Qhull&,
+		      const Rule*) const;
   void addObjSurfMap(MonteCarlo::Qhull*);
+  template<typename T>
+  static void holdWork(const T&,ELog::ThreadHold*);
+  template<typename T>
+  void runQueue(ModelSupport::CellQueue&,const T&) const;
+  static void complementQueue(const OTYPE&,
+			      const std::vector<MonteCarlo::Qhull*>&,
+			      std::vector<Rule*>&,ModelSupport::CellQueue&);
+  static void surfaceQueue(const std::vector<MonteCarlo::Qhull*>&,
+			   std::vector<int>&,ModelSupport::CellQueue&);
+  static void vertexQueue(const std::vector<MonteCarlo::Qhull*>&,
+			  std::vector<int>&,ModelSupport::CellQueue&);
 
  public:
 
@@ -133,6 +161,12 @@ class Simulation
   
   /// set the command line
   void setCmdLine(const std::string& S) { cmdLine=S; }
+  /// Check each complement removal against Algebra
+  void setCompCheck(const int F) { compCheck=F; }
+  /// Set the threads of the cell passes [0/1 : serial]
+  void setThreads(const size_t N) { nThread=N; }
+  /// Access the threads of the cell passes
+  size_t getThreads() const { return nThread; }
   void resetAll();
   /// Register an altered surface
   void registerAlterSurface(AlterSurfBase* Ptr) { ASurfPtr=Ptr; }
@@ -148,6 +182,9 @@ class Simulation
   const MonteCarlo::Qhull* findQhull(const int) const; 
   MonteCarlo::Object* findCell(const Geometry::Vec3D&,
 			       MonteCarlo::Object*) const;
+  MonteCarlo::Object* findCell(const Geometry::Vec3D&,
+			       MonteCarlo::Object*,
+			       Geometry::SenseCache&) const;
   int findCellNumber(const Geometry::Vec3D&,const int) const;  
 
   int existCell(const int) const;              ///< check if cell exist
@@ -175,6 +212,7 @@ class Simulation
 
   int calcVertex(const int); 
   void calcAllVertex();
+  void calcAllBoundBox();
   
   void masterRotation();
 
@@ -209,9 +247,15 @@ class Simulation
 
   void createObjSurfMap();
   void validateObjSurfMap();
+  void learnObjSurfMap(const Geometry::Vec3D&,const size_t);
   /// Access surface map
   const ModelSupport::ObjSurfMap* getOSM() const;
 
+  void createBVH();
+  void updateBVH();
+  /// Access cell box tree
+  const ModelSupport::ObjBVH* getBVH() const { return BVHPtr; }
+
   // Tally processing
 
   void removeAllTally();
@@ -26,6 +26,6 @@ int
 createMeshTally(const mainSystem::inputParam&,Simulation*);
 
 int createVTK(const mainSystem::inputParam&,
-	      const Simulation*,const std::string&);
+	      Simulation*,const std::string&);
 
 #endif 
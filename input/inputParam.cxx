@@ -934,6 +934,11 @@ inputParam::regDefItem<long int>
   (const std::string&,const std::string&,const size_t,
    const long int&,const long int&,const long int&);
 
+// DEFAULT : size_t
+template void 
+inputParam::regDefItem<size_t>
+(const std::string&,const std::string&,const size_t,const size_t&);
+
 
 // SET VALUE
 
@@ -0,0 +1,410 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   log/MethodProfile.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <time.h>
+#include <boost/thread/mutex.hpp>
+
+#include "MethodProfile.h"
+
+namespace ELog
+{
+
+/*!
+  \struct flatItem
+  \brief Totals of a method over all the call tree
+*/
+struct flatItem
+{
+  size_t count;          ///< Number of calls
+  double incTime;        ///< Inclusive time [not recursive]
+  double excTime;        ///< Exclusive time
+
+  flatItem() : count(0),incTime(0.0),excTime(0.0) {}  ///< Constructor
+};
+
+/*!
+  \struct flatCompare
+  \brief Orders methods by decreasing exclusive time
+*/
+struct flatCompare
+{
+  /// Comparison of the exclusive time
+  bool operator()(const std::pair<std::string,flatItem>& A,
+		  const std::pair<std::string,flatItem>& B) const
+    { return A.second.excTime>B.second.excTime; }
+};
+
+profNode::profNode(const std::string& N,const size_t P) :
+  Name(N),parent(P),count(0),incTime(0.0),childTime(0.0)
+  /*!
+    Constructor
+    \param N :: Class::Method name
+    \param P :: Parent node
+  */
+{}
+
+profTree::profTree() :
+  current(0)
+  /*!
+    Constructor : Sets the root node
+  */
+{
+  Nodes.push_back(profNode("",0));
+}
+
+void
+profTree::enter(const std::string& Name)
+  /*!
+    Move to the child node of a call and start its time
+    \param Name :: Class::Method
+  */
+{
+  enter(Name,MethodProfile::wallTime());
+  return;
+}
+
+void
+profTree::enter(const std::string& Name,const double T)
+  /*!
+    Move to the child node of a call started at T
+    \param Name :: Class::Method
+    \param T :: Start time [s]
+  */
+{
+  std::map<std::string,size_t>::const_iterator mc=
+    Nodes[current].Child.find(Name);
+  size_t index;
+  if (mc==Nodes[current].Child.end())
+    {
+      index=Nodes.size();
+      Nodes[current].Child.insert
+	(std::map<std::string,size_t>::value_type(Name,index));
+      Nodes.push_back(profNode(Name,current));
+    }
+  else
+    index=mc->second;
+
+  current=index;
+  StartTime.push_back(T);
+  return;
+}
+
+void
+profTree::leave()
+  /*!
+    Add the time of the current call and move to its parent
+  */
+{
+  leave(MethodProfile::wallTime());
+  return;
+}
+
+void
+profTree::leave(const double TEnd)
+  /*!
+    Add the time of the current call ended at TEnd
+    and move to its parent
+    \param TEnd :: End time [s]
+  */
+{
+  if (StartTime.empty()) return;
+
+  const double T=TEnd-StartTime.back();
+  StartTime.pop_back();
+  profNode& Item=Nodes[current];
+  Item.count++;
+  Item.incTime+=T;
+  current=Item.parent;
+  Nodes[current].childTime+=T;
+  return;
+}
+
+int MethodProfile::activeFlag(0);
+
+MethodProfile::MethodProfile()
+  /*!
+    Constructor
+  */
+{}
+
+MethodProfile::~MethodProfile()
+  /*!
+    Destructor : writes the profile if active
+  */
+{
+  if (activeFlag)
+    {
+      activeFlag=0;
+      write();
+    }
+  clear();
+}
+
+MethodProfile&
+MethodProfile::Instance()
+  /*!
+    MethodProfile Accessor [Singleton]
+    \return effective this
+  */
+{
+  static MethodProfile A;
+  return A;
+}
+
+double
+MethodProfile::wallTime()
+  /*!
+    Monotonic wall clock
+    \return time [s]
+  */
+{
+  struct timespec TS;
+  clock_gettime(CLOCK_MONOTONIC,&TS);
+  return static_cast<double>(TS.tv_sec)+
+    1e-9*static_cast<double>(TS.tv_nsec);
+}
+
+profTree*&
+MethodProfile::threadTree()
+  /*!
+    Access the thread local pointer to the call tree
+    of the calling thread
+    \return Tree pointer [0 if not created]
+  */
+{
+  static __thread profTree* TPtr(0);
+  return TPtr;
+}
+
+profTree*
+MethodProfile::addTree()
+  /*!
+    Create a new tree [owned by the profile]
+    \return new tree
+  */
+{
+  static boost::mutex* MPtr=new boost::mutex();
+  boost::mutex::scoped_lock Lock(*MPtr);
+  Trees.push_back(new profTree());
+  return Trees.back();
+}
+
+profTree&
+MethodProfile::getTree()
+  /*!
+    Access the call tree of the calling thread.
+    The trees are kept after the thread exits.
+    \return profTree for this thread
+  */
+{
+  profTree*& TPtr=threadTree();
+  if (!TPtr)
+    TPtr=Instance().addTree();
+  return *TPtr;
+}
+
+void
+MethodProfile::enter(const std::string& CN,const std::string& MN)
+  /*!
+    Record the start of a call
+    \param CN :: Class name
+    \param MN :: Method name
+  */
+{
+  getTree().enter(CN+"::"+MN);
+  return;
+}
+
+void
+MethodProfile::leave()
+  /*!
+    Record the end of a call
+  */
+{
+  getTree().leave();
+  return;
+}
+
+void
+MethodProfile::setActive(const std::string& Stem)
+  /*!
+    Start recording calls
+    \param Stem :: Output file stem [.txt/.folded]
+  */
+{
+  FileStem=Stem;
+  activeFlag=1;
+  return;
+}
+
+void
+MethodProfile::insertTree(const profTree& A)
+  /*!
+    Add a copy of a finished call tree [not recorded 
+    by a thread] to the profile
+    \param A :: Tree to copy
+  */
+{
+  *addTree()=A;
+  return;
+}
+
+void
+MethodProfile::clear()
+  /*!
+    Remove all the trees [only when no thread is recording]
+  */
+{
+  for(size_t i=0;i<Trees.size();i++)
+    delete Trees[i];
+  Trees.clear();
+  threadTree()=0;
+  return;
+}
+
+void
+MethodProfile::write() const
+  /*!
+    Write the text profile and the folded stacks
+  */
+{
+  if (FileStem.empty() || Trees.empty()) return;
+
+  std::ofstream TX((FileStem+".txt").c_str());
+  writeFlat(TX);
+  writeTree(TX);
+  std::ofstream FX((FileStem+".folded").c_str());
+  writeFolded(FX);
+  return;
+}
+
+void
+MethodProfile::writeFlat(std::ostream& OX) const
+  /*!
+    Write the totals of each method over all threads.
+    The inclusive time of a recursive call is only
+    counted at the outer call.
+    \param OX :: Output stream
+  */
+{
+  std::map<std::string,flatItem> Flat;
+  for(size_t i=0;i<Trees.size();i++)
+    {
+      const std::vector<profNode>& Nodes=Trees[i]->getNodes();
+      for(size_t j=1;j<Nodes.size();j++)
+	{
+	  const profNode& Item=Nodes[j];
+	  flatItem& FI=Flat[Item.Name];
+	  FI.count+=Item.count;
+	  FI.excTime+=Item.incTime-Item.childTime;
+	  // skip if the method is already open above
+	  size_t pIndex=Item.parent;
+	  while(pIndex && Nodes[pIndex].Name!=Item.Name)
+	    pIndex=Nodes[pIndex].parent;
+	  if (!pIndex)
+	    FI.incTime+=Item.incTime;
+	}
+    }
+
+  std::vector<std::pair<std::string,flatItem> >
+    Order(Flat.begin(),Flat.end());
+  std::sort(Order.begin(),Order.end(),flatCompare());
+
+  OX<<"# Method profile : threads "<<Trees.size()<<std::endl;
+  OX<<"# "<<std::setw(12)<<"calls"<<std::setw(14)<<"incl[s]"
+    <<std::setw(14)<<"excl[s]"<<"  method"<<std::endl;
+  std::vector<std::pair<std::string,flatItem> >::const_iterator vc;
+  for(vc=Order.begin();vc!=Order.end();vc++)
+    OX<<"  "<<std::setw(12)<<vc->second.count
+      <<std::setw(14)<<vc->second.incTime
+      <<std::setw(14)<<vc->second.excTime
+      <<"  "<<vc->first<<std::endl;
+  return;
+}
+
+void
+MethodProfile::writeTree(std::ostream& OX) const
+  /*!
+    Write the call tree of each thread
+    \param OX :: Output stream
+  */
+{
+  for(size_t i=0;i<Trees.size();i++)
+    {
+      OX<<"# Call tree : thread "<<i<<std::endl;
+      const std::vector<profNode>& Nodes=Trees[i]->getNodes();
+      // depth first from the root
+      std::vector<std::pair<size_t,size_t> > Stack;
+      Stack.push_back(std::pair<size_t,size_t>(0,0));
+      while(!Stack.empty())
+	{
+	  const size_t index=Stack.back().first;
+	  const size_t depth=Stack.back().second;
+	  Stack.pop_back();
+	  const profNode& Item=Nodes[index];
+	  if (index)
+	    OX<<std::string(2*depth,' ')<<Item.Name<<" : "<<Item.count
+	      <<" "<<Item.incTime<<" "<<Item.incTime-Item.childTime
+	      <<std::endl;
+	  std::map<std::string,size_t>::const_reverse_iterator mc;
+	  for(mc=Item.Child.rbegin();mc!=Item.Child.rend();mc++)
+	    Stack.push_back(std::pair<size_t,size_t>(mc->second,depth+1));
+	}
+    }
+  return;
+}
+
+void
+MethodProfile::writeFolded(std::ostream& OX) const
+  /*!
+    Write the folded stacks [flamegraph input]: the
+    call path and the exclusive time in microseconds
+    \param OX :: Output stream
+  */
+{
+  for(size_t i=0;i<Trees.size();i++)
+    {
+      const std::vector<profNode>& Nodes=Trees[i]->getNodes();
+      for(size_t j=1;j<Nodes.size();j++)
+	{
+	  const double excTime=Nodes[j].incTime-Nodes[j].childTime;
+	  const long int uSec=static_cast<long int>(1e6*excTime);
+	  if (uSec<=0) continue;
+
+	  std::string Path=Nodes[j].Name;
+	  for(size_t pIndex=Nodes[j].parent;pIndex;
+	      pIndex=Nodes[pIndex].parent)
+	    Path=Nodes[pIndex].Name+";"+Path;
+	  OX<<Path<<" "<<uSec<<std::endl;
+	}
+    }
+  return;
+}
+
+} // NAMESPACE ELog
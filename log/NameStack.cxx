@@ -29,21 +29,24 @@
 namespace ELog
 {
 
+const size_t NameStack::maxDepth;
+
 NameStack::NameStack() :
-  indentLevel(0)
+  depth(0),indentLevel(0)
   /*!
     Constructor
   */
 {}
 
 NameStack::NameStack(const NameStack& A) :
-  key(A.key),Class(A.Class),Method(A.Method),
-  indentLevel(A.indentLevel)
+  key(A.key),depth(0),indentLevel(A.indentLevel)
   /*!
     Copy Constructor
     \param A :: NameStack to copy
   */
-{}
+{
+  copyLevels(A);
+}
 
 NameStack&
 NameStack::operator=(const NameStack& A) 
@@ -56,13 +59,35 @@ NameStack::operator=(const NameStack& A)
   if (this!=&A)
     {
       key=A.key;
-      Class=A.Class;
-      Method=A.Method;
+      copyLevels(A);
       indentLevel=A.indentLevel;
     }
   return *this;
 }
 
+void
+NameStack::copyLevels(const NameStack& A)
+  /*!
+    Copy the levels of A. Only the store of the 
+    held levels is copied.
+    \param A :: NameStack to copy
+  */
+{
+  depth=A.depth;
+  const size_t N((depth<maxDepth) ? depth : maxDepth);
+  for(size_t i=0;i<N;i++)
+    {
+      Class[i]=A.Class[i];
+      Method[i]=A.Method[i];
+    }
+  const size_t NS((N<A.ClassStore.size()) ? N : A.ClassStore.size());
+  ClassStore.assign(A.ClassStore.begin(),A.ClassStore.begin()+
+		    static_cast<long int>(NS));
+  MethodStore.assign(A.MethodStore.begin(),A.MethodStore.begin()+
+		     static_cast<long int>(NS));
+  return;
+}
+
 void
 NameStack::clear()
  /*!
@@ -70,8 +95,9 @@ NameStack::clear()
  */
 {
   key.erase(key.begin(),key.end());
-  Class.clear();
-  Method.clear();
+  ClassStore.clear();
+  MethodStore.clear();
+  depth=0;
   indentLevel=0;
   return;
 }
@@ -80,28 +106,63 @@ void
 NameStack::addComp(const std::string& CN,
 		   const std::string& MN)
   /*!
-    Adds a component to the class names series
+    Adds a component to the class names series.
+    The names are copied into the store of the level.
     \param CN :: Class name
     \param MN :: Method name
   */
 {
-  Class.push_back(CN);
-  Method.push_back(MN);
+  if (depth<maxDepth)
+    {
+      if (ClassStore.size()<=depth)
+	{
+	  ClassStore.resize(depth+1);
+	  MethodStore.resize(depth+1);
+	}
+      ClassStore[depth]=CN;
+      MethodStore[depth]=MN;
+      Class[depth]=0;
+      Method[depth]=0;
+    }
+  depth++;
   return;
 }
 
-void
-NameStack::popBack() 
+const char*
+NameStack::className(const size_t Index) const
   /*!
-    Pop back a item
+    Class name of a held level
+    \param Index :: Level [less than maxDepth]
+    \return Class name
   */
 {
-  if (!Class.empty())
-    {
-      Class.pop_back();
-      Method.pop_back();
-    }
-  return;
+  return (Class[Index]) ? Class[Index] : ClassStore[Index].c_str();
+}
+
+const char*
+NameStack::methodName(const size_t Index) const
+  /*!
+    Method name of a held level
+    \param Index :: Level [less than maxDepth]
+    \return Method name
+  */
+{
+  return (Method[Index]) ? Method[Index] : MethodStore[Index].c_str();
+}
+
+std::string
+NameStack::itemStr(const size_t Index) const
+  /*!
+    Write a level as Class::Method
+    \param Index :: Level [less than depth]
+    \return Class::Method / "" if the level is not held
+  */
+{
+  if (Index>=maxDepth) return "";
+  std::string Out(className(Index));
+  Out+="::";
+  Out+=methodName(Index);
+  return Out;
 }
 
 std::string
@@ -111,8 +172,7 @@ NameStack::getBase() const
     \return BaseItem
   */
 {
-  return (Class.empty()) ?  
-    "" : Class.back()+"::"+Method.back();
+  return (!depth) ? "" : itemStr(depth-1);
 }
 
 std::string
@@ -124,17 +184,15 @@ NameStack::getItem(const long int Index) const
     \return BaseItem
   */
 {
-  if (Class.empty()) return "";
+  if (!depth) return "";
   if (!Index) 
-    return Class.back()+"::"+Method.back();
+    return itemStr(depth-1);
   
-  const size_t CSize=Class.size();
- 
   const size_t itx( (Index<0) 
-		    ? (CSize-static_cast<size_t>(1-Index)) 
+		    ? (depth-static_cast<size_t>(1-Index)) 
 		    : static_cast<size_t>(Index));
 
-  return (itx<CSize) ? Class[itx]+"::"+Method[itx] : "";
+  return (itx<depth) ? itemStr(itx) : "";
 } 
 
 std::string
@@ -144,13 +202,12 @@ NameStack::getFull() const
     \return BaseItem
   */
 {
-  std::vector<std::string>::const_iterator vc(Class.begin());
-  std::vector<std::string>::const_iterator ac(Method.begin());
-  std::string Out=*vc+"::"+*ac;
-  for(ac++,vc++;vc!=Class.end();vc++,ac++)
+  if (!depth) return "";
+  std::string Out=itemStr(0);
+  for(size_t i=1;i<depth && i<maxDepth;i++)
     {
       Out+="#";
-      Out+=*vc+"::"+*ac;
+      Out+=itemStr(i);
     }
   return Out;
 }
@@ -162,15 +219,14 @@ NameStack::getFullTree() const
     \return BaseItem
   */
 {
-  std::vector<std::string>::const_iterator vc(Class.begin());
-  std::vector<std::string>::const_iterator ac(Method.begin());
+  if (!depth) return "";
   size_t indent(2);
-  std::string Out=*vc+"::"+*ac;
-  for(ac++,vc++;vc!=Class.end();vc++,ac++,indent+=2)
+  std::string Out=itemStr(0);
+  for(size_t i=1;i<depth && i<maxDepth;i++,indent+=2)
     {
       Out+="\n";
       Out+=std::string(indent,' ');
-      Out+=*vc+"::"+*ac;
+      Out+=itemStr(i);
     }
   return Out;
 }
@@ -113,6 +113,19 @@ OutputLog<RepClass>::~OutputLog()
   */
 {}
 
+template<typename RepClass>
+ThreadHold*&
+OutputLog<RepClass>::threadHold()
+  /*!
+    Access the hold pointer of the calling thread 
+    [0 : messages are reported directly]
+    \return ThreadHold pointer for this thread
+  */
+{
+  static __thread ThreadHold* HPtr(0);
+  return HPtr;
+}
+
 template<typename RepClass>
 int
 OutputLog<RepClass>::isActive(const int Flag) const
@@ -211,6 +224,14 @@ OutputLog<RepClass>::report(const std::string& M,const int T)
 {
   static int length(0);
 
+  ThreadHold* HPtr=threadHold();
+  if (HPtr)
+    {
+      HPtr->EText.push_back(M);
+      HPtr->EType.push_back(T);
+      return;
+    }
+
   std::string cxItem=M;
   std::string::size_type pos;
 
@@ -285,9 +306,11 @@ OutputLog<RepClass>::report(const int T)
     \param T :: Type of error 
   */
 {
-  report(cx.str(),T);
-  cx.str("");
-  makeAction(T);
+  std::ostringstream& OX=Estream();
+  report(OX.str(),T);
+  OX.str("");
+  if (!threadHold())
+    makeAction(T);
   return;
 }
 
@@ -488,6 +511,40 @@ OutputLog<RepClass>::disLevel(const int levelFlag)
   return;
 }
 
+template<typename RepClass>
+void
+OutputLog<RepClass>::holdThread(ThreadHold* HPtr)
+  /*!
+    Hold the messages of the calling thread. 
+    The holder must be dispatched by the main thread
+    after the worker has finished.
+    \param HPtr :: Holder for the messages [0 to report directly]
+  */
+{
+  threadHold()=HPtr;
+  return;
+}
+
+template<typename RepClass>
+void
+OutputLog<RepClass>::dispatchHold(ThreadHold& HItem)
+  /*!
+    Report the messages held by a worker thread 
+    [in order] and clear the holder. 
+    Only called from the reporting thread.
+    \param HItem :: Holder of a finished worker
+  */
+{
+  for(size_t i=0;i<HItem.EText.size();i++)
+    {
+      report(HItem.EText[i],HItem.EType[i]);
+      makeAction(HItem.EType[i]);
+    }
+  HItem.EText.clear();
+  HItem.EType.clear();
+  return;
+}
+
 // ENDL FUNCTION :
 
 template<typename RepClass>
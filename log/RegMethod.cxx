@@ -23,17 +23,81 @@
 #include <sstream>
 #include <map>
 #include <vector>
+#include <boost/thread/tss.hpp>
 
 #include "NameStack.h"
+#include "MethodProfile.h"
 #include "RegMethod.h"
 
 namespace ELog
 {
 
-NameStack RegMethod::Base;
+NameStack*&
+RegMethod::threadStack()
+  /*!
+    Access the thread local pointer to the stack 
+    of the calling thread [fast path]
+    \return Stack pointer [0 if not created]
+  */
+{
+  static __thread NameStack* NPtr(0);
+  return NPtr;
+}
+
+void
+RegMethod::releaseStack(NameStack* NPtr)
+  /*!
+    Delete the stack of a thread at thread exit
+    \param NPtr :: Stack to delete
+  */
+{
+  threadStack()=0;
+  delete NPtr;
+  return;
+}
+
+NameStack&
+RegMethod::getStack()
+  /*!
+    Access the name stack of the calling thread.
+    The thread_specific_ptr owns the stack and 
+    deletes it at thread exit. The holder is never 
+    deleted so that it outlives any static object that
+    registers in its destructor.
+    \return NameStack for this thread
+  */
+{
+  NameStack*& NPtr=threadStack();
+  if (!NPtr)
+    {
+      static boost::thread_specific_ptr<NameStack>* TSPtr=
+	new boost::thread_specific_ptr<NameStack>(&RegMethod::releaseStack);
+      NPtr=new NameStack();
+      TSPtr->reset(NPtr);
+    }
+  return *NPtr;
+}
+
+void
+RegMethod::addLiteral(const char* CN,const char* MN)
+  /*!
+    Add names to the stack from the character array
+    constructor. The names are held by pointer.
+    \param CN :: Class name [string literal]
+    \param MN :: Method name [string literal]
+  */
+{
+  NSPtr=&getStack();
+  profFlag=MethodProfile::isActive();
+  NSPtr->addComp(CN,MN);
+  if (profFlag)
+    MethodProfile::enter(CN,MN);
+  return;
+}
 
 RegMethod::RegMethod(const std::string& CN,
 		     const std::string& MN) :
+  NSPtr(&getStack()),profFlag(MethodProfile::isActive()),
   indentLevel(0)
   /*!
     Constructor add name to stack
@@ -41,12 +105,15 @@ RegMethod::RegMethod(const std::string& CN,
     \param MN :: Method name
   */
 {
-  Base.addComp(CN,MN);
+  NSPtr->addComp(CN,MN);
+  if (profFlag)
+    MethodProfile::enter(CN,MN);
 }
 
 RegMethod::RegMethod(const std::string& CN,
 		     const std::string& MN,
 		     const int param) :
+  NSPtr(&getStack()),profFlag(MethodProfile::isActive()),
   indentLevel(0)
   /*!
     Constructor add name to stack
@@ -57,7 +124,9 @@ RegMethod::RegMethod(const std::string& CN,
 {
   std::ostringstream cx;
   cx<<"<"<<param<<">";
-  Base.addComp(CN+cx.str(),MN);
+  NSPtr->addComp(CN+cx.str(),MN);
+  if (profFlag)
+    MethodProfile::enter(CN+cx.str(),MN);
 }
 
 RegMethod::~RegMethod() 
@@ -65,9 +134,11 @@ RegMethod::~RegMethod()
     Destructor removes one from the stack
   */
 {
-  Base.popBack();
+  NSPtr->popBack();
+  if (profFlag)
+    MethodProfile::leave();
   if (indentLevel) 
-    Base.addIndent(-indentLevel);
+    NSPtr->addIndent(-indentLevel);
 }
 
 void
@@ -77,7 +148,7 @@ RegMethod::incIndent()
   */
 {
   indentLevel+=2;
-  Base.addIndent(2);
+  NSPtr->addIndent(2);
   return;
 }
 
@@ -88,7 +159,7 @@ RegMethod::decIndent()
   */
 {
   indentLevel-=2;
-  Base.addIndent(-2);
+  NSPtr->addIndent(-2);
   return;
 }
 
@@ -0,0 +1,121 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   logInc/MethodProfile.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef ELog_MethodProfile_h
+#define ELog_MethodProfile_h
+
+namespace ELog
+{
+
+/*!
+  \struct profNode
+  \brief Call tree node of a method
+*/
+struct profNode
+{
+  std::string Name;                      ///< Class::Method
+  size_t parent;                         ///< Parent node
+  size_t count;                          ///< Number of calls
+  double incTime;                        ///< Inclusive time [s]
+  double childTime;                      ///< Time in children [s]
+  std::map<std::string,size_t> Child;    ///< Child nodes
+
+  profNode(const std::string&,const size_t);
+};
+
+/*!
+  \class profTree
+  \brief Call tree of one thread
+*/
+class profTree
+{
+ private:
+
+  std::vector<profNode> Nodes;        ///< Nodes [0 is the root]
+  size_t current;                     ///< Current node
+  std::vector<double> StartTime;      ///< Start time of open calls
+
+ public:
+
+  profTree();
+
+  void enter(const std::string&);
+  void enter(const std::string&,const double);
+  void leave();
+  void leave(const double);
+  /// Access nodes
+  const std::vector<profNode>& getNodes() const { return Nodes; }
+};
+
+  /*!
+    \class MethodProfile
+    \brief Call counts and times of RegMethod calls
+    \author S. Ansell
+    \version 1.0
+    \date March 2013
+
+    When active each RegMethod adds its call to the
+    call tree of its thread. The trees are written as
+    text and as a folded stack file at exit.
+  */
+class MethodProfile
+{
+ private:
+
+  static int activeFlag;              ///< Record calls
+
+  std::string FileStem;               ///< Output stem
+  std::vector<profTree*> Trees;       ///< Tree of each thread
+
+  MethodProfile();
+  /// \cond NOWRITTEN
+  MethodProfile(const MethodProfile&);
+  MethodProfile& operator=(const MethodProfile&);
+  /// \endcond NOWRITTEN
+
+  static profTree*& threadTree();
+  static profTree& getTree();
+  profTree* addTree();
+
+ public:
+
+  ~MethodProfile();
+
+  static MethodProfile& Instance();
+  /// Calls are recorded
+  static int isActive() { return activeFlag; }
+  static double wallTime();
+  static void enter(const std::string&,const std::string&);
+  static void leave();
+
+  void setActive(const std::string&);
+  void insertTree(const profTree&);
+  void clear();
+  void write() const;
+
+  void writeFlat(std::ostream&) const;
+  void writeTree(std::ostream&) const;
+  void writeFolded(std::ostream&) const;
+};
+
+}
+
+#endif
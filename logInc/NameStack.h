@@ -28,18 +28,36 @@ namespace ELog
     \class NameStack 
     \brief Holds a list of items for a calling stack
     \author S. Ansell
-    \version 1.0
+    \version 1.1
     \date June 2009
+
+    Items are held as pointers in a fixed array so that
+    string literals are not copied. Other names are copied
+    into a store that only grows to the deepest level that
+    needed a copy [a null pointer marks a stored name]. 
+    Levels deeper than maxDepth are counted but not held.
   */
 class NameStack
 {
+ public:
+
+  static const size_t maxDepth=1024;    ///< Levels held
+
  private:
 
   std::map<std::string,int> key;        ///< Key names
-  std::vector<std::string> Class;       ///< Class Name
-  std::vector<std::string> Method;      ///< Method Name
+  size_t depth;                         ///< Number of levels
+  const char* Class[maxDepth];          ///< Class Name [0 : stored]
+  const char* Method[maxDepth];         ///< Method Name [0 : stored]
+  std::vector<std::string> ClassStore;  ///< Copied class names
+  std::vector<std::string> MethodStore; ///< Copied method names
   long int indentLevel;                 ///< Indent level
 
+  void copyLevels(const NameStack&);
+  const char* className(const size_t) const;
+  const char* methodName(const size_t) const;
+  std::string itemStr(const size_t) const;
+
  public:
 
   NameStack();
@@ -49,8 +67,19 @@ class NameStack
 
   void clear(); 
   
+  /// Add a level from names that outlive it [not copied]
+  void addComp(const char* CN,const char* MN)
+    {
+      if (depth<maxDepth)
+	{
+	  Class[depth]=CN;
+	  Method[depth]=MN;
+	}
+      depth++;
+    }
   void addComp(const std::string&,const std::string&);
-  void popBack();
+  /// Remove the last level
+  void popBack() { if (depth) depth--; }
 
   std::string getBase() const;
   std::string getItem(const long int) const;
@@ -58,7 +87,9 @@ class NameStack
   std::string getFullTree() const;
 
   /// Access depth of function:
-  size_t getDepth() const { return Class.size(); }
+  size_t getDepth() const { return depth; }
+  /// Number of levels with a copied name store
+  size_t getStoreSize() const { return ClassStore.size(); }
 
   void addIndent(const long int);
   /// Output of the indent level
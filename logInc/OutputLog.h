@@ -39,6 +39,24 @@ namespace ELog
 
   enum { basic=1,warn=2,error=4,debug=8,diag=16,crit=32,trace=64 };
 
+/*!
+  \struct ThreadHold
+  \brief Messages of a worker thread 
+  \author S. Ansell
+  \date November 2013
+  \version 1.0
+
+  The messages are held [unformatted] until the 
+  main thread dispatches them after the join.
+*/
+
+struct ThreadHold
+{
+  std::ostringstream cx;            ///< Stream of the thread
+  std::vector<std::string> EText;   ///< Held messages
+  std::vector<int> EType;           ///< Held message types
+};
+
 /*!
   \class OutputLog
   \brief A master error log
@@ -82,6 +100,8 @@ class OutputLog
   std::vector<std::string> EText;   ///< Storage buffer (text)
   std::vector<int> EType;           ///< Storage buffer (type)
 
+  static ThreadHold*& threadHold();
+
   int isActive(const int) const;
   std::string getColour(const int) const;
   void makeAction(const int);
@@ -101,7 +121,9 @@ class OutputLog
   void report(const std::string&,const int);
   void report(const int);
 
-  std::ostringstream& Estream() { return cx; }   ///< Access stream
+  /// Access stream [of the thread if held]
+  std::ostringstream& Estream() 
+    { return (threadHold()) ? threadHold()->cx : cx; }   
 
   /// Set Pointer
   void setNBasePtr(NameStack* Ptr) { NBasePtr=Ptr; } 
@@ -111,12 +133,12 @@ class OutputLog
   /// Template specialization to get input
   template<typename InputType>
   OutputLog& operator<<(const InputType& A)
-    { cx<<A; return *this; }
+    { Estream()<<A; return *this; }
   
   /// Special to pick up modifications to the stream
   OutputLog& operator<<(std::ostream& (*f)(std::ostream&) )
     {
-      f(cx);
+      f(Estream());
       return *this;
     }
 
@@ -159,6 +181,10 @@ class OutputLog
   void unlock() { storeFlag=0; }   ///< Set unlock
   void dispatch(const int);      
   void disLevel(const int);      
+
+  // Worker threads:
+  void holdThread(ThreadHold*);
+  void dispatchHold(ThreadHold&);
 };
 
 ///\cond EXTERN
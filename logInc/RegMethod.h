@@ -33,15 +33,28 @@ namespace ELog
 
     This class is called as a registration class.
     It keeps location etc possible for 
+    Each thread has its own stack. 
+
+    Names given as character arrays [string literals] are
+    held by pointer and are not copied: the array must 
+    outlive the RegMethod. Any other name, including a
+    const char* from std::string::c_str(), binds to the 
+    std::string constructor and is copied.
   */
 
 class RegMethod
 {
  private:
 
-  static NameStack Base;           ///< Singleton of base to register
+  static NameStack*& threadStack();
+  static void releaseStack(NameStack*);
+  static NameStack& getStack();    ///< Stack of current thread
 
+  NameStack* NSPtr;                ///< Stack of the thread
+  int profFlag;                    ///< Call is profiled
   int indentLevel;                 ///< Additional indent
+
+  void addLiteral(const char*,const char*);
   /// \cond NOWRITTEN
   RegMethod(const RegMethod&);
   RegMethod& operator=(const RegMethod&);
@@ -50,17 +63,23 @@ class RegMethod
  public:
 
   /// Access NameStack pointer
-  NameStack* getBasePtr() { return &Base; }
+  NameStack* getBasePtr() { return NSPtr; }
+  /// Constructor from string literals [held by pointer]
+  template<size_t NC,size_t NM>
+  RegMethod(const char (&CN)[NC],const char (&MN)[NM]) :
+    NSPtr(0),profFlag(0),indentLevel(0)
+    { addLiteral(CN,MN); }
   RegMethod(const std::string&,const std::string&);
   RegMethod(const std::string&,const std::string&,const int);
   ~RegMethod();
 
   /// Access string
-  static std::string getBase() { return Base.getBase(); }
+  static std::string getBase() { return getStack().getBase(); }
   /// Access string
-  static std::string getFull() { return Base.getFullTree(); }
+  static std::string getFull() { return getStack().getFullTree(); }
   /// Access particular item 
-  static std::string getItem(const int I) { return Base.getItem(I); }
+  static std::string getItem(const int I)
+    { return getStack().getItem(I); }
 
   void incIndent();
   void decIndent();
@@ -48,19 +48,26 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "BoundBox.h"
 #include "Transform.h"
 #include "Surface.h"
+#include "Quadratic.h"
+#include "Plane.h"
+#include "Cylinder.h"
+#include "Sphere.h"
+#include "SenseCache.h"
 #include "surfIndex.h"
 #include "BnId.h"
 #include "Acomp.h"
 #include "Algebra.h"
 #include "Rules.h"
 #include "RuleCheck.h"
+#include "RuleCode.h"
 #include "HeadRule.h"
 
 
 HeadRule::HeadRule() :
-  HeadNode(0)
+  HeadNode(0),CodePtr(0)
   /*!
     Creates a new rule
   */
@@ -68,12 +75,16 @@ HeadRule::HeadRule() :
 
 
 HeadRule::HeadRule(const HeadRule& A) :
-  HeadNode((A.HeadNode) ? A.HeadNode->clone() : 0)
+  HeadNode((A.HeadNode) ? A.HeadNode->clone() : 0),CodePtr(0)
   /*!
-    Copy constructor
+    Copy constructor. The compiled rule is rebuilt
+    as it points into the tree.
     \param A :: Head rule to copy
   */
-{}
+{
+  if (A.CodePtr)
+    buildCode();
+}
 
 HeadRule&
 HeadRule::operator=(const HeadRule& A)  
@@ -85,8 +96,11 @@ HeadRule::operator=(const HeadRule& A)
 {
   if (this!=&A)
     {
+      clearCode();
       delete HeadNode;
       HeadNode=(A.HeadNode) ? A.HeadNode->clone() : 0;
+      if (A.CodePtr)
+	buildCode();
     }
   return *this;
 }
@@ -96,6 +110,7 @@ HeadRule::~HeadRule()
     Destructor
   */
 {
+  delete CodePtr;
   delete HeadNode;
 }
 
@@ -105,11 +120,57 @@ HeadRule::reset()
     Assuming that the head-rule needs to be reset
    */
 {
+  clearCode();
   delete HeadNode;
   HeadNode=0;
   return;
 }
 
+void
+HeadRule::setRule(Rule* RPtr) 
+  /*!
+    Replace the rule tree 
+    \param RPtr :: New top rule [ownership taken]
+   */
+{
+  clearCode();
+  delete HeadNode;
+  HeadNode=RPtr;
+  if (HeadNode)
+    HeadNode->setParent(0);
+  return;
+}
+
+void
+HeadRule::clearCode()
+  /*!
+    Remove the compiled rule : must be called
+    whenever the tree is changed
+  */
+{
+  delete CodePtr;
+  CodePtr=0;
+  return;
+}
+
+void
+HeadRule::buildCode()
+  /*!
+    Compile the tree into a flat program. If the tree
+    cannot be compiled (e.g. unset surfaces) then the
+    tree is used directly.
+  */
+{
+  ELog::RegMethod RegA("HeadRule","buildCode");
+
+  clearCode();
+  if (!HeadNode) return;
+  CodePtr=new RuleCode;
+  if (!CodePtr->build(HeadNode))
+    clearCode();
+  return;
+}
+
 bool
 HeadRule::isComplementary() const
   /*!
@@ -133,6 +194,7 @@ HeadRule::populateSurf()
   ELog::RegMethod RegA("HeadRule","populateSurf");
   if (HeadNode)
     HeadNode->populateSurf();
+  buildCode();
   return;
 }
 
@@ -169,6 +231,7 @@ HeadRule::isValid(const Geometry::Vec3D& Pt,
     \return true/false 
   */
 {
+  if (CodePtr) return CodePtr->isValid(Pt,S);
   return (HeadNode) ? HeadNode->isValid(Pt,S) : 0;
 }
 
@@ -180,6 +243,7 @@ HeadRule::isValid(const Geometry::Vec3D& Pt)const
     \return true/false 
   */
 {
+  if (CodePtr) return CodePtr->isValid(Pt);
   return (HeadNode) ? HeadNode->isValid(Pt) : 0;
 }
 
@@ -203,6 +267,7 @@ HeadRule::isDirectionValid(const Geometry::Vec3D& Pt,const int S)const
     \return true/false 
   */
 {
+  if (CodePtr) return CodePtr->isDirectionValid(Pt,S);
   return (HeadNode) ? HeadNode->isDirectionValid(Pt,S) : 0;
 }
 
@@ -216,6 +281,75 @@ HeadRule::pairValid(const int S,const Geometry::Vec3D& Pt)const
     \return true/false 
   */
 {
+  if (CodePtr) return CodePtr->pairValid(S,Pt);
+  return (HeadNode) ? HeadNode->pairValid(S,Pt) : 0;
+}
+
+bool
+HeadRule::isValid(Geometry::SenseCache& SC) const
+  /*!
+    Calculate if the cache point is valid. Surface
+    sides are shared through the cache.
+    \param SC :: Surface sense cache [holds point]
+    \return true/false 
+  */
+{
+  if (CodePtr) return CodePtr->isValid(SC);
+  return (HeadNode) ? HeadNode->isValid(SC.getPoint()) : 0;
+}
+
+bool
+HeadRule::isDirectionValid(Geometry::SenseCache& SC,const int S) const
+  /*!
+    Calculate if the cache point is valid
+    \param SC :: Surface sense cache [holds point]
+    \param S :: Surface to treat as true/false [based on sign]
+    \return true/false 
+  */
+{
+  if (CodePtr) return CodePtr->isDirectionValid(SC,S);
+  return (HeadNode) ? HeadNode->isDirectionValid(SC.getPoint(),S) : 0;
+}
+
+int
+HeadRule::pairValid(const int S,Geometry::SenseCache& SC) const
+  /*!
+    Calculate the valid state for both sides of a surface
+    \param S :: Surface number to alternate on
+    \param SC :: Surface sense cache [holds point]
+    \return valid(S->false) : valid(S->true)
+  */
+{
+  if (CodePtr) return CodePtr->pairValid(S,SC);
+  return (HeadNode) ? HeadNode->pairValid(S,SC.getPoint()) : 0;
+}
+
+void
+HeadRule::setTrack(const Geometry::Vec3D& Org,
+		   const Geometry::Vec3D& uVec) const
+  /*!
+    Set the track for trackPairValid
+    \param Org :: Track origin
+    \param uVec :: Track direction [unit]
+  */
+{
+  if (CodePtr) CodePtr->setTrack(Org,uVec);
+  return;
+}
+
+int
+HeadRule::trackPairValid(const int S,const Geometry::Vec3D& Pt,
+			 const double D) const
+  /*!
+    Calculate the valid state for both sides of a surface
+    at a point on the track given to setTrack
+    \param S :: Surface number to alternate on
+    \param Pt :: Point on the track
+    \param D :: Distance of Pt along the track
+    \return valid(S->false) : valid(S->true)
+  */
+{
+  if (CodePtr) return CodePtr->trackPairValid(S,Pt,D);
   return (HeadNode) ? HeadNode->pairValid(S,Pt) : 0;
 }
 
@@ -257,6 +391,194 @@ HeadRule::getOppositeSurfaces() const
 }
 
 
+Geometry::BoundBox
+HeadRule::calcBoundBox() const
+  /*!
+    Calculate a conservative axis aligned box that contains
+    every valid point of the rule. Directions that cannot
+    be bounded are left open.
+    \return bounding box
+  */
+{
+  ELog::RegMethod RegA("HeadRule","calcBoundBox");
+  return ruleBox(HeadNode);
+}
+
+Geometry::BoundBox
+HeadRule::ruleBox(const Rule* RPtr)
+  /*!
+    Interval calculation of the box of a rule.
+    Intersections are intersected, unions are merged.
+    Planes in an intersection are used to tighten the box
+    of the other members of the intersection.
+    Complements/unknown rules are unbounded.
+    \param RPtr :: Rule to process
+    \return bounding box
+  */
+{
+  Geometry::BoundBox Out;
+  if (!RPtr) return Out;
+
+  if (RPtr->type()==-1)
+    {
+      Out=ruleBox(RPtr->leaf(0));
+      Out.merge(ruleBox(RPtr->leaf(1)));
+      return Out;
+    }
+  if (RPtr->type()==1)
+    {
+      // Collect the flat list of intersection members
+      std::vector<std::pair<const Geometry::Plane*,int> > PVec;
+      std::stack<const Rule*> TreeLine;
+      TreeLine.push(RPtr);
+      while(!TreeLine.empty())
+	{
+	  const Rule* tmpA=TreeLine.top();
+	  TreeLine.pop();
+	  if (!tmpA) continue;
+	  if (tmpA->type()==1)
+	    {
+	      TreeLine.push(tmpA->leaf(0));
+	      TreeLine.push(tmpA->leaf(1));
+	      continue;
+	    }
+	  const SurfPoint* SPtr=dynamic_cast<const SurfPoint*>(tmpA);
+	  const Geometry::Plane* PPtr=(SPtr) ?
+	    dynamic_cast<const Geometry::Plane*>(SPtr->getKey()) : 0;
+	  if (PPtr)
+	    PVec.push_back(std::pair<const Geometry::Plane*,int>
+			   (PPtr,SPtr->getSign()));
+	  else
+	    Out.intersect(ruleBox(tmpA));
+	}
+      // Planes : iterate since each can tighten the others
+      for(size_t iter=0;iter<4;iter++)
+	{
+	  int change(0);
+	  for(size_t i=0;i<PVec.size();i++)
+	    change+=planeBox(Out,*PVec[i].first,PVec[i].second);
+	  if (!change) break;
+	}
+      return Out;
+    }
+  const SurfPoint* SPtr=dynamic_cast<const SurfPoint*>(RPtr);
+  if (SPtr && SPtr->getKey())
+    return surfBox(SPtr->getKey(),SPtr->getSign());
+
+  return Out;
+}
+
+int
+HeadRule::planeBox(Geometry::BoundBox& ABox,
+		   const Geometry::Plane& PRef,const int sign)
+  /*!
+    Tighten the box using a half space. For sign*(N.P-D)>=0
+    each coordinate is limited using the extent of the box
+    in the other coordinates.
+    \param ABox :: Box to tighten
+    \param PRef :: Plane
+    \param sign :: Side of the plane
+    \return number of limits changed
+  */
+{
+  const double limit(1e37);
+  const Geometry::Vec3D& N=PRef.getNormal();
+  const Geometry::Vec3D& Low=ABox.getLow();
+  const Geometry::Vec3D& High=ABox.getHigh();
+  double A[3];
+  for(size_t i=0;i<3;i++)
+    {
+      A[i]=(sign>0) ? N[i] : -N[i];
+      if (std::abs(A[i])<1e-12) A[i]=0.0;
+    }
+  // a.P >= B
+  const double B=((sign>0) ? PRef.getDistance() : -PRef.getDistance())
+    -Geometry::zeroTol;
+
+  int cnt(0);
+  for(size_t i=0;i<3;i++)
+    {
+      if (A[i]==0.0) continue;
+      // Maximum of the other terms
+      double sumMax(0.0);
+      size_t j;
+      for(j=0;j<3;j++)
+	{
+	  if (j==i || A[j]==0.0) continue;
+	  const double V=(A[j]>0.0) ? High[j] : Low[j];
+	  if (std::abs(V)>=limit) break;
+	  sumMax+=A[j]*V;
+	}
+      if (j!=3) continue;
+      const double value=(B-sumMax)/A[i];
+      if (A[i]>0.0)
+	{
+	  if (value-Geometry::shiftTol>Low[i]+Geometry::shiftTol)
+	    {
+	      ABox.setLow(i,value-Geometry::shiftTol);
+	      cnt++;
+	    }
+	}
+      else if (value+Geometry::shiftTol<High[i]-Geometry::shiftTol)
+	{
+	  ABox.setHigh(i,value+Geometry::shiftTol);
+	  cnt++;
+	}
+    }
+  return cnt;
+}
+
+Geometry::BoundBox
+HeadRule::surfBox(const Geometry::Surface* SPtr,const int sign)
+  /*!
+    Calculate the box of one side of a surface.
+    Only planes and the inside of spheres and cylinders
+    give a limit.
+    \param SPtr :: Surface
+    \param sign :: side of the surface
+    \return bounding box
+  */
+{
+  Geometry::BoundBox Out;
+
+  const Geometry::Plane* PPtr=
+    dynamic_cast<const Geometry::Plane*>(SPtr);
+  if (PPtr)
+    {
+      planeBox(Out,*PPtr,sign);
+      return Out;
+    }
+  if (sign>0) return Out;
+
+  const Geometry::Sphere* SphPtr=
+    dynamic_cast<const Geometry::Sphere*>(SPtr);
+  if (SphPtr)
+    {
+      const Geometry::Vec3D& C=SphPtr->getCentre();
+      const double R=SphPtr->getRadius()+Geometry::shiftTol;
+      return Geometry::BoundBox(C-Geometry::Vec3D(R,R,R),
+				C+Geometry::Vec3D(R,R,R));
+    }
+
+  const Geometry::Cylinder* CPtr=
+    dynamic_cast<const Geometry::Cylinder*>(SPtr);
+  if (CPtr)
+    {
+      // Only limited in directions normal to the axis
+      const Geometry::Vec3D& C=CPtr->getCentre();
+      const Geometry::Vec3D& A=CPtr->getNormal();
+      const double R=CPtr->getRadius();
+      const double RPad=sqrt(R*R+Geometry::shiftTol)+Geometry::shiftTol;
+      for(size_t i=0;i<3;i++)
+	if (std::abs(A[i])<1e-12)
+	  {
+	    Out.setLow(i,C[i]-RPad);
+	    Out.setHigh(i,C[i]+RPad);
+	  }
+    }
+  return Out;
+}
+
 
 int
 HeadRule::removeItems(const int SN) 
@@ -270,6 +592,7 @@ HeadRule::removeItems(const int SN)
   ELog::RegMethod RegA("HeadRule","removeItems");
 
   if (!HeadNode) return -1;
+  clearCode();
 
   int cnt(0);
   std::stack<Rule*> TreeLine;
@@ -317,6 +640,7 @@ HeadRule::removeItem(Rule* Target)
 {
   ELog::RegMethod RegA("HeadRule","remveIte");
   if (!Target) return;
+  clearCode();
   Rule* P=Target->getParent();
   if (!P)
     {
@@ -361,6 +685,7 @@ HeadRule::substituteSurf(const int SurfN,const int newSurfN,
 {
   ELog::RegMethod RegA("HeadRule","substitueSurf");
 
+  clearCode();
   int cnt(0);
 
   SurfPoint* Ptr=dynamic_cast<SurfPoint*>(HeadNode->findKey(SurfN));
@@ -383,6 +708,7 @@ HeadRule::makeComplement()
   ELog::RegMethod RegA("HeadRule","makeComplement");
 
   if (!HeadNode) return;
+  clearCode();
   MonteCarlo::Algebra AX;
   AX.setFunctionObjStr("#( "+HeadNode->display()+") ");
   delete HeadNode;
@@ -547,6 +873,8 @@ HeadRule::createAddition(const int InterFlag,const Rule* NRptr)
 {
   ELog::RegMethod RegA("HeadRule","createAddition");
 
+  clearCode();
+
   // This is an intersection and we want to add our rule at the base
   // Find first item that is not an intersection
   Rule* RPtr(HeadNode);
@@ -584,6 +912,153 @@ HeadRule::createAddition(const int InterFlag,const Rule* NRptr)
 }
 
 
+int
+HeadRule::parseNumber(const char*& PX,int& SN)
+  /*!
+    Read a signed integer [at most 9 digits] 
+    \param PX :: Position [moved past the number]
+    \param SN :: Number
+    \return 1 on success / 0 on failure [PX unchanged]
+  */
+{
+  const char* Pt=PX;
+  const int sign=(*Pt=='-') ? -1 : 1;
+  if (*Pt=='-') Pt++;
+  int N(0);
+  size_t nDigit(0);
+  for(;isdigit(*Pt);Pt++,nDigit++)
+    N=10*N+(*Pt-'0');
+  if (!nDigit || nDigit>9)
+    return 0;
+  SN=sign*N;
+  PX=Pt;
+  return 1;
+}
+
+Rule*
+HeadRule::parseUnit(const char*& PX)
+  /*!
+    Parse a unit of the rule : a surface, a #cell,
+    a complement group #( ) or a bracketed rule.
+    \param PX :: Position [moved past the unit]
+    \return new Rule / 0 on failure
+  */
+{
+  while(isspace(*PX)) PX++;
+  int SN;
+  if (*PX=='#')
+    {
+      PX++;
+      if (parseNumber(PX,SN))
+	{
+	  if (SN<0) return 0;
+	  CompObj* TmpO=new CompObj();
+	  TmpO->setObjN(SN);
+	  return TmpO;
+	}
+      while(isspace(*PX)) PX++;
+      if (*PX!='(') return 0;
+      Rule* RPtr=parseUnit(PX);
+      return (RPtr) ? procComp(RPtr) : 0;
+    }
+  if (*PX=='(')
+    {
+      PX++;
+      Rule* RPtr=parseUnion(PX);
+      if (!RPtr) return 0;
+      while(isspace(*PX)) PX++;
+      if (*PX!=')')
+	{
+	  delete RPtr;
+	  return 0;
+	}
+      PX++;
+      return RPtr;
+    }
+  if (!parseNumber(PX,SN))
+    return 0;
+  SurfPoint* TmpR=new SurfPoint();
+  TmpR->setKeyN(SN);
+  return TmpR;
+}
+
+Rule*
+HeadRule::parseIntersection(const char*& PX)
+  /*!
+    Parse a sequence of units joined by intersection.
+    The tree is built from the left as procPair does.
+    \param PX :: Position [moved past the intersections]
+    \return new Rule / 0 on failure
+  */
+{
+  Rule* RPtr=parseUnit(PX);
+  while(RPtr)
+    {
+      while(isspace(*PX)) PX++;
+      if (!*PX || *PX==':' || *PX==')')
+	return RPtr;
+      Rule* BPtr=parseUnit(PX);
+      if (!BPtr)
+	{
+	  delete RPtr;
+	  return 0;
+	}
+      RPtr=new Intersection(RPtr,BPtr);
+    }
+  return 0;
+}
+
+Rule*
+HeadRule::parseUnion(const char*& PX)
+  /*!
+    Parse a sequence of intersections joined by union.
+    The tree is built from the left as procPair does.
+    \param PX :: Position [moved past the unions]
+    \return new Rule / 0 on failure
+  */
+{
+  Rule* RPtr=parseIntersection(PX);
+  while(RPtr)
+    {
+      while(isspace(*PX)) PX++;
+      if (*PX!=':')
+	return RPtr;
+      PX++;
+      Rule* BPtr=parseIntersection(PX);
+      if (!BPtr)
+	{
+	  delete RPtr;
+	  return 0;
+	}
+      RPtr=new Union(RPtr,BPtr);
+    }
+  return 0;
+}
+
+Rule*
+HeadRule::parseString(const std::string& Line)
+  /*!
+    Single pass parse of a cell rule string made of 
+    surfaces, #cell, #( ), ( ) and : only. The tree is 
+    the same as the tree from the bracket substitution. 
+    \param Line :: String value
+    \return new Rule / 0 if the string needs the full parser
+  */
+{
+  const char* PX=Line.c_str();
+  Rule* RPtr=parseUnion(PX);
+  if (RPtr)
+    {
+      while(isspace(*PX)) PX++;
+      if (*PX)
+	{
+	  delete RPtr;
+	  return 0;
+	}
+    }
+  return RPtr;
+}
+
 int
 HeadRule::procString(const std::string& Line) 
   /*!
@@ -598,8 +1073,12 @@ HeadRule::procString(const std::string& Line)
 
   if (StrFunc::isEmpty(Line)) return 0;
 
+  clearCode();
   delete HeadNode;
-  HeadNode=0;
+  HeadNode=parseString(Line);
+  if (HeadNode) return 1;
+
+  // Full parser for all other strings
   std::map<int,Rule*> RuleList;    //List for the rules 
   int Ridx=0;                     //Current index (not necessary size of RuleList 
   // SURFACE REPLACEMENT
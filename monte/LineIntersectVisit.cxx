@@ -34,6 +34,7 @@
 #include <boost/regex.hpp>
 #include <boost/bind.hpp>
 #include <boost/multi_array.hpp>
+#include <boost/thread/tss.hpp>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -83,6 +84,19 @@ operator<<(std::ostream& OX,const LineIntersectVisit& A)
   return OX;
 }
 
+const size_t LineIntersectVisit::nReserve(16);
+
+LineIntersectVisit::LineIntersectVisit() :
+  BaseVisit(),neutIndex(0)
+  /*!
+    Constructor [for the thread scratch pool]
+  */
+{
+  PtOut.reserve(nReserve);
+  DOut.reserve(nReserve);
+  SurfIndex.reserve(nReserve);
+}
+
 LineIntersectVisit::LineIntersectVisit
   (const Geometry::Vec3D& Pt,const Geometry::Vec3D& uVec) :
     BaseVisit(),ATrack(Pt,uVec),neutIndex(0)
@@ -102,6 +116,109 @@ LineIntersectVisit::LineIntersectVisit
   */
 {}
 
+/*!
+  \struct scratchPool
+  \brief Tracking objects of one thread by depth
+*/
+struct LineIntersectVisit::scratchPool
+{
+  std::vector<LineIntersectVisit*> Items;  ///< Object at each depth
+  size_t depth;                            ///< Depth in use
+
+  scratchPool() : depth(0) {}             ///< Constructor
+  ~scratchPool();
+};
+
+LineIntersectVisit::scratchPool::~scratchPool()
+  /*!
+    Destructor : delete the objects
+  */
+{
+  for(size_t i=0;i<Items.size();i++)
+    delete Items[i];
+}
+
+LineIntersectVisit::scratchPool&
+LineIntersectVisit::threadPool()
+  /*!
+    Access the scratch pool of the calling thread.
+    The holder is never deleted [as RegMethod::getStack].
+    \return scratchPool for this thread
+  */
+{
+  static boost::thread_specific_ptr<scratchPool>* TSPtr=
+    new boost::thread_specific_ptr<scratchPool>();
+  scratchPool* PPtr=TSPtr->get();
+  if (!PPtr)
+    {
+      PPtr=new scratchPool();
+      TSPtr->reset(PPtr);
+    }
+  return *PPtr;
+}
+
+LineIntersectVisit*
+LineIntersectVisit::acquire()
+  /*!
+    Take the object at the next depth of the thread pool.
+    \return LineIntersectVisit [not owned]
+  */
+{
+  scratchPool& SP=threadPool();
+  if (SP.depth==SP.Items.size())
+    SP.Items.push_back(new LineIntersectVisit());
+  return SP.Items[SP.depth++];
+}
+
+void
+LineIntersectVisit::release()
+  /*!
+    Return the deepest object to the thread pool
+  */
+{
+  threadPool().depth--;
+  return;
+}
+
+LineIntersectVisit::Scratch::Scratch(const Geometry::Vec3D& Pt,
+				     const Geometry::Vec3D& uVec) :
+  LPtr(LineIntersectVisit::acquire())
+  /*!
+    Take a tracking object from the pool of the calling 
+    thread set to a new line with an empty track. No memory
+    is allocated once the arrays have grown to the largest
+    track. A nested Scratch on the same thread gets its 
+    own object.
+    \param Pt :: Point to start track
+    \param uVec :: Outgoing track direction
+  */
+{
+  LPtr->ATrack=Geometry::Line(Pt,uVec);
+  LPtr->neutIndex=0;
+  LPtr->clearTrack();
+}
+
+LineIntersectVisit::Scratch::Scratch(const MonteCarlo::neutron& N) :
+  LPtr(LineIntersectVisit::acquire())
+  /*!
+    Take a tracking object from the pool of the calling 
+    thread set to the neutron track with an empty track.
+    \param N :: Neutron to track
+  */
+{
+  LPtr->ATrack=Geometry::Line(N.Pos,N.uVec);
+  LPtr->neutIndex=N.ID;
+  LPtr->clearTrack();
+}
+
+LineIntersectVisit::Scratch::~Scratch()
+  /*!
+    Destructor : return the object to the thread pool
+  */
+{
+  LineIntersectVisit::release();
+}
+
 void
 LineIntersectVisit::setLine(const Geometry::Vec3D& Pt,
 			    const Geometry::Vec3D& Axis)
@@ -49,11 +49,14 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "BoundBox.h"
 #include "Transform.h"
 #include "Track.h"
 #include "Line.h"
 #include "LineIntersectVisit.h"
+#include "TrackCache.h"
 #include "Surface.h"
+#include "SenseCache.h"
 #include "surfIndex.h"
 #include "Rules.h"
 #include "HeadRule.h"
@@ -117,6 +120,7 @@ Object::startLine(const std::string& Line)
 Object::Object() :
   ObjName(0),listNum(-1),Tmp(300),MatN(-1),fill(0),trcl(0),
   universe(0),imp(1),density(0.0),placehold(0),populated(0),
+  boxLow(-1e38,-1e38,-1e38),boxHigh(1e38,1e38,1e38),
   objSurfValid(0)
  /*!
    Defaut constuctor, set temperature to 300C and material to vacuum
@@ -127,7 +131,8 @@ Object::Object(const int N,const int M,const double T,
 	       const std::string& Line) :
   ObjName(N),listNum(-1),Tmp(T),MatN(M),fill(0),trcl(0),
   universe(0),imp(1),density(0.0),placehold(0),
-  populated(0),objSurfValid(0)
+  populated(0),boxLow(-1e38,-1e38,-1e38),boxHigh(1e38,1e38,1e38),
+  objSurfValid(0)
  /*!
    Constuctor, set temperature to 300C 
    \param N :: number
@@ -139,11 +144,27 @@ Object::Object(const int N,const int M,const double T,
   HRule.procString(Line);
 }
 
+Object::Object(const int N,const int M,const double T,
+	       const HeadRule& HR) :
+  ObjName(N),listNum(-1),Tmp(T),MatN(M),fill(0),trcl(0),
+  universe(0),imp(1),density(0.0),placehold(0),
+  populated(0),HRule(HR),boxLow(-1e38,-1e38,-1e38),
+  boxHigh(1e38,1e38,1e38),objSurfValid(0)
+ /*!
+   Constuctor from a built rule
+   \param N :: number
+   \param M :: material
+   \param T :: temperature (K)
+   \param HR :: Rule of the cell
+ */
+{}
+
 Object::Object(const Object& A) :
   ObjName(A.ObjName),listNum(A.listNum),Tmp(A.Tmp),MatN(A.MatN),
   fill(A.fill),trcl(A.trcl),universe(A.universe),imp(A.imp),
   density(A.density),placehold(A.placehold),populated(A.populated),
-  HRule(A.HRule),objSurfValid(0),SurList(A.SurList),SurSet(A.SurSet)
+  HRule(A.HRule),boxLow(A.boxLow),boxHigh(A.boxHigh),
+  boxSurf(A.boxSurf),objSurfValid(0),SurList(A.SurList),SurSet(A.SurSet)
   /*!
     Copy constructor
     \param A :: Object to copy
@@ -172,6 +193,9 @@ Object::operator=(const Object& A)
       placehold=A.placehold;
       populated=A.populated;
       HRule=A.HRule;
+      boxLow=A.boxLow;
+      boxHigh=A.boxHigh;
+      boxSurf=A.boxSurf;
       objSurfValid=0;
       SurList=A.SurList;
       SurSet=A.SurSet;
@@ -246,6 +270,7 @@ Object::complementaryObject(const int Cnum,std::string& Ln)
   CompCell<<Cnum<<" ";
   Ln.insert(posA-1,CompCell.str());
   objSurfValid=0;
+  clearBoundBox();
   return 1;
 }
 
@@ -261,6 +286,156 @@ Object::hasComplement() const
   return HRule.isComplementary();
 }
 
+void
+Object::setKeyTemp(const double tval)
+  /*!
+    Set the temperature from a tmp= keyword
+    \param tval :: Temperature [K]
+  */
+{
+  if (tval<0.0)
+    {
+      ELog::EM<<"Negative temp (error) "<<tval<<ELog::endErr;
+      Tmp=0.0;
+    }
+  else
+    Tmp=tval;
+  return;
+}
+
+int
+Object::procKeyWords(std::string& Ln)
+  /*!
+    Single pass removal of the keywords (tmp= fill= trcl= 
+    u= imp:n=) from the rule part of a cell line. Each keyword 
+    must start a word and have a single value word.
+    \param Ln :: Rule + keywords [keywords removed on success]
+    \retval 1 :: Ln has no letters left
+    \retval 0 :: Not processed [Ln unchanged]
+  */
+{
+  // Keyword names [lowercase] : 0 tmp / 1 fill / 2 trcl / 3 u / 4 imp:n
+  static const char* const keyName[]={"tmp","fill","trcl","u","imp:n"};
+
+  size_t index;
+  for(index=0;index<Ln.size() && !isalpha(Ln[index]);index++) ;
+  if (index==Ln.size()) return 1;         // Nothing to do
+
+  std::string Out(Ln,0,index);
+  double tval(0.0);
+  int iVal[5]={0,0,0,0,0};
+  int found[5]={0,0,0,0,0};
+  while(index<Ln.size())
+    {
+      if (!isalpha(Ln[index]))
+	{
+	  Out+=Ln[index++];
+	  continue;
+	}
+      if (index && !isspace(Ln[index-1]))
+	return 0;
+      // Match the name [case insensitive except :n]
+      size_t kIndex;
+      size_t pos(index);
+      for(kIndex=0;kIndex<5;kIndex++)
+	{
+	  const char* KN=keyName[kIndex];
+	  size_t i;
+	  for(i=0;KN[i] && index+i<Ln.size();i++)
+	    {
+	      const char C=(kIndex==4 && i>2) ? Ln[index+i] : 
+		static_cast<char>(tolower(Ln[index+i]));
+	      if (C!=KN[i]) break;
+	    }
+	  if (!KN[i])
+	    {
+	      pos=index+i;
+	      break;
+	    }
+	}
+      if (kIndex==5 || found[kIndex]) return 0;
+      for(;pos<Ln.size() && isspace(Ln[pos]);pos++) ;
+      if (pos==Ln.size() || Ln[pos]!='=') return 0;
+      for(pos++;pos<Ln.size() && isspace(Ln[pos]);pos++) ;
+      const size_t vStart(pos);
+      for(;pos<Ln.size() && !isspace(Ln[pos]);pos++) ;
+      const std::string Value(Ln,vStart,pos-vStart);
+      if (Value.empty()) return 0;
+      if (kIndex==0)
+	{
+	  if (!StrFunc::convert(Value,tval)) return 0;
+	}
+      else
+	{
+	  // fill/imp:n are digits only
+	  if ((kIndex==1 || kIndex==4) && 
+	      Value.find_first_not_of("0123456789")!=std::string::npos)
+	    return 0;
+	  if (!StrFunc::convert(Value,iVal[kIndex])) return 0;
+	}
+      found[kIndex]=1;
+      index=pos;
+    }
+
+  if (found[0]) setKeyTemp(tval);
+  if (found[1]) fill=iVal[1];
+  if (found[2]) trcl=iVal[2];
+  if (found[3]) universe=iVal[3];
+  if (found[4]) imp=iVal[4];
+  Ln=Out;
+  return 1;
+}
+
+int
+Object::procRegexKeyWords(std::string& Ln)
+  /*!
+    Remove the keywords from a cell line using regular 
+    expressions. Used for lines that procKeyWords cannot 
+    process.
+    \param Ln :: Rule + keywords [keywords removed]
+    \return 1 if no letters are left / 0 on junk 
+  */
+{
+  ELog::RegMethod RegA("Object","procRegexKeyWords");
+
+  static const boost::regex TmpSea("[Tt][Mm][Pp]\\s*=\\s*(\\S+)(\\s|$)");
+  static const boost::regex FillSea("[fF][iI][lL][lL]\\s*=\\s*(\\d+)(\\s|$)");
+  static const boost::regex TRCLSea("[tT][Rr][Cc][lL]\\s*=\\s*(\\S+)(\\s|$)");
+  static const boost::regex UnivSea("[uU]\\s*=\\s*(\\S+)(\\s|$)");
+  static const boost::regex ImpSea("[iI][mM][pP]:n\\s*=\\s*(\\d+)(\\s|$)");
+  // Does the string now contain junk...
+  static const boost::regex letters("[a-zA-Z]");    
+
+  std::string Extract;
+  // Temperature
+  double tval;
+  if (StrFunc::StrRemove(Ln,Extract,TmpSea) &&
+      StrFunc::StrFullCut(Extract,TmpSea,tval,0))
+    setKeyTemp(tval);
+  // Fill
+  int fVal;
+  if (StrFunc::StrRemove(Ln,Extract,FillSea) &&
+      StrFunc::StrFullCut(Extract,FillSea,fVal,0))
+    fill=fVal;
+  // TRCL
+  int trclVal;
+  if (StrFunc::StrRemove(Ln,Extract,TRCLSea) &&
+      StrFunc::StrFullCut(Extract,TRCLSea,trclVal,0))
+    trcl=trclVal;
+  // Universe
+  int uVal;
+  if (StrFunc::StrRemove(Ln,Extract,UnivSea) &&
+      StrFunc::StrFullCut(Extract,UnivSea,uVal,0))
+    universe=uVal;
+  // Importance
+  int iVal;
+  if (StrFunc::StrRemove(Ln,Extract,ImpSea) &&
+      StrFunc::StrFullCut(Extract,ImpSea,iVal,0))
+    imp=iVal;
+  
+  return (StrFunc::StrLook(Ln,letters)) ? 0 : 1;
+}
+
 int
 Object::setObject(std::string Ln)
  /*! 
@@ -307,58 +482,8 @@ Object::setObject(std::string Ln)
       density=0.0;          // Vacuum
     }  
 
-  // Temperature
-  const boost::regex TmpSea("[Tt][Mm][Pp]\\s*=\\s*(\\S+)(\\s|$)");
-  const boost::regex FillSea("[fF][iI][lL][lL]\\s*=\\s*(\\d+)(\\s|$)");
-  const boost::regex TRCLSea("[tT][Rr][Cc][lL]\\s*=\\s*(\\S+)(\\s|$)");
-  const boost::regex UnivSea("[uU]\\s*=\\s*(\\S+)(\\s|$)");
-  const boost::regex ImpSea("[iI][mM][pP]:n\\s*=\\s*(\\d+)(\\s|$)");
-  std::string Extract;
-  // Temperature
-  double tval;
-  if (StrFunc::StrRemove(Ln,Extract,TmpSea) &&
-      StrFunc::StrFullCut(Extract,TmpSea,tval,0))
-    {
-      if (tval<0.0)
-        {
-	  ELog::EM<<"Negative temp (error) "<<tval<<ELog::endErr;
-	  tval=0.0;
-	}
-      Tmp=tval;
-    }
-  // Fill
-  int fVal;
-  if (StrFunc::StrRemove(Ln,Extract,FillSea) &&
-      StrFunc::StrFullCut(Extract,FillSea,fVal,0))
-    {
-      fill=fVal;
-    }
-
-  // TRCL
-  int trclVal;
-  if (StrFunc::StrRemove(Ln,Extract,TRCLSea) &&
-      StrFunc::StrFullCut(Extract,FillSea,trclVal,0))
-    {
-      trcl=trclVal;
-    }
-
-  // Universe
-  int uVal;
-  if (StrFunc::StrRemove(Ln,Extract,UnivSea) &&
-      StrFunc::StrFullCut(Extract,FillSea,uVal,0))
-    {
-      universe=uVal;
-    }
-  // Importance
-  int iVal;
-  if (StrFunc::StrRemove(Ln,Extract,ImpSea) &&
-      StrFunc::StrFullCut(Extract,FillSea,iVal,0))
-    {
-      imp=iVal;
-    }
-  
-  const boost::regex letters("[a-zA-Z]");    // Does the string now contain junk...
-  if (StrFunc::StrLook(Ln,letters))
+  // Keywords : regex only if the fast scan fails
+  if (!procKeyWords(Ln) && !procRegexKeyWords(Ln))
     {
       ELog::EM<<"Junk letters in cell definition:"<<Ln<<ELog::endErr;
       return 0;
@@ -369,6 +494,7 @@ Object::setObject(std::string Ln)
       SurList.clear();
       SurSet.erase(SurSet.begin(),SurSet.end());
       objSurfValid=0;
+      clearBoundBox();
       return 1;
     }
 
@@ -386,9 +512,24 @@ Object::procString(const std::string& cellStr)
    */
 {
   populated=0;
+  clearBoundBox();
   return HRule.procString(cellStr);
 }
 
+int
+Object::procRule(Rule* RPtr)
+  /*!
+    Replace the cell rule
+    \param RPtr :: New rule [ownership taken]
+    \return 1 on success / 0 on no rule
+   */
+{
+  populated=0;
+  clearBoundBox();
+  HRule.setRule(RPtr);
+  return (RPtr) ? 1 : 0;
+}
+
 int
 Object::setObject(const int N,const int matNum,
 		  const std::vector<Token>& TVec)
@@ -417,6 +558,7 @@ Object::setObject(const int N,const int matNum,
       SurList.clear();
       SurSet.erase(SurSet.begin(),SurSet.end());
       objSurfValid=0;
+      clearBoundBox();
       return 1;
     }
 
@@ -441,6 +583,7 @@ Object::populate()
     {
       HRule.populateSurf();
       populated=1;
+      clearBoundBox();
     }
   return 0;
 }
@@ -470,6 +613,173 @@ Object::addSurfString(const std::string& XE)
 }
 
 
+void
+Object::calcBoundBox()
+  /*!
+    Calculate the bounding box of the object
+    from the rule tree. Requires a populated object.
+  */
+{
+  ELog::RegMethod RegA("Object","calcBoundBox");
+
+  populate();
+  setBoundBox(HRule.calcBoundBox());
+  return;
+}
+
+Geometry::BoundBox
+Object::ruleBoundBox() const
+  /*!
+    Calculate the box of the rule tree without 
+    changing the stored box. Requires a populated object.
+    \return conservative bounding box
+  */
+{
+  return HRule.calcBoundBox();
+}
+
+void
+Object::setBoundBox(const Geometry::BoundBox& ABox)
+  /*!
+    Set the bounding box. The box is only used while 
+    none of the surfaces of the cell has moved since 
+    it was set.
+    \param ABox :: Box to use
+  */
+{
+  boxLow=ABox.getLow();
+  boxHigh=ABox.getHigh();
+  boxSurf.clear();
+  std::stack<const Rule*> TreeLine;
+  TreeLine.push(HRule.getTopRule());
+  while(!TreeLine.empty())
+    {
+      const Rule* tmpA=TreeLine.top();
+      TreeLine.pop();
+      if (tmpA)
+	{
+	  const Rule* tmpB=tmpA->leaf(0);
+	  const Rule* tmpC=tmpA->leaf(1);
+	  if (tmpB || tmpC)
+	    {
+	      if (tmpB) TreeLine.push(tmpB);
+	      if (tmpC) TreeLine.push(tmpC);
+	    }
+	  else
+	    {
+	      const SurfPoint* SurX=dynamic_cast<const SurfPoint*>(tmpA);
+	      if (SurX && SurX->getKey())
+		{
+		  SurX->getKey()->setInCell();
+		  boxSurf.push_back
+		    (std::pair<const Geometry::Surface*,size_t>
+		     (SurX->getKey(),SurX->getKey()->getGeneration()));
+		}
+	    }
+	}
+    }
+  return;
+}
+
+bool
+Object::boxCurrent() const
+  /*!
+    Determine if the box was set under the current 
+    generation of each surface of the cell. A surface 
+    moved after the box was set can take the cell outside it.
+    \return true if the box can be used to reject
+  */
+{
+  std::vector<std::pair<const Geometry::Surface*,size_t> >::const_iterator vc;
+  for(vc=boxSurf.begin();vc!=boxSurf.end();vc++)
+    if (vc->first->getGeneration()!=vc->second)
+      return 0;
+  return 1;
+}
+
+bool
+Object::inBoundBox(const Geometry::Vec3D& Pt) const
+  /*!
+    Fast reject test on the bounding box. The surfaces 
+    are only checked for a point outside the box.
+    \param Pt :: Point to test
+    \return false if the point is outside a current box
+  */
+{
+  return ((Pt.X()>=boxLow.X() && Pt.X()<=boxHigh.X() &&
+	   Pt.Y()>=boxLow.Y() && Pt.Y()<=boxHigh.Y() &&
+	   Pt.Z()>=boxLow.Z() && Pt.Z()<=boxHigh.Z()) ||
+	  !boxCurrent());
+}
+
+void
+Object::clearBoundBox()
+  /*!
+    Reset the bounding box to everything
+  */
+{
+  boxLow=Geometry::Vec3D(-1e38,-1e38,-1e38);
+  boxHigh=Geometry::Vec3D(1e38,1e38,1e38);
+  boxSurf.clear();
+  return;
+}
+
+Geometry::BoundBox
+Object::getBoundBox() const
+  /*!
+    Access the bounding box
+    \return Bounding box [unbounded if not calculated 
+    or set before a surface change]
+  */
+{
+  Geometry::BoundBox Out;
+  if (!boxCurrent())
+    return Out;
+  for(size_t i=0;i<3;i++)
+    {
+      Out.setLow(i,boxLow[i]);
+      Out.setHigh(i,boxHigh[i]);
+    }
+  return Out;
+}
+
+bool
+Object::lineBoundBox(const Geometry::Vec3D& IP,
+		     const Geometry::Vec3D& UV) const
+  /*!
+    Determine if the forward line IP + lambda(UV) can
+    enter the bounding box (slab test).
+    \param IP :: Initial point
+    \param UV :: Direction
+    \return true if the line passes through the box [or 
+    the box is out of date]
+  */
+{
+  double tMin(-Geometry::shiftTol);
+  double tMax(1e38);
+  for(size_t i=0;i<3;i++)
+    {
+      const double P=IP[i];
+      const double U=UV[i];
+      const double L=boxLow[i];
+      const double H=boxHigh[i];
+      if (std::abs(U)<1e-12)
+	{
+	  if (P<L || P>H) return !boxCurrent();
+	}
+      else
+	{
+	  double tA=(L-P)/U;
+	  double tB=(H-P)/U;
+	  if (tA>tB) std::swap(tA,tB);
+	  if (tA>tMin) tMin=tA;
+	  if (tB<tMax) tMax=tB;
+	  if (tMin>tMax) return !boxCurrent();
+	}
+    }
+  return 1;
+}
+
 int
 Object::isOnSide(const Geometry::Vec3D& Pt) const
   /*!
@@ -480,29 +790,25 @@ Object::isOnSide(const Geometry::Vec3D& Pt) const
 {
   ELog::RegMethod RegA("Object","isOnSide");
 
-  std::map<int,int> surMap=mapValid(Pt);
-  std::map<int,int>::iterator mc;
-
-  std::set<int> onSurf;
-  for(mc=surMap.begin();mc!=surMap.end();mc++)
+  // Surfaces the point is on
+  std::vector<int> onSurf;
+  std::vector<const Geometry::Surface*>::const_iterator vc;
+  for(vc=SurList.begin();vc!=SurList.end();vc++)
     {
-      if (!mc->second)
-	onSurf.insert(mc->first);
+      if (!(*vc)->side(Pt))
+	onSurf.push_back((*vc)->getName());
     }
   // Definately not on the surface
   if (onSurf.empty()) return 0;
-  std::set<int>::const_iterator sc;
+  std::sort(onSurf.begin(),onSurf.end());
+  std::vector<int>::const_iterator sc;
   for(sc=onSurf.begin();sc!=onSurf.end();sc++)
     {
-      mc=surMap.find(*sc);
-      mc->second=-1;
-      const int Adir=HRule.isValid(surMap);
-      mc->second=1;
-      const int Bdir=HRule.isValid(surMap);
+      const int Adir=HRule.isDirectionValid(Pt,-(*sc));
+      const int Bdir=HRule.isDirectionValid(Pt,*sc);
 
       if ((Adir ^ Bdir)==1)        // Opposite 
 	return (Bdir) ? *sc : -(*sc);
-      mc->second=0;
     }
 
   return 0;
@@ -580,6 +886,7 @@ Object::isValid(const Geometry::Vec3D& Pt) const
   \returns 1 if true and 0 if false
 */
 {
+  if (!inBoundBox(Pt)) return 0;
   return HRule.isValid(Pt);
 }
 
@@ -637,6 +944,34 @@ Object::isValid(const std::map<int,int>& SMap) const
   return HRule.isValid(SMap);
 }
 
+int
+Object::isValid(Geometry::SenseCache& SC) const
+/*! 
+  Determines is the cache point is within the object 
+  or on the surface. Surface sides are shared with
+  other cells tested on the same cache.
+  \param SC :: Surface sense cache [holds point]
+  \returns 1 if true and 0 if false
+*/
+{
+  if (!inBoundBox(SC.getPoint())) return 0;
+  return HRule.isValid(SC);
+}
+
+int
+Object::isDirectionValid(Geometry::SenseCache& SC,
+			 const int ExSN) const
+/*! 
+  Determines is the cache point is within the object 
+  or on the surface
+  \param SC :: Surface sense cache [holds point]
+  \param ExSN :: Excluded surf Number [signed]
+  \returns 1 if true and 0 if false
+*/
+{
+  return HRule.isDirectionValid(SC,ExSN);
+}
+
 std::map<int,int>
 Object::mapValid(const Geometry::Vec3D& Pt) const
 /*! 
@@ -846,6 +1181,7 @@ Object::removeSurface(const int SurfN)
     {
       createSurfaceList();
       objSurfValid=0;
+      clearBoundBox();
     }
   return cnt;
 }
@@ -873,6 +1209,7 @@ Object::substituteSurf(const int SurfN,const int NsurfN,
       populated=0;
       populate();
       createSurfaceList();
+      clearBoundBox();
     }
   return out;
 }
@@ -891,7 +1228,11 @@ Object::hasIntercept(const Geometry::Vec3D& IP,
 {
   ELog::RegMethod RegA("Object","hadIntercept");
 
-  MonteCarlo::LineIntersectVisit LI(IP,UV);
+  if (!lineBoundBox(IP,UV))
+    return 0;
+
+  MonteCarlo::LineIntersectVisit::Scratch LS(IP,UV);
+  MonteCarlo::LineIntersectVisit& LI=LS.item();
   std::vector<const Geometry::Surface*>::const_iterator vc;
   for(vc=SurList.begin();vc!=SurList.end();vc++)
     (*vc)->acceptVisitor(LI);
@@ -922,10 +1263,12 @@ Object::forwardIntercept(const Geometry::Vec3D& IP,
 {
   ELog::RegMethod RegA("Object","forwardIntercept");
   
-  MonteCarlo::LineIntersectVisit LI(IP,UV);
+  MonteCarlo::LineIntersectVisit::Scratch LS(IP,UV);
+  MonteCarlo::LineIntersectVisit& LI=LS.item();
   std::vector<const Geometry::Surface*>::const_iterator vc;
   for(vc=SurList.begin();vc!=SurList.end();vc++)
     (*vc)->acceptVisitor(LI);
+  HRule.setTrack(LI.getTrack().getOrigin(),LI.getTrack().getDirect());
 
   const std::vector<Geometry::Vec3D>& IPts(LI.getPoints());
   const std::vector<double>& dPts(LI.getDistance());
@@ -938,7 +1281,8 @@ Object::forwardIntercept(const Geometry::Vec3D& IP,
     {
       if (dPts[i]>Geometry::shiftTol && dPts[i]<minDist)
 	{
-	  const int pAB=pairValid(surfIndex[i]->getName(),IPts[i]);
+	  const int pAB=HRule.trackPairValid(surfIndex[i]->getName(),
+					     IPts[i],dPts[i]);
 	  if (pAB==1 || pAB==2)            // Going either way
 	    {
 	      minDist=dPts[i];
@@ -968,6 +1312,25 @@ Object::trackOutCell(const MonteCarlo::neutron& N,double& D,
   return trackCell(N,D,-1,SPtr,startSurf);
 }
 
+int
+Object::trackOutCell(const MonteCarlo::neutron& N,double& D,
+		     const Geometry::Surface*& SPtr,
+		     const int startSurf,
+		     MonteCarlo::TrackCache& TC) const
+  /*!
+    Track the distance to exit the cell using the
+    intersections held for the neutron ray
+    \param N :: Neutron [on the TC ray]
+    \param D :: Distance to exit
+    \param SPtr :: Surface at exit
+    \param startSurf :: Start surface [not to be used]
+    \param TC :: Intersection cache of the ray
+    \return surface number on exit
+  */
+{
+  return trackCell(N,D,-1,SPtr,startSurf,TC);
+}
+
 int
 Object::trackIntoCell(const MonteCarlo::neutron& N,double& D,
 		      const Geometry::Surface*& SPtr,
@@ -1022,16 +1385,86 @@ Object::trackCell(const MonteCarlo::neutron& N,double& D,
    */
 {
   ELog::RegMethod RegA("Object","trackCell[D,dir]");
-  MonteCarlo::LineIntersectVisit LI(N);
+
+  if (!lineBoundBox(N.Pos,N.uVec))
+    {
+      D=1e38;
+      surfPtr=0;
+      return 0;
+    }
+
+  MonteCarlo::LineIntersectVisit::Scratch LS(N);
+  MonteCarlo::LineIntersectVisit& LI=LS.item();
   std::vector<const Geometry::Surface*>::const_iterator vc;
   for(vc=SurList.begin();vc!=SurList.end();vc++)
     (*vc)->acceptVisitor(LI);
+  HRule.setTrack(LI.getTrack().getOrigin(),LI.getTrack().getDirect());
 
+  return trackPoints(N,LI.getPoints(),LI.getDistance(),
+		     LI.getSurfIndex(),D,direction,surfPtr,startSurf);
+}
 
-  const std::vector<Geometry::Vec3D>& IPts(LI.getPoints());
-  const std::vector<double>& dPts(LI.getDistance());
-  const std::vector<const Geometry::Surface*>& surfIndex(LI.getSurfIndex());
+int
+Object::trackCell(const MonteCarlo::neutron& N,double& D,
+		  const int direction,
+		  const Geometry::Surface*& surfPtr,
+		  const int startSurf,
+		  MonteCarlo::TrackCache& TC) const
+  /*!
+    Track to a neutron to a cell using the intersections
+    held for the neutron ray. Surfaces already met on the
+    ray are not solved again.
+    \param N :: Neutron [on the TC ray]
+    \param D :: Distance traveled to the cell
+    \param direction :: direction to track [+1/-1 : in/out ] 
+    \param surfPtr :: Surface at exit
+    \param startSurf :: Start surface
+    \param TC :: Intersection cache of the ray
+    \return surface number of intercept
+   */
+{
+  ELog::RegMethod RegA("Object","trackCell[D,dir,TC]");
 
+  if (!TC.isActive())
+    return trackCell(N,D,direction,surfPtr,startSurf);
+
+  if (!lineBoundBox(N.Pos,N.uVec))
+    {
+      D=1e38;
+      surfPtr=0;
+      return 0;
+    }
+
+  TC.collect(SurList,N.Pos);
+  HRule.setTrack(N.Pos,TC.getDirect());
+
+  return trackPoints(N,TC.getPoints(),TC.getDistance(),
+		     TC.getSurfIndex(),D,direction,surfPtr,startSurf);
+}
+
+int
+Object::trackPoints(const MonteCarlo::neutron& N,
+		    const std::vector<Geometry::Vec3D>& IPts,
+		    const std::vector<double>& dPts,
+		    const std::vector<const Geometry::Surface*>& surfIndex,
+		    double& D,const int direction,
+		    const Geometry::Surface*& surfPtr,
+		    const int startSurf) const
+  /*!
+    Find the intersection point that moves the neutron 
+    in/out of the cell. HRule.setTrack must be set to the
+    neutron track.
+    \param N :: Neutron 
+    \param IPts :: Intersection points
+    \param dPts :: Distances of the points from the neutron
+    \param surfIndex :: Surface of each point
+    \param D :: Distance traveled to the cell
+    \param direction :: direction to track [+1/-1 : in/out ] 
+    \param surfPtr :: Surface at exit
+    \param startSurf :: Start surface
+    \return surface number of intercept
+   */
+{
   D=1e38;
   surfPtr=0;
   // NOTE: we only check for and exiting surface by going
@@ -1044,7 +1477,7 @@ Object::trackCell(const MonteCarlo::neutron& N,double& D,
 	{
 	  const int NS=surfIndex[i]->getName();
 		       
-	  const int pAB=pairValid(NS,IPts[i]);
+	  const int pAB=HRule.trackPairValid(NS,IPts[i],dPts[i]);
 	  if (pAB==1 || pAB==2)        // in / out
 	    {
 	      const int normD=surfIndex[i]->sideDirection(IPts[i],N.uVec);
@@ -1082,10 +1515,12 @@ Object::forwardInterceptInit(const Geometry::Vec3D& IP,
 {
   ELog::RegMethod RegA("Object","forwardInterceptInit");
   
-  MonteCarlo::LineIntersectVisit LI(IP,UV);
+  MonteCarlo::LineIntersectVisit::Scratch LS(IP,UV);
+  MonteCarlo::LineIntersectVisit& LI=LS.item();
   std::vector<const Geometry::Surface*>::const_iterator vc;
   for(vc=SurList.begin();vc!=SurList.end();vc++)
     (*vc)->acceptVisitor(LI);
+  HRule.setTrack(LI.getTrack().getOrigin(),LI.getTrack().getDirect());
 
   const std::vector<Geometry::Vec3D>& IPts(LI.getPoints());
   const std::vector<double>& dPts(LI.getDistance());
@@ -1098,7 +1533,8 @@ Object::forwardInterceptInit(const Geometry::Vec3D& IP,
     {
       if (dPts[i]>Geometry::shiftTol && dPts[i]<minDist)
 	{
-	  const int pAB=pairValid(surfIndex[i]->getName(),IPts[i]);
+	  const int pAB=HRule.trackPairValid(surfIndex[i]->getName(),
+					     IPts[i],dPts[i]);
 	  if (pAB==1 || pAB==2)            // Going either way
 	    {
 	      minDist=dPts[i];
@@ -1114,7 +1550,8 @@ Object::forwardInterceptInit(const Geometry::Vec3D& IP,
 	  if (dPts[i]>-Geometry::shiftTol && dPts[i]<Geometry::shiftTol && 
 	      dPts[i]<minDist)
 	    {
-	      const int pAB=pairValid(surfIndex[i]->getName(),IPts[i]);
+	      const int pAB=HRule.trackPairValid(surfIndex[i]->getName(),
+						 IPts[i],dPts[i]);
 	      if (pAB==1 || pAB==2)            // Going either way
 		{
 		  minDist=dPts[i];
@@ -1134,6 +1571,7 @@ Object::makeComplement()
    */
 {
   HRule.makeComplement();
+  clearBoundBox();
   return;
 }
 
@@ -47,12 +47,15 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "BoundBox.h"
 #include "Quaternion.h"
 #include "localRotate.h"
 #include "masterRotate.h"
 #include "OutputLog.h"
 #include "Transform.h"
 #include "Surface.h"
+#include "Quadratic.h"
+#include "Plane.h"
 #include "Rules.h"
 #include "HeadRule.h"
 #include "Object.h"
@@ -64,6 +67,9 @@
 namespace MonteCarlo
 {
 
+const double Qhull::boxTol(1e-3);
+const double Qhull::vertexLimit(1e5);
+
 Qhull::Qhull() : Object()
   /*!
     Default Constructor
@@ -82,6 +88,18 @@ Qhull::Qhull(const int N,const int M,
   */
 {}
 
+Qhull::Qhull(const int N,const int M,
+	     const double T,const HeadRule& HR) :
+  Object(N,M,T,HR)
+  /*!
+    Constuctor, sets number/material and temperature 
+   \param N :: number
+   \param M :: material
+   \param T :: temperature
+   \param HR :: Rule of the cell
+  */
+{}
+
 Qhull::Qhull(const Qhull& A) : Object(A),
   VList(A.VList),CofM(A.CofM)
   /*!
@@ -124,26 +142,146 @@ Qhull::clone() const
   return new Qhull(*this);
 }
 
+int
+Qhull::lineBox(const Geometry::Line& Lx,const Geometry::BoundBox& ABox)
+  /*!
+    Determine if the infinite line passes through the box 
+    (slab test in both directions)
+    \param Lx :: Line
+    \param ABox :: Box
+    \return true if the line passes through the box
+  */
+{
+  const Geometry::Vec3D& P=Lx.getOrigin();
+  const Geometry::Vec3D& U=Lx.getDirect();
+  double tMin(-1e38);
+  double tMax(1e38);
+  for(size_t i=0;i<3;i++)
+    {
+      const double L=ABox.getLow()[i];
+      const double H=ABox.getHigh()[i];
+      if (std::abs(U[i])<1e-12)
+	{
+	  if (P[i]<L || P[i]>H) return 0;
+	}
+      else
+	{
+	  double tA=(L-P[i])/U[i];
+	  double tB=(H-P[i])/U[i];
+	  if (tA>tB) std::swap(tA,tB);
+	  if (tA>tMin) tMin=tA;
+	  if (tB<tMax) tMax=tB;
+	  if (tMin>tMax) return 0;
+	}
+    }
+  return 1;
+}
+
+Geometry::BoundBox
+Qhull::vertexBox() const
+  /*!
+    Calculate the box that must contain every vertex:
+    the rule box [padded] limited to the vertex range.
+    \return box of possible vertex points
+  */
+{
+  Geometry::BoundBox ABox=ruleBoundBox();
+  if (ABox.isEmpty())
+    ABox.setUnbounded();
+  ABox.grow(boxTol);
+  ABox.intersect(Geometry::BoundBox
+		 (Geometry::Vec3D(-vertexLimit,-vertexLimit,-vertexLimit),
+		  Geometry::Vec3D(vertexLimit,vertexLimit,vertexLimit)));
+  return ABox;
+}
+
 int
 Qhull::calcIntersections()
   /*! 
     Loops over all the surfaces and calculates the appropiate
-    intersection
+    intersection. The line of each pair of planes is calculated
+    once and the triples of a pair of planes that are parallel
+    or whose line misses the cell box are skipped. 
+    The points [and their order] are the same as 
+    SurInter::processPoint on each triple.
     \return number of items intersection points.
   */
 {
   ELog::RegMethod RegA("Qhull","calcIntersections");
 
   VList.clear();                       // clear list of Vertex
-  std::vector<const Geometry::Surface*>::const_iterator ic,jc,kc;
-  int cnt(0);
-  for(ic=SurList.begin();ic!=SurList.end();ic++)
-    for(jc=ic+1;jc!=SurList.end();jc++)
-      for(kc=jc+1;kc!=SurList.end();kc++)
-        {
-	  // This adds intersections to the VList
-	  cnt+=getIntersect(*ic,*jc,*kc);	  
+  const size_t NS(SurList.size());
+  if (NS<3) return 0;
+
+  const Geometry::BoundBox ABox=vertexBox();
+  if (ABox.isEmpty()) return 0;
+
+  std::vector<const Geometry::Quadratic*> QVec(NS);
+  std::vector<const Geometry::Plane*> PVec(NS);
+  for(size_t i=0;i<NS;i++)
+    {
+      QVec[i]=dynamic_cast<const Geometry::Quadratic*>(SurList[i]);
+      PVec[i]=dynamic_cast<const Geometry::Plane*>(SurList[i]);
+    }
+  // Lines of plane pairs [i*NS+j] : flag set if usable
+  std::vector<Geometry::Line> PLine(NS*NS);
+  std::vector<int> PFlag(NS*NS,0);
+  for(size_t i=0;i<NS;i++)
+    for(size_t j=i+1;PVec[i] && j<NS;j++)
+      if (PVec[j] && PVec[i]!=PVec[j])
+	{
+	  Geometry::Line& Lx=PLine[i*NS+j];
+	  PFlag[i*NS+j]=(Lx.setLine(*PVec[i],*PVec[j]) &&
+			 lineBox(Lx,ABox)) ? 1 : 0;
 	}
+
+  int cnt(0);
+  std::vector<Geometry::Vec3D> Out;
+  for(size_t i=0;i<NS;i++)
+    for(size_t j=i+1;j<NS;j++)
+      {
+	if (SurList[i]==SurList[j]) continue;
+	// both planes : single line
+	if (PVec[i] && PVec[j] && !PFlag[i*NS+j]) continue;
+	for(size_t k=j+1;k<NS;k++)
+	  {
+	    if (SurList[k]==SurList[i] || SurList[k]==SurList[j])
+	      continue;
+	    // Non-quadratic [processPoint reports these]
+	    if (!QVec[i] || !QVec[j] || !QVec[k])
+	      {
+		cnt+=getIntersect(SurList[i],SurList[j],SurList[k],ABox);
+		continue;
+	      }
+	    // First two planes and the other surface
+	    size_t PA(NS),PB(NS),OI(NS);
+	    const size_t Index[3]={i,j,k};
+	    for(size_t m=0;m<3;m++)
+	      {
+		if (!PVec[Index[m]])
+		  OI=Index[m];
+		else if (PA==NS)
+		  PA=Index[m];
+		else if (PB==NS)
+		  PB=Index[m];
+		else 
+		  OI=Index[m];
+	      }
+	    Out.clear();
+	    if (PB!=NS)
+	      {
+		if (!PFlag[PA*NS+PB]) continue;
+		if (PVec[OI])
+		  PLine[PA*NS+PB].intersect(Out,*PVec[OI]);
+		else
+		  PLine[PA*NS+PB].intersect(Out,*QVec[OI]);
+	      }
+	    else
+	      Out=SurInter::makePoint(QVec[i],QVec[j],QVec[k]);
+	    // This adds intersections to the VList
+	    cnt+=addVertex(SurList[i],SurList[j],SurList[k],Out,ABox);
+	  }
+      }
   // return number of item found
   return cnt;
 }
@@ -151,7 +289,8 @@ Qhull::calcIntersections()
 int
 Qhull::getIntersect(const Geometry::Surface* SurfX,
 		    const Geometry::Surface* SurfY,
-		    const Geometry::Surface* SurfZ)
+		    const Geometry::Surface* SurfZ,
+		    const Geometry::BoundBox& ABox)
   /*!
     Calculates the intersection between three surfaces.
     Adds the point to the vertex list if the point is valid 
@@ -160,21 +299,42 @@ Qhull::getIntersect(const Geometry::Surface* SurfX,
     \param SurfX :: Surface pointer
     \param SurfY :: Surface pointer
     \param SurfZ :: Surface pointer
+    \param ABox :: Box of possible vertex points
     \returns Number intersections found
   */
 {
   ELog::RegMethod RegA("Qhull","getIntersect");
 
-  std::vector<Geometry::Vec3D> PntOut=
+  const std::vector<Geometry::Vec3D> PntOut=
     SurInter::processPoint(SurfX,SurfY,SurfZ);
-  
+  return addVertex(SurfX,SurfY,SurfZ,PntOut,ABox);
+}
+
+int
+Qhull::addVertex(const Geometry::Surface* SurfX,
+		 const Geometry::Surface* SurfY,
+		 const Geometry::Surface* SurfZ,
+		 const std::vector<Geometry::Vec3D>& PntOut,
+		 const Geometry::BoundBox& ABox)
+  /*!
+    Add the intersection points of three surfaces to the 
+    vertex list if the point is valid and is on a side.
+    \param SurfX :: Surface pointer
+    \param SurfY :: Surface pointer
+    \param SurfZ :: Surface pointer
+    \param PntOut :: Intersection points
+    \param ABox :: Box of possible vertex points
+    \returns Number of points added
+  */
+{
   std::vector<Geometry::Vec3D>::const_iterator vc;
   int Ncnt(0);
   for(vc=PntOut.begin();vc!=PntOut.end();vc++)
     {
-      if (isValid(*vc) &&         // Is point in/on the object
+      if (ABox.isValid(*vc) &&    // Fast reject 
+	  isValid(*vc) &&         // Is point in/on the object
 	  isOnSide(*vc) &&        // Is point on a side 
-	  vc->abs()<1e5)          // Tracked onto the very large points
+	  vc->abs()<vertexLimit)  // Tracked onto the very large points
 	{
 	  SurfVertex tmp;
 	  tmp.addSurface(const_cast<Geometry::Surface*>(SurfX));
@@ -244,8 +404,45 @@ Qhull::calcCentreOfMass()
 	}
       CofM/=static_cast<double>(VList.size());
     }
-  if (this->getName()==207)
-    ELog::EM<<"Centr of Mass == "<<CofM<<ELog::endDebug;
+  return;
+}
+
+void
+Qhull::calcBoundBox()
+  /*!
+    Calculate the bounding box from the rule tree and
+    then, if the cell is closed and only made of planes,
+    tighten it with the vertex points [if calculated].
+  */
+{
+  ELog::RegMethod RegA("Qhull","calcBoundBox");
+
+  Object::calcBoundBox();
+  if (VList.empty()) return;
+
+  Geometry::BoundBox ABox=getBoundBox();
+  if (ABox.isUnbounded() || ABox.isEmpty())
+    return;
+  // vertex points are only kept within vertexLimit of the origin
+  for(size_t i=0;i<3;i++)
+    if (std::abs(ABox.getLow()[i])>=vertexLimit ||
+	std::abs(ABox.getHigh()[i])>=vertexLimit)
+      return;
+
+  std::vector<const Geometry::Surface*>::const_iterator sc;
+  for(sc=SurList.begin();sc!=SurList.end();sc++)
+    if (!dynamic_cast<const Geometry::Plane*>(*sc))
+      return;
+
+  Geometry::BoundBox VBox;
+  VBox.setEmpty();
+  std::vector<SurfVertex>::const_iterator vc;
+  for(vc=VList.begin();vc!=VList.end();vc++)
+    VBox.addPoint(vc->getPoint());
+  VBox.grow(10.0*Geometry::shiftTol);
+
+  ABox.intersect(VBox);
+  setBoundBox(ABox);
   return;
 }
 
@@ -451,6 +648,7 @@ Qhull::displace(const Geometry::Vec3D& DVec)
 {
   for_each(VList.begin(),VList.end(),
 	   boost::bind(&SurfVertex::displace,_1,boost::ref(DVec)));
+  clearBoundBox();
   return;
 }
 
@@ -464,6 +662,7 @@ Qhull::rotate(const Geometry::Matrix<double>& MRot)
 {
   for_each(VList.begin(),VList.end(),
 	   boost::bind(&SurfVertex::rotate,_1,boost::ref(MRot)));
+  clearBoundBox();
   return;
 }
 
@@ -477,6 +676,7 @@ Qhull::mirror(const Geometry::Plane& PObj)
 {
   for_each(VList.begin(),VList.end(),
 	   boost::bind(&SurfVertex::mirror,_1,boost::ref(PObj)));
+  clearBoundBox();
   return;
 }
 
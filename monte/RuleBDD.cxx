@@ -0,0 +1,685 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   monte/RuleBDD.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <complex>
+#include <cmath>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <limits>
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "GTKreport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "BoundBox.h"
+#include "Rules.h"
+#include "HeadRule.h"
+#include "Object.h"
+#include "Qhull.h"
+#include "RuleBDD.h"
+
+namespace MonteCarlo
+{
+
+const size_t RuleBDD::falseNode(0);
+const size_t RuleBDD::trueNode(1);
+
+RuleBDD::RuleBDD()
+  /*!
+    Constructor : sets the terminals
+  */
+{
+  clear();
+}
+
+RuleBDD::RuleBDD(const RuleBDD& A) :
+  Nodes(A.Nodes),Unique(A.Unique),Computed(A.Computed),
+  SurfLevel(A.SurfLevel),LevelSurf(A.LevelSurf),
+  CellNode(A.CellNode),Active(A.Active)
+  /*!
+    Copy constructor
+    \param A :: RuleBDD to copy
+  */
+{}
+
+RuleBDD&
+RuleBDD::operator=(const RuleBDD& A)
+  /*!
+    Assignment operator
+    \param A :: RuleBDD to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      Nodes=A.Nodes;
+      Unique=A.Unique;
+      Computed=A.Computed;
+      SurfLevel=A.SurfLevel;
+      LevelSurf=A.LevelSurf;
+      CellNode=A.CellNode;
+      Active=A.Active;
+    }
+  return *this;
+}
+
+RuleBDD::~RuleBDD()
+  /*!
+    Destructor
+  */
+{}
+
+void
+RuleBDD::clear()
+  /*!
+    Remove all the nodes/variables and leave the terminals
+  */
+{
+  const size_t termLevel=std::numeric_limits<size_t>::max();
+  Nodes.clear();
+  Nodes.push_back(bddNode(termLevel,falseNode,falseNode));
+  Nodes.push_back(bddNode(termLevel,trueNode,trueNode));
+  Unique.clear();
+  Computed.clear();
+  SurfLevel.clear();
+  LevelSurf.clear();
+  CellNode.clear();
+  Active.clear();
+  return;
+}
+
+size_t
+RuleBDD::makeNode(const size_t L,const size_t lo,const size_t hi)
+  /*!
+    Get the unique node of the variable/cofactors
+    \param L :: Variable level
+    \param lo :: Node for the negative sense
+    \param hi :: Node for the positive sense
+    \return node index
+  */
+{
+  if (lo==hi) return lo;
+
+  const bddKey K(L,lo,hi);
+  std::map<bddKey,size_t>::const_iterator mc=Unique.find(K);
+  if (mc!=Unique.end())
+    return mc->second;
+
+  const size_t index=Nodes.size();
+  Nodes.push_back(bddNode(L,lo,hi));
+  Unique.insert(std::map<bddKey,size_t>::value_type(K,index));
+  return index;
+}
+
+size_t
+RuleBDD::surfNode(const int SN)
+  /*!
+    Get the node of a signed surface [new surfaces
+    are added after all the existing levels]
+    \param SN :: Signed surface number
+    \return node index
+  */
+{
+  const int surfN=(SN>0) ? SN : -SN;
+  size_t L;
+  std::map<int,size_t>::const_iterator mc=SurfLevel.find(surfN);
+  if (mc==SurfLevel.end())
+    {
+      L=LevelSurf.size();
+      SurfLevel.insert(std::map<int,size_t>::value_type(surfN,L));
+      LevelSurf.push_back(surfN);
+    }
+  else
+    L=mc->second;
+
+  return (SN>0) ? makeNode(L,falseNode,trueNode) :
+    makeNode(L,trueNode,falseNode);
+}
+
+size_t
+RuleBDD::ite(const size_t F,const size_t G,const size_t H)
+  /*!
+    If-then-else : (F G) : (-F H)
+    \param F :: Test node
+    \param G :: Node if F true
+    \param H :: Node if F false
+    \return node index
+  */
+{
+  if (F==trueNode) return G;
+  if (F==falseNode) return H;
+  if (G==H) return G;
+  if (G==trueNode && H==falseNode) return F;
+
+  const bddKey K(F,G,H);
+  std::map<bddKey,size_t>::const_iterator mc=Computed.find(K);
+  if (mc!=Computed.end())
+    return mc->second;
+
+  // Nodes can move as the vector grows : take copies
+  const bddNode FN=Nodes[F];
+  const bddNode GN=Nodes[G];
+  const bddNode HN=Nodes[H];
+  const size_t L=std::min(FN.level,std::min(GN.level,HN.level));
+
+  const size_t hiN=ite((FN.level==L) ? FN.hi : F,
+		       (GN.level==L) ? GN.hi : G,
+		       (HN.level==L) ? HN.hi : H);
+  const size_t loN=ite((FN.level==L) ? FN.lo : F,
+		       (GN.level==L) ? GN.lo : G,
+		       (HN.level==L) ? HN.lo : H);
+  const size_t index=makeNode(L,loN,hiN);
+  Computed.insert(std::map<bddKey,size_t>::value_type(K,index));
+  return index;
+}
+
+size_t
+RuleBDD::andNode(const size_t A,const size_t B)
+  /*!
+    Intersection of two nodes
+    \param A :: Node
+    \param B :: Node
+    \return A B
+  */
+{
+  return ite(A,B,falseNode);
+}
+
+size_t
+RuleBDD::orNode(const size_t A,const size_t B)
+  /*!
+    Union of two nodes
+    \param A :: Node
+    \param B :: Node
+    \return A : B
+  */
+{
+  return ite(A,trueNode,B);
+}
+
+size_t
+RuleBDD::notNode(const size_t A)
+  /*!
+    Complement of a node
+    \param A :: Node
+    \return #A
+  */
+{
+  return ite(A,falseNode,trueNode);
+}
+
+const Rule*
+RuleBDD::cellRule(const int cellN,const OTYPE& OList) const
+  /*!
+    Get the rule of a cell used as #N / %N
+    \param cellN :: Cell number
+    \param OList :: Cell map
+    \return top rule of the cell
+  */
+{
+  OTYPE::const_iterator vc=OList.find(cellN);
+  if (vc==OList.end() || !vc->second->topRule())
+    throw ColErr::InContainerError<int>
+      (cellN,"RuleBDD::cellRule unknown complementary unit");
+  if (Active.find(cellN)!=Active.end())
+    throw ColErr::InContainerError<int>
+      (cellN,"RuleBDD::cellRule cyclic complementary unit");
+  return vc->second->topRule();
+}
+
+size_t
+RuleBDD::cellNode(const int cellN,const OTYPE& OList)
+  /*!
+    Get the node of a cell [built once]
+    \param cellN :: Cell number
+    \param OList :: Cell map
+    \return node index
+  */
+{
+  std::map<int,size_t>::const_iterator mc=CellNode.find(cellN);
+  if (mc!=CellNode.end())
+    return mc->second;
+
+  const Rule* RPtr=cellRule(cellN,OList);
+  Active.insert(cellN);
+  const size_t index=build(RPtr,OList);
+  Active.erase(cellN);
+  CellNode.insert(std::map<int,size_t>::value_type(cellN,index));
+  return index;
+}
+
+size_t
+RuleBDD::build(const Rule* RPtr,const OTYPE& OList)
+  /*!
+    Convert a rule tree into a node
+    \param RPtr :: Rule to convert
+    \param OList :: Cell map [for #N/%N]
+    \return node index
+  */
+{
+  if (!RPtr)
+    throw ColErr::EmptyValue<void>("RuleBDD::build rule");
+
+  if (const SurfPoint* SPtr=dynamic_cast<const SurfPoint*>(RPtr))
+    return surfNode(SPtr->getSign()*SPtr->getKeyN());
+
+  if (RPtr->type())
+    {
+      // first leaf first to follow the cell order
+      const size_t A=build(RPtr->leaf(0),OList);
+      const size_t B=build(RPtr->leaf(1),OList);
+      return (RPtr->type()==1) ? andNode(A,B) : orNode(A,B);
+    }
+  if (dynamic_cast<const CompGrp*>(RPtr))
+    return notNode(build(RPtr->leaf(0),OList));
+  if (dynamic_cast<const ContGrp*>(RPtr))
+    return build(RPtr->leaf(0),OList);
+  if (const CompObj* CPtr=dynamic_cast<const CompObj*>(RPtr))
+    return notNode(cellNode(CPtr->getObjN(),OList));
+  if (const ContObj* CPtr=dynamic_cast<const ContObj*>(RPtr))
+    return cellNode(CPtr->getObjN(),OList);
+
+  throw ColErr::InvalidLine(RPtr->display(),"RuleBDD::build rule type",0);
+}
+
+size_t
+RuleBDD::substitute(const size_t F,const size_t D,const size_t value,
+		    std::map<size_t,size_t>& Done)
+  /*!
+    Replace node D in the graph below F by a terminal
+    \param F :: Node to rebuild
+    \param D :: Node to replace
+    \param value :: Terminal to use
+    \param Done :: Nodes already rebuilt
+    \return node index
+  */
+{
+  if (F==D) return value;
+  if (F==falseNode || F==trueNode) return F;
+
+  std::map<size_t,size_t>::const_iterator mc=Done.find(F);
+  if (mc!=Done.end())
+    return mc->second;
+
+  const bddNode FN=Nodes[F];
+  const size_t loN=substitute(FN.lo,D,value,Done);
+  const size_t hiN=substitute(FN.hi,D,value,Done);
+  const size_t index=makeNode(FN.level,loN,hiN);
+  Done.insert(std::map<size_t,size_t>::value_type(F,index));
+  return index;
+}
+
+size_t
+RuleBDD::findDominator(const size_t F,const size_t termN) const
+  /*!
+    Find the top node (other than F) that is on every
+    path from F to a terminal. The paths through each
+    node are counted: from F to the node and from
+    the node to the terminal.
+    \param F :: Top node
+    \param termN :: Terminal [true/false]
+    \return node index [0 if none]
+  */
+{
+  // Reachable nodes in level order
+  std::vector<std::pair<size_t,size_t> > Order;
+  std::set<size_t> Seen;
+  std::vector<size_t> Stack;
+  Stack.push_back(F);
+  Seen.insert(F);
+  while(!Stack.empty())
+    {
+      const size_t N=Stack.back();
+      Stack.pop_back();
+      Order.push_back(std::pair<size_t,size_t>(Nodes[N].level,N));
+      const size_t Child[2]={Nodes[N].lo,Nodes[N].hi};
+      for(size_t i=0;i<2;i++)
+	if (Child[i]>trueNode && Seen.insert(Child[i]).second)
+	  Stack.push_back(Child[i]);
+    }
+  std::sort(Order.begin(),Order.end());
+
+  std::map<size_t,double> From;
+  std::map<size_t,double> To;
+  To[falseNode]=(termN==falseNode) ? 1.0 : 0.0;
+  To[trueNode]=(termN==trueNode) ? 1.0 : 0.0;
+  From[F]=1.0;
+  for(size_t i=0;i<Order.size();i++)
+    {
+      const bddNode& N=Nodes[Order[i].second];
+      const double fN=From[Order[i].second];
+      From[N.lo]+=fN;
+      From[N.hi]+=fN;
+    }
+  for(size_t i=Order.size();i>0;i--)
+    {
+      const bddNode& N=Nodes[Order[i-1].second];
+      To[Order[i-1].second]=To[N.lo]+To[N.hi];
+    }
+
+  const double total=To[F];
+  for(size_t i=1;i<Order.size();i++)
+    {
+      const size_t N=Order[i].second;
+      if (To[N]>0.5 && From[N]*To[N]==total)
+	return N;
+    }
+  return 0;
+}
+
+Rule*
+RuleBDD::joinRule(Rule* A,Rule* B,const int typeFlag)
+  /*!
+    Join two rules written as "A B" or "A : B".
+    If either rule is missing both are deleted.
+    \param A :: First rule [ownership taken]
+    \param B :: Second rule [ownership taken]
+    \param typeFlag :: 1 for intersection / -1 for union
+    \return joined rule [0 on failure]
+  */
+{
+  if (!A || !B)
+    {
+      delete A;
+      delete B;
+      return 0;
+    }
+  // Intersection holds its leaves reversed
+  if (typeFlag==1)
+    return new Intersection(B,A);
+  return new Union(A,B);
+}
+
+Rule*
+RuleBDD::literal(const size_t L,const int sign,size_t& nLiteral) const
+  /*!
+    Make a surface of a level
+    \param L :: Level
+    \param sign :: Sense of the surface
+    \param nLiteral :: Literals left [decremented]
+    \return SurfPoint [0 if no literals left]
+  */
+{
+  if (!nLiteral) return 0;
+  nLiteral--;
+  return new SurfPoint(0,sign*LevelSurf[L]);
+}
+
+Rule*
+RuleBDD::emitRule(const size_t F,size_t& nLiteral)
+  /*!
+    Write a node as a rule tree. Single surface terms
+    are taken off first then common factors. If neither
+    exists the node is split on its top surface.
+    \param F :: Node to write [not terminal]
+    \param nLiteral :: Maximum number of surfaces to use
+    \return new rule [0 on failure]
+  */
+{
+  if (F==falseNode || F==trueNode) return 0;
+
+  const bddNode FN=Nodes[F];
+  if (FN.lo==falseNode && FN.hi==trueNode)
+    return literal(FN.level,1,nLiteral);
+  if (FN.lo==trueNode && FN.hi==falseNode)
+    return literal(FN.level,-1,nLiteral);
+
+  if (FN.lo==falseNode)
+    return joinRule(literal(FN.level,1,nLiteral),
+		    emitRule(FN.hi,nLiteral),1);
+  if (FN.hi==falseNode)
+    return joinRule(literal(FN.level,-1,nLiteral),
+		    emitRule(FN.lo,nLiteral),1);
+  if (FN.hi==trueNode)
+    return joinRule(literal(FN.level,1,nLiteral),
+		    emitRule(FN.lo,nLiteral),-1);
+  if (FN.lo==trueNode)
+    return joinRule(literal(FN.level,-1,nLiteral),
+		    emitRule(FN.hi,nLiteral),-1);
+
+  // F == F[D->1] D
+  size_t D=findDominator(F,trueNode);
+  if (D)
+    {
+      std::map<size_t,size_t> Done;
+      const size_t FA=substitute(F,D,trueNode,Done);
+      return joinRule(emitRule(FA,nLiteral),emitRule(D,nLiteral),1);
+    }
+  // F == F[D->0] : D
+  D=findDominator(F,falseNode);
+  if (D)
+    {
+      std::map<size_t,size_t> Done;
+      const size_t FA=substitute(F,D,falseNode,Done);
+      return joinRule(emitRule(FA,nLiteral),emitRule(D,nLiteral),-1);
+    }
+
+  Rule* hiRule=joinRule(literal(FN.level,1,nLiteral),
+			emitRule(FN.hi,nLiteral),1);
+  Rule* loRule=joinRule(literal(FN.level,-1,nLiteral),
+			emitRule(FN.lo,nLiteral),1);
+  return joinRule(hiRule,loRule,-1);
+}
+
+Rule*
+RuleBDD::makeRule(const size_t F)
+  /*!
+    Write a node as a rule tree
+    \param F :: Node
+    \return new rule [0 for a terminal]
+  */
+{
+  ELog::RegMethod RegA("RuleBDD","makeRule");
+
+  if (F>=Nodes.size())
+    throw ColErr::IndexError<size_t>(F,Nodes.size(),RegA.getBase());
+
+  size_t nLiteral=std::numeric_limits<size_t>::max();
+  return emitRule(F,nLiteral);
+}
+
+void
+RuleBDD::expandGroup(const Rule* RPtr,const OTYPE& OList,
+		     const int compFlag,const int groupType,
+		     std::vector<Rule*>& Items,std::set<int>& Surf)
+  /*!
+    Add the expanded rule to a group of intersections/unions.
+    Sub-rules of the same type are merged into the group
+    and repeated surfaces are dropped.
+    \param RPtr :: Rule to copy
+    \param OList :: Cell map
+    \param compFlag :: The rule is complemented
+    \param groupType :: Type of the group [0 for none]
+    \param Items :: Rules of the group
+    \param Surf :: Signed surfaces of the group
+  */
+{
+  if (!RPtr)
+    throw ColErr::EmptyValue<void>("RuleBDD::expandGroup rule");
+
+  if (const SurfPoint* SPtr=dynamic_cast<const SurfPoint*>(RPtr))
+    {
+      const int SN=(compFlag) ? -SPtr->getSign()*SPtr->getKeyN() :
+	SPtr->getSign()*SPtr->getKeyN();
+      if (Surf.insert(SN).second)
+	Items.push_back(new SurfPoint(0,SN));
+      return;
+    }
+
+  if (RPtr->type())
+    {
+      const int T=(compFlag) ? -RPtr->type() : RPtr->type();
+      if (T==groupType)
+	{
+	  expandGroup(RPtr->leaf(0),OList,compFlag,T,Items,Surf);
+	  expandGroup(RPtr->leaf(1),OList,compFlag,T,Items,Surf);
+	  return;
+	}
+      // new group
+      std::vector<Rule*> subItems;
+      std::set<int> subSurf;
+      expandGroup(RPtr->leaf(0),OList,compFlag,T,subItems,subSurf);
+      expandGroup(RPtr->leaf(1),OList,compFlag,T,subItems,subSurf);
+      Rule* Out=subItems[0];
+      for(size_t i=1;i<subItems.size();i++)
+	Out=joinRule(Out,subItems[i],T);
+      Items.push_back(Out);
+      return;
+    }
+
+  if (dynamic_cast<const CompGrp*>(RPtr))
+    {
+      expandGroup(RPtr->leaf(0),OList,!compFlag,groupType,Items,Surf);
+      return;
+    }
+  if (dynamic_cast<const ContGrp*>(RPtr))
+    {
+      expandGroup(RPtr->leaf(0),OList,compFlag,groupType,Items,Surf);
+      return;
+    }
+
+  int cellN(0);
+  int cellComp(compFlag);
+  if (const CompObj* CPtr=dynamic_cast<const CompObj*>(RPtr))
+    {
+      cellN=CPtr->getObjN();
+      cellComp=!compFlag;
+    }
+  else if (const ContObj* CPtr=dynamic_cast<const ContObj*>(RPtr))
+    cellN=CPtr->getObjN();
+  else
+    throw ColErr::InvalidLine(RPtr->display(),
+			      "RuleBDD::expandGroup rule type",0);
+
+  const Rule* cellPtr=cellRule(cellN,OList);
+  Active.insert(cellN);
+  expandGroup(cellPtr,OList,cellComp,groupType,Items,Surf);
+  Active.erase(cellN);
+  return;
+}
+
+Rule*
+RuleBDD::expandRule(const Rule* RPtr,const OTYPE& OList)
+  /*!
+    Copy a rule with each #N/%N replaced by the cell rule
+    and the complements moved down to the surfaces
+    \param RPtr :: Rule to copy
+    \param OList :: Cell map
+    \return new rule
+  */
+{
+  std::vector<Rule*> Items;
+  std::set<int> Surf;
+  expandGroup(RPtr,OList,0,0,Items,Surf);
+  return Items.front();
+}
+
+Rule*
+RuleBDD::removeComplement(const Rule* RPtr,const OTYPE& OList)
+  /*!
+    Remove the complements (#N and #( )) from a cell rule.
+    The node of the rule is written out if it needs
+    fewer surfaces than the direct expansion.
+    \param RPtr :: Cell rule
+    \param OList :: Cell map
+    \return new rule [without complements]
+  */
+{
+  ELog::RegMethod RegA("RuleBDD","removeComplement");
+
+  Rule* Expand=expandRule(RPtr,OList);
+  const size_t F=build(RPtr,OList);
+  size_t nLiteral=countLiterals(Expand);
+  if (F==falseNode || F==trueNode || nLiteral<2)
+    return Expand;
+
+  nLiteral--;
+  Rule* Out=emitRule(F,nLiteral);
+  // Check the written rule is the same node
+  if (Out && build(Out,OList)==F)
+    {
+      delete Expand;
+      return Out;
+    }
+  delete Out;
+  return Expand;
+}
+
+size_t
+RuleBDD::countLiterals(const Rule* RPtr)
+  /*!
+    Count the surfaces in a rule
+    \param RPtr :: Rule
+    \return number of SurfPoint
+  */
+{
+  if (!RPtr) return 0;
+  if (RPtr->type())
+    return countLiterals(RPtr->leaf(0))+countLiterals(RPtr->leaf(1));
+  if (dynamic_cast<const SurfPoint*>(RPtr))
+    return 1;
+  return countLiterals(RPtr->leaf(0));
+}
+
+size_t
+RuleBDD::countLiterals(const Rule* RPtr,const OTYPE& OList)
+  /*!
+    Estimate the size of a rule with the #N/%N cells
+    [only one level of cells is followed]
+    \param RPtr :: Rule
+    \param OList :: Cell map
+    \return number of SurfPoint
+  */
+{
+  if (!RPtr) return 0;
+  if (RPtr->type())
+    return countLiterals(RPtr->leaf(0),OList)+
+      countLiterals(RPtr->leaf(1),OList);
+  if (dynamic_cast<const SurfPoint*>(RPtr))
+    return 1;
+
+  int cellN(0);
+  if (const CompObj* CPtr=dynamic_cast<const CompObj*>(RPtr))
+    cellN=CPtr->getObjN();
+  else if (const ContObj* CPtr=dynamic_cast<const ContObj*>(RPtr))
+    cellN=CPtr->getObjN();
+  else
+    return countLiterals(RPtr->leaf(0),OList);
+
+  OTYPE::const_iterator vc=OList.find(cellN);
+  return (vc!=OList.end()) ? countLiterals(vc->second->topRule()) : 1;
+}
+
+} // NAMESPACE MonteCarlo
@@ -0,0 +1,906 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   monte/RuleCode.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <complex>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Surface.h"
+#include "Quadratic.h"
+#include "Plane.h"
+#include "Sphere.h"
+#include "Cylinder.h"
+#include "SenseCache.h"
+#include "Rules.h"
+#include "RuleCode.h"
+
+/*!
+  \struct directSide
+  \brief Surface sides evaluated directly
+*/
+struct directSide
+{
+  const Geometry::Vec3D& Pt;     ///< Point to test
+
+  /// Constructor
+  explicit directSide(const Geometry::Vec3D& P) : Pt(P) {}
+
+  /// Point access
+  const Geometry::Vec3D& getPoint() const { return Pt; }
+  /// Surface side
+  int side(const Geometry::Surface* SPtr) const
+    { return SPtr->side(Pt); }
+};
+
+/*!
+  \struct cacheSide
+  \brief Surface sides taken from a SenseCache
+*/
+struct cacheSide
+{
+  Geometry::SenseCache& SC;      ///< Cache [holds point]
+
+  /// Constructor
+  explicit cacheSide(Geometry::SenseCache& S) : SC(S) {}
+
+  /// Point access
+  const Geometry::Vec3D& getPoint() const { return SC.getPoint(); }
+  /// Surface side
+  int side(const Geometry::Surface* SPtr) const
+    { return SC.side(SPtr); }
+};
+
+/*!
+  \struct validLeaf
+  \brief Leaf values for isValid(Pt)
+*/
+template<typename SideTYPE>
+struct validLeaf
+{
+  const SideTYPE& SD;            ///< Side evaluator
+
+  /// Constructor
+  explicit validLeaf(const SideTYPE& S) : SD(S) {}
+
+  /// Surface value
+  int surf(const Geometry::Surface* SPtr,const int,const int sign,
+	   const size_t) const
+    { return (SD.side(SPtr)*sign>=0) ? 3 : 0; }
+  /// Rule value
+  int rule(const Rule* RPtr) const
+    { return (RPtr->isValid(SD.getPoint())) ? 3 : 0; }
+};
+
+/*!
+  \struct exclLeaf
+  \brief Leaf values for isValid(Pt,ExSN)
+*/
+template<typename SideTYPE>
+struct exclLeaf
+{
+  const SideTYPE& SD;            ///< Side evaluator
+  const int ExSN;                ///< Excluded surface [abs]
+
+  /// Constructor
+  exclLeaf(const SideTYPE& S,const int SN) :
+    SD(S),ExSN(abs(SN)) {}
+
+  /// Surface value
+  int surf(const Geometry::Surface* SPtr,const int keyN,
+	   const int sign,const size_t) const
+    {
+      if (keyN==ExSN) return 3;
+      return (SD.side(SPtr)*sign>=0) ? 3 : 0;
+    }
+  /// Rule value
+  int rule(const Rule* RPtr) const
+    { return (RPtr->isValid(SD.getPoint(),ExSN)) ? 3 : 0; }
+};
+
+/*!
+  \struct dirLeaf
+  \brief Leaf values for isDirectionValid(Pt,ExSN)
+*/
+template<typename SideTYPE>
+struct dirLeaf
+{
+  const SideTYPE& SD;            ///< Side evaluator
+  const int ExSN;                ///< Excluded surface [signed]
+
+  /// Constructor
+  dirLeaf(const SideTYPE& S,const int SN) :
+    SD(S),ExSN(SN) {}
+
+  /// Surface value
+  int surf(const Geometry::Surface* SPtr,const int keyN,
+	   const int sign,const size_t) const
+    {
+      if (keyN==abs(ExSN)) return (sign*ExSN>0) ? 3 : 0;
+      return (SD.side(SPtr)*sign>=0) ? 3 : 0;
+    }
+  /// Rule value
+  int rule(const Rule* RPtr) const
+    { return (RPtr->isDirectionValid(SD.getPoint(),ExSN)) ? 3 : 0; }
+};
+
+/*!
+  \struct pairLeaf
+  \brief Leaf values for pairValid(SN,Pt)
+*/
+template<typename SideTYPE>
+struct pairLeaf
+{
+  const SideTYPE& SD;            ///< Side evaluator
+  const int SN;                  ///< Alternating surface [signed]
+
+  /// Constructor
+  pairLeaf(const SideTYPE& S,const int N) :
+    SD(S),SN(N) {}
+
+  /// Surface value
+  int surf(const Geometry::Surface* SPtr,const int keyN,
+	   const int sign,const size_t) const
+    {
+      if (keyN==abs(SN)) return (sign>0) ? 2 : 1;
+      return (SD.side(SPtr)*sign>=0) ? 3 : 0;
+    }
+  /// Rule value
+  int rule(const Rule* RPtr) const
+    { return RPtr->pairValid(SN,SD.getPoint()); }
+};
+
+/*!
+  \struct trackLeaf
+  \brief Leaf values for pairValid at a point on the track
+*/
+struct trackLeaf
+{
+  const Geometry::Vec3D& Pt;     ///< Point to test
+  const double D;                ///< Distance of Pt along the track
+  const double PtScale;          ///< 1+|Pt| [rounding of direct side]
+  const int SN;                  ///< Alternating surface [signed]
+  const int* Mode;               ///< Line type of each slot
+  const double* Coef;            ///< Line coefficients of each slot
+
+  /// Constructor
+  trackLeaf(const Geometry::Vec3D& P,const double DV,const int N,
+	    const int* M,const double* C) :
+    Pt(P),D(DV),PtScale(1.0+fabs(P[0])+fabs(P[1])+fabs(P[2])),
+    SN(N),Mode(M),Coef(C) {}
+
+  /// Surface value
+  int surf(const Geometry::Surface* SPtr,const int keyN,
+	   const int sign,const size_t slot) const
+    {
+      if (keyN==abs(SN)) return (sign>0) ? 2 : 1;
+      int sideV=(Mode[slot]) ?
+	RuleCode::lineSide(Mode[slot],Coef+5*slot,D,PtScale) : 2;
+      if (sideV==2)
+	sideV=SPtr->side(Pt);
+      return (sideV*sign>=0) ? 3 : 0;
+    }
+  /// Rule value
+  int rule(const Rule* RPtr) const
+    { return RPtr->pairValid(SN,Pt); }
+};
+
+std::ostream&
+operator<<(std::ostream& OX,const RuleCode& A)
+  /*!
+    Standard output stream
+    \param OX :: Output stream
+    \param A :: RuleCode to write
+    \return Stream State
+   */
+{
+  A.write(OX);
+  return OX;
+}
+
+const double RuleCode::lineGuard(1e-12);
+
+RuleCode::RuleCode() :
+  maxDepth(0),serial(nextSerial())
+  /*!
+    Constructor
+  */
+{}
+
+RuleCode::RuleCode(const RuleCode& A) :
+  Code(A.Code),maxDepth(A.maxDepth),
+  SlotSurf(A.SlotSurf),SlotType(A.SlotType),serial(nextSerial())
+  /*!
+    Copy constructor
+    \param A :: RuleCode to copy
+  */
+{}
+
+RuleCode&
+RuleCode::operator=(const RuleCode& A)
+  /*!
+    Assignment operator
+    \param A :: RuleCode to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      Code=A.Code;
+      maxDepth=A.maxDepth;
+      SlotSurf=A.SlotSurf;
+      SlotType=A.SlotType;
+      serial=nextSerial();
+    }
+  return *this;
+}
+
+void
+RuleCode::clear()
+  /*!
+    Remove the program
+  */
+{
+  Code.clear();
+  maxDepth=0;
+  SlotSurf.clear();
+  SlotType.clear();
+  serial=nextSerial();
+  return;
+}
+
+void
+RuleCode::addOp(const int op,const size_t jump)
+  /*!
+    Add a non-leaf operation
+    \param op :: Operation type
+    \param jump :: Jump target / constant value
+  */
+{
+  RuleOp Item;
+  Item.op=op;
+  Item.sign=0;
+  Item.keyN=0;
+  Item.slot=0;
+  Item.jump=jump;
+  Item.SPtr=0;
+  Item.RPtr=0;
+  Code.push_back(Item);
+  return;
+}
+
+size_t
+RuleCode::addSlot(const Geometry::Surface* SPtr)
+  /*!
+    Get the slot of a surface, adding it if new.
+    The line type is set from the surface class.
+    \param SPtr :: Surface 
+    \return slot index
+  */
+{
+  for(size_t i=0;i<SlotSurf.size();i++)
+    if (SlotSurf[i]==SPtr) return i;
+
+  const std::string CName=SPtr->className();
+  int LType(lineDirect);
+  if (CName=="Plane")
+    LType=linePlane;
+  else if (CName=="General" || CName=="Quadratic")
+    LType=lineEqn;
+  else if (CName=="Sphere")
+    LType=lineSphere;
+  else if (CName=="Cylinder")
+    LType=lineCyl;
+
+  SlotSurf.push_back(SPtr);
+  SlotType.push_back(LType);
+  return SlotSurf.size()-1;
+}
+
+int
+RuleCode::compile(const Rule* RPtr,const size_t depth)
+  /*!
+    Add the code for a rule. The result of the rule is
+    left in the value register.
+    \param RPtr :: Rule to compile
+    \param depth :: Current stack depth
+    \return 1 on success / 0 if the rule cannot be compiled
+  */
+{
+  if (!RPtr) return 0;
+  if (depth>maxDepth) maxDepth=depth;
+
+  const int RType=RPtr->type();
+  if (RType)        // Intersection / Union
+    {
+      // flatten the chain of the same type [left to right]
+      std::vector<const Rule*> Items;
+      std::vector<const Rule*> RStack;
+      RStack.push_back(RPtr);
+      while(!RStack.empty())
+	{
+	  const Rule* Ptr=RStack.back();
+	  RStack.pop_back();
+	  if (Ptr->type()==RType)
+	    {
+	      if (!Ptr->leaf(0) || !Ptr->leaf(1))
+		return 0;
+	      RStack.push_back(Ptr->leaf(1));
+	      RStack.push_back(Ptr->leaf(0));
+	    }
+	  else
+	    Items.push_back(Ptr);
+	}
+
+      const int jumpOp=(RType==1) ? opJZero : opJAll;
+      const int joinOp=(RType==1) ? opAnd : opOr;
+      std::vector<size_t> JumpIndex;
+      if (!compile(Items[0],depth))
+	return 0;
+      for(size_t i=1;i<Items.size();i++)
+	{
+	  JumpIndex.push_back(Code.size());
+	  addOp(jumpOp);
+	  addOp(opPush);
+	  if (!compile(Items[i],depth+1))
+	    return 0;
+	  addOp(joinOp);
+	}
+      for(size_t i=0;i<JumpIndex.size();i++)
+	Code[JumpIndex[i]].jump=Code.size();
+      return 1;
+    }
+
+  const SurfPoint* SurX=dynamic_cast<const SurfPoint*>(RPtr);
+  if (SurX)
+    {
+      if (!SurX->getKey()) return 0;
+      RuleOp Item;
+      Item.op=opSurf;
+      Item.sign=SurX->getSign();
+      Item.keyN=SurX->getKeyN();
+      Item.slot=addSlot(SurX->getKey());
+      Item.jump=0;
+      Item.SPtr=SurX->getKey();
+      Item.RPtr=0;
+      Code.push_back(Item);
+      return 1;
+    }
+
+  const CompGrp* CG=dynamic_cast<const CompGrp*>(RPtr);
+  if (CG)
+    {
+      if (!CG->leaf(0))
+	{
+	  addOp(opConst,3);
+	  return 1;
+	}
+      if (!compile(CG->leaf(0),depth))
+	return 0;
+      addOp(opNot);
+      return 1;
+    }
+
+  const BoolValue* BV=dynamic_cast<const BoolValue*>(RPtr);
+  if (BV)
+    {
+      addOp(opConst,(BV->isValid(Geometry::Vec3D())) ? 3 : 0);
+      return 1;
+    }
+
+  // Anything else is called directly
+  RuleOp Item;
+  Item.op=opRule;
+  Item.sign=0;
+  Item.keyN=0;
+  Item.slot=0;
+  Item.jump=0;
+  Item.SPtr=0;
+  Item.RPtr=RPtr;
+  Code.push_back(Item);
+  return 1;
+}
+
+int
+RuleCode::build(const Rule* RPtr)
+  /*!
+    Compile a rule tree. If the tree has null
+    parts then no program is made.
+    \param RPtr :: Top rule
+    \return 1 on success / 0 on failure [program empty]
+  */
+{
+  ELog::RegMethod RegA("RuleCode","build");
+
+  clear();
+  if (!RPtr) return 0;
+  if (!compile(RPtr,0))
+    {
+      clear();
+      return 0;
+    }
+  return 1;
+}
+
+template<typename LeafTYPE>
+int
+RuleCode::run(const LeafTYPE& Leaf) const
+  /*!
+    Run the program
+    \param Leaf :: Leaf value functor
+    \return final value [0-3]
+  */
+{
+  int fixedStack[64];
+  std::vector<int> largeStack;
+  int* SStack(fixedStack);
+  if (maxDepth>=64)
+    {
+      largeStack.resize(maxDepth+1);
+      SStack=&largeStack[0];
+    }
+
+  size_t SIndex(0);
+  int value(0);
+  const size_t NCode(Code.size());
+  size_t pc(0);
+  while(pc<NCode)
+    {
+      const RuleOp& Item=Code[pc];
+      switch (Item.op)
+	{
+	case opSurf:
+	  value=Leaf.surf(Item.SPtr,Item.keyN,Item.sign,Item.slot);
+	  break;
+	case opConst:
+	  value=static_cast<int>(Item.jump);
+	  break;
+	case opRule:
+	  value=Leaf.rule(Item.RPtr);
+	  break;
+	case opJZero:
+	  if (!value)
+	    {
+	      pc=Item.jump;
+	      continue;
+	    }
+	  break;
+	case opJAll:
+	  if (value==3)
+	    {
+	      pc=Item.jump;
+	      continue;
+	    }
+	  break;
+	case opPush:
+	  SStack[SIndex++]=value;
+	  break;
+	case opAnd:
+	  value&=SStack[--SIndex];
+	  break;
+	case opOr:
+	  value|=SStack[--SIndex];
+	  break;
+	case opNot:
+	  value=(~value) & 3;
+	  break;
+	}
+      pc++;
+    }
+  return value;
+}
+
+bool
+RuleCode::isValid(const Geometry::Vec3D& Pt) const
+  /*!
+    Calculate if a point is valid
+    \param Pt :: Point to test
+    \return true/false
+  */
+{
+  const directSide SD(Pt);
+  return (run(validLeaf<directSide>(SD))) ? 1 : 0;
+}
+
+bool
+RuleCode::isValid(const Geometry::Vec3D& Pt,const int ExSN) const
+  /*!
+    Calculate if a point is valid
+    \param Pt :: Point to test
+    \param ExSN :: Surface to treat as true
+    \return true/false
+  */
+{
+  const directSide SD(Pt);
+  return (run(exclLeaf<directSide>(SD,ExSN))) ? 1 : 0;
+}
+
+bool
+RuleCode::isDirectionValid(const Geometry::Vec3D& Pt,const int ExSN) const
+  /*!
+    Calculate if a point is valid
+    \param Pt :: Point to test
+    \param ExSN :: Surface to treat as true/false [based on sign]
+    \return true/false
+  */
+{
+  const directSide SD(Pt);
+  return (run(dirLeaf<directSide>(SD,ExSN))) ? 1 : 0;
+}
+
+int
+RuleCode::pairValid(const int SN,const Geometry::Vec3D& Pt) const
+  /*!
+    Calculate the valid state for both sides of a surface
+    \param SN :: Surface number to alternate on
+    \param Pt :: Point to test
+    \return valid(SN->false) : valid(SN->true)
+  */
+{
+  const directSide SD(Pt);
+  return run(pairLeaf<directSide>(SD,SN));
+}
+
+bool
+RuleCode::isValid(Geometry::SenseCache& SC) const
+  /*!
+    Calculate if the cache point is valid
+    \param SC :: Surface sense cache [holds point]
+    \return true/false
+  */
+{
+  const cacheSide SD(SC);
+  return (run(validLeaf<cacheSide>(SD))) ? 1 : 0;
+}
+
+bool
+RuleCode::isDirectionValid(Geometry::SenseCache& SC,const int ExSN) const
+  /*!
+    Calculate if the cache point is valid
+    \param SC :: Surface sense cache [holds point]
+    \param ExSN :: Surface to treat as true/false [based on sign]
+    \return true/false
+  */
+{
+  const cacheSide SD(SC);
+  return (run(dirLeaf<cacheSide>(SD,ExSN))) ? 1 : 0;
+}
+
+int
+RuleCode::pairValid(const int SN,Geometry::SenseCache& SC) const
+  /*!
+    Calculate the valid state for both sides of a surface
+    \param SN :: Surface number to alternate on
+    \param SC :: Surface sense cache [holds point]
+    \return valid(SN->false) : valid(SN->true)
+  */
+{
+  const cacheSide SD(SC);
+  return run(pairLeaf<cacheSide>(SD,SN));
+}
+
+size_t
+RuleCode::nextSerial()
+  /*!
+    Get a new program number. A track set by a program
+    is only used while the program keeps its number.
+    \return unique number
+  */
+{
+  static boost::mutex* MPtr=new boost::mutex;
+  static size_t serialCount(0);
+  boost::mutex::scoped_lock Lock(*MPtr);
+  return ++serialCount;
+}
+
+RuleCode::trackWork&
+RuleCode::threadWork()
+  /*!
+    Access the track coefficients of the calling thread.
+    The holder is never deleted [as RegMethod::getStack].
+    \return trackWork for this thread
+  */
+{
+  static boost::thread_specific_ptr<trackWork>* TSPtr=
+    new boost::thread_specific_ptr<trackWork>();
+  trackWork* TPtr=TSPtr->get();
+  if (!TPtr)
+    {
+      TPtr=new trackWork;
+      TPtr->owner=0;
+      TPtr->serial=0;
+      TSPtr->reset(TPtr);
+    }
+  return *TPtr;
+}
+
+void
+RuleCode::eqnCoef(const std::vector<double>& BN,
+		  const Geometry::Vec3D& Org,
+		  const Geometry::Vec3D& uVec,double* C)
+  /*!
+    Reduce a quadratic equation to C[0]+C[1]d+C[2]d^2 
+    along the line Org+d*uVec [as Line::intersect].
+    C[3] is the size of the equation coefficients.
+    \param BN :: Base equation
+    \param Org :: Line origin
+    \param uVec :: Line direction
+    \param C :: Coefficients [4]
+  */
+{
+  const double a(Org[0]),b(Org[1]),c(Org[2]);
+  const double d(uVec[0]),e(uVec[1]),f(uVec[2]);
+  C[2]= BN[0]*d*d+BN[1]*e*e+BN[2]*f*f+
+    BN[3]*d*e+BN[4]*d*f+BN[5]*e*f;
+  C[1]= 2*BN[0]*a*d+2*BN[1]*b*e+2*BN[2]*c*f+
+    BN[3]*(a*e+b*d)+BN[4]*(a*f+c*d)+BN[5]*(b*f+c*e)+
+    BN[6]*d+BN[7]*e+BN[8]*f;
+  C[0]= BN[0]*a*a+BN[1]*b*b+BN[2]*c*c+
+    BN[3]*a*b+BN[4]*a*c+BN[5]*b*c+BN[6]*a+BN[7]*b+
+    BN[8]*c+BN[9];
+  C[3]=0.0;
+  for(size_t i=0;i<10;i++)
+    C[3]+=fabs(BN[i]);
+  return;
+}
+
+void
+RuleCode::setTrack(const Geometry::Vec3D& Org,
+		   const Geometry::Vec3D& uVec) const
+  /*!
+    Reduce each surface slot to a function of the 
+    distance along the line Org+d*uVec. The result is
+    held per thread until the next setTrack.
+    \param Org :: Line origin
+    \param uVec :: Line direction [unit]
+  */
+{
+  trackWork& TW=threadWork();
+  const size_t NSlot(SlotSurf.size());
+  TW.owner=this;
+  TW.serial=serial;
+  for(size_t i=0;i<3;i++)
+    {
+      TW.Line[i]=Org[i];
+      TW.Line[i+3]=uVec[i];
+    }
+  TW.Mode.resize(NSlot);
+  TW.Gen.resize(NSlot);
+  TW.Coef.resize(5*NSlot);
+  for(size_t i=0;i<NSlot;i++)
+    {
+      TW.Gen[i]=SlotSurf[i]->getGeneration();
+      double* C= &TW.Coef[5*i];
+      TW.Mode[i]=SlotType[i];
+      switch (SlotType[i])
+	{
+	case linePlane:
+	  {
+	    const Geometry::Plane* PPtr=
+	      static_cast<const Geometry::Plane*>(SlotSurf[i]);
+	    C[0]=PPtr->getNormal().dotProd(Org)-PPtr->getDistance();
+	    C[1]=PPtr->getNormal().dotProd(uVec);
+	    break;
+	  }
+	case lineEqn:
+	  eqnCoef(static_cast<const Geometry::Quadratic*>(SlotSurf[i])
+		  ->copyBaseEqn(),Org,uVec,C);
+	  break;
+	case lineSphere:
+	  {
+	    const Geometry::Sphere* SPtr=
+	      static_cast<const Geometry::Sphere*>(SlotSurf[i]);
+	    const Geometry::Vec3D X=Org-SPtr->getCentre();
+	    C[0]=X.dotProd(X)-SPtr->getRadius()*SPtr->getRadius();
+	    C[1]=2.0*X.dotProd(uVec);
+	    C[2]=uVec.dotProd(uVec);
+	    C[3]=1.0+SPtr->getCentre().abs();
+	    break;
+	  }
+	case lineCyl:
+	  {
+	    const Geometry::Cylinder* CPtr=
+	      static_cast<const Geometry::Cylinder*>(SlotSurf[i]);
+	    const int NV=CPtr->getNvec();
+	    if (NV)
+	      {
+		const size_t ix(static_cast<size_t>(NV % 3));
+		const size_t iy(static_cast<size_t>((NV+1) % 3));
+		C[0]=Org[ix]-CPtr->getCentre()[ix];
+		C[1]=uVec[ix];
+		C[2]=Org[iy]-CPtr->getCentre()[iy];
+		C[3]=uVec[iy];
+		C[4]=CPtr->getRadius()*CPtr->getRadius();
+	      }
+	    else
+	      {
+		TW.Mode[i]=lineEqn;
+		eqnCoef(CPtr->copyBaseEqn(),Org,uVec,C);
+	      }
+	    break;
+	  }
+	}
+    }
+  return;
+}
+
+int
+RuleCode::lineSide(const int mode,const double* C,const double D,
+		   const double PtScale)
+  /*!
+    Side of a surface at distance D along the track.
+    The tolerances are those of the surface side functions.
+    The line value is rounded differently from the surface
+    value at the point, so a value within the rounding of 
+    either of a tolerance edge is not decided here.
+    \param mode :: Line type [not lineDirect]
+    \param C :: Coefficients of the slot
+    \param D :: Distance along the track
+    \param PtScale :: 1+|Pt| of the point at D
+    \return side [-1,0,1] / 2 if the surface must be tested
+  */
+{
+  double value(0.0);
+  double scale(0.0);
+  double tol(0.0);
+  switch (mode)
+    {
+    case linePlane:
+      value=C[0]+D*C[1];
+      scale=fabs(C[0])+fabs(D*C[1])+PtScale;
+      tol=Geometry::zeroTol;
+      break;
+    case lineEqn:
+      value=C[0]+D*(C[1]+D*C[2]);
+      scale=fabs(C[0])+fabs(D*C[1])+fabs(D*D*C[2])+
+	C[3]*PtScale*PtScale;
+      tol=Geometry::zeroTol;
+      break;
+    case lineSphere:
+      value=C[0]+D*(C[1]+D*C[2]);
+      scale=fabs(C[0])+fabs(D*C[1])+fabs(D*D*C[2])+
+	C[3]*PtScale*PtScale;
+      break;
+    case lineCyl:
+      {
+	const double x=C[0]+D*C[1];
+	const double y=C[2]+D*C[3];
+	const double xs=fabs(C[0])+fabs(D*C[1]);
+	const double ys=fabs(C[2])+fabs(D*C[3]);
+	value=x*x+y*y-C[4];
+	scale=xs*xs+ys*ys+C[4]+PtScale*PtScale;
+	tol=Geometry::parallelTol;
+	break;
+      }
+    default:
+      return 2;
+    }
+  if (fabs(fabs(value)-tol)<=lineGuard*scale)
+    return 2;
+  if (fabs(value)<tol)
+    return 0;
+  return (value>0.0) ? 1 : -1;
+}
+
+bool
+RuleCode::isCurrent(const trackWork& TW) const
+  /*!
+    Determine if a track was set by this program and is 
+    still current. It is stale if the program is rebuilt 
+    or copied, if one of its surfaces is moved, or if 
+    another program has set a track.
+    \param TW :: Track of the calling thread
+    \return true if the track can be used
+  */
+{
+  if (TW.owner!=this || TW.serial!=serial || 
+      SlotSurf.empty() || TW.Gen.size()!=SlotSurf.size())
+    return 0;
+  for(size_t i=0;i<SlotSurf.size();i++)
+    if (TW.Gen[i]!=SlotSurf[i]->getGeneration())
+      return 0;
+  return 1;
+}
+
+bool
+RuleCode::hasTrack() const
+  /*!
+    Determine if the track of the calling thread can
+    be used by trackPairValid
+    \return true if the track is current
+  */
+{
+  return isCurrent(threadWork());
+}
+
+int
+RuleCode::trackPairValid(const int SN,const Geometry::Vec3D& Pt,
+			 const double D) const
+  /*!
+    Calculate the valid state for both sides of a surface
+    at a point on the track given to setTrack. The surface
+    sides are found from the line coefficients. If the
+    track is stale or Pt is not at D on it the surface 
+    sides are calculated directly.
+    \param SN :: Surface number to alternate on
+    \param Pt :: Point to test
+    \param D :: Distance of Pt along the track
+    \return valid(SN->false) : valid(SN->true)
+  */
+{
+  const trackWork& TW=threadWork();
+  if (!isCurrent(TW))
+    return pairValid(SN,Pt);
+  // Point must be on the track 
+  double offLine(0.0);
+  for(size_t i=0;i<3;i++)
+    offLine+=fabs(Pt[i]-TW.Line[i]-D*TW.Line[i+3]);
+  if (offLine>Geometry::zeroTol*(1.0+fabs(D)))
+    return pairValid(SN,Pt);
+  return run(trackLeaf(Pt,D,SN,&TW.Mode[0],&TW.Coef[0]));
+}
+
+void
+RuleCode::write(std::ostream& OX) const
+  /*!
+    Write out the program
+    \param OX :: Output stream
+  */
+{
+  static const char* opName[]=
+    { "SURF","CONST","RULE","JZERO","JALL","PUSH","AND","OR","NOT" };
+
+  for(size_t i=0;i<Code.size();i++)
+    {
+      const RuleOp& Item=Code[i];
+      OX<<std::setw(4)<<i<<" "<<opName[Item.op];
+      if (Item.op==opSurf)
+	OX<<" "<<Item.sign*Item.keyN;
+      else if (Item.op==opRule)
+	OX<<" "<<Item.RPtr->display();
+      else if (Item.op!=opPush && Item.op!=opAnd &&
+	       Item.op!=opOr && Item.op!=opNot)
+	OX<<" "<<Item.jump;
+      OX<<std::endl;
+    }
+  return;
+}
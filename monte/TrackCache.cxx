@@ -0,0 +1,209 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   monte/TrackCache.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "GTKreport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "Surface.h"
+#include "Line.h"
+#include "LineIntersectVisit.h"
+#include "TrackCache.h"
+
+namespace MonteCarlo
+{
+
+TrackCache::TrackCache() :
+  active(0),stamp(1),nEval(0),nCall(0)
+  /*!
+    Constructor
+  */
+{}
+
+TrackCache::TrackCache(const TrackCache& A) :
+  Origin(A.Origin),Direct(A.Direct),active(A.active),
+  stamp(A.stamp),Stamp(A.Stamp),First(A.First),NRoot(A.NRoot),
+  Root(A.Root),RootPt(A.RootPt),PtOut(A.PtOut),DOut(A.DOut),
+  SurfOut(A.SurfOut),nEval(A.nEval),nCall(A.nCall)
+  /*!
+    Copy constructor
+    \param A :: TrackCache to copy
+  */
+{}
+
+TrackCache&
+TrackCache::operator=(const TrackCache& A)
+  /*!
+    Assignment operator
+    \param A :: TrackCache to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      Origin=A.Origin;
+      Direct=A.Direct;
+      active=A.active;
+      stamp=A.stamp;
+      Stamp=A.Stamp;
+      First=A.First;
+      NRoot=A.NRoot;
+      Root=A.Root;
+      RootPt=A.RootPt;
+      PtOut=A.PtOut;
+      DOut=A.DOut;
+      SurfOut=A.SurfOut;
+      nEval=A.nEval;
+      nCall=A.nCall;
+    }
+  return *this;
+}
+
+void
+TrackCache::newStamp()
+  /*!
+    Move to a new generation : on wrap round
+    the stamps are cleared
+  */
+{
+  stamp++;
+  if (!stamp)
+    {
+      std::fill(Stamp.begin(),Stamp.end(),0);
+      stamp=1;
+    }
+  Root.clear();
+  RootPt.clear();
+  return;
+}
+
+void
+TrackCache::setRay(const Geometry::Vec3D& O,const Geometry::Vec3D& D)
+  /*!
+    Set a new ray. The previous intersections are dropped.
+    \param O :: Ray origin
+    \param D :: Ray direction
+  */
+{
+  newStamp();
+  Origin=O;
+  Direct=D.unit();
+  active=1;
+  return;
+}
+
+void
+TrackCache::clear()
+  /*!
+    Invalidate the memo : required if a surface
+    is moved while the ray is held
+  */
+{
+  newStamp();
+  active=0;
+  return;
+}
+
+void
+TrackCache::collect(const std::vector<const Geometry::Surface*>& SurList,
+		    const Geometry::Vec3D& Pos)
+  /*!
+    Collect the intersections of a set of surfaces with
+    the ray. Surfaces not met on this ray are solved 
+    from the ray origin and kept. The distances are 
+    measured from Pos [a point on the ray].
+    \param SurList :: Surfaces [e.g. of a cell]
+    \param Pos :: Current point on the ray
+  */
+{
+  PtOut.clear();
+  DOut.clear();
+  SurfOut.clear();
+  if (!active) return;
+
+  const double T=(Pos-Origin).dotProd(Direct);
+  std::vector<const Geometry::Surface*>::const_iterator vc;
+  for(vc=SurList.begin();vc!=SurList.end();vc++)
+    {
+      const Geometry::Surface* SPtr= *vc;
+      nCall++;
+      const size_t index=SPtr->getIndex();
+      if (index>=Stamp.size())
+	{
+	  Stamp.resize(index+1,0);
+	  First.resize(index+1,0);
+	  NRoot.resize(index+1,0);
+	}
+      if (Stamp[index]!=stamp)
+	{
+	  LineIntersectVisit::Scratch LS(Origin,Direct);
+	  LineIntersectVisit& LI=LS.item();
+	  SPtr->acceptVisitor(LI);
+	  const std::vector<Geometry::Vec3D>& IPts(LI.getPoints());
+	  const std::vector<double>& dPts(LI.getDistance());
+	  Stamp[index]=stamp;
+	  First[index]=Root.size();
+	  NRoot[index]=dPts.size();
+	  Root.insert(Root.end(),dPts.begin(),dPts.end());
+	  RootPt.insert(RootPt.end(),IPts.begin(),IPts.end());
+	  nEval++;
+	}
+      const size_t IStart(First[index]);
+      for(size_t i=IStart;i<IStart+NRoot[index];i++)
+	{
+	  PtOut.push_back(RootPt[i]);
+	  DOut.push_back(Root[i]-T);
+	  SurfOut.push_back(SPtr);
+	}
+    }
+  return;
+}
+
+void
+TrackCache::resetCount()
+  /*!
+    Zero the evaluation counters
+  */
+{
+  nEval=0;
+  nCall=0;
+  return;
+}
+
+}  // NAMESPACE MonteCarlo
@@ -25,10 +25,14 @@
 class Token;
 class Rule;
 class CompGrp;
+class RuleCode;
 
 namespace Geometry
 {
   class Surface;
+  class Plane;
+  class BoundBox;
+  class SenseCache;
 }
 
 /*!
@@ -46,13 +50,26 @@ class HeadRule
  private:
 
   Rule* HeadNode;                    ///< Parent object (for tree)
+  RuleCode* CodePtr;                 ///< Compiled rule [if built]
 
   Rule* findKey(const int); 
   void removeItem(Rule*);
   static int procPair(std::string&,std::map<int,Rule*>&,int&);
   static CompGrp* procComp(Rule*);
 
+  static int parseNumber(const char*&,int&);
+  static Rule* parseUnit(const char*&);
+  static Rule* parseIntersection(const char*&);
+  static Rule* parseUnion(const char*&);
+  static Rule* parseString(const std::string&);
+
   void createAddition(const int,const Rule*);
+  void clearCode();
+
+  static Geometry::BoundBox ruleBox(const Rule*);
+  static Geometry::BoundBox surfBox(const Geometry::Surface*,const int);
+  static int planeBox(Geometry::BoundBox&,const Geometry::Plane&,
+		      const int);
 
  public:
 
@@ -64,6 +81,9 @@ class HeadRule
   const Rule* getTopRule() const { return HeadNode; }
 
   void populateSurf();
+  void buildCode();
+  /// Has a compiled rule
+  bool hasCode() const { return (CodePtr) ? 1 : 0; }
   void reset();
 
   /// Has a valid rule
@@ -77,14 +97,21 @@ class HeadRule
   int pairValid(const int,const Geometry::Vec3D&) const;           
   bool isValid(const std::map<int,int>&) const; 
   bool isDirectionValid(const Geometry::Vec3D&,const int) const; 
+  bool isValid(Geometry::SenseCache&) const;
+  bool isDirectionValid(Geometry::SenseCache&,const int) const;
+  int pairValid(const int,Geometry::SenseCache&) const;
+  void setTrack(const Geometry::Vec3D&,const Geometry::Vec3D&) const;
+  int trackPairValid(const int,const Geometry::Vec3D&,const double) const;
 
   std::set<const Geometry::Surface*> getOppositeSurfaces() const;
+  Geometry::BoundBox calcBoundBox() const;
   int removeItems(const int);
 
   int substituteSurf(const int,const int,const Geometry::Surface*);
   void makeComplement();
 
   int procString(const std::string&);
+  void setRule(Rule*);
 
   void addIntersection(const int);
   void addUnion(const int);
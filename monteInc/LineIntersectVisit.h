@@ -34,7 +34,10 @@ namespace MonteCarlo
   \date September 2007 
   \brief Intersect of Line with a surface 
 
-  Creates interaction with a line
+  Creates interaction with a line. The points, distances
+  and surfaces are held as separate arrays. Tracking uses
+  a Scratch object from the per-thread pool which keeps
+  its array capacity between calls.
 */
 
 class LineIntersectVisit : public Global::BaseVisit
@@ -47,13 +50,46 @@ class LineIntersectVisit : public Global::BaseVisit
     std::vector<const Geometry::Surface*> SurfIndex;           ///< SurfNames
     int neutIndex;                        ///< Neutron number
 
+    static const size_t nReserve;         ///< Initial capacity
+
+    struct scratchPool;
+
     void procTrack(const Geometry::Surface*);
+    static scratchPool& threadPool();
+    static LineIntersectVisit* acquire();
+    static void release();
     ///\cond PRIVATE
+    LineIntersectVisit();
     LineIntersectVisit(const LineIntersectVisit&);
     LineIntersectVisit& operator=(const LineIntersectVisit&);
     ///\endcond PRIVATE
 
   public:
+
+    /*!
+      \class Scratch
+      \brief Holds a LineIntersectVisit from the thread pool
+
+      The object at the next depth of the calling thread's 
+      pool is taken on construction and returned on 
+      destruction, so nested tracking does not share it.
+    */
+    class Scratch
+    {
+    private:
+      LineIntersectVisit* LPtr;           ///< Object at this depth
+      ///\cond PRIVATE
+      Scratch(const Scratch&);
+      Scratch& operator=(const Scratch&);
+      ///\endcond PRIVATE
+    public:
+      Scratch(const Geometry::Vec3D&,const Geometry::Vec3D&);
+      explicit Scratch(const MonteCarlo::neutron&);
+      ~Scratch();
+      /// Access the tracking object
+      LineIntersectVisit& item() const { return *LPtr; }
+    };
+    friend class Scratch;
     
     LineIntersectVisit(const Geometry::Vec3D&,
 		       const Geometry::Vec3D&);
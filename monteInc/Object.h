@@ -24,9 +24,16 @@
 
 class Token;
 
+namespace Geometry
+{
+  class BoundBox;
+  class SenseCache;
+}
+
 namespace MonteCarlo
 {
   class neutron;
+  class TrackCache;
 
 /*!
   \class Object
@@ -56,14 +63,27 @@ class Object
   int populated;     ///< Full population
 
   HeadRule HRule;    ///< Top rule
+  Geometry::Vec3D boxLow;    ///< Low corner of bounding box
+  Geometry::Vec3D boxHigh;   ///< High corner of bounding box
+  /// Surfaces of the box with their generation [Surface::getGeneration]
+  std::vector<std::pair<const Geometry::Surface*,size_t> > boxSurf;
   /// Set of surfaces that are logically opposite in the rule.
   std::set<const Geometry::Surface*> logicOppSurf;
  
   int procPair(std::string&,std::map<int,Rule*>&,int&) const;
+  void setKeyTemp(const double);
+  int procKeyWords(std::string&);
+  int procRegexKeyWords(std::string&);
   int checkSurfaceValid(const Geometry::Vec3D&,const Geometry::Vec3D&) const;
   int checkExteriorValid(const Geometry::Vec3D&,const Geometry::Vec3D&) const;
   /// Calc in/out 
   int calcInOut(const int,const int) const;
+  int trackPoints(const MonteCarlo::neutron&,
+		  const std::vector<Geometry::Vec3D>&,
+		  const std::vector<double>&,
+		  const std::vector<const Geometry::Surface*>&,
+		  double&,const int,const Geometry::Surface*&,
+		  const int) const;
 
  protected:
   
@@ -73,6 +93,8 @@ class Object
   std::set<int> SurSet;              ///< set of surfaces in cell [signed]
 
   int trackDirection(const Geometry::Vec3D&,const Geometry::Vec3D&) const;
+  void setBoundBox(const Geometry::BoundBox&);
+  Geometry::BoundBox ruleBoundBox() const;
 
  public:
   
@@ -80,6 +102,7 @@ class Object
 
   Object();
   Object(const int,const int,const double,const std::string&);
+  Object(const int,const int,const double,const HeadRule&);
   Object(const Object&);
   Object& operator=(const Object&);
   virtual Object* clone() const;
@@ -101,6 +124,7 @@ class Object
   int setObject(std::string);
   int setObject(const int,const int,const std::vector<Token>&);
   int procString(const std::string&);
+  int procRule(Rule*);
   void setDensity(const double D) { density=D; }       ///< Set Density [Atom/A^3]
   void setMaterial(const int M) { MatN=M; }            ///< Set Material number
   void setPlaceHold(const int P) { placehold=P; }      ///< Set placeholder
@@ -138,10 +162,19 @@ class Object
   int isValid(const Geometry::Vec3D&,const std::set<int>&) const;            
   int pairValid(const int,const Geometry::Vec3D&) const;   
   int isValid(const std::map<int,int>&) const; 
+  int isValid(Geometry::SenseCache&) const;
+  int isDirectionValid(Geometry::SenseCache&,const int) const;
   std::map<int,int> mapValid(const Geometry::Vec3D&) const;
 
   int isOnSide(const Geometry::Vec3D&) const;
 
+  virtual void calcBoundBox();
+  void clearBoundBox();
+  Geometry::BoundBox getBoundBox() const;
+  bool boxCurrent() const;
+  bool inBoundBox(const Geometry::Vec3D&) const;
+  bool lineBoundBox(const Geometry::Vec3D&,const Geometry::Vec3D&) const;
+
   int surfSign(const int) const;
   /// Access surface index
   const std::set<int>& getSurfSet() const { return SurSet; }
@@ -169,10 +202,16 @@ class Object
   int trackCell(const MonteCarlo::neutron&,double&,
 		const int,const Geometry::Surface*&,
 		const int) const;
+  int trackCell(const MonteCarlo::neutron&,double&,
+		const int,const Geometry::Surface*&,
+		const int,MonteCarlo::TrackCache&) const;
   int trackIntoCell(const MonteCarlo::neutron&,double&,
 		    const Geometry::Surface*&,const int =0) const;
   int trackOutCell(const MonteCarlo::neutron&,double&,
 		   const Geometry::Surface*&,const int =0) const;
+  int trackOutCell(const MonteCarlo::neutron&,double&,
+		   const Geometry::Surface*&,const int,
+		   MonteCarlo::TrackCache&) const;
 
   // OUTPUT
   std::string cellCompStr() const;
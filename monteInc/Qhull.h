@@ -25,6 +25,8 @@
 namespace Geometry
 {
   class Surface;
+  class Line;
+  class BoundBox;
 }
 
 namespace MonteCarlo
@@ -46,11 +48,20 @@ class Qhull : public Object
 {
  private:
   
+  static const double boxTol;         ///< Padding of the vertex box
+  static const double vertexLimit;    ///< Largest vertex coordinate
+
   std::vector<SurfVertex> VList;      ///< Full Vertex list
   Geometry::Vec3D CofM;               ///< Effective centre of mass
 
+  static int lineBox(const Geometry::Line&,const Geometry::BoundBox&);
+
+  Geometry::BoundBox vertexBox() const;
   int getIntersect(const Geometry::Surface*,const Geometry::Surface*,
-		   const Geometry::Surface*);
+		   const Geometry::Surface*,const Geometry::BoundBox&);
+  int addVertex(const Geometry::Surface*,const Geometry::Surface*,
+		const Geometry::Surface*,const std::vector<Geometry::Vec3D>&,
+		const Geometry::BoundBox&);
 
   void calcCentreOfMass();
 
@@ -58,6 +69,7 @@ class Qhull : public Object
   
   Qhull();
   Qhull(const int,const int,const double,const std::string&);
+  Qhull(const int,const int,const double,const HeadRule&);
   Qhull(const Qhull&);
   Qhull& operator=(const Qhull&);
   virtual Qhull* clone() const;
@@ -68,6 +80,7 @@ class Qhull : public Object
   int calcIntersections();
   int calcVertex();
   int calcMidVertex();
+  virtual void calcBoundBox();
   
   Geometry::Matrix<double> getRotation(const unsigned int,const unsigned int,
 			     const unsigned int,const unsigned int) const;
@@ -0,0 +1,140 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   monteInc/RuleBDD.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef MonteCarlo_RuleBDD_h
+#define MonteCarlo_RuleBDD_h
+
+class Rule;
+
+namespace MonteCarlo
+{
+  class Qhull;
+
+/*!
+  \struct bddNode
+  \brief Decision node of a RuleBDD
+*/
+struct bddNode
+{
+  size_t level;        ///< Variable level [surface]
+  size_t lo;           ///< Node if the surface sense is negative
+  size_t hi;           ///< Node if the surface sense is positive
+
+  /// Constructor
+  bddNode(const size_t L,const size_t A,const size_t B) :
+    level(L),lo(A),hi(B) {}
+};
+
+/*!
+  \struct bddKey
+  \brief Index triple for the unique/computed tables
+*/
+struct bddKey
+{
+  size_t A;       ///< First index
+  size_t B;       ///< Second index
+  size_t C;       ///< Third index
+
+  /// Constructor
+  bddKey(const size_t a,const size_t b,const size_t c) :
+    A(a),B(b),C(c) {}
+  /// Order for map
+  bool operator<(const bddKey& K) const
+    { return (A!=K.A) ? A<K.A : ((B!=K.B) ? B<K.B : C<K.C); }
+};
+
+/*!
+  \class RuleBDD
+  \version 1.0
+  \author S. Ansell
+  \date June 2013
+  \brief Reduced ordered BDD of cell rules
+
+  Each surface is a boolean variable [true on the positive
+  side] ordered by first use. Nodes are shared through the
+  unique table and all the boolean operations go through
+  a cached ite. Complemented cells (#N) are built once
+  and reused. A node is written back as a rule tree
+  by splitting off the common factors (dominator nodes)
+  of the graph.
+*/
+
+class RuleBDD
+{
+ private:
+
+  typedef std::map<int,Qhull*> OTYPE;    ///< Cell map
+
+  static const size_t falseNode;         ///< False terminal
+  static const size_t trueNode;          ///< True terminal
+
+  std::vector<bddNode> Nodes;            ///< Nodes [0/1 terminals]
+  std::map<bddKey,size_t> Unique;        ///< Unique table
+  std::map<bddKey,size_t> Computed;      ///< Cache of ite
+  std::map<int,size_t> SurfLevel;        ///< Surface : Level
+  std::vector<int> LevelSurf;            ///< Level : Surface
+  std::map<int,size_t> CellNode;         ///< Cell : Node
+  std::set<int> Active;                  ///< Cells being built
+
+  size_t makeNode(const size_t,const size_t,const size_t);
+  size_t surfNode(const int);
+  size_t ite(const size_t,const size_t,const size_t);
+  size_t cellNode(const int,const OTYPE&);
+
+  const Rule* cellRule(const int,const OTYPE&) const;
+  size_t substitute(const size_t,const size_t,const size_t,
+		    std::map<size_t,size_t>&);
+  size_t findDominator(const size_t,const size_t) const;
+  Rule* literal(const size_t,const int,size_t&) const;
+  Rule* emitRule(const size_t,size_t&);
+  void expandGroup(const Rule*,const OTYPE&,const int,const int,
+		   std::vector<Rule*>&,std::set<int>&);
+  Rule* expandRule(const Rule*,const OTYPE&);
+
+  static Rule* joinRule(Rule*,Rule*,const int);
+
+ public:
+
+  RuleBDD();
+  RuleBDD(const RuleBDD&);
+  RuleBDD& operator=(const RuleBDD&);
+  ~RuleBDD();
+
+  void clear();
+
+  /// Number of nodes [including terminals]
+  size_t size() const { return Nodes.size(); }
+
+  size_t andNode(const size_t,const size_t);
+  size_t orNode(const size_t,const size_t);
+  size_t notNode(const size_t);
+  size_t build(const Rule*,const OTYPE&);
+
+  Rule* makeRule(const size_t);
+  Rule* removeComplement(const Rule*,const OTYPE&);
+
+  static size_t countLiterals(const Rule*);
+  static size_t countLiterals(const Rule*,const OTYPE&);
+};
+
+}
+
+#endif
@@ -0,0 +1,150 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   monteInc/RuleCode.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef RuleCode_h
+#define RuleCode_h
+
+class Rule;
+
+namespace Geometry
+{
+  class Surface;
+  class SenseCache;
+}
+
+/*!
+  \class RuleCode
+  \brief Flat postfix program of a rule tree
+  \author S. Ansell
+  \version 1.0
+  \date November 2013
+
+  The rule tree is compiled into a linear list of
+  operations run on a small value stack. Each value
+  is the two-bit pairValid state [0-3]; boolean
+  tests use 0/3. Chains of intersections [unions]
+  are flattened and jump to the end of the chain
+  as soon as the result is false [true]. Items that
+  cannot be compiled (e.g. CompObj) are called
+  through the rule virtual functions.
+
+  Each surface has a slot. For tracking, setTrack
+  reduces the surfaces to functions of the distance
+  along the line so that the sides at the intersection
+  points are found without the surface objects.
+  The track is only used while the program is 
+  unchanged [serial], no slot surface has moved 
+  [Surface::getGeneration] and the point is on the line.
+*/
+
+class RuleCode
+{
+ public:
+
+  /// Operation types
+  enum opType { opSurf=0,opConst=1,opRule=2,
+		opJZero=3,opJAll=4,opPush=5,
+		opAnd=6,opOr=7,opNot=8 };
+
+ private:
+
+  /// Surface side along a line
+  enum lineType { lineDirect=0,linePlane=1,lineEqn=2,
+		  lineSphere=3,lineCyl=4 };
+
+  /// Single operation
+  struct RuleOp
+  {
+    int op;                          ///< Operation type
+    int sign;                        ///< Surface sense [opSurf]
+    int keyN;                        ///< Surface number [opSurf]
+    size_t slot;                     ///< Surface slot [opSurf]
+    size_t jump;                     ///< Jump target / constant
+    const Geometry::Surface* SPtr;   ///< Surface [opSurf]
+    const Rule* RPtr;                ///< Rule [opRule]
+  };
+
+  /// Line coefficients of each slot [one per thread]
+  struct trackWork
+  {
+    const RuleCode* owner;           ///< Code that set the track
+    size_t serial;                   ///< Program serial of owner
+    std::vector<size_t> Gen;         ///< Generation of each slot surface
+    double Line[6];                  ///< Track origin : direction
+    std::vector<int> Mode;           ///< Line type used [lineType]
+    std::vector<double> Coef;        ///< Five coefficients per slot
+  };
+
+  static const double lineGuard;     ///< Relative rounding of line values
+
+  std::vector<RuleOp> Code;          ///< Program
+  size_t maxDepth;                   ///< Max stack depth
+  std::vector<const Geometry::Surface*> SlotSurf;  ///< Surface of slot
+  std::vector<int> SlotType;         ///< Line type of slot
+  size_t serial;                     ///< Unique number of program
+
+  void addOp(const int,const size_t =0);
+  size_t addSlot(const Geometry::Surface*);
+  int compile(const Rule*,const size_t);
+
+  static size_t nextSerial();
+  static trackWork& threadWork();
+  bool isCurrent(const trackWork&) const;
+  static void eqnCoef(const std::vector<double>&,const Geometry::Vec3D&,
+		      const Geometry::Vec3D&,double*);
+
+  template<typename LeafTYPE>
+  int run(const LeafTYPE&) const;
+
+ public:
+
+  RuleCode();
+  RuleCode(const RuleCode&);
+  RuleCode& operator=(const RuleCode&);
+  ~RuleCode() {}   ///< Destructor
+
+  int build(const Rule*);
+  void clear();
+  /// Has no program
+  bool isEmpty() const { return Code.empty(); }
+  /// Number of operations
+  size_t size() const { return Code.size(); }
+
+  bool isValid(const Geometry::Vec3D&) const;
+  bool isValid(const Geometry::Vec3D&,const int) const;
+  bool isDirectionValid(const Geometry::Vec3D&,const int) const;
+  int pairValid(const int,const Geometry::Vec3D&) const;
+  bool isValid(Geometry::SenseCache&) const;
+  bool isDirectionValid(Geometry::SenseCache&,const int) const;
+  int pairValid(const int,Geometry::SenseCache&) const;
+
+  void setTrack(const Geometry::Vec3D&,const Geometry::Vec3D&) const;
+  bool hasTrack() const;
+  int trackPairValid(const int,const Geometry::Vec3D&,const double) const;
+  static int lineSide(const int,const double*,const double,const double);
+
+  void write(std::ostream&) const;
+};
+
+std::ostream&
+operator<<(std::ostream&,const RuleCode&);
+
+#endif
@@ -0,0 +1,108 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   monteInc/TrackCache.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef MonteCarlo_TrackCache_h
+#define MonteCarlo_TrackCache_h
+
+namespace Geometry
+{
+  class Surface;
+}
+
+namespace MonteCarlo
+{
+
+/*!
+  \class TrackCache
+  \brief Memo of surface intersections along one ray
+  \version 1.0
+  \date November 2013
+  \author S. Ansell
+
+  Holds a ray and all the intersections of each surface
+  met along it. The intersections of a surface are
+  found once [from the ray origin] and reused by every
+  cell on the ray that shares the surface. Entries are
+  indexed by the dense surface index and stamped with
+  the ray generation [as SenseCache]. A cache must not
+  be shared between threads.
+*/
+
+class TrackCache
+{
+ private:
+
+  Geometry::Vec3D Origin;             ///< Ray origin
+  Geometry::Vec3D Direct;             ///< Ray direction [unit]
+  int active;                         ///< Ray set
+  unsigned int stamp;                 ///< Current generation
+  std::vector<unsigned int> Stamp;    ///< Generation of each entry
+  std::vector<size_t> First;          ///< First root of each entry
+  std::vector<size_t> NRoot;          ///< Number of roots of each entry
+  std::vector<double> Root;           ///< Root distance from Origin
+  std::vector<Geometry::Vec3D> RootPt;  ///< Root point
+
+  std::vector<Geometry::Vec3D> PtOut;   ///< Collected points
+  std::vector<double> DOut;             ///< Collected distances
+  std::vector<const Geometry::Surface*> SurfOut;  ///< Collected surfaces
+
+  size_t nEval;                       ///< Surface intersections solved
+  size_t nCall;                       ///< Surface intersection requests
+
+  void newStamp();
+
+ public:
+
+  TrackCache();
+  TrackCache(const TrackCache&);
+  TrackCache& operator=(const TrackCache&);
+  ~TrackCache() {}   ///< Destructor
+
+  void setRay(const Geometry::Vec3D&,const Geometry::Vec3D&);
+  void clear();
+  /// Access ray origin
+  const Geometry::Vec3D& getOrigin() const { return Origin; }
+  /// Access ray direction
+  const Geometry::Vec3D& getDirect() const { return Direct; }
+  /// Is a ray set
+  int isActive() const { return active; }
+
+  void collect(const std::vector<const Geometry::Surface*>&,
+	       const Geometry::Vec3D&);
+
+  /// Distances from the collect point
+  const std::vector<double>& getDistance() const { return DOut; }
+  /// Points of the last collect
+  const std::vector<Geometry::Vec3D>& getPoints() const { return PtOut; }
+  /// Surfaces of the last collect
+  const std::vector<const Geometry::Surface*>& getSurfIndex() const
+    { return SurfOut; }
+
+  /// Number of surface intersections solved
+  size_t getEval() const { return nEval; }
+  /// Number of surface intersection requests
+  size_t getCall() const { return nCall; }
+  void resetCount();
+};
+
+}  // NAMESPACE MonteCarlo
+
+#endif
@@ -89,6 +89,7 @@
 #include "surfRegister.h"
 #include "ModelSupport.h"
 #include "neutron.h"
+#include "TrackCache.h"
 #include "Simulation.h"
 #include "LineTrack.h"
 
@@ -178,6 +179,8 @@ LineTrack::calculate(const Simulation& ASim)
   const int flagDebug(debugStatus::Instance().getFlag());
 
   MonteCarlo::neutron nOut(1.0,InitPt,EndPt-InitPt);
+  MonteCarlo::TrackCache TC;
+  TC.setRay(nOut.Pos,nOut.uVec);
   // Find Initial cell [no default]
   MonteCarlo::Object* OPtr=ASim.findCell(InitPt+
 					 (EndPt-InitPt).unit()*1e-5,0);
@@ -190,7 +193,7 @@ LineTrack::calculate(const Simulation& ASim)
   while(OPtr)
     {
       // Note: Need OPPOSITE Sign on exiting surface
-      SN= -OPtr->trackOutCell(nOut,aDist,SPtr,-SN);
+      SN= -OPtr->trackOutCell(nOut,aDist,SPtr,-SN,TC);
       // Update Track : returns 1 on excess of distance
       if (SN && updateDistance(OPtr,aDist))
 	{
@@ -39,6 +39,7 @@
 #include "GTKreport.h"
 #include "NameStack.h"
 #include "RegMethod.h"
+#include "MethodProfile.h"
 #include "OutputLog.h"
 #include "BaseVisit.h"
 #include "BaseModVisit.h"
@@ -206,9 +207,11 @@ createInputs(inputParam& IParam)
 
   IParam.regFlag("a","axis");
   IParam.regItem<std::string>("angle","angle");
+  IParam.regFlag("bvh","bvh");
   IParam.regDefItem<int>("c","cellRange",2,0,0);
   IParam.regItem<double>("C","ECut");
   IParam.regFlag("cinder","cinder");
+  IParam.regFlag("compCheck","compCheck");
   IParam.regItem<int>("d","debug");
   IParam.regDefItem<std::string>("dc","doseCalc",1,"InternalDOSE");
   IParam.regFlag("e","endf");
@@ -225,7 +228,9 @@ createInputs(inputParam& IParam)
   IParam.regFlag("md5","md5");
   IParam.regItem<int>("memStack","memStack");
   IParam.regDefItem<int>("n","nps",1,10000);
+  IParam.regItem<size_t>("osmLearn","osmLearn",1);
   IParam.regFlag("p","PHITS");
+  IParam.regItem<std::string>("profile","profile",1);
   IParam.regFlag("Monte","Monte");
   IParam.regDefItem<double>("photon","photon",1,0.001);
 
@@ -251,16 +256,22 @@ createInputs(inputParam& IParam)
   IParam.regFlag("TW","tallyWeight");
   IParam.regItem<std::string>("TX","Txml",1);
   IParam.regItem<std::string>("targetType","targetType",1);
+  IParam.regDefItem<size_t>("threads","threads",1,1);
   IParam.regDefItem<int>("u","units",1,0);
   IParam.regItem<size_t>("validCheck","validCheck",1);
+  IParam.regItem<size_t>("validThreads","validThreads",1);
   IParam.regFlag("um","voidUnMask");
   IParam.regItem<double>("volume","volume",4);
   IParam.regDefItem<int>("VN","volNum",1,20000);
+  IParam.regItem<size_t>("VT","volThreads",1);
   IParam.regFlag("void","void");
   IParam.regFlag("vtk","vtk");
   std::vector<std::string> VItems(15,"");
   IParam.regDefItemList<std::string>("vmat","vmat",15,VItems);
   IParam.regFlag("vcell","vcell");
+  IParam.regFlag("vline","vtkLine");
+  IParam.regDefItem<std::string>("vfmt","vtkFormat",1,"ascii");
+  IParam.regDefItem<size_t>("voct","vtkOctree",1,0);
 
   IParam.regItem<double>("w","weight");
   IParam.regItem<Geometry::Vec3D>("WP","weightPt");
@@ -272,9 +283,11 @@ createInputs(inputParam& IParam)
   
   IParam.setDesc("angle","Orientate to component [name]");
   IParam.setDesc("axis","Rotate to main axis rotation [TS2]");
+  IParam.setDesc("bvh","Use a cell box tree to find cells");
   IParam.setDesc("c","Cells to protect");
   IParam.setDesc("ECut","Cut energy");
   IParam.setDesc("cinder","Outer Cinder files");
+  IParam.setDesc("compCheck","Check complement removal with Algebra");
   IParam.setDesc("d","debug flag");
   IParam.setDesc("dc","Dose flag (internalDOSE/DOSE)");
   IParam.setDesc("e","Convert materials to ENDF-VII");
@@ -291,7 +304,9 @@ createInputs(inputParam& IParam)
   IParam.setDesc("md5","MD5 track of cells");
   IParam.setDesc("memStack","Memstack verbrosity value");
   IParam.setDesc("n","Number of starting particles");
+  IParam.setDesc("osmLearn","Order cell neighbours from N warm-up rays");
   IParam.setDesc("p","PHITS output");
+  IParam.setDesc("profile","Write method profile to [stem].txt/.folded");
   IParam.setDesc("Monte","MonteCarlo capable simulation");
   IParam.setDesc("photon","Photon Cut energy");
   IParam.setDesc("r","Renubmer cells");
@@ -312,14 +327,21 @@ createInputs(inputParam& IParam)
   IParam.setDesc("TW","Activate tally pd weight system");
   IParam.setDesc("Txml","Tally xml file");
   IParam.setDesc("targetType","Name of target type");
+  IParam.setDesc("threads","Threads of the cell passes, validCheck "
+		 "and volume integration");
   IParam.setDesc("u","Units in cm");
   IParam.setDesc("um","Unset void area (from imp=0)");
   IParam.setDesc("void","Adds the void card to the simulation");
   IParam.setDesc("volume","Create volume about point/radius for f4 tally");
   IParam.setDesc("vtk","Write out VTK plot mesh");
   IParam.setDesc("vmat","sections to be written by vmat");
+  IParam.setDesc("vline","Fill the VTK mesh by tracking lines");
+  IParam.setDesc("vfmt","VTK output format [ascii/binary/vti/vtiz]");
+  IParam.setDesc("voct","Octree VTK mesh : max split levels per voxel [0-20]");
   IParam.setDesc("VN","Number of points in the volume integration");
+  IParam.setDesc("VT","Old name of -threads");
   IParam.setDesc("validCheck","Run simulation to check for validity");
+  IParam.setDesc("validThreads","Old name of -threads");
 
   IParam.setDesc("w","weightBias");
   IParam.setDesc("WType","Initial model for weights [help for info]");
@@ -678,6 +700,9 @@ createSimulation(inputParam& IParam,
       (static_cast<unsigned int>(IParam.getValue<int>("debug")));
     
   IParam.processMainInput(Names);
+  if (IParam.flag("profile"))
+    ELog::MethodProfile::Instance().
+      setActive(IParam.getValue<std::string>("profile"));
 
   Simulation* SimPtr;
   if (IParam.flag("PHITS"))
@@ -689,6 +714,15 @@ createSimulation(inputParam& IParam,
 
 
   SimPtr->setCmdLine(cmdLine.str());        // set full command line
+  if (IParam.flag("compCheck"))
+    SimPtr->setCompCheck(1);
+  // -validThreads and -VT are old names of -threads
+  size_t nThread=IParam.getValue<size_t>("threads");
+  if (IParam.flag("validThreads"))
+    nThread=IParam.getValue<size_t>("validThreads");
+  if (IParam.flag("VT"))
+    nThread=IParam.getValue<size_t>("VT");
+  SimPtr->setThreads(nThread);
 
   return SimPtr;
 }
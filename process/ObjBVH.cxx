@@ -0,0 +1,303 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   process/ObjBVH.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "BoundBox.h"
+#include "SenseCache.h"
+#include "Surface.h"
+#include "Rules.h"
+#include "HeadRule.h"
+#include "Object.h"
+#include "Qhull.h"
+#include "ObjBVH.h"
+
+namespace ModelSupport
+{
+
+/*!
+  \struct centreCompare
+  \brief Orders cell index by the box centre on one axis
+*/
+struct centreCompare
+{
+  const std::vector<Geometry::BoundBox>& BoxVec;  ///< Boxes
+  const size_t axis;                              ///< Axis to compare
+
+  /// Constructor
+  centreCompare(const std::vector<Geometry::BoundBox>& B,
+		const size_t A) : BoxVec(B),axis(A) {}
+
+  /// Comparison on centre
+  bool operator()(const size_t A,const size_t B) const
+    { return BoxVec[A].getCentre()[axis]<BoxVec[B].getCentre()[axis]; }
+};
+
+const size_t ObjBVH::leafSize(4);
+
+ObjBVH::ObjBVH() :
+  active(0),cellMove(0)
+  /*!
+    Constructor
+  */
+{}
+
+ObjBVH::ObjBVH(const ObjBVH& A) :
+  active(A.active),cellMove(A.cellMove),
+  ObjVec(A.ObjVec),BoxVec(A.BoxVec),
+  OrderVec(A.OrderVec),unBound(A.unBound),Nodes(A.Nodes)
+  /*!
+    Copy constructor
+    \param A :: ObjBVH to copy
+  */
+{}
+
+ObjBVH&
+ObjBVH::operator=(const ObjBVH& A)
+  /*!
+    Assignment operator
+    \param A :: ObjBVH to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      active=A.active;
+      cellMove=A.cellMove;
+      ObjVec=A.ObjVec;
+      BoxVec=A.BoxVec;
+      OrderVec=A.OrderVec;
+      unBound=A.unBound;
+      Nodes=A.Nodes;
+    }
+  return *this;
+}
+
+void
+ObjBVH::clearAll()
+  /*!
+    Remove all the cells and de-activate the tree
+  */
+{
+  active=0;
+  cellMove=0;
+  ObjVec.clear();
+  BoxVec.clear();
+  OrderVec.clear();
+  unBound.clear();
+  Nodes.clear();
+  return;
+}
+
+void
+ObjBVH::buildNode(const size_t nodeIndex,const size_t startIndex,
+		  const size_t count)
+  /*!
+    Recursively construct the tree node covering the
+    items [startIndex,startIndex+count) in OrderVec.
+    Split is at the median centre on the longest axis.
+    \param nodeIndex :: Node to fill
+    \param startIndex :: First item in OrderVec
+    \param count :: Number of items
+  */
+{
+  Geometry::BoundBox NBox;
+  Geometry::BoundBox CBox;
+  NBox.setEmpty();
+  CBox.setEmpty();
+  for(size_t i=startIndex;i<startIndex+count;i++)
+    {
+      NBox.merge(BoxVec[OrderVec[i]]);
+      CBox.addPoint(BoxVec[OrderVec[i]].getCentre());
+    }
+  Nodes[nodeIndex].Box=NBox;
+  Nodes[nodeIndex].leftIndex=0;
+  Nodes[nodeIndex].startIndex=startIndex;
+  Nodes[nodeIndex].count=count;
+
+  if (count<=leafSize) return;
+  const size_t axis=CBox.longestAxis();
+  if (CBox.getHigh()[axis]-CBox.getLow()[axis]<Geometry::zeroTol)
+    return;
+
+  const size_t mid(count/2);
+  std::vector<size_t>::iterator sc=OrderVec.begin()+
+    static_cast<long int>(startIndex);
+  std::nth_element(sc,sc+static_cast<long int>(mid),
+		   sc+static_cast<long int>(count),
+		   centreCompare(BoxVec,axis));
+
+  const size_t leftIndex(Nodes.size());
+  Nodes.push_back(BVHNode());
+  Nodes.push_back(BVHNode());
+  Nodes[nodeIndex].leftIndex=leftIndex;
+  buildNode(leftIndex,startIndex,mid);
+  buildNode(leftIndex+1,startIndex+mid,count-mid);
+  return;
+}
+
+void
+ObjBVH::build(const std::map<int,MonteCarlo::Qhull*>& OMap)
+  /*!
+    Build the tree from the cell map. Placeholder cells
+    are not entered. The cell boxes must be calculated.
+    \param OMap :: Map of cells
+  */
+{
+  ELog::RegMethod RegA("ObjBVH","build");
+
+  clearAll();
+  std::map<int,MonteCarlo::Qhull*>::const_iterator mc;
+  for(mc=OMap.begin();mc!=OMap.end();mc++)
+    {
+      if (!mc->second->isPlaceHold())
+	{
+	  const Geometry::BoundBox ABox=mc->second->getBoundBox();
+	  if (ABox.isBounded())
+	    OrderVec.push_back(ObjVec.size());
+	  else
+	    unBound.push_back(ObjVec.size());
+	  ObjVec.push_back(mc->second);
+	  BoxVec.push_back(ABox);
+	}
+    }
+  if (!OrderVec.empty())
+    {
+      Nodes.push_back(BVHNode());
+      buildNode(0,0,OrderVec.size());
+    }
+  active=1;
+  cellMove=Geometry::Surface::getCellMove();
+  return;
+}
+
+int
+ObjBVH::isDirty() const
+  /*!
+    Determine if the tree must be rebuilt
+    \return true if a surface of the cells has moved 
+    since the build [and the tree is in use]
+  */
+{
+  return (active && 
+	  cellMove!=Geometry::Surface::getCellMove()) ? 1 : 0;
+}
+
+MonteCarlo::Object*
+ObjBVH::findCell(const Geometry::Vec3D& Pt) const
+  /*!
+    Find the first cell [in map order] that contains the point.
+    \param Pt :: Point to find
+    \return Object / 0 if not found
+  */
+{
+  Geometry::SenseCache SC;
+  SC.setPoint(Pt);
+  return findCell(SC);
+}
+
+MonteCarlo::Object*
+ObjBVH::findCell(Geometry::SenseCache& SC) const
+  /*!
+    Find the first cell [in map order] that contains the point.
+    Only cells whose box contains the point and the unbounded
+    cells are tested.
+    \param SC :: Surface sense cache [holds point]
+    \return Object / 0 if not found
+  */
+{
+  const Geometry::Vec3D& Pt=SC.getPoint();
+  std::vector<size_t> Candidate;
+  if (!Nodes.empty())
+    {
+      std::vector<size_t> NStack;
+      NStack.push_back(0);
+      while(!NStack.empty())
+	{
+	  const BVHNode& NRef=Nodes[NStack.back()];
+	  NStack.pop_back();
+	  if (!NRef.Box.isValid(Pt)) continue;
+	  if (NRef.leftIndex)
+	    {
+	      NStack.push_back(NRef.leftIndex+1);
+	      NStack.push_back(NRef.leftIndex);
+	    }
+	  else
+	    {
+	      for(size_t i=NRef.startIndex;i<NRef.startIndex+NRef.count;i++)
+		if (BoxVec[OrderVec[i]].isValid(Pt))
+		  Candidate.push_back(OrderVec[i]);
+	    }
+	}
+      std::sort(Candidate.begin(),Candidate.end());
+    }
+
+  // Merge the two sorted lists to keep map order
+  std::vector<size_t>::const_iterator ac=Candidate.begin();
+  std::vector<size_t>::const_iterator uc=unBound.begin();
+  while(ac!=Candidate.end() || uc!=unBound.end())
+    {
+      size_t index;
+      if (uc==unBound.end() || (ac!=Candidate.end() && *ac<*uc))
+	index= *ac++;
+      else
+	index= *uc++;
+      if (ObjVec[index]->isValid(SC))
+	return ObjVec[index];
+    }
+  return 0;
+}
+
+void
+ObjBVH::write(std::ostream& OX) const
+  /*!
+    Write out the tree
+    \param OX :: Output stream
+  */
+{
+  OX<<"ObjBVH : "<<ObjVec.size()<<" cells ("
+    <<unBound.size()<<" unbounded) : "<<Nodes.size()<<" nodes"<<std::endl;
+  for(size_t i=0;i<ObjVec.size();i++)
+    OX<<"  "<<ObjVec[i]->getName()<<" : "<<BoxVec[i]<<std::endl;
+  return;
+}
+
+} // NAMESPACE ModelSupport
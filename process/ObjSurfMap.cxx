@@ -32,6 +32,8 @@
 #include <iterator>
 #include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -44,9 +46,13 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "MersenneTwister.h"
+#include "BoundBox.h"
+#include "SenseCache.h"
 #include "Rules.h"
 #include "HeadRule.h"
 #include "Object.h"
+#include "neutron.h"
 #include "Surface.h"
 #include "Quadratic.h"
 #include "Plane.h"
@@ -62,6 +68,21 @@
 namespace ModelSupport
 {
 
+/*!
+  \struct hitCompare
+  \brief Orders candidates by decreasing hit count
+*/
+struct hitCompare
+{
+  /// Comparison of the hit counts
+  bool operator()(const std::pair<size_t,MonteCarlo::Object*>& A,
+		  const std::pair<size_t,MonteCarlo::Object*>& B) const
+    { return A.first>B.first; }
+};
+
+const size_t ObjSurfMap::maxPairs(100000);
+const double ObjSurfMap::boxTol(1e-3);
+
 void
 ObjSurfMap::removeEqualSurf(const std::map<int,Geometry::Surface*>& EQMap,
 			    std::map<int,MonteCarlo::Qhull*>& OMap)
@@ -85,14 +106,18 @@ ObjSurfMap::removeEqualSurf(const std::map<int,Geometry::Surface*>& EQMap,
   return;
 }
 
-ObjSurfMap::ObjSurfMap() 
+ObjSurfMap::ObjSurfMap() :
+  SCPtr(new Geometry::SenseCache),graphValid(0)
  /*! 
    Constructor 
  */
 {}
 
 ObjSurfMap::ObjSurfMap(const ObjSurfMap& A) :
-  SMap(A.SMap)
+  SMap(A.SMap),ObjSurf(A.ObjSurf),SCPtr(new Geometry::SenseCache),
+  graphValid(A.graphValid),GKey(A.GKey),GKeyIndex(A.GKeyIndex),
+  GFrom(A.GFrom),GRowIndex(A.GRowIndex),GObj(A.GObj),
+  GHits(A.GHits)
   /*! 
     Copy Constructor 
     \param A :: ObjSurfMap to copy
@@ -111,10 +136,27 @@ ObjSurfMap::operator=(const ObjSurfMap& A)
   if (this!=&A)
     {
       SMap=A.SMap;
+      ObjSurf=A.ObjSurf;
+      SCPtr->clear();
+      graphValid=A.graphValid;
+      GKey=A.GKey;
+      GKeyIndex=A.GKeyIndex;
+      GFrom=A.GFrom;
+      GRowIndex=A.GRowIndex;
+      GObj=A.GObj;
+      GHits=A.GHits;
     }
   return *this;
 }
 
+ObjSurfMap::~ObjSurfMap()
+  /*!
+    Destructor
+  */
+{
+  delete SCPtr;
+}
+
 void
 ObjSurfMap::clearAll()
   /*!
@@ -122,6 +164,26 @@ ObjSurfMap::clearAll()
   */
 {
   SMap.erase(SMap.begin(),SMap.end());
+  ObjSurf.clear();
+  SCPtr->clear();
+  clearGraph();
+  return;
+}
+
+void
+ObjSurfMap::clearGraph()
+  /*!
+    Clears the adjacency graph [findNextObject 
+    then uses the surface map]
+  */
+{
+  graphValid=0;
+  GKey.clear();
+  GKeyIndex.clear();
+  GFrom.clear();
+  GRowIndex.clear();
+  GObj.clear();
+  GHits.clear();
   return;
 }
 
@@ -193,24 +255,201 @@ ObjSurfMap::addSurface(const int SurfN,MonteCarlo::Object* OPtr)
    */
 {
   ELog::RegMethod RegA("ObjSurfMap","addSurface");
-  // Find is this surface esists
+  // Object already on this surface
+  if (!ObjSurf[OPtr].insert(SurfN).second)
+    return;
+  if (graphValid) clearGraph();
+  SMap[SurfN].push_back(OPtr);
+  return;
+}
+
+void
+ObjSurfMap::eraseEntry(const int SurfN,const MonteCarlo::Object* OPtr)
+  /*!
+    Remove an object from the list of a surface.
+    The reverse map is not changed.
+    \param SurfN :: Signed surface number
+    \param OPtr :: Object pointer
+   */
+{
   OMTYPE::iterator mc=SMap.find(SurfN);
-  if (mc!=SMap.end())         // surface exists add object
+  if (mc!=SMap.end())
     {
-      // Check the object list to see if we have this object
       STYPE& VItem=mc->second;
-      STYPE::iterator vc=
-	find_if(VItem.begin(),VItem.end(),
-		boost::bind(std::equal_to<MonteCarlo::Object*>(),_1,OPtr));
-      if (vc==VItem.end())
-	mc->second.push_back(OPtr);
+      VItem.erase(std::remove(VItem.begin(),VItem.end(),OPtr),VItem.end());
+      if (VItem.empty())
+	SMap.erase(mc);
     }
-  else   // 
+  return;
+}
+
+void
+ObjSurfMap::removeObject(const MonteCarlo::Object* OPtr)
+  /*!
+    Remove an object from the map [e.g. before it is deleted]
+    \param OPtr :: Object pointer
+   */
+{
+  ELog::RegMethod RegA("ObjSurfMap","removeObject");
+
+  OSTYPE::iterator oc=ObjSurf.find(OPtr);
+  if (oc==ObjSurf.end()) return;
+
+  if (graphValid) clearGraph();
+  std::set<int>::const_iterator sc;
+  for(sc=oc->second.begin();sc!=oc->second.end();sc++)
+    eraseEntry(*sc,OPtr);
+  ObjSurf.erase(oc);
+  return;
+}
+
+void
+ObjSurfMap::updateObject(MonteCarlo::Object* OPtr)
+  /*!
+    Patch the map for an object that has changed.
+    Surfaces no longer on the object are removed and
+    new surfaces are added. Unchanged surfaces keep
+    the object at the same place in their list.
+    \param OPtr :: Object pointer [surface list set]
+   */
+{
+  ELog::RegMethod RegA("ObjSurfMap","updateObject");
+
+  const std::set<int>& sSet=OPtr->getSurfSet();
+  OSTYPE::iterator oc=ObjSurf.find(OPtr);
+  if (oc!=ObjSurf.end())
     {
-      std::pair<OMTYPE::iterator,bool> PIter=
-	SMap.insert(OMTYPE::value_type(SurfN,STYPE()));
-      PIter.first->second.push_back(OPtr);
+      std::vector<int> oldSurf;
+      std::set_difference(oc->second.begin(),oc->second.end(),
+			  sSet.begin(),sSet.end(),
+			  std::back_inserter(oldSurf));
+      if (!oldSurf.empty() && graphValid) 
+	clearGraph();
+      std::vector<int>::const_iterator vc;
+      for(vc=oldSurf.begin();vc!=oldSurf.end();vc++)
+	{
+	  eraseEntry(*vc,OPtr);
+	  oc->second.erase(*vc);
+	}
     }
+  addSurfaces(OPtr);
+  return;
+}
+
+void
+ObjSurfMap::buildBlock(const std::vector<MonteCarlo::Object*>& OVec,
+		       const size_t startN,const size_t endN,
+		       std::vector<std::set<int> >& SSets,
+		       std::vector<int>& failFlag,OMTYPE& Out,
+		       ELog::ThreadHold* HPtr)
+  /*!
+    Build the partial map of a block of objects.
+    The surface list of an object is created if empty.
+    Only the block items of SSets/failFlag and Out are 
+    written. A failed object is flagged and left out.
+    \param OVec :: Objects 
+    \param startN :: First index
+    \param endN :: Last index + 1
+    \param SSets :: Surface set of each object
+    \param failFlag :: Set for objects with no surface list
+    \param Out :: Partial map
+    \param HPtr :: Holder of the log messages [0 : not held]
+   */
+{
+  if (HPtr) ELog::EM.holdThread(HPtr);
+  for(size_t i=startN;i<endN;i++)
+    {
+      if (OVec[i]->getSurfSet().empty())
+	{
+	  try
+	    {
+	      OVec[i]->createSurfaceList();
+	    }
+	  catch (const std::exception&)
+	    {
+	      failFlag[i]=1;
+	      continue;
+	    }
+	}
+      SSets[i]=OVec[i]->getSurfSet();
+      std::set<int>::const_iterator sc;
+      for(sc=SSets[i].begin();sc!=SSets[i].end();sc++)
+	Out[*sc].push_back(OVec[i]);
+    }
+  if (HPtr) ELog::EM.holdThread(0);
+  return;
+}
+
+void
+ObjSurfMap::addObjects(const std::vector<MonteCarlo::Object*>& OVec,
+		       const size_t nThread)
+  /*!
+    Add a group of objects not already in the map. 
+    Each thread creates the missing surface lists and
+    builds the partial map of a contiguous block. The 
+    blocks are merged in order, so the map is the same
+    as adding the objects in turn. The log messages of the
+    threads are reported after the join, and a failed 
+    surface list is repeated to raise its error.
+    \param OVec :: Objects 
+    \param nThread :: Number of threads
+   */
+{
+  ELog::RegMethod RegA("ObjSurfMap","addObjects");
+
+  if (OVec.empty()) return;
+  if (graphValid) clearGraph();
+
+  const size_t NT=(nThread>1 && OVec.size()>nThread) ? nThread : 1;
+  std::vector<OMTYPE> Blocks(NT);
+  std::vector<std::set<int> > SSets(OVec.size());
+  std::vector<int> failFlag(OVec.size(),0);
+  if (NT==1)
+    buildBlock(OVec,0,OVec.size(),SSets,failFlag,Blocks[0],0);
+  else
+    {
+      std::vector<boost::shared_ptr<ELog::ThreadHold> > HVec;
+      boost::thread_group TGroup;
+      for(size_t i=0;i<NT;i++)
+	{
+	  HVec.push_back(boost::shared_ptr<ELog::ThreadHold>
+			 (new ELog::ThreadHold));
+	  TGroup.create_thread
+	    (boost::bind(&ObjSurfMap::buildBlock,boost::cref(OVec),
+			 (OVec.size()*i)/NT,(OVec.size()*(i+1))/NT,
+			 boost::ref(SSets),boost::ref(failFlag),
+			 boost::ref(Blocks[i]),HVec.back().get()));
+	}
+      TGroup.join_all();
+      for(size_t i=0;i<NT;i++)
+	ELog::EM.dispatchHold(*HVec[i]);
+    }
+
+  for(size_t i=0;i<OVec.size();i++)
+    if (failFlag[i])
+      OVec[i]->createSurfaceList();
+  if (std::find(failFlag.begin(),failFlag.end(),1)!=failFlag.end())
+    {
+      // Repeated list did not fail : build the map again serially
+      Blocks.assign(1,OMTYPE());
+      failFlag.assign(OVec.size(),0);
+      buildBlock(OVec,0,OVec.size(),SSets,failFlag,Blocks[0],0);
+    }
+
+  for(size_t i=0;i<Blocks.size();i++)
+    {
+      OMTYPE::iterator mc;
+      for(mc=Blocks[i].begin();mc!=Blocks[i].end();mc++)
+	{
+	  STYPE& VItem=SMap[mc->first];
+	  if (VItem.empty())
+	    VItem.swap(mc->second);
+	  else
+	    VItem.insert(VItem.end(),mc->second.begin(),mc->second.end());
+	}
+    }
+  for(size_t i=0;i<OVec.size();i++)
+    ObjSurf[OVec[i]].swap(SSets[i]);
   return;
 }
 
@@ -219,7 +458,9 @@ ObjSurfMap::findNextObject(const int SN,
 			   const Geometry::Vec3D& Pos,
 			   const int objExclude) const
   /*!
-    Calculate the next object 
+    Calculate the next object using the map's
+    own surface sense cache [not thread safe].
+    Writes out the candidate cells on failure.
     \param SN :: Surface number
     \param Pos :: position
     \param ObjExclude :: Excluded object
@@ -228,17 +469,11 @@ ObjSurfMap::findNextObject(const int SN,
 {
   ELog::RegMethod RegA("ObjSurfMap","findNextObject");
 
-  const int flagDebug(debugStatus::Instance().getFlag());
+  MonteCarlo::Object* OPtr=findNextObject(SN,Pos,objExclude,*SCPtr);
+  if (OPtr) return OPtr;
+
   const STYPE& MVec=getObjects(SN);
   STYPE::const_iterator mc;
-
-  for(mc=MVec.begin();mc!=MVec.end();mc++)
-    {
-      if ((*mc)->getName()!=objExclude && 
-	  (*mc)->isDirectionValid(Pos,SN))
-	return *mc;
-    }
-  
   // DEBUG CODE FOR FAILURE:
   ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
   const masterRotate& MR=masterRotate::Instance();
@@ -272,6 +507,329 @@ ObjSurfMap::findNextObject(const int SN,
   return 0;
 }
 
+MonteCarlo::Object*
+ObjSurfMap::findNextObject(const int SN,
+			   const Geometry::Vec3D& Pos,
+			   const int objExclude,
+			   Geometry::SenseCache& SC) const
+  /*!
+    Calculate the next object. Each surface is evaluated
+    once at Pos for all the candidate objects. Nothing
+    is written so it can be used from several threads
+    each with its own cache.
+    \param SN :: Surface number
+    \param Pos :: position
+    \param ObjExclude :: Excluded object
+    \param SC :: Surface sense cache
+    \return Next Object Ptr / 0 on point not valid
+   */
+{
+  ELog::RegMethod RegA("ObjSurfMap","findNextObject");
+
+  SC.setPoint(Pos);
+  if (graphValid)
+    {
+      const size_t kIndex=findKey(SN);
+      if (kIndex==GKey.size()) return 0;
+      const size_t rIndex=findRow(kIndex,objExclude);
+      if (rIndex!=GFrom.size())
+	{
+	  MonteCarlo::Object* OPtr=
+	    testRow(rIndex,SN,objExclude,SC,GFrom.size());
+	  if (OPtr) return OPtr;
+	}
+      // remainder of the surface [skip the from-cell row]
+      return testRow(GKeyIndex[kIndex],SN,objExclude,SC,rIndex);
+    }
+
+  const STYPE& MVec=getObjects(SN);
+  STYPE::const_iterator mc;
+  for(mc=MVec.begin();mc!=MVec.end();mc++)
+    {
+      if ((*mc)->getName()!=objExclude && 
+	  (*mc)->isDirectionValid(SC,SN))
+	return *mc;
+    }
+  
+  return 0;
+}
+
+int
+ObjSurfMap::boxOverlap(const MonteCarlo::Object* APtr,
+		       const MonteCarlo::Object* BPtr)
+  /*!
+    Determine if the bounding boxes of two cells
+    overlap [or touch within boxTol]
+    \param APtr :: First cell
+    \param BPtr :: Second cell
+    \return 1 if the boxes overlap
+  */
+{
+  const Geometry::BoundBox ABox=APtr->getBoundBox();
+  const Geometry::BoundBox BBox=BPtr->getBoundBox();
+  for(size_t i=0;i<3;i++)
+    {
+      if (ABox.getLow()[i]>BBox.getHigh()[i]+boxTol ||
+	  BBox.getLow()[i]>ABox.getHigh()[i]+boxTol)
+	return 0;
+    }
+  return 1;
+}
+
+void
+ObjSurfMap::buildGraph()
+  /*!
+    Compile the map into the adjacency graph. Each signed
+    surface has a row of all its cells [map order] and then
+    a row for each cell on the opposite side of the surface
+    holding the cells whose bounding box overlaps that cell.
+    The rows are flat vectors indexed by offset [CSR].
+    A surface with more than maxPairs from/to pairs only 
+    has the first row. The cell bounding boxes must be set
+    for the overlap to reduce a row.
+  */
+{
+  ELog::RegMethod RegA("ObjSurfMap","buildGraph");
+
+  clearGraph();
+  OMTYPE::const_iterator mc;
+  for(mc=SMap.begin();mc!=SMap.end();mc++)
+    {
+      const STYPE& ToVec=mc->second;
+      GKey.push_back(mc->first);
+      GKeyIndex.push_back(GFrom.size());
+      // row for any cell
+      GFrom.push_back(0);
+      GRowIndex.push_back(GObj.size());
+      GObj.insert(GObj.end(),ToVec.begin(),ToVec.end());
+
+      OMTYPE::const_iterator oc=SMap.find(-mc->first);
+      if (oc!=SMap.end() && oc->second.size()*ToVec.size()<=maxPairs)
+	{
+	  // cells left through the surface [in name order]
+	  std::map<int,const MonteCarlo::Object*> FromMap;
+	  STYPE::const_iterator vc;
+	  for(vc=oc->second.begin();vc!=oc->second.end();vc++)
+	    FromMap.insert(std::map<int,const MonteCarlo::Object*>::
+			   value_type((*vc)->getName(),*vc));
+
+	  std::map<int,const MonteCarlo::Object*>::const_iterator fc;
+	  for(fc=FromMap.begin();fc!=FromMap.end();fc++)
+	    {
+	      const size_t rowStart(GObj.size());
+	      for(vc=ToVec.begin();vc!=ToVec.end();vc++)
+		if ((*vc)->getName()!=fc->first && 
+		    boxOverlap(fc->second,*vc))
+		  GObj.push_back(*vc);
+	      if (GObj.size()!=rowStart)
+		{
+		  GFrom.push_back(fc->first);
+		  GRowIndex.push_back(rowStart);
+		}
+	    }
+	}
+    }
+  GKeyIndex.push_back(GFrom.size());
+  GRowIndex.push_back(GObj.size());
+  GHits.resize(GObj.size(),0);
+  graphValid=1;
+  return;
+}
+
+size_t
+ObjSurfMap::findKey(const int SN) const
+  /*!
+    Find the graph index of a signed surface
+    \param SN :: Signed surface number
+    \return key index / GKey.size() if not found
+  */
+{
+  std::vector<int>::const_iterator kc=
+    std::lower_bound(GKey.begin(),GKey.end(),SN);
+  return (kc!=GKey.end() && *kc==SN) ?
+    static_cast<size_t>(kc-GKey.begin()) : GKey.size();
+}
+
+size_t
+ObjSurfMap::findRow(const size_t kIndex,const int fromCell) const
+  /*!
+    Find the row of a cell left through a surface
+    \param kIndex :: Key index
+    \param fromCell :: Cell being left
+    \return row index / GFrom.size() if not found
+  */
+{
+  std::vector<int>::const_iterator aIter=GFrom.begin()+
+    static_cast<long int>(GKeyIndex[kIndex]+1);
+  std::vector<int>::const_iterator bIter=GFrom.begin()+
+    static_cast<long int>(GKeyIndex[kIndex+1]);
+  std::vector<int>::const_iterator rc=
+    std::lower_bound(aIter,bIter,fromCell);
+  return (rc!=bIter && *rc==fromCell) ?
+    static_cast<size_t>(rc-GFrom.begin()) : GFrom.size();
+}
+
+MonteCarlo::Object*
+ObjSurfMap::testRow(const size_t rIndex,const int SN,
+		    const int objExclude,Geometry::SenseCache& SC,
+		    const size_t skipIndex) const
+  /*!
+    Find the first valid cell in a row of the graph.
+    The cells whose bounding box holds the point are tested
+    first and then the rest, each in row [hit] order.
+    Cells in the skip row [already tested] are not tested.
+    \param rIndex :: Row index
+    \param SN :: Surface number
+    \param objExclude :: Excluded object
+    \param SC :: Surface sense cache [point set]
+    \param skipIndex :: Row to skip / GFrom.size() for none
+    \return Object Ptr / 0 if none valid
+  */
+{
+  std::vector<MonteCarlo::Object*>::const_iterator aIter(GObj.end());
+  std::vector<MonteCarlo::Object*>::const_iterator bIter(GObj.end());
+  if (skipIndex!=GFrom.size())
+    {
+      aIter=GObj.begin()+static_cast<long int>(GRowIndex[skipIndex]);
+      bIter=GObj.begin()+static_cast<long int>(GRowIndex[skipIndex+1]);
+    }
+  const Geometry::Vec3D& Pos=SC.getPoint();
+  // pass 0 : box holds Pos / pass 1 : the rest
+  for(size_t pass=0;pass<2;pass++)
+    for(size_t i=GRowIndex[rIndex];i<GRowIndex[rIndex+1];i++)
+      {
+	MonteCarlo::Object* OPtr=GObj[i];
+	if (OPtr->inBoundBox(Pos)!=(pass==0))
+	  continue;
+	if (OPtr->getName()!=objExclude && 
+	    std::find(aIter,bIter,OPtr)==bIter &&
+	    OPtr->isDirectionValid(SC,SN))
+	  return OPtr;
+      }
+  return 0;
+}
+
+void
+ObjSurfMap::addRowHit(const size_t rIndex,const MonteCarlo::Object* OPtr)
+  /*!
+    Count a hit on a cell in a row
+    \param rIndex :: Row index
+    \param OPtr :: Cell entered
+  */
+{
+  for(size_t i=GRowIndex[rIndex];i<GRowIndex[rIndex+1];i++)
+    if (GObj[i]==OPtr)
+      {
+	GHits[i]++;
+	return;
+      }
+  return;
+}
+
+void
+ObjSurfMap::addHit(const int SN,const int fromCell,
+		   const MonteCarlo::Object* OPtr)
+  /*!
+    Record a transition through a surface. The counts
+    are used to order the rows in orderGraph.
+    \param SN :: Signed surface number [as findNextObject]
+    \param fromCell :: Cell left
+    \param OPtr :: Cell entered
+  */
+{
+  if (!graphValid || !OPtr) return;
+  const size_t kIndex=findKey(SN);
+  if (kIndex==GKey.size()) return;
+
+  addRowHit(GKeyIndex[kIndex],OPtr);
+  const size_t rIndex=findRow(kIndex,fromCell);
+  if (rIndex!=GFrom.size())
+    addRowHit(rIndex,OPtr);
+  return;
+}
+
+void
+ObjSurfMap::orderGraph()
+  /*!
+    Sort each row of the graph by decreasing hit count.
+    Equal counts keep their order.
+  */
+{
+  ELog::RegMethod RegA("ObjSurfMap","orderGraph");
+
+  std::vector<std::pair<size_t,MonteCarlo::Object*> > Row;
+  for(size_t rIndex=0;rIndex<GFrom.size();rIndex++)
+    {
+      const size_t aIndex(GRowIndex[rIndex]);
+      const size_t bIndex(GRowIndex[rIndex+1]);
+      Row.clear();
+      for(size_t i=aIndex;i<bIndex;i++)
+	Row.push_back(std::pair<size_t,MonteCarlo::Object*>
+		      (GHits[i],GObj[i]));
+      std::stable_sort(Row.begin(),Row.end(),hitCompare());
+      for(size_t i=aIndex;i<bIndex;i++)
+	{
+	  GHits[i]=Row[i-aIndex].first;
+	  GObj[i]=Row[i-aIndex].second;
+	}
+    }
+  return;
+}
+
+void
+ObjSurfMap::learn(MonteCarlo::Object* InitObj,
+		  const Geometry::Vec3D& Centre,const size_t N)
+  /*!
+    Warm up the graph: track N random rays from Centre,
+    count the transitions and order the rows by them.
+    \param InitObj :: Cell containing Centre
+    \param Centre :: Start point
+    \param N :: Number of rays
+  */
+{
+  ELog::RegMethod RegA("ObjSurfMap","learn");
+
+  if (!graphValid)
+    buildGraph();
+
+  MTRand TRand(static_cast<MTRand::uint32>(5489UL));
+  Geometry::SenseCache SC;
+  const Geometry::Surface* SPtr;
+  double aDist;
+  size_t nHit(0);
+
+  const int initSurfNum=InitObj->isOnSide(Centre);
+  for(size_t i=0;i<N;i++)
+    {
+      const double phi=TRand.rand()*M_PI;
+      const double theta=2.0*TRand.rand()*M_PI;
+      MonteCarlo::neutron TNeut(1,Centre,
+				Geometry::Vec3D(cos(theta)*sin(phi),
+						sin(theta)*sin(phi),
+						cos(phi)));
+      MonteCarlo::Object* OPtr=InitObj;
+      int SN(-initSurfNum);
+      while(OPtr && OPtr->getImp())
+	{
+	  SN= -OPtr->trackOutCell(TNeut,aDist,SPtr,-SN);
+	  if (!SN || aDist>1e30) break;
+	  TNeut.moveForward(aDist);
+	  MonteCarlo::Object* NPtr=
+	    findNextObject(SN,TNeut.Pos,OPtr->getName(),SC);
+	  if (NPtr)
+	    {
+	      addHit(SN,OPtr->getName(),NPtr);
+	      nHit++;
+	    }
+	  OPtr=NPtr;
+	}
+    }
+  orderGraph();
+  ELog::EM<<"Graph rows == "<<GFrom.size()<<" : transitions == "
+	  <<nHit<<ELog::endDiag;
+  return;
+}
+
 void
 ObjSurfMap::removeReverseSurf(const int primSurf,const int revSurf)
   /*!
@@ -290,13 +848,16 @@ ObjSurfMap::removeReverseSurf(const int primSurf,const int revSurf)
       OMTYPE::iterator ac=SMap.find(sign_index*revSurf);
       if (ac!=SMap.end())
 	{
-	  STYPE& OVec=ac->second;
-	  STYPE::iterator oc;
+	  // copy as addSurface changes SMap
+	  const STYPE OVec=ac->second;
+	  SMap.erase(ac);
+	  STYPE::const_iterator oc;
 	  // add to reverse list of opposite signed prim surf
 	  for(oc=OVec.begin();oc!=OVec.end();oc++)
-	    addSurface(-sign_index*primSurf,*oc);
-	  // Now remove item list
-	  SMap.erase(ac);
+	    {
+	      ObjSurf[*oc].erase(sign_index*revSurf);
+	      addSurface(-sign_index*primSurf,*oc);
+	    }
 	}
     }
   return;
@@ -0,0 +1,318 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   process/RuleBuild.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Rules.h"
+#include "HeadRule.h"
+#include "surfRegister.h"
+#include "RuleBuild.h"
+
+namespace ModelSupport
+{
+
+RuleBuild::RuleBuild(const surfRegister& SR,const int index) :
+  SMap(SR),offset(index),Term(0),Full(0)
+  /*!
+    Constructor
+    \param SR :: Surface register of the component
+    \param index :: Surface offset [as getComposite]
+  */
+{}
+
+RuleBuild::RuleBuild(const RuleBuild& A) :
+  SMap(A.SMap),offset(A.offset),
+  Term((A.Term) ? A.Term->clone() : 0),
+  Full((A.Full) ? A.Full->clone() : 0)
+  /*!
+    Copy constructor
+    \param A :: RuleBuild to copy
+  */
+{}
+
+RuleBuild::~RuleBuild()
+  /*!
+    Destructor
+  */
+{
+  delete Term;
+  delete Full;
+}
+
+void
+RuleBuild::clear()
+  /*!
+    Remove all the items
+  */
+{
+  delete Term;
+  delete Full;
+  Term=0;
+  Full=0;
+  return;
+}
+
+int
+RuleBuild::realSurf(const int SN,const int index) const
+  /*!
+    Convert an offset surface to the real surface
+    \param SN :: Signed surface number
+    \param index :: Offset to add
+    \return real surface number [signed]
+  */
+{
+  return (SN>0) ? SMap.realSurf(SN+index) : SMap.realSurf(SN-index);
+}
+
+void
+RuleBuild::addInter(Rule* RPtr)
+  /*!
+    Add a unit to the current intersection term
+    \param RPtr :: Unit [ownership taken]
+  */
+{
+  Term=(Term) ? new Intersection(Term,RPtr) : RPtr;
+  return;
+}
+
+void
+RuleBuild::addUnion(Rule* RPtr)
+  /*!
+    Close the current term and start a new 
+    one with a unit
+    \param RPtr :: Unit [ownership taken]
+  */
+{
+  if (Term)
+    Full=(Full) ? new Union(Full,Term) : Term;
+  Term=RPtr;
+  return;
+}
+
+RuleBuild&
+RuleBuild::inter(const int SN)
+  /*!
+    Intersect with a surface
+    \param SN :: Signed surface [offset added]
+    \return *this
+  */
+{
+  SurfPoint* SPtr=new SurfPoint();
+  SPtr->setKeyN(realSurf(SN,offset));
+  addInter(SPtr);
+  return *this;
+}
+
+RuleBuild&
+RuleBuild::inter(const int SA,const int SB)
+  /*!
+    Intersect with two surfaces [e.g. a slab]
+    \param SA :: Signed surface [offset added]
+    \param SB :: Signed surface [offset added]
+    \return *this
+  */
+{
+  inter(SA);
+  return inter(SB);
+}
+
+RuleBuild&
+RuleBuild::inter(const int* const SArray,const size_t N)
+  /*!
+    Intersect with a list of surfaces
+    \param SArray :: Signed surfaces [offset added]
+    \param N :: Number of surfaces
+    \return *this
+  */
+{
+  for(size_t i=0;i<N;i++)
+    inter(SArray[i]);
+  return *this;
+}
+
+RuleBuild&
+RuleBuild::interTrue(const int SN)
+  /*!
+    Intersect with a surface without an offset 
+    [the T numbers of getComposite]
+    \param SN :: Signed surface 
+    \return *this
+  */
+{
+  SurfPoint* SPtr=new SurfPoint();
+  SPtr->setKeyN(SMap.realSurf(SN));
+  addInter(SPtr);
+  return *this;
+}
+
+RuleBuild&
+RuleBuild::inter(const HeadRule& HR)
+  /*!
+    Intersect with a rule [as a bracketed unit]
+    \param HR :: Rule to add [no offset]
+    \return *this
+  */
+{
+  if (HR.hasRule())
+    addInter(HR.getTopRule()->clone());
+  return *this;
+}
+
+RuleBuild&
+RuleBuild::inter(const RuleBuild& A)
+  /*!
+    Intersect with a rule being built [as a bracketed unit]
+    \param A :: Builder to add
+    \return *this
+  */
+{
+  Rule* RPtr=A.makeRule();
+  if (RPtr)
+    addInter(RPtr);
+  return *this;
+}
+
+RuleBuild&
+RuleBuild::interComp(const HeadRule& HR)
+  /*!
+    Intersect with the complement of a rule : #( )
+    \param HR :: Rule to add [no offset]
+    \return *this
+  */
+{
+  if (HR.hasRule())
+    addInter(new CompGrp(0,HR.getTopRule()->clone()));
+  return *this;
+}
+
+RuleBuild&
+RuleBuild::interComp(const RuleBuild& A)
+  /*!
+    Intersect with the complement of a rule being built : #( )
+    \param A :: Builder to add
+    \return *this
+  */
+{
+  Rule* RPtr=A.makeRule();
+  if (RPtr)
+    addInter(new CompGrp(0,RPtr));
+  return *this;
+}
+
+RuleBuild&
+RuleBuild::unite(const int SN)
+  /*!
+    Union with a new term starting with a surface
+    \param SN :: Signed surface [offset added]
+    \return *this
+  */
+{
+  SurfPoint* SPtr=new SurfPoint();
+  SPtr->setKeyN(realSurf(SN,offset));
+  addUnion(SPtr);
+  return *this;
+}
+
+RuleBuild&
+RuleBuild::unite(const HeadRule& HR)
+  /*!
+    Union with a new term starting with a rule
+    \param HR :: Rule to add [no offset]
+    \return *this
+  */
+{
+  if (HR.hasRule())
+    addUnion(HR.getTopRule()->clone());
+  return *this;
+}
+
+RuleBuild&
+RuleBuild::unite(const RuleBuild& A)
+  /*!
+    Union with a new term starting with a rule being built
+    \param A :: Builder to add
+    \return *this
+  */
+{
+  Rule* RPtr=A.makeRule();
+  if (RPtr)
+    addUnion(RPtr);
+  return *this;
+}
+
+Rule*
+RuleBuild::makeRule() const
+  /*!
+    Create the rule tree of the items so far
+    \return new Rule [0 if empty]
+  */
+{
+  if (!Full)
+    return (Term) ? Term->clone() : 0;
+  if (!Term)
+    return Full->clone();
+  return new Union(Full->clone(),Term->clone());
+}
+
+HeadRule
+RuleBuild::getRule() const
+  /*!
+    Create the rule of the items so far
+    \return HeadRule 
+  */
+{
+  HeadRule Out;
+  Out.setRule(makeRule());
+  return Out;
+}
+
+std::string
+RuleBuild::display() const
+  /*!
+    Write out the rule
+    \return rule string [as a cell rule]
+  */
+{
+  return getRule().display();
+}
+
+}  // NAMESPACE ModelSupport
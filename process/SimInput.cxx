@@ -105,10 +105,16 @@ inputPatternSim(Simulation& System,const mainSystem::inputParam& IParam)
   */
 {
   ELog::RegMethod RegA("SimInput","inputPatterSim");
+  // Same start point as SimValid
+  if (IParam.flag("osmLearn"))
+    System.learnObjSurfMap(Geometry::Vec3D(0.1,0.1,0.1),
+			   IParam.getValue<size_t>("osmLearn"));
+
   if (IParam.flag("validCheck"))
     {
       ELog::EM<<"TRACK "<<ELog::endDebug;
       ModelSupport::SimValid SValidCheck;
+      SValidCheck.setThreads(System.getThreads());
       SValidCheck.run(System,IParam.getValue<size_t>("validCheck"));
     }
   
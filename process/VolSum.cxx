@@ -30,9 +30,13 @@
 #include <map>
 #include <set>
 #include <vector>
+#include <algorithm>
 #include <boost/shared_ptr.hpp>
 #include <boost/format.hpp>
 #include <boost/multi_array.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -47,6 +51,7 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "SenseCache.h"
 #include "Quaternion.h"
 #include "localRotate.h"
 #include "masterRotate.h"
@@ -68,6 +73,7 @@
 #include "cellFluxTally.h"
 #include "ObjSurfMap.h"
 #include "neutron.h"
+#include "TrackCache.h"
 #include "Simulation.h"
 #include "volUnit.h"
 #include "VolSum.h"
@@ -77,10 +83,12 @@ extern MTRand RNG;
 namespace ModelSupport
 {
 
+const size_t VolSum::blockSize(4096);
+
 VolSum::VolSum(const Geometry::Vec3D& OPt,
 	       const double R) : 
   Origin(OPt),radius(R),fullVol(M_PI*R*R),
-  totalDist(0),nTracks(0)
+  totalDist(0),nTracks(0),nThread(1)
   /*!
     Constructor
     \param OPt :: Centre
@@ -91,7 +99,7 @@ VolSum::VolSum(const Geometry::Vec3D& OPt,
 VolSum::VolSum(const VolSum& A) : 
   Origin(A.Origin),radius(A.radius),
   fullVol(A.fullVol),totalDist(A.totalDist),
-  nTracks(A.nTracks),tallyVols(A.tallyVols)
+  nTracks(A.nTracks),nThread(A.nThread),tallyVols(A.tallyVols)
   /*!
     Copy constructor
     \param A :: VolSum to copy
@@ -113,6 +121,7 @@ VolSum::operator=(const VolSum& A)
       fullVol=A.fullVol;
       totalDist=A.totalDist;
       nTracks=A.nTracks;
+      nThread=A.nThread;
       tallyVols=A.tallyVols;
     }
   return *this;
@@ -196,20 +205,33 @@ VolSum::addTallyCell(const int TN,const int CN)
 }
 
 void
-VolSum::addDistance(const int ObjN,const double D)
+VolSum::addDistance(tvTYPE& TV,const int ObjN,const double D)
   /*!
-    Adds distance to all the objects
+    Adds distance to all the objects of a tally set
+    \param TV :: Tally volumes to add to
     \param ObjN :: Object number
     \param D :: Distance to add to tally calc
    */
 {
   // Change to a boost::bind
   tvTYPE::iterator mc;
-  for(mc=tallyVols.begin();mc!=tallyVols.end();mc++)
+  for(mc=TV.begin();mc!=TV.end();mc++)
     mc->second.addUnit(ObjN,D);
   return;
 }
 
+void
+VolSum::addDistance(const int ObjN,const double D)
+  /*!
+    Adds distance to all the objects
+    \param ObjN :: Object number
+    \param D :: Distance to add to tally calc
+   */
+{
+  addDistance(tallyVols,ObjN,D);
+  return;
+}
+
 void
 VolSum::addFlux(const int ObjN,const double& R,const double& D)
   /*!
@@ -242,37 +264,104 @@ VolSum::reset()
 }
 
 void
-VolSum::pointRun(const Simulation& System,const size_t N) 
+VolSum::pointBlock(const Simulation& System,MTRand& TRand,
+		   const size_t N,tvTYPE& TV) const
   /*!
-    Calculate the tracking
-    \param System :: Simulation to use
+    Calculate a block of points. Uses its own 
+    surface sense cache.
+    \param System :: Simulation to use [read only]
+    \param TRand :: Random number stream for the block
     \param N :: Number of points to test
+    \param TV :: Tally volumes to add to
   */
 {
-  ELog::RegMethod RegA("VolSum","run");
-  
+  ELog::RegMethod RegA("VolSum","pointBlock");
+
+  Geometry::SenseCache SC;
+
   MonteCarlo::Object* OPtr(0);
-  reset();
-  fullVol=4.0*M_PI*(radius*radius*radius)/3.0;
-  // Note for sphere that you can use X,Y,Z in any orthogonal 
-  // directiron
   double phi,theta;
-  Geometry::Vec3D XPt;
   for(size_t i=0;i<N;i++)
     {
-      // Get random starting point on edge of volume
-      phi=RNG.rand()*M_PI;
-      theta=2.0*RNG.rand()*M_PI;
+      phi=TRand.rand()*M_PI;
+      theta=2.0*TRand.rand()*M_PI;
       Geometry::Vec3D Pt(cos(theta)*sin(phi),
 			 sin(theta)*sin(phi),
 			 cos(phi));
-      // Deal with scaling
-      Pt*=radius*pow(RNG.rand(),0.3333333333);
+      Pt*=radius*pow(TRand.rand(),0.3333333333);
 
-      OPtr=System.findCell(Pt,OPtr);      
-      addDistance(OPtr->getName(),1.0);
+      OPtr=System.findCell(Pt,OPtr,SC);      
+      addDistance(TV,OPtr->getName(),1.0);
     }
-  nTracks+=N;
+  return;
+}
+
+void
+VolSum::pointGroup(const Simulation& System,const unsigned int seed,
+		   const size_t N,const size_t first,const size_t step,
+		   tvTYPE& TV) const
+  /*!
+    Calculate the point blocks first, first+step, ... 
+    Each block has its own random stream keyed on the
+    common seed and the block index.
+    \param System :: Simulation to use [read only]
+    \param seed :: Common seed
+    \param N :: Total number of points 
+    \param first :: First block
+    \param step :: Step between blocks [number of groups]
+    \param TV :: Tally volumes to add to
+  */
+{
+  for(size_t i=first;i*blockSize<N;i+=step)
+    {
+      MTRand::uint32 Key[2];
+      Key[0]=seed;
+      Key[1]=static_cast<MTRand::uint32>(i);
+      MTRand TRand(Key,2);
+      pointBlock(System,TRand,std::min(N,(i+1)*blockSize)-i*blockSize,TV);
+    }
+  return;
+}
+
+void
+VolSum::pointRun(const Simulation& System,const size_t N) 
+  /*!
+    Calculate the tracking. A serial run [nThread<=1] draws
+    the points from RNG in order. With threads the points 
+    are split into fixed blocks, each with its own random 
+    stream, and the blocks are shared over the threads with
+    a private copy of the tally volumes. Each point adds an
+    exact unit count so the threaded result does not depend
+    on the number of threads.
+    \param System :: Simulation to use
+    \param N :: Number of points to test
+  */
+{
+  ELog::RegMethod RegA("VolSum","pointRun");
+  
+  reset();
+  fullVol=4.0*M_PI*(radius*radius*radius)/3.0;
+  if (nThread<=1)
+    pointBlock(System,RNG,N,tallyVols);
+  else
+    {
+      const MTRand::uint32 seed=RNG.randInt();
+      const size_t nGroup=std::min(nThread,(N+blockSize-1)/blockSize);
+      std::vector<tvTYPE> TVols(nGroup,tallyVols);
+      boost::thread_group TGroup;
+      for(size_t i=0;i<nGroup;i++)
+	TGroup.create_thread(boost::bind(&VolSum::pointGroup,this,
+					 boost::cref(System),seed,N,
+					 i,nGroup,boost::ref(TVols[i])));
+      TGroup.join_all();
+
+      tvTYPE::iterator mc;
+      for(size_t i=0;i<nGroup;i++)
+	for(mc=tallyVols.begin();mc!=tallyVols.end();mc++)
+	  mc->second.merge(TVols[i].find(mc->first)->second);
+    }
+
+  nTracks+=static_cast<int>(N);
   return;
 }
 
@@ -292,6 +381,7 @@ VolSum::run(const Simulation& System,const size_t N)
   fullVol=M_PI*radius*radius;
   const Geometry::Surface* SPtr;          // Output surface
   double aDist;       
+  MonteCarlo::TrackCache TC;
 
   // Note for sphere that you can use X,Y,Z in any orthogonal 
   // directiron
@@ -322,6 +412,7 @@ VolSum::run(const Simulation& System,const size_t N)
       totalDist+=trackDistance;
       
       MonteCarlo::neutron TNeut(1,Origin+Pt*radius,XPt);
+      TC.setRay(TNeut.Pos,TNeut.uVec);
 
       // Find Initial cell [Store for next time]
       InitObj=System.findCell(TNeut.Pos,InitObj);      
@@ -331,7 +422,7 @@ VolSum::run(const Simulation& System,const size_t N)
       while(OPtr)
 	{
 	  // Note: Need OPPOSITE Sign on exiting surface
-	  SN= -OPtr->trackOutCell(TNeut,aDist,SPtr,-SN);
+	  SN= -OPtr->trackOutCell(TNeut,aDist,SPtr,-SN,TC);
 	  trackDistance-=aDist;
 	  if (trackDistance > 0.0)
 	    {
@@ -83,6 +83,7 @@ calcVolumes(Simulation* SimPtr,const mainSystem::inputParam& IParam)
       const double R=IParam.getValue<double>("volume",3);
       const int NP=IParam.getValue<int>("volNum");
       VolSum VTally(Org,R);
+      VTally.setThreads(SimPtr->getThreads());
       VTally.populateTally(*SimPtr);
       VTally.pointRun(*SimPtr,NP);
       VTally.write("volumes");
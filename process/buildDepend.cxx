@@ -0,0 +1,246 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   process/buildDepend.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <list>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "support.h"
+#include "Code.h"
+#include "FItem.h"
+#include "varList.h"
+#include "FuncDataBase.h"
+#include "MD5hash.h"
+#include "objectRegister.h"
+#include "buildDepend.h"
+
+namespace ModelSupport
+{
+
+buildDepend::buildDepend() 
+  /*!
+    Constructor
+  */
+{}
+
+buildDepend::buildDepend(const buildDepend& A) : 
+  VarMap(A.VarMap),HashMap(A.HashMap)
+  /*!
+    Copy constructor
+    \param A :: buildDepend to copy
+  */
+{}
+
+buildDepend&
+buildDepend::operator=(const buildDepend& A)
+  /*!
+    Assignment operator
+    \param A :: buildDepend to copy
+    \return *this
+  */
+{
+  if (this!=&A)
+    {
+      VarMap=A.VarMap;
+      HashMap=A.HashMap;
+    }
+  return *this;
+}
+
+buildDepend::~buildDepend()
+  /*!
+    Destructor
+  */
+{}
+
+void
+buildDepend::clear()
+  /*!
+    Remove all the recorded components
+  */
+{
+  VarMap.clear();
+  HashMap.clear();
+  return;
+}
+
+std::string
+buildDepend::compName(const std::vector<std::string>& Names,
+		      const std::string& Var)
+  /*!
+    Find the component that owns a variable
+    \param Names :: Registered component names
+    \param Var :: Variable name
+    \return longest component name that starts Var / "global"
+  */
+{
+  size_t best(0);
+  std::string Out("global");
+  std::vector<std::string>::const_iterator vc;
+  for(vc=Names.begin();vc!=Names.end();vc++)
+    {
+      if (vc->size()>best && !Var.compare(0,vc->size(),*vc))
+	{
+	  best=vc->size();
+	  Out= *vc;
+	}
+    }
+  return Out;
+}
+
+std::string
+buildDepend::hashVar(const FuncDataBase& Control,
+		     const std::set<std::string>& Vars)
+  /*!
+    Calculate the hash of the values of a set of variables.
+    Missing variables are included so that adding one 
+    [which replaces a default] counts as a change.
+    \param Control :: DataBase
+    \param Vars :: Variables to hash
+    \return Hash string
+  */
+{
+  const varList& VL=Control.getVarList();
+  std::ostringstream cx;
+  std::set<std::string>::const_iterator sc;
+  for(sc=Vars.begin();sc!=Vars.end();sc++)
+    {
+      cx<<*sc<<" = ";
+      const FItem* FI=VL.findVar(*sc);
+      if (FI)
+	{
+	  std::string Value;
+	  FI->getValue(Value);
+	  cx<<Value;
+	}
+      else
+	cx<<"-";
+      cx<<std::endl;
+    }
+  MD5hash sum;
+  return sum.processMessage(cx.str());
+}
+
+void
+buildDepend::record(const FuncDataBase& Control)
+  /*!
+    Record the variables read since the read set of
+    the DataBase was last cleared and stop its recording. 
+    This must be called before the objectRegister is reset.
+    \param Control :: DataBase
+  */
+{
+  ELog::RegMethod RegA("buildDepend","record");
+
+  Control.stopReadSet();
+  const objectRegister& OR=objectRegister::Instance();
+  std::vector<std::string> Names;
+  for(int i=0;i<OR.nRegion();i++)
+    Names.push_back(OR.getRegionName(i));
+
+  clear();
+  const std::set<std::string>& RSet=Control.getReadSet();
+  std::set<std::string>::const_iterator sc;
+  for(sc=RSet.begin();sc!=RSet.end();sc++)
+    VarMap[compName(Names,*sc)].insert(*sc);
+
+  VTYPE::const_iterator mc;
+  for(mc=VarMap.begin();mc!=VarMap.end();mc++)
+    HashMap.insert(HTYPE::value_type(mc->first,
+				     hashVar(Control,mc->second)));
+  return;
+}
+
+int
+buildDepend::hasChanged(const FuncDataBase& Control,
+			std::vector<std::string>& Changed) const
+  /*!
+    Find the components with changed input variables
+    \param Control :: DataBase
+    \param Changed :: Names of the changed components 
+    \return true if a rebuild is required [including no record]
+  */
+{
+  ELog::RegMethod RegA("buildDepend","hasChanged");
+
+  Changed.clear();
+  if (HashMap.empty())
+    return 1;
+
+  VTYPE::const_iterator mc;
+  for(mc=VarMap.begin();mc!=VarMap.end();mc++)
+    {
+      HTYPE::const_iterator hc=HashMap.find(mc->first);
+      if (hc==HashMap.end() || 
+	  hc->second!=hashVar(Control,mc->second))
+	Changed.push_back(mc->first);
+    }
+  return (Changed.empty()) ? 0 : 1;
+}
+
+int
+buildDepend::hasChanged(const FuncDataBase& Control) const
+  /*!
+    Determine if a rebuild is required and write
+    the changed components
+    \param Control :: DataBase
+    \return true if a rebuild is required
+  */
+{
+  ELog::RegMethod RegA("buildDepend","hasChanged");
+
+  std::vector<std::string> Changed;
+  if (!hasChanged(Control,Changed))
+    {
+      ELog::EM<<"No component inputs changed"<<ELog::endDiag;
+      return 0;
+    }
+  if (!Changed.empty())
+    {
+      ELog::EM<<"Changed components :";
+      std::vector<std::string>::const_iterator vc;
+      for(vc=Changed.begin();vc!=Changed.end();vc++)
+	ELog::EM<<" "<<*vc;
+      ELog::EM<<ELog::endDiag;
+    }
+  return 1;
+}
+
+} // NAMESPACE ModelSupport
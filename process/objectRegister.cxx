@@ -73,9 +73,14 @@ void
 objectRegister::reset()
   /*!
     Delete all the references to the shared_ptr register
+    and all the registered cell ranges
   */
 {
   Components.erase(Components.begin(),Components.end());
+  regionMap.erase(regionMap.begin(),regionMap.end());
+  regionNames.clear();
+  rangeIndex.clear();
+  cellNumber=1000000;
   return;
 }
 objectRegister& 
@@ -135,35 +140,71 @@ objectRegister::getRange(const std::string& Name,const int Index) const
   return 0;
 }
 
-std::string
-objectRegister::inRange(const int Index) const
+int
+objectRegister::inRangeID(const int Index) const
   /*!
-    Get the range of an object
-    \param Name :: Name of the object to get
-    \param Index :: Offset number
-    \return string
+    Find the component that holds a cell number.
+    Binary search of the sorted ranges. The range end 
+    [start+size] is inclusive, as the original search: 
+    where a block starts at that number the later block
+    holds it.
+    \param Index :: Cell number
+    \return component id / -1 if not registered
    */
 {
-  static std::string prev;
-  
-  MTYPE::const_iterator mc;
-  mc=regionMap.find(prev);
-
-  if (mc!=regionMap.end() && 
-      Index>=mc->second.first && 
-      Index<=mc->second.first+mc->second.second)
-    return mc->first;
-    
-  for(mc=regionMap.begin();mc!=regionMap.end();mc++)
+  // first range with start > Index
+  size_t lowIndex(0);
+  size_t highIndex(rangeIndex.size());
+  while(lowIndex<highIndex)
     {
-      const std::pair<int,int>& IP=mc->second;
-      if (Index>=IP.first && Index<=IP.first+IP.second)
-	{
-	  prev=mc->first;
-	  return mc->first;
-	}
+      const size_t mid((lowIndex+highIndex)/2);
+      if (rangeIndex[mid].start<=Index)
+	lowIndex=mid+1;
+      else
+	highIndex=mid;
     }
-  return std::string("");
+  if (!lowIndex || Index>rangeIndex[lowIndex-1].end)
+    return -1;
+  return rangeIndex[lowIndex-1].compID;
+}
+
+const std::string&
+objectRegister::inRange(const int Index) const
+  /*!
+    Get the name of the component that holds a cell
+    \param Index :: Cell number
+    \return Component name / empty string 
+   */
+{
+  return getRegionName(inRangeID(Index));
+}
+
+int
+objectRegister::getRegionID(const std::string& Name) const
+  /*!
+    Get the component id of a registered name
+    \param Name :: Full name of the block
+    \return component id / -1 if not registered
+   */
+{
+  std::vector<std::string>::const_iterator vc=
+    std::find(regionNames.begin(),regionNames.end(),Name);
+  return (vc!=regionNames.end()) ? 
+    static_cast<int>(vc-regionNames.begin()) : -1;
+}
+
+const std::string&
+objectRegister::getRegionName(const int compID) const
+  /*!
+    Get the name of a component id
+    \param compID :: Component id
+    \return Name / empty string if compID not valid
+   */
+{
+  static const std::string emptyName;
+  if (compID<0 || compID>=static_cast<int>(regionNames.size()))
+    return emptyName;
+  return regionNames[static_cast<size_t>(compID)];
 }
 
 int
@@ -192,6 +233,18 @@ objectRegister::cell(const std::string& Name,const int Index,const int size)
     }
   regionMap.insert(MTYPE::value_type(cx.str(),
 				     std::pair<int,int>(cellNumber,size)));
+
+  rangeUnit RU;
+  RU.start=cellNumber;
+  RU.end=cellNumber+size;
+  RU.compID=static_cast<int>(regionNames.size());
+  regionNames.push_back(cx.str());
+  // keep sorted by start [new blocks are normally last]
+  std::vector<rangeUnit>::iterator vc=rangeIndex.end();
+  while(vc!=rangeIndex.begin() && (vc-1)->start>RU.start)
+    vc--;
+  rangeIndex.insert(vc,RU);
+
   cellNumber+=size;
   return cellNumber-size;
 }
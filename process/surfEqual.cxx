@@ -79,6 +79,8 @@
 
 //typedef ModelSupport::surfIndex::STYPE SMAP;
 typedef std::map<int,Geometry::Surface*> SMAP;
+/// Candidate sets [buckets of the surface index]
+typedef std::vector<const SMAP*> CVEC;
 
 namespace ModelSupport
 {
@@ -95,8 +97,7 @@ struct unknownSurface
 {
   /// Handle Index out of range
   static RetType 
-  dispatch(const int Index,const Geometry::Surface*,
-	   const std::map<int,Geometry::Surface*>&)
+  dispatch(const int Index,const Geometry::Surface*,const CVEC&)
     {
       throw ColErr::IndexError<int>(Index,
 				    Geometry::ExportSize,"unknownSurface");
@@ -117,14 +118,13 @@ template<class State,class Index,typename RetType>
 struct EqualSurface
 {
   static RetType
-  dispatch(const int I,RetType SPtr,
-	   const std::map<int,Geometry::Surface*>& SMap)
+  dispatch(const int I,RetType SPtr,const CVEC& SMap)
     /*!
       Creates the pointer to the surface
       Index refers to the positon on the Geometry::ExportClass list
       \param I :: Index of runtime value (check with Index)
       \param SPtr :: Surface pointer      
-      \param SMap :: Surface to use
+      \param SMap :: Candidate surface sets
       \retval Ptr :: success
     */
     {
@@ -172,7 +172,9 @@ equalSurface(const Geometry::Surface* SPtr)
     EqualSurface<boost::mpl::_1 , boost::mpl::_2,const Geometry::Surface*> >::type FTYPE;
   
   ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
-  return FTYPE::dispatch(Index,SPtr,SurI.surMap());
+  CVEC Candidate;
+  SurI.equalCandidates(SPtr,Candidate);
+  return FTYPE::dispatch(Index,SPtr,Candidate);
 }
 
 Geometry::Surface*
@@ -194,35 +196,45 @@ equalSurface(Geometry::Surface* SPtr)
     EqualSurface<boost::mpl::_1 , boost::mpl::_2,Geometry::Surface*> >::type FTYPE;
   
   ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
-  return FTYPE::dispatch(Index,SPtr,SurI.surMap());
+  CVEC Candidate;
+  SurI.equalCandidates(SPtr,Candidate);
+  return FTYPE::dispatch(Index,SPtr,Candidate);
 }
 
 
 template<typename SurfType,typename RetType>
 RetType
-EqualSurf(SurfType surf,const SMAP& SurMap)
+EqualSurf(SurfType surf,const CVEC& SurSets)
   /*!
     Helper function to determine if the surface object
-    is similar to any we currently have
+    is similar to any we currently have. The first equal
+    surface in number order [over all the sets] is returned.
     \param surf : Surface to find [Ptr]
-    \param SurMap :: surface map to objects
+    \param SurSets :: surface sets [each in number order]
     \returns Surface Ptr (either new/old)
   */
 {
   ELog::RegMethod RegA("surfEqual","EqualSurf<>");
 		       //+SurfType::classType()+">");  // remove ptr (*)
   const int index=surf->getName();
+  SurfType Out(0);
+  CVEC::const_iterator vc;
   SMAP::const_iterator mc;
-  for(mc=SurMap.begin();mc!=SurMap.end();mc++)
-    {
-      if (mc->first!=index) 
-        {
-	  SurfType sndObj=dynamic_cast<SurfType>(mc->second);
-          if (sndObj && sndObj->operator==(*surf))
-	    return static_cast<RetType>(sndObj); 
-	}
-    }
-  return static_cast<RetType>(surf);
+  for(vc=SurSets.begin();vc!=SurSets.end();vc++)
+    for(mc=(*vc)->begin();mc!=(*vc)->end() &&
+	  (!Out || mc->first<Out->getName());mc++)
+      {
+	if (mc->first!=index) 
+	  {
+	    SurfType sndObj=dynamic_cast<SurfType>(mc->second);
+	    if (sndObj && sndObj->operator==(*surf))
+	      {
+		Out=sndObj;
+		break;
+	      }
+	  }
+      }
+  return static_cast<RetType>((Out) ? Out : surf);
 }
 
 int
@@ -244,7 +256,10 @@ equalSurfNum(const Geometry::Surface* SPtr)
     EqualSurface<boost::mpl::_1 , boost::mpl::_2,const Geometry::Surface*> >::type FTYPE;
   
   ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
-  const Geometry::Surface* OutPtr=FTYPE::dispatch(Index,SPtr,SurI.surMap());
+  CVEC Candidate;
+  SurI.equalCandidates(SPtr,Candidate);
+  const Geometry::Surface* OutPtr=
+    FTYPE::dispatch(Index,SPtr,Candidate);
   return OutPtr->getName();
 }
 
@@ -299,50 +314,50 @@ oppositeSurfaces(const Geometry::Surface* SPtr,
 ///\cond TEMPLATE
 
 template const Geometry::Surface* 
-EqualSurf<const Geometry::ArbPoly*,const Geometry::Surface*>(const Geometry::ArbPoly*,const SMAP&);
+EqualSurf<const Geometry::ArbPoly*,const Geometry::Surface*>(const Geometry::ArbPoly*,const CVEC&);
 template const Geometry::Surface* 
-EqualSurf<const Geometry::Cone*,const Geometry::Surface*>(const Geometry::Cone*,const SMAP&);
+EqualSurf<const Geometry::Cone*,const Geometry::Surface*>(const Geometry::Cone*,const CVEC&);
 template const Geometry::Surface* 
-EqualSurf<const Geometry::CylCan*,const Geometry::Surface*>(const Geometry::CylCan*,const SMAP&);
+EqualSurf<const Geometry::CylCan*,const Geometry::Surface*>(const Geometry::CylCan*,const CVEC&);
 template const Geometry::Surface* 
-EqualSurf<const Geometry::Cylinder*,const Geometry::Surface*>(const Geometry::Cylinder*,const SMAP&);
+EqualSurf<const Geometry::Cylinder*,const Geometry::Surface*>(const Geometry::Cylinder*,const CVEC&);
 template const Geometry::Surface* 
-EqualSurf<const Geometry::General*,const Geometry::Surface*>(const Geometry::General*,const SMAP&);
+EqualSurf<const Geometry::General*,const Geometry::Surface*>(const Geometry::General*,const CVEC&);
 template const Geometry::Surface* 
-EqualSurf<const Geometry::MBrect*,const Geometry::Surface*>(const Geometry::MBrect*,const SMAP&);
+EqualSurf<const Geometry::MBrect*,const Geometry::Surface*>(const Geometry::MBrect*,const CVEC&);
 template const Geometry::Surface* 
-EqualSurf<const Geometry::NullSurface*,const Geometry::Surface*>(const Geometry::NullSurface*,const SMAP&);
+EqualSurf<const Geometry::NullSurface*,const Geometry::Surface*>(const Geometry::NullSurface*,const CVEC&);
 template const Geometry::Surface* 
-EqualSurf<const Geometry::Plane*,const Geometry::Surface*>(const Geometry::Plane*,const SMAP&);
+EqualSurf<const Geometry::Plane*,const Geometry::Surface*>(const Geometry::Plane*,const CVEC&);
 template const Geometry::Surface* 
-EqualSurf<const Geometry::Quadratic*,const Geometry::Surface*>(const Geometry::Quadratic*,const SMAP&);
+EqualSurf<const Geometry::Quadratic*,const Geometry::Surface*>(const Geometry::Quadratic*,const CVEC&);
 template const Geometry::Surface* 
-EqualSurf<const Geometry::Sphere*,const Geometry::Surface*>(const Geometry::Sphere*,const SMAP&);
+EqualSurf<const Geometry::Sphere*,const Geometry::Surface*>(const Geometry::Sphere*,const CVEC&);
 template const Geometry::Surface* 
-EqualSurf<const Geometry::Torus*,const Geometry::Surface*>(const Geometry::Torus*,const SMAP&);
+EqualSurf<const Geometry::Torus*,const Geometry::Surface*>(const Geometry::Torus*,const CVEC&);
 
 template Geometry::Surface* 
-EqualSurf<Geometry::ArbPoly*,Geometry::Surface*>(Geometry::ArbPoly*,const SMAP&);
+EqualSurf<Geometry::ArbPoly*,Geometry::Surface*>(Geometry::ArbPoly*,const CVEC&);
 template Geometry::Surface* 
-EqualSurf<Geometry::Cone*,Geometry::Surface*>(Geometry::Cone*,const SMAP&);
+EqualSurf<Geometry::Cone*,Geometry::Surface*>(Geometry::Cone*,const CVEC&);
 template Geometry::Surface* 
-EqualSurf<Geometry::CylCan*,Geometry::Surface*>(Geometry::CylCan*,const SMAP&);
+EqualSurf<Geometry::CylCan*,Geometry::Surface*>(Geometry::CylCan*,const CVEC&);
 template Geometry::Surface* 
-EqualSurf<Geometry::Cylinder*,Geometry::Surface*>(Geometry::Cylinder*,const SMAP&);
+EqualSurf<Geometry::Cylinder*,Geometry::Surface*>(Geometry::Cylinder*,const CVEC&);
 template Geometry::Surface* 
-EqualSurf<Geometry::General*,Geometry::Surface*>(Geometry::General*,const SMAP&);
+EqualSurf<Geometry::General*,Geometry::Surface*>(Geometry::General*,const CVEC&);
 template Geometry::Surface* 
-EqualSurf<Geometry::MBrect*,Geometry::Surface*>(Geometry::MBrect*,const SMAP&);
+EqualSurf<Geometry::MBrect*,Geometry::Surface*>(Geometry::MBrect*,const CVEC&);
 template Geometry::Surface* 
-EqualSurf<Geometry::NullSurface*,Geometry::Surface*>(Geometry::NullSurface*,const SMAP&);
+EqualSurf<Geometry::NullSurface*,Geometry::Surface*>(Geometry::NullSurface*,const CVEC&);
 template Geometry::Surface* 
-EqualSurf<Geometry::Plane*,Geometry::Surface*>(Geometry::Plane*,const SMAP&);
+EqualSurf<Geometry::Plane*,Geometry::Surface*>(Geometry::Plane*,const CVEC&);
 template Geometry::Surface* 
-EqualSurf<Geometry::Quadratic*,Geometry::Surface*>(Geometry::Quadratic*,const SMAP&);
+EqualSurf<Geometry::Quadratic*,Geometry::Surface*>(Geometry::Quadratic*,const CVEC&);
 template Geometry::Surface* 
-EqualSurf<Geometry::Sphere*,Geometry::Surface*>(Geometry::Sphere*,const SMAP&);
+EqualSurf<Geometry::Sphere*,Geometry::Surface*>(Geometry::Sphere*,const CVEC&);
 template Geometry::Surface* 
-EqualSurf<Geometry::Torus*,Geometry::Surface*>(Geometry::Torus*,const SMAP&);
+EqualSurf<Geometry::Torus*,Geometry::Surface*>(Geometry::Torus*,const CVEC&);
 
 
 ///\endcond TEMPLATE
@@ -175,6 +175,19 @@ volUnit::addFlux(const int CN,const double R,const double D)
   return;
 }
 
+void 
+volUnit::merge(const volUnit& A)
+  /*!
+    Add the contributions of another unit 
+    [same cells]
+    \param A :: Unit to add
+  */
+{
+  npts+=A.npts;
+  lineSum+=A.lineSum;
+  return;
+}
+
 void 
 volUnit::reset()
   /*!
@@ -0,0 +1,107 @@
+/*********************************************************************
+  CombLayer : MNCPX Input builder
+
+ * File:   processInc/ObjBVH.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+#ifndef ModelSupport_ObjBVH_h
+#define ModelSupport_ObjBVH_h
+
+namespace Geometry
+{
+  class SenseCache;
+}
+
+namespace MonteCarlo
+{
+  class Object;
+  class Qhull;
+}
+
+namespace ModelSupport
+{
+
+/*!
+  \class ObjBVH
+  \version 1.0
+  \author S. Ansell
+  \date November 2013
+  \brief Bounding volume hierarchy of cells
+
+  Uses the conservative axis aligned box of each cell.
+  Cells that cannot be bounded are kept in a separate
+  list and always tested. The cell index is the position
+  in the Simulation cell map, so that the first valid cell
+  found is the same as a linear search of that map.
+  The owner rebuilds the tree after a change to the 
+  cells. A move of a surface used by a cell box since 
+  the build [Surface::getCellMove] makes the tree dirty:
+  the owner must rebuild it before the next search.
+*/
+
+class ObjBVH
+{
+ private:
+
+  /// Tree node : leaf if leftIndex==0
+  struct BVHNode
+  {
+    Geometry::BoundBox Box;    ///< Box of all children
+    size_t leftIndex;          ///< Left child [right == left+1]
+    size_t startIndex;         ///< First item in OrderVec
+    size_t count;              ///< Number of items in OrderVec
+  };
+
+  static const size_t leafSize;          ///< Max items in a leaf
+
+  int active;                            ///< Tree in use
+  size_t cellMove;                       ///< Cell surface moves at build
+  std::vector<MonteCarlo::Object*> ObjVec;  ///< Cells [map order]
+  std::vector<Geometry::BoundBox> BoxVec;   ///< Box for each cell
+  std::vector<size_t> OrderVec;          ///< Bounded cells [tree order]
+  std::vector<size_t> unBound;           ///< Unbounded cells [map order]
+  std::vector<BVHNode> Nodes;            ///< Flat tree [0 is root]
+
+  void buildNode(const size_t,const size_t,const size_t);
+
+ public:
+
+  ObjBVH();
+  ObjBVH(const ObjBVH&);
+  ObjBVH& operator=(const ObjBVH&);
+  ~ObjBVH() {}          ///< Destructor
+
+  void clearAll();
+  /// Is the tree built and in use
+  int isActive() const { return active; }
+  int isDirty() const;
+  /// Number of cells in the tree
+  size_t size() const { return ObjVec.size(); }
+  /// Number of cells without a box
+  size_t unBoundSize() const { return unBound.size(); }
+
+  void build(const std::map<int,MonteCarlo::Qhull*>&);
+  MonteCarlo::Object* findCell(const Geometry::Vec3D&) const;
+  MonteCarlo::Object* findCell(Geometry::SenseCache&) const;
+
+  void write(std::ostream&) const;
+};
+
+}
+
+#endif
@@ -25,6 +25,7 @@
 namespace Geometry
 {
   class Surface;
+  class SenseCache;
 }
 
 namespace MonteCarlo
@@ -32,6 +33,11 @@ namespace MonteCarlo
   class Object;
 }
 
+namespace ELog
+{
+  struct ThreadHold;
+}
+
 namespace ModelSupport
 {
 
@@ -41,6 +47,11 @@ namespace ModelSupport
   \author S. Ansell
   \date November 2010
   \brief Surface number to Object map
+
+  The map is built by surface number. buildGraph compiles
+  it into a flat [CSR] adjacency graph keyed by signed
+  surface and the cell being left, so that the likely
+  neighbour is tested first by findNextObject.
 */
 
 class ObjSurfMap
@@ -51,30 +62,73 @@ class ObjSurfMap
   /// Surface store
   typedef std::vector<MonteCarlo::Object*> STYPE;
   typedef std::map<int,STYPE> OMTYPE;      ///< +/-SurfN : ObjecPtr
+  /// Object : signed surfaces held in the map
+  typedef std::map<const MonteCarlo::Object*,std::set<int> > OSTYPE;
    
  private:
 
+  static const size_t maxPairs;   ///< Max from/to pairs for a surface
+  static const double boxTol;     ///< Tolerance on box overlap
+
   OMTYPE SMap;                    ///< SurfNumber : Object map
+  OSTYPE ObjSurf;                 ///< Object : Surfaces [reverse of SMap]
+  Geometry::SenseCache* SCPtr;    ///< Surface sense for findNextObject
+
+  int graphValid;                 ///< Graph is up to date with SMap
+  std::vector<int> GKey;          ///< Signed surface numbers [sorted]
+  std::vector<size_t> GKeyIndex;  ///< Key : first row [size GKey+1]
+  std::vector<int> GFrom;         ///< Row : cell left [0 for any cell]
+  std::vector<size_t> GRowIndex;  ///< Row : first candidate [size GFrom+1]
+  std::vector<MonteCarlo::Object*> GObj;  ///< Candidates
+  std::vector<size_t> GHits;      ///< Hits on candidate [learned]
+
   void addSurface(const int,MonteCarlo::Object*);
+  void eraseEntry(const int,const MonteCarlo::Object*);
+  static void buildBlock(const std::vector<MonteCarlo::Object*>&,
+			 const size_t,const size_t,
+			 std::vector<std::set<int> >&,
+			 std::vector<int>&,OMTYPE&,ELog::ThreadHold*);
+
+  void clearGraph();
+  size_t findKey(const int) const;
+  size_t findRow(const size_t,const int) const;
+  MonteCarlo::Object* testRow(const size_t,const int,const int,
+			      Geometry::SenseCache&,const size_t) const;
+  void addRowHit(const size_t,const MonteCarlo::Object*);
+  static int boxOverlap(const MonteCarlo::Object*,
+			const MonteCarlo::Object*);
 
  public:
 
   ObjSurfMap();
   ObjSurfMap(const ObjSurfMap&);
   ObjSurfMap& operator=(const ObjSurfMap&);
-  ~ObjSurfMap() {}          ///< Destructor
+  ~ObjSurfMap();
 
   void clearAll();
   
   void addSurfaces(MonteCarlo::Object*);
+  void addObjects(const std::vector<MonteCarlo::Object*>&,const size_t);
+  void removeObject(const MonteCarlo::Object*);
+  void updateObject(MonteCarlo::Object*);
   
   MonteCarlo::Object* getObj(const int,const size_t) const;
   const STYPE& getObjects(const int) const;
   MonteCarlo::Object* findNextObject(const int,
 				     const Geometry::Vec3D&,const int) const;
+  MonteCarlo::Object* findNextObject(const int,
+				     const Geometry::Vec3D&,const int,
+				     Geometry::SenseCache&) const;
 
   void removeReverseSurf(const int,const int);
 
+  void buildGraph();
+  /// Graph in use
+  int hasGraph() const { return graphValid; }
+  void addHit(const int,const int,const MonteCarlo::Object*);
+  void orderGraph();
+  void learn(MonteCarlo::Object*,const Geometry::Vec3D&,const size_t);
+
 
   void write(const std::string&) const;
   void write(std::ostream&) const;
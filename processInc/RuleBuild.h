@@ -0,0 +1,88 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   processInc/RuleBuild.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#ifndef ModelSupport_RuleBuild_h
+#define ModelSupport_RuleBuild_h
+
+class Rule;
+class HeadRule;
+
+namespace ModelSupport
+{
+  class surfRegister;
+
+/*!
+  \class RuleBuild
+  \version 1.0
+  \author S. Ansell
+  \date June 2013
+  \brief Builds a cell rule from offset surface numbers
+
+  Surfaces are given as in getComposite (signed and offset
+  from the component index) and are resolved through the
+  surfRegister straight into the rule tree. Intersections 
+  bind tighter than unions so that :
+  inter(1).inter(-2).unite(3) is the same as "1 -2 : 3".
+  Sub-rules act as bracketed units.
+*/
+
+class RuleBuild
+{
+ private:
+
+  const surfRegister& SMap;       ///< Surface register
+  const int offset;               ///< Offset of the surfaces
+  Rule* Term;                     ///< Current intersection term
+  Rule* Full;                     ///< Union of the finished terms
+
+  int realSurf(const int,const int) const;
+  void addInter(Rule*);
+  void addUnion(Rule*);
+
+ public:
+
+  RuleBuild(const surfRegister&,const int);
+  RuleBuild(const RuleBuild&);
+  ~RuleBuild();
+
+  RuleBuild& inter(const int);
+  RuleBuild& inter(const int,const int);
+  RuleBuild& inter(const int* const,const size_t);
+  RuleBuild& inter(const HeadRule&);
+  RuleBuild& inter(const RuleBuild&);
+  RuleBuild& interTrue(const int);
+  RuleBuild& interComp(const HeadRule&);
+  RuleBuild& interComp(const RuleBuild&);
+  RuleBuild& unite(const int);
+  RuleBuild& unite(const HeadRule&);
+  RuleBuild& unite(const RuleBuild&);
+
+  /// Has any item been added
+  bool empty() const { return (!Term && !Full); }
+  void clear();
+  Rule* makeRule() const;
+  HeadRule getRule() const;
+  std::string display() const;
+};
+
+}
+
+#endif
@@ -23,6 +23,7 @@
 #define VolSum_h
 
 class Simulation;
+class MTRand;
 namespace MonteCarlo
 {
   class Object;
@@ -45,6 +46,8 @@ class VolSum
   
   /// tally volume type
   typedef std::map<int,volUnit> tvTYPE; 
+
+  static const size_t blockSize;            ///< Points in a block
   // Input data
   Geometry::Vec3D Origin;                   ///< Origin
   double radius;                            ///< Radius
@@ -52,8 +55,14 @@ class VolSum
   
   double totalDist;                         ///< Total distance
   int nTracks;                              ///< Number of full tracks
+  size_t nThread;                           ///< Threads for pointRun
    
   tvTYPE tallyVols;                         ///< TallyNum:Volumes
+
+  static void addDistance(tvTYPE&,const int,const double);
+  void pointBlock(const Simulation&,MTRand&,const size_t,tvTYPE&) const;
+  void pointGroup(const Simulation&,const unsigned int,const size_t,
+		  const size_t,const size_t,tvTYPE&) const;
     
  public:
   
@@ -63,6 +72,8 @@ class VolSum
   ~VolSum();
 
   void reset();
+  /// Set the number of threads for pointRun
+  void setThreads(const size_t N) { nThread=N; }
   void addDistance(const int,const double);
   void addFlux(const int,const double&,const double&);
   //  void populate(const Simulation&);
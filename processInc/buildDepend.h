@@ -0,0 +1,82 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   processInc/buildDepend.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#ifndef ModelSupport_buildDepend_h
+#define ModelSupport_buildDepend_h
+
+class FuncDataBase;
+
+namespace ModelSupport
+{
+
+/*!
+  \class buildDepend
+  \version 1.0
+  \author S. Ansell
+  \date June 2013
+  \brief Tracks the variables read by each component build
+
+  The variables read from the FuncDataBase during a build
+  are split between the registered components [longest
+  matching name prefix] with the rest kept as "global".
+  A hash of the values of each set allows a later pass 
+  to find the components whose inputs have changed.
+  The DataBase only records reads between clearReadSet
+  and record.
+*/
+
+class buildDepend
+{
+ private:
+
+  /// Storage type : component : variables
+  typedef std::map<std::string,std::set<std::string> > VTYPE;
+  /// Storage type : component : hash
+  typedef std::map<std::string,std::string> HTYPE;
+
+  VTYPE VarMap;                    ///< Variables of each component
+  HTYPE HashMap;                   ///< Hash of the variable values
+
+  static std::string compName(const std::vector<std::string>&,
+			      const std::string&);
+  static std::string hashVar(const FuncDataBase&,
+			     const std::set<std::string>&);
+
+ public:
+
+  buildDepend();
+  buildDepend(const buildDepend&);
+  buildDepend& operator=(const buildDepend&);
+  ~buildDepend();
+
+  void clear();
+  /// Number of components recorded
+  size_t size() const { return HashMap.size(); }
+
+  void record(const FuncDataBase&);
+  int hasChanged(const FuncDataBase&,std::vector<std::string>&) const;
+  int hasChanged(const FuncDataBase&) const;
+
+};
+
+}
+
+#endif
@@ -36,6 +36,10 @@ namespace ModelSupport
   \author S. Ansell
   \date June 2011
   \brief Controls Object Registration in 10000 (or greater) blocks
+
+  Each registered block has a component id [registration order]
+  and a [start,end] cell range kept in a vector sorted by start
+  so cell to component lookup is a binary search.
 */
 
 class objectRegister
@@ -49,8 +53,18 @@ class objectRegister
   /// Index of them
   typedef std::map<std::string,CTYPE > cMapTYPE;
 
+  /// Cell range of a registered block
+  struct rangeUnit
+  {
+    int start;                     ///< First cell
+    int end;                       ///< Last cell [start+size]
+    int compID;                    ///< Component id
+  };
+
   int cellNumber;                  ///< Current new cell number
   MTYPE regionMap;                 ///< Index of kept object number
+  std::vector<std::string> regionNames;  ///< Names [by component id]
+  std::vector<rangeUnit> rangeIndex;     ///< Ranges sorted by start
 
   cMapTYPE Components;             ///< Pointer to real objects
 
@@ -69,7 +83,12 @@ class objectRegister
   int cell(const std::string&,const int = -1,const int = 10000);
   int getCell(const std::string&,const int =-1) const;
   int getRange(const std::string&,const int =-1) const;
-  std::string inRange(const int) const;
+  int inRangeID(const int) const;
+  const std::string& inRange(const int) const;
+  int getRegionID(const std::string&) const;
+  const std::string& getRegionName(const int) const;
+  /// Number of registered blocks
+  int nRegion() const { return static_cast<int>(regionNames.size()); }
 
   void addObject(const std::string&,const CTYPE&);
   void addObject(const CTYPE&);
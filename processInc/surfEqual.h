@@ -29,7 +29,8 @@ const Geometry::Surface* equalSurface(const Geometry::Surface*);
 Geometry::Surface* equalSurface(Geometry::Surface*);
  
 template<typename SurfType,typename RetType>
-RetType EqualSurf(SurfType,const std::map<int,Geometry::Surface*>&);
+RetType EqualSurf(SurfType,
+		  const std::vector<const std::map<int,Geometry::Surface*>*>&);
 
 int
 equalSurfNum(const Geometry::Surface*);
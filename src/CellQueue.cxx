@@ -0,0 +1,93 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   src/CellQueue.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <vector>
+#include <algorithm>
+#include <boost/thread/mutex.hpp>
+
+#include "CellQueue.h"
+
+namespace ModelSupport
+{
+
+/*!
+  \struct costCompare
+  \brief Orders (cost,index) by decreasing cost then index
+*/
+struct costCompare
+{
+  /// Comparison of the cost/index
+  bool operator()(const std::pair<size_t,size_t>& A,
+		  const std::pair<size_t,size_t>& B) const
+    { return (A.first!=B.first) ? A.first>B.first : A.second<B.second; }
+};
+
+CellQueue::CellQueue(const std::vector<size_t>& Cost) :
+  MPtr(new boost::mutex),nextItem(0)
+  /*!
+    Constructor
+    \param Cost :: Estimated cost of each item
+  */
+{
+  std::vector<std::pair<size_t,size_t> > Items;
+  for(size_t i=0;i<Cost.size();i++)
+    Items.push_back(std::pair<size_t,size_t>(Cost[i],i));
+  std::sort(Items.begin(),Items.end(),costCompare());
+
+  for(size_t i=0;i<Items.size();i++)
+    Order.push_back(Items[i].second);
+}
+
+CellQueue::~CellQueue()
+  /*!
+    Destructor
+  */
+{
+  delete MPtr;
+}
+
+int
+CellQueue::next(size_t& index)
+  /*!
+    Take the next item of the queue
+    \param index :: Item index [set if found]
+    \return 1 if an item is found / 0 if the queue is empty
+  */
+{
+  boost::mutex::scoped_lock Lock(*MPtr);
+  if (nextItem>=Order.size())
+    return 0;
+  index=Order[nextItem++];
+  return 1;
+}
+
+size_t
+CellQueue::nThread(const size_t nReq) const
+  /*!
+    Number of threads to use on the queue
+    \param nReq :: Requested threads
+    \return requested threads [1 if there are fewer items]
+  */
+{
+  return (nReq>1 && Order.size()>nReq) ? nReq : 1;
+}
+
+} // NAMESPACE ModelSupport
@@ -30,6 +30,8 @@
 #include <set>
 #include <map>
 #include <string>
+#include <boost/thread.hpp>
+#include <boost/thread/tss.hpp>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -42,21 +44,36 @@
 namespace ModelSupport
 {
 
-SimTrack::SimTrack() 
+SimTrack::SimTrack(const int AFlag) :
+  autoAdd(AFlag)
   /*!
     Constructor
+    \param AFlag :: Add unknown simulations on use
   */
 {}
 
 SimTrack&
 SimTrack::Instance()
   /*!
-    Singleton this
+    Singleton this [one per thread]
     \return SimTrack object
    */
 {
-  static SimTrack ST;
-  return ST;
+  static SimTrack ST(0);
+  static const boost::thread::id mainID(boost::this_thread::get_id());
+  static boost::thread_specific_ptr<SimTrack>* TSPtr=
+    new boost::thread_specific_ptr<SimTrack>();
+
+  if (boost::this_thread::get_id()==mainID)
+    return ST;
+
+  SimTrack* STPtr=TSPtr->get();
+  if (!STPtr)
+    {
+      STPtr=new SimTrack(1);
+      TSPtr->reset(STPtr);
+    }
+  return *STPtr;
 }
 
 void
@@ -100,9 +117,12 @@ SimTrack::setCell(const Simulation* SimPtr,MonteCarlo::Object* OPtr)
   fcTYPE::iterator mc=findCell.find(sInt);
   if (mc==findCell.end())
     {
-      if (OPtr)
+      if (OPtr && !autoAdd)
 	throw ColErr::InContainerError<fcTYPE::key_type>
 	  (sInt,"SimTrack::setCell"+ELog::RegMethod::getFull());
+      if (autoAdd)
+	findCell.insert(fcTYPE::value_type(sInt,OPtr));
+      return;
     }
   mc->second=OPtr;
   return;
@@ -121,7 +141,10 @@ SimTrack::curCell(const Simulation* SimPtr) const
   fcTYPE::key_type sInt=reinterpret_cast<fcTYPE::key_type>(SimPtr);
   fcTYPE::const_iterator mc=findCell.find(sInt);
   if (mc==findCell.end())
-    throw ColErr::InContainerError<fcTYPE::key_type>(sInt,"sInt");
+    {
+      if (autoAdd) return 0;
+      throw ColErr::InContainerError<fcTYPE::key_type>(sInt,"sInt");
+    }
   return mc->second;
 }
 
@@ -30,9 +30,13 @@
 #include <map>
 #include <set>
 #include <vector>
+#include <algorithm>
 #include <boost/shared_ptr.hpp>
 #include <boost/format.hpp>
 #include <boost/multi_array.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -47,6 +51,7 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "SenseCache.h"
 #include "Quaternion.h"
 #include "localRotate.h"
 #include "masterRotate.h"
@@ -68,6 +73,7 @@
 #include "cellFluxTally.h"
 #include "ObjSurfMap.h"
 #include "neutron.h"
+#include "TrackCache.h"
 #include "Simulation.h"
 #include "SimValid.h"
 
@@ -76,15 +82,17 @@ extern MTRand RNG;
 namespace ModelSupport
 {
 
+const size_t SimValid::blockSize(256);
+
 SimValid::SimValid() :
-  Centre(Geometry::Vec3D(0.1,0.1,0.1))
+  Centre(Geometry::Vec3D(0.1,0.1,0.1)),nThread(1)
   /*!
     Constructor
   */
 {}
 
 SimValid::SimValid(const SimValid& A) : 
-  Centre(A.Centre)
+  Centre(A.Centre),nThread(A.nThread)
   /*!
     Copy constructor
     \param A :: SimValid to copy
@@ -102,54 +110,48 @@ SimValid::operator=(const SimValid& A)
   if (this!=&A)
     {
       Centre=A.Centre;
+      nThread=A.nThread;
     }
   return *this;
 }
 
-int
-SimValid::run(const Simulation& System,const size_t N) const
+void
+SimValid::runBlock(const Simulation& System,
+		   MonteCarlo::Object* InitObj,
+		   const int initSurfNum,
+		   MTRand& TRand,validBlock& VB) const
   /*!
-    Calculate the tracking
-    \param System :: Simulation to use
-    \param N :: Number of points to test
-    \return true if valid
+    Calculate the tracking for one block of tracks. 
+    Uses its own surface sense cache. Nothing is 
+    written: a failure is put in VB.Log.
+    \param System :: Simulation to use [read only]
+    \param InitObj :: Initial cell
+    \param initSurfNum :: Surface of Centre on InitObj
+    \param TRand :: Random number stream for the block
+    \param VB :: Block to process [status/Log set]
   */
 {
-  ELog::RegMethod RegA("SimValid","run");
+  ELog::RegMethod RegA("SimValid","runBlock");
   
   const ModelSupport::ObjSurfMap* OSMPtr =System.getOSM();
-  MonteCarlo::Object* InitObj(0);
   const Geometry::Surface* SPtr;          // Output surface
   double aDist;       
-
-  // Note for sphere that you can use X,Y,Z in any orthogonal 
-  // directiron
   double phi,theta;
 
-  // Find Initial cell [Store for next time]
-  InitObj=System.findCell(Centre,InitObj);  
-  const int initSurfNum=InitObj->isOnSide(Centre);
+  Geometry::SenseCache SC;
+  MonteCarlo::TrackCache TC;
 
-  ELog::EM<<"C == "<<Centre<<ELog::endDebug;      
-  ELog::EM<<"InitOb == "<<InitObj->getName()<<ELog::endDebug;      
-  ELog::EM<<"Init == "<<initSurfNum<<ELog::endDebug; 
-     
-  if (InitObj->getName()==118)
-    {
-      ELog::EM<<InitObj->topRule()->display(Centre);
-      ELog::EM<<ELog::endErr;
-    }
-  // check surfaces
-  for(size_t i=0;i<N;i++)
+  VB.status=1;
+  for(size_t i=VB.startN;i<VB.endN;i++)
     {
       std::vector<simPoint> Pts;
-      // Get random starting point on edge of volume
-      phi=RNG.rand()*M_PI;
-      theta=2.0*RNG.rand()*M_PI;
+      phi=TRand.rand()*M_PI;
+      theta=2.0*TRand.rand()*M_PI;
       Geometry::Vec3D D(cos(theta)*sin(phi),
 			sin(theta)*sin(phi),
 			cos(phi));
       MonteCarlo::neutron TNeut(1,Centre,D);
+      TC.setRay(TNeut.Pos,TNeut.uVec);
 
       MonteCarlo::Object* OPtr=InitObj;
       int SN(-initSurfNum);
@@ -158,65 +160,156 @@ SimValid::run(const Simulation& System,const size_t N) const
       while(OPtr && OPtr->getImp())
 	{
 	  // Note: Need OPPOSITE Sign on exiting surface
-	  SN= -OPtr->trackOutCell(TNeut,aDist,SPtr,-SN);
+	  SN= -OPtr->trackOutCell(TNeut,aDist,SPtr,-SN,TC);
 	  if (aDist>1e30 && Pts.size()==1)
-	    {
-	      ELog::EM<<"Index == "<<Pts.size()-2<<ELog::endDebug;
-	      ELog::EM<<"D == "<<Pts[0].Pt<<ELog::endDebug;
-	      ELog::EM<<"D == "<<SN<<ELog::endDebug;
-	      aDist=1e-5;
-	    }
+	    aDist=1e-5;
 
 	  TNeut.moveForward(aDist);
 	  Pts.push_back(simPoint(TNeut.Pos,OPtr->getName(),SN,OPtr));
 	  OPtr=(SN) ?
-	    OSMPtr->findNextObject(SN,TNeut.Pos,OPtr->getName()) : 0;	    
-
+	    OSMPtr->findNextObject(SN,TNeut.Pos,OPtr->getName(),SC) : 0;
 	}
 
       if (!OPtr)
 	{
-	  ELog::EM<<"------------"<<ELog::endCrit;
-	  ELog::EM<<"I == "<<i<<" "<<SN<<ELog::endCrit;
+	  std::ostringstream cx;
+	  cx<<"------------"<<std::endl;
+	  cx<<"I == "<<i<<" "<<SN<<std::endl;
 	  for(size_t j=0;j<Pts.size();j++)
-	    {
-	      ELog::EM<<"Pos["<<j<<"]=="<<Pts[j].Pt<<" :: "
-		      <<Pts[j].objN<<" "<<Pts[j].surfN<<ELog::endDebug;
-	    }
+	    cx<<"Pos["<<j<<"]=="<<Pts[j].Pt<<" :: "
+	      <<Pts[j].objN<<" "<<Pts[j].surfN<<std::endl;
 
 	  const size_t index(Pts.size()-2);
-	  ELog::EM<<"Base Obj == "<<*Pts[index].OPtr
-		  <<ELog::endDebug;
-	  ELog::EM<<"Next Obj == "<<*Pts[index+1].OPtr
-		  <<ELog::endDebug;
-	  OPtr=Pts[index].OPtr;
+	  cx<<"Base Obj == "<<*Pts[index].OPtr<<std::endl;
+	  cx<<"Next Obj == "<<*Pts[index+1].OPtr<<std::endl;
 	  // RESET:
-	  TNeut.Pos=Pts[index].Pt;  // Reset point
-	  OPtr=Pts[index].OPtr;
-
-	  OPtr=OSMPtr->findNextObject(Pts[index].surfN,
-				      TNeut.Pos,OPtr->getName());	    
+	  TNeut.Pos=Pts[index].Pt;
+	  OPtr=OSMPtr->findNextObject(Pts[index].surfN,TNeut.Pos,
+				      Pts[index].OPtr->getName(),SC);
 	  if (OPtr)
-	    {
-	      ELog::EM<<"Found Obj == "<<*OPtr<<" :: "<<Pts[index].Pt<<" "
-		      <<OPtr->pointStr(Pts[index].Pt)<<ELog::endDebug;
-	      ELog::EM<<OPtr->isValid(Pts[index].Pt)<<ELog::endDebug;
-	    }
+	    cx<<"Found Obj == "<<*OPtr<<" :: "<<Pts[index].Pt<<" "
+	      <<OPtr->pointStr(Pts[index].Pt)<<std::endl;
 	  else
-	    ELog::EM<<"No object "<<ELog::endDebug;
+	    cx<<"No object "<<std::endl;
 	  TNeut.Pos+=D*0.00001;
 
-	  MonteCarlo::Object* NOPtr=System.findCell(TNeut.Pos,0);
+	  MonteCarlo::Object* NOPtr=System.findCell(TNeut.Pos,0,SC);
 	  if (NOPtr)
 	    {
-	      ELog::EM<<"NEutron == "<<TNeut<<ELog::endDebug;
-	      ELog::EM<<"Actual object == "<<*NOPtr<<ELog::endDebug;
-	      ELog::EM<<" IMP == "<<NOPtr->getImp()<<ELog::endDebug;
+	      cx<<"NEutron == "<<TNeut<<std::endl;
+	      cx<<"Actual object == "<<*NOPtr<<std::endl;
+	      cx<<" IMP == "<<NOPtr->getImp()<<std::endl;
 	    }
-	  ELog::EM<<"Failed to calculate cell correctly: "<<i<<ELog::endCrit;
-	  return 0;
+	  cx<<"Failed to calculate cell correctly: "<<i;
+	  VB.Log=cx.str();
+	  VB.status=0;
+	  return;
+	}
+    }
+  return;
+}
+
+void
+SimValid::runGroup(const Simulation& System,
+		   MonteCarlo::Object* InitObj,
+		   const int initSurfNum,
+		   std::vector<validBlock>& Blocks,
+		   const size_t first,const size_t step) const
+  /*!
+    Calculate the blocks first, first+step, ... in order.
+    Each block has its own random stream keyed on the
+    common seed and the block index.
+    \param System :: Simulation to use [read only]
+    \param InitObj :: Initial cell
+    \param initSurfNum :: Surface of Centre on InitObj
+    \param Blocks :: All the blocks [only the group is changed]
+    \param first :: First block
+    \param step :: Step between blocks [number of groups]
+  */
+{
+  for(size_t i=first;i<Blocks.size();i+=step)
+    {
+      MTRand::uint32 Key[2];
+      Key[0]=Blocks[i].seed;
+      Key[1]=static_cast<MTRand::uint32>(Blocks[i].index);
+      MTRand TRand(Key,2);
+      runBlock(System,InitObj,initSurfNum,TRand,Blocks[i]);
+    }
+  return;
+}
+
+int
+SimValid::run(const Simulation& System,const size_t N) const
+  /*!
+    Calculate the tracking. A serial run [nThread<=1] draws
+    the tracks from RNG in order, as a single block. With
+    threads the tracks are split into fixed blocks, each 
+    with its own random stream, and the blocks are shared 
+    over the threads: the tracks [and failure reported] 
+    then do not depend on the number of threads.
+    \param System :: Simulation to use
+    \param N :: Number of points to test
+    \return true if valid
+  */
+{
+  ELog::RegMethod RegA("SimValid","run");
+  
+  // Find Initial cell [Store for next time]
+  MonteCarlo::Object* InitObj=System.findCell(Centre,0);  
+  const int initSurfNum=InitObj->isOnSide(Centre);
+
+  ELog::EM<<"C == "<<Centre<<ELog::endDebug;      
+  ELog::EM<<"InitOb == "<<InitObj->getName()<<ELog::endDebug;      
+  ELog::EM<<"Init == "<<initSurfNum<<ELog::endDebug; 
+     
+  if (InitObj->getName()==118)
+    {
+      ELog::EM<<InitObj->topRule()->display(Centre);
+      ELog::EM<<ELog::endErr;
+    }
+
+  std::vector<validBlock> Blocks;
+  if (nThread<=1)
+    {
+      Blocks.resize(1);
+      Blocks[0].index=0;
+      Blocks[0].startN=0;
+      Blocks[0].endN=N;
+      Blocks[0].seed=0;
+      Blocks[0].status=1;
+      runBlock(System,InitObj,initSurfNum,RNG,Blocks[0]);
+    }
+  else
+    {
+      const MTRand::uint32 seed=RNG.randInt();
+      const size_t nBlock((N+blockSize-1)/blockSize);
+      Blocks.resize(nBlock);
+      for(size_t i=0;i<nBlock;i++)
+	{
+	  Blocks[i].index=i;
+	  Blocks[i].startN=i*blockSize;
+	  Blocks[i].endN=std::min(N,(i+1)*blockSize);
+	  Blocks[i].seed=seed;
+	  Blocks[i].status=1;
 	}
+      const size_t nGroup=std::min(nThread,nBlock);
+      boost::thread_group TGroup;
+      for(size_t i=0;i<nGroup;i++)
+	TGroup.create_thread(boost::bind(&SimValid::runGroup,this,
+					 boost::cref(System),InitObj,
+					 initSurfNum,boost::ref(Blocks),
+					 i,nGroup));
+      TGroup.join_all();
     }
+
+  for(size_t i=0;i<Blocks.size();i++)
+    if (!Blocks[i].status)
+      {
+	ELog::EM<<"Block "<<i<<" ["<<Blocks[i].startN<<"-"
+		<<Blocks[i].endN<<"]"<<ELog::endCrit;
+	ELog::EM<<Blocks[i].Log<<ELog::endCrit;
+	return 0;
+      }
   return 1;
 }
 
@@ -37,6 +37,7 @@
 #include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/array.hpp>
+#include <boost/thread.hpp>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -57,6 +58,8 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "BoundBox.h"
+#include "SenseCache.h"
 #include "Quaternion.h"
 #include "localRotate.h"
 #include "masterRotate.h"
@@ -86,6 +89,7 @@
 #include "HeadRule.h"
 #include "Object.h"
 #include "Qhull.h"
+#include "RuleBDD.h"
 #include "AlterSurfBase.h"
 #include "RemoveCell.h"
 #include "WForm.h"
@@ -100,13 +104,16 @@
 #include "Source.h"
 #include "KCode.h"
 #include "ObjSurfMap.h"
+#include "ObjBVH.h"
+#include "CellQueue.h"
 #include "PhysicsCards.h"
 #include "ReadFunctions.h"
 #include "SimTrack.h"
 #include "Simulation.h"
 
 Simulation::Simulation()  :
-  CNum(100000),ASurfPtr(0),RCellPtr(0),OSMPtr(new ModelSupport::ObjSurfMap),
+  CNum(100000),compCheck(0),nThread(1),ASurfPtr(0),RCellPtr(0),OSMPtr(new ModelSupport::ObjSurfMap),
+  BVHPtr(new ModelSupport::ObjBVH),
   PhysPtr(new physicsSystem::PhysicsCards)
   /*!
     Start of simulation Object
@@ -116,10 +123,12 @@ Simulation::Simulation()  :
 }
 
 Simulation::Simulation(const Simulation& A)  :
-  inputFile(A.inputFile),CNum(A.CNum),DB(A.DB),
+  inputFile(A.inputFile),CNum(A.CNum),compCheck(A.compCheck),
+  nThread(A.nThread),DB(A.DB),
   ASurfPtr((A.ASurfPtr) ? A.ASurfPtr->clone() : 0),
   RCellPtr((A.RCellPtr) ? A.RCellPtr->clone() : 0),
   OSMPtr(new ModelSupport::ObjSurfMap),
+  BVHPtr(new ModelSupport::ObjBVH),
   TList(A.TList),  cellOutOrder(A.cellOutOrder),
   PhysPtr(new physicsSystem::PhysicsCards(*A.PhysPtr))
   /*!
@@ -146,7 +155,8 @@ Simulation::Simulation(const Simulation& A)  :
     }
 
   createObjSurfMap();
-
+  if (A.BVHPtr->isActive())
+    createBVH();
 }
 
 Simulation&
@@ -161,6 +171,8 @@ Simulation::operator=(const Simulation& A)
     {
       inputFile=A.inputFile;
       CNum=A.CNum;
+      compCheck=A.compCheck;
+      nThread=A.nThread;
       DB=A.DB;
       ASurfPtr=(A.ASurfPtr) ? A.ASurfPtr->clone() : 0;
       RCellPtr=(A.RCellPtr) ? A.RCellPtr->clone() : 0;
@@ -185,6 +197,8 @@ Simulation::operator=(const Simulation& A)
 	}
       ModelSupport::SimTrack::Instance().setCell(this,0);
       createObjSurfMap();
+      if (A.BVHPtr->isActive())
+	createBVH();
     }
   return *this;
 }
@@ -202,6 +216,7 @@ Simulation::~Simulation()
   delete OSMPtr;
   deleteObjects();
   deleteTally();
+  delete BVHPtr;
 }
 
 void
@@ -230,6 +245,7 @@ Simulation::deleteObjects()
   */
 {
   ModelSupport::SimTrack::Instance().setCell(this,0);
+  BVHPtr->clearAll();
   OTYPE::iterator mc;
   for(mc=OList.begin();mc!=OList.end();mc++)
     delete mc->second;
@@ -476,6 +492,7 @@ Simulation::addCell(const int cellNumber,const MonteCarlo::Qhull& A)
   PhysPtr->setVolume(cellNumber,1.0);
   // Add surfaces to OSMPtr:
   //  OSMPtr->addSurfaces(QHptr);
+  updateBVH();
 
   return 1;
 }
@@ -701,12 +718,14 @@ Simulation::removeCells(const int startN,const int endN)
 	  (vc->first>=startN && (endN<0 || vc->first<=endN)))
 	{
 	  ST.checkDelete(this,vc->second);
+	  OSMPtr->removeObject(vc->second);
 	  delete vc->second;
 	}
       else
 	newOList.insert(OTYPE::value_type(vc->first,vc->second));
     }
   OList=newOList;
+  updateBVH();
 // Now process Physics so importance/volume cards can be set
 //  processCellsImp();
 //  ELog::CellM.processReport(std::cout);
@@ -732,8 +751,10 @@ Simulation::removeCell(const int Index)
   
   ModelSupport::SimTrack& ST(ModelSupport::SimTrack::Instance());
   ST.checkDelete(this,vc->second);
+  OSMPtr->removeObject(vc->second);
   delete vc->second;
   OList.erase(vc);
+  updateBVH();
   
 // Now process Physics so importance/volume cards can be set
 //  processCellsImp();
@@ -807,10 +828,12 @@ Simulation::removeDeadCells()
       if (dmc!=OList.end())
 	{
 	  ST.checkDelete(this,dmc->second);
+	  OSMPtr->removeObject(dmc->second);
 	  delete dmc->second;
 	  OList.erase(dmc);
 	}
     }
+  updateBVH();
 		  
        
   // Now process Physics so importance/volume cards can be set
@@ -839,6 +862,7 @@ Simulation::removeAllSurface(const int KeyN)
       oc->second->createSurfaceList();
     }
   ModelSupport::surfIndex::Instance().deleteSurface(KeyN);
+  updateBVH();
   return 0;
 }
 
@@ -869,6 +893,7 @@ Simulation::substituteAllSurface(const int KeyN,const int NsurfN)
   for(tc=TItem.begin();tc!=TItem.end();tc++)
     tc->second->renumberSurf(KeyN,NsurfN);
 
+  updateBVH();
   return 0;
 }
 
@@ -918,6 +943,7 @@ Simulation::makeVirtual(const int CellN)
       return -1;
     }
   vc->second->setPlaceHold(1);
+  updateBVH();
   return 0;
 }
 
@@ -1054,18 +1080,177 @@ Simulation::removeComplement(MonteCarlo::Qhull& OB) const
 {
   ELog::RegMethod RegA("Simulation","removeComplement");
 
-  MonteCarlo::Algebra AX;
+  MonteCarlo::RuleBDD BX;
+  return removeComplement(BX,OB);
+}
+
+int
+Simulation::removeComplement(MonteCarlo::RuleBDD& BX,
+			     MonteCarlo::Qhull& OB) const
+  /*!
+    Remove a complement form an object
+    \param BX :: BDD of the cells [shared over calls]
+    \param OB :: object to extract complement
+    \return 1 on success / 0 on failure
+  */
+{
+  ELog::RegMethod RegA("Simulation","removeComplement(BDD)");
+
+  Rule* RX=BX.removeComplement(OB.topRule(),OList);
+  if (compCheck)
+    checkComplement(BX,OB,RX);
+  return OB.procRule(RX);
+}
 
+int
+Simulation::checkComplement(MonteCarlo::RuleBDD& BX,
+			    const MonteCarlo::Qhull& OB,
+			    const Rule* RX) const
+  /*!
+    Check a complement removal against the Algebra expansion
+    \param BX :: BDD of the cells
+    \param OB :: object [before the complement removal]
+    \param RX :: Rule without complements
+    \return 1 if the same / 0 if different
+  */
+{
+  ELog::RegMethod RegA("Simulation","checkComplement");
+
+  MonteCarlo::Algebra AX;
   AX.setFunctionObjStr(OB.cellStr(OList));
+  HeadRule HA;
+  HA.procString(AX.writeMCNPX());
+  if (BX.build(HA.getTopRule(),OList)!=BX.build(RX,OList))
+    {
+      ELog::EM<<"Complement mismatch in cell "<<OB.getName()<<ELog::endErr;
+      ELog::EM<<"Algebra == "<<HA.display()<<ELog::endErr;
+      ELog::EM<<"RuleBDD == "<<RX->display()<<ELog::endErr;
+      return 0;
+    }
+  return 1;
+}
+
+
+template<typename T>
+void
+Simulation::holdWork(const T& workFunc,ELog::ThreadHold* HPtr)
+  /*!
+    Run a queue worker with its log messages held
+    \param workFunc :: Worker to run
+    \param HPtr :: Holder for the messages of this thread
+  */
+{
+  ELog::EM.holdThread(HPtr);
+  workFunc();
+  ELog::EM.holdThread(0);
+  return;
+}
+
+template<typename T>
+void
+Simulation::runQueue(ModelSupport::CellQueue& CQ,const T& workFunc) const
+  /*!
+    Run a queue worker on the threads of the simulation.
+    The workers do not write to the log: their messages
+    are held and reported in thread order after the join.
+    Failed cells are flagged by the worker for the caller
+    to repeat.
+    \param CQ :: Cell queue [bound in workFunc]
+    \param workFunc :: Worker to run in each thread
+  */
+{
+  const size_t NT=CQ.nThread(nThread);
+  if (NT==1)
+    workFunc();
+  else
+    {
+      std::vector<boost::shared_ptr<ELog::ThreadHold> > HVec;
+      boost::thread_group TGroup;
+      for(size_t i=0;i<NT;i++)
+	{
+	  HVec.push_back(boost::shared_ptr<ELog::ThreadHold>
+			 (new ELog::ThreadHold));
+	  TGroup.create_thread(boost::bind(&Simulation::holdWork<T>,
+					   boost::cref(workFunc),
+					   HVec.back().get()));
+	}
+      TGroup.join_all();
+      for(size_t i=0;i<NT;i++)
+	ELog::EM.dispatchHold(*HVec[i]);
+    }
+  return;
+}
 
-  return OB.procString(AX.writeMCNPX());
+void
+Simulation::complementQueue(const OTYPE& MList,
+			    const std::vector<MonteCarlo::Qhull*>& QVec,
+			    std::vector<Rule*>& RVec,
+			    ModelSupport::CellQueue& CQ)
+  /*!
+    Find the rules without complements of the queued cells.
+    Each thread has one BDD. It is cleared for each cell 
+    [keeping its node store] so that the rule does not
+    depend on the cell order. Failed cells are left empty.
+    \param MList :: Cell map [not changed]
+    \param QVec :: Cells
+    \param RVec :: New rule of each cell
+    \param CQ :: Cell queue
+  */
+{
+  ELog::RegMethod RegA("Simulation","complementQueue");
+
+  MonteCarlo::RuleBDD BX;
+  size_t index;
+  while(CQ.next(index))
+    {
+      BX.clear();
+      try
+        {
+	  RVec[index]=BX.removeComplement(QVec[index]->topRule(),MList);
+	}
+      catch (const std::exception&)
+        {
+	  RVec[index]=0;
+	}
+    }
+  return;
 }
 
+void
+Simulation::surfaceQueue(const std::vector<MonteCarlo::Qhull*>& QVec,
+			 std::vector<int>& failFlag,
+			 ModelSupport::CellQueue& CQ)
+  /*!
+    Populate and create the surface list of the queued cells
+    \param QVec :: Cells
+    \param failFlag :: Set for the failed cells
+    \param CQ :: Cell queue
+  */
+{
+  ELog::RegMethod RegA("Simulation","surfaceQueue");
+
+  size_t index;
+  while(CQ.next(index))
+    {
+      try
+        {
+	  QVec[index]->createSurfaceList();
+	}
+      catch (const std::exception&)
+        {
+	  failFlag[index]=1;
+	}
+    }
+  return;
+}
 
 int
 Simulation::removeComplements()
   /*!
-    Expand each complement on a tree.
+    Expand each complement on a tree. The new rules are
+    found on the threads from the unchanged cells and
+    then set in cell order. Failed cells are repeated
+    so that the error is raised here.
     \retval 0 on success, 
     \retval -1 failed to find surface key
   */
@@ -1074,6 +1259,8 @@ Simulation::removeComplements()
 
   populateCells();
   int retVal(0);
+  std::vector<MonteCarlo::Qhull*> QVec;
+  std::vector<size_t> Cost;
   OTYPE::iterator vc;
   for(vc=OList.begin();vc!=OList.end();vc++)
     {
@@ -1083,16 +1270,9 @@ Simulation::removeComplements()
         {  
 	  if (workObj.isPopulated())
 	    {
-	      MonteCarlo::Algebra AX;
-	      AX.setFunctionObjStr(workObj.cellStr(OList));
-	      if (!workObj.procString(AX.writeMCNPX()))
-		{
-		  ELog::EM<<"Error processing Algebra Complement : "
-			  <<ELog::endErr;
-		  throw ColErr::ExitAbort(RegA.getFull());
-		}
-	      workObj.populate();
-	      workObj.createSurfaceList();
+	      QVec.push_back(vc->second);
+	      Cost.push_back(MonteCarlo::RuleBDD::countLiterals
+			     (workObj.topRule(),OList));
 	    }
 	  else 
 	    {
@@ -1102,6 +1282,36 @@ Simulation::removeComplements()
 	    }
 	}
     }
+
+  std::vector<Rule*> RVec(QVec.size(),0);
+  ModelSupport::CellQueue CQ(Cost);
+  runQueue(CQ,boost::bind(&Simulation::complementQueue,boost::cref(OList),
+			  boost::cref(QVec),boost::ref(RVec),boost::ref(CQ)));
+
+  MonteCarlo::RuleBDD BX;
+  for(size_t i=0;i<QVec.size();i++)
+    {
+      BX.clear();
+      if (!RVec[i])
+	RVec[i]=BX.removeComplement(QVec[i]->topRule(),OList);
+      if (compCheck)
+	checkComplement(BX,*QVec[i],RVec[i]);
+      if (!QVec[i]->procRule(RVec[i]))
+	{
+	  ELog::EM<<"Error processing Complement : "
+		  <<ELog::endErr;
+	  throw ColErr::ExitAbort(RegA.getFull());
+	}
+    }
+
+  std::vector<int> failFlag(QVec.size(),0);
+  ModelSupport::CellQueue SQ(Cost);
+  runQueue(SQ,boost::bind(&Simulation::surfaceQueue,boost::cref(QVec),
+			  boost::ref(failFlag),boost::ref(SQ)));
+  for(size_t i=0;i<QVec.size();i++)
+    if (failFlag[i])
+      QVec[i]->createSurfaceList();
+
   return retVal;
 }
 
@@ -1264,23 +1474,84 @@ Simulation::calcVertex(const int CellN)
   return CellN;
 }
 
+void
+Simulation::vertexQueue(const std::vector<MonteCarlo::Qhull*>& QVec,
+			std::vector<int>& failFlag,
+			ModelSupport::CellQueue& CQ)
+  /*!
+    Calculate the vertexes of the queued cells.
+    Cells without vertexes use the mid points.
+    \param QVec :: Cells
+    \param failFlag :: Set for the failed cells
+    \param CQ :: Cell queue
+  */
+{
+  ELog::RegMethod RegA("Simulation","vertexQueue");
+
+  size_t index;
+  while(CQ.next(index))
+    {
+      try
+        {
+	  // This point may be outside of the point
+	  if (!QVec[index]->calcVertex())   
+	    QVec[index]->calcMidVertex();
+	}
+      catch (const std::exception&)
+        {
+	  failFlag[index]=1;
+	}
+    }
+  return;
+}
+
 void
 Simulation::calcAllVertex()
   /*! 
      Calculates the vertexes in the Cell and stores
-     in the Qhull. The number of vertexes found are returned. 
+     in the Qhull. The cells are independent and are
+     queued over the simulation threads : the cost goes
+     as the cube of the number of surfaces.
   */
 {
-  ELog::RegMethod RegA("Simulation","calcVertex");
+  ELog::RegMethod RegA("Simulation","calcAllVertex");
+
+  // surface lookup is done before the threads start
+  std::vector<MonteCarlo::Qhull*> QVec;
+  std::vector<size_t> Cost;
   OTYPE::iterator mc;
-  int debugOutput(0);
   for(mc=OList.begin();mc!=OList.end();mc++)
     {
-      // This point may be outside of the point
-      debugOutput++;
-      if (!mc->second->calcVertex())   
-	mc->second->calcMidVertex();
+      mc->second->populate();
+      QVec.push_back(mc->second);
+      const size_t NS=
+	MonteCarlo::RuleBDD::countLiterals(mc->second->topRule());
+      Cost.push_back(NS*NS*NS);
     }
+
+  std::vector<int> failFlag(QVec.size(),0);
+  ModelSupport::CellQueue CQ(Cost);
+  runQueue(CQ,boost::bind(&Simulation::vertexQueue,boost::cref(QVec),
+			  boost::ref(failFlag),boost::ref(CQ)));
+  // repeat to raise the error here
+  for(size_t i=0;i<QVec.size();i++)
+    if (failFlag[i] && !QVec[i]->calcVertex())
+      QVec[i]->calcMidVertex();
+  return;
+}
+
+void
+Simulation::calcAllBoundBox()
+  /*!
+    Calculate the bounding box of all the cells.
+    These are used as a fast reject in Object::isValid
+  */
+{
+  ELog::RegMethod RegA("Simulation","calcAllBoundBox");
+
+  OTYPE::iterator mc;
+  for(mc=OList.begin();mc!=OList.end();mc++)
+    mc->second->calcBoundBox();
   return;
 }
 
@@ -1295,7 +1566,7 @@ Simulation::addObjSurfMap(MonteCarlo::Qhull* QPtr)
   if (QPtr->getSurfSet().empty())
     QPtr->createSurfaceList();
   
-  OSMPtr->addSurfaces(QPtr);
+  OSMPtr->updateObject(QPtr);
   QPtr->setObjSurfValid();
   return;
 }
@@ -1317,8 +1588,8 @@ Simulation::validateObjSurfMap()
 	{
 	  if (objPtr->getSurfSet().empty())
 	    objPtr->createSurfaceList();
-	  // First add surface that are opposite 
-	  OSMPtr->addSurfaces(objPtr);
+	  // Patch the changed surfaces only
+	  OSMPtr->updateObject(objPtr);
 	  objPtr->setObjSurfValid();
 	}
     }
@@ -1329,20 +1600,78 @@ void
 Simulation::createObjSurfMap()
   /*! 
     Creates all the object surface mappings.
+    The map [and any missing surface lists] is built 
+    over the simulation threads and is the same as a 
+    serial build. Later changes are patched by 
+    validateObjSurfMap.
   */
 {
 
   ELog::RegMethod RegA("Simulation","createObjSurfMap");
 
   OSMPtr->clearAll();  
+  std::vector<MonteCarlo::Object*> OVec;
   OTYPE::iterator mc;
   for(mc=OList.begin();mc!=OList.end();mc++)
     {
-      if (mc->second->getSurfSet().empty())
-	mc->second->createSurfaceList();
-      // First add surface that are opposite 
-      OSMPtr->addSurfaces(mc->second);
+      mc->second->setObjSurfValid();
+      OVec.push_back(mc->second);
     }  
+  OSMPtr->addObjects(OVec,nThread);
+  return;
+}
+
+void
+Simulation::learnObjSurfMap(const Geometry::Vec3D& Centre,
+			    const size_t N)
+  /*!
+    Compile the object surface map into its adjacency
+    graph [using the cell boxes] and order the neighbours
+    by the transitions of N rays from Centre.
+    \param Centre :: Start point of the rays
+    \param N :: Number of rays [0 : graph only]
+  */
+{
+  ELog::RegMethod RegA("Simulation","learnObjSurfMap");
+
+  calcAllBoundBox();
+  OSMPtr->buildGraph();
+  MonteCarlo::Object* InitObj=findCell(Centre,0);
+  if (InitObj && N)
+    OSMPtr->learn(InitObj,Centre,N);
+  return;
+}
+
+void
+Simulation::createBVH()
+  /*!
+    Build the cell box tree and use it in findCell.
+    Later cell and surface changes rebuild it [updateBVH].
+  */
+{
+  ELog::RegMethod RegA("Simulation","createBVH");
+  calcAllBoundBox();
+  BVHPtr->build(OList);
+  ELog::EM<<"BVH cells == "<<BVHPtr->size()<<" [unbounded "
+	  <<BVHPtr->unBoundSize()<<"]"<<ELog::endDiag;
+  return;
+}
+
+void
+Simulation::updateBVH()
+  /*!
+    Rebuild the cell box tree [if in use] with new cell
+    boxes. Called by every method that changes the cells
+    or moves the surfaces: findCell does not rebuild the
+    tree and fails on a tree that is out of date.
+  */
+{
+  ELog::RegMethod RegA("Simulation","updateBVH");
+  if (BVHPtr->isActive())
+    {
+      calcAllBoundBox();
+      BVHPtr->build(OList);
+    }
   return;
 }
 
@@ -1562,16 +1891,36 @@ MonteCarlo::Object*
 Simulation::findCell(const Geometry::Vec3D& Pt,
 		     MonteCarlo::Object* testCell) const
   /*! 
-    Object that a given the point is in.
+    Object that a given the point is in. Uses a local
+    surface sense cache.
+    \param Pt :: Point to find
+    \param testCell :: Last Cell (since points often are close together 
+    \retval Object ptr
+    \retval 0 :: No cell exists
+  */
+{
+  Geometry::SenseCache SC;
+  return findCell(Pt,testCell,SC);
+}
+
+MonteCarlo::Object*
+Simulation::findCell(const Geometry::Vec3D& Pt,
+		     MonteCarlo::Object* testCell,
+		     Geometry::SenseCache& SC) const
+  /*! 
+    Object that a given the point is in. Each surface
+    is evaluated at most once for all the cells tested.
     \param Pt :: Point to find
     \param testCell :: Last Cell (since points often are close together 
+    \param SC :: Surface sense cache
     \retval Object ptr
     \retval 0 :: No cell exists
   */
 {
   ModelSupport::SimTrack& ST(ModelSupport::SimTrack::Instance());
+  SC.setPoint(Pt);
   // First test users guess:
-  if (testCell && testCell->isValid(Pt))
+  if (testCell && testCell->isValid(SC))
     {
       ST.setCell(this,testCell);
       return testCell;
@@ -1579,15 +1928,24 @@ Simulation::findCell(const Geometry::Vec3D& Pt,
   // Ok how about our last find
   MonteCarlo::Object* curObjPtr=ST.curCell(this);
   if (curObjPtr && curObjPtr!=testCell 
-      && curObjPtr->isValid(Pt))
+      && curObjPtr->isValid(SC))
     return curObjPtr;
+
+  if (BVHPtr->isActive())
+    {
+      if (BVHPtr->isDirty())
+	throw ColErr::ExitAbort("Cell box tree out of date [updateBVH]");
+      MonteCarlo::Object* OPtr=BVHPtr->findCell(SC);
+      ST.setCell(this,OPtr);
+      return OPtr;
+    }
       
   // now we need to search everthing
   OTYPE::const_iterator mpc;
   for(mpc=OList.begin();mpc!=OList.end();mpc++)
     {
       if (!mpc->second->isPlaceHold() &&
-	  mpc->second->isValid(Pt))
+	  mpc->second->isValid(SC))
         {
 	  ST.setCell(this,mpc->second);
 	  return mpc->second;
@@ -2209,6 +2567,8 @@ Simulation::masterRotation()
     mc->second->rotateMaster();
 
   MR.setGlobal();
+  calcAllBoundBox();
+  updateBVH();
   return;
 }
 
@@ -110,7 +110,7 @@ createMeshTally(const mainSystem::inputParam& IParam,
 
 int
 createVTK(const mainSystem::inputParam& IParam,
-	  const Simulation* SimPtr,
+	  Simulation* SimPtr,
 	  const std::string& Oname)
   /*!
     Run the VTK box
@@ -152,6 +152,17 @@ createVTK(const mainSystem::inputParam& IParam,
       if (IParam.flag("vtk"))
 	{
 	  ELog::EM<<"Processing VTK:"<<ELog::endBasic;
+	  // Check the format before the populate
+	  const std::string vFormat=IParam.getValue<std::string>("vtkFormat");
+	  const size_t octDepth=IParam.getValue<size_t>("vtkOctree");
+	  if (octDepth && vFormat!="ascii" && vFormat!="binary")
+	    throw ColErr::InContainerError<std::string>
+	      (vFormat,"Octree VTK format [ascii/binary]");
+	  if (vFormat!="ascii" && vFormat!="binary" &&
+	      vFormat!="vti" && vFormat!="vtiz")
+	    throw ColErr::InContainerError<std::string>
+	      (vFormat,"VTK format [ascii/binary/vti/vtiz]");
+
 	  Visit VTK;
 
 	  VTK.setType(Visit::material);
@@ -166,13 +177,26 @@ createVTK(const mainSystem::inputParam& IParam,
 	    }
 	  if (IParam.flag("vcell"))
 	    VTK.setType(Visit::cellID);
+	  if (IParam.flag("vtkLine"))
+	    {
+	      SimPtr->createObjSurfMap();
+	      VTK.setLineTrack(1);
+	    }
+	  VTK.setOctree(octDepth);
 
 	  // PROCESS VTK:
 	  VTK.setBox(MeshA,MeshB);
 	  VTK.setIndex(meshPts[0],meshPts[1],meshPts[2]);
 	  VTK.populate(SimPtr,Active);
-	  
-	  VTK.writeVTK(Oname);
+
+	  if (octDepth)
+	    VTK.writeOctreeVTK(Oname,(vFormat=="binary") ? 1 : 0);
+	  else if (vFormat=="ascii")
+	    VTK.writeVTK(Oname);
+	  else if (vFormat=="binary")
+	    VTK.writeVTKBinary(Oname);
+	  else
+	    VTK.writeVTI(Oname,(vFormat=="vtiz") ? 1 : 0);
 	  return 2;
 	}
     }
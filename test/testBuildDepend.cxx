@@ -0,0 +1,231 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   test/testBuildDepend.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <list>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <boost/tuple/tuple.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "GTKreport.h"
+#include "OutputLog.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Code.h"
+#include "FItem.h"
+#include "varList.h"
+#include "FuncDataBase.h"
+#include "objectRegister.h"
+#include "buildDepend.h"
+
+#include "testFunc.h"
+#include "testBuildDepend.h"
+
+using namespace ModelSupport;
+
+testBuildDepend::testBuildDepend() 
+  /*!
+    Constructor
+  */
+{}
+
+testBuildDepend::~testBuildDepend() 
+  /*!
+    Destructor
+  */
+{}
+
+int 
+testBuildDepend::applyTest(const int extra)
+  /*!
+    Applies all the tests and returns 
+    the error number
+    \param extra :: Test number to run
+    \retval -1 : SetObject 
+    \retval 0 : All succeeded
+  */
+{
+  ELog::RegMethod RegA("testBuildDepend","applyTest");
+  TestFunc::regSector("testBuildDepend");
+
+  typedef int (testBuildDepend::*testPtr)();
+  testPtr TPtr[]=
+    {
+      &testBuildDepend::testHasChanged,
+      &testBuildDepend::testReadSet
+    };
+  const std::string TestName[]=
+    {
+      "HasChanged",
+      "ReadSet"
+    };
+  
+  const int TSize(sizeof(TPtr)/sizeof(testPtr));
+  if (!extra)
+    {
+      std::ios::fmtflags flagIO=std::cout.setf(std::ios::left);
+      for(int i=0;i<TSize;i++)
+        {
+	  std::cout<<std::setw(30)<<TestName[i]<<"("<<i+1<<")"<<std::endl;
+	}
+      std::cout.flags(flagIO);
+      return 0;
+    }
+  for(int i=0;i<TSize;i++)
+    {
+      if (extra<0 || extra==i+1)
+        {
+	  TestFunc::regTest(TestName[i]);
+	  const int retValue= (this->*TPtr[i])();
+	  if (retValue || extra>0)
+	    return retValue;
+	}
+    }
+  return 0;
+}
+
+int
+testBuildDepend::testHasChanged()
+  /*!
+    Test that a changed variable is given to the component
+    with the longest matching name and that a missing 
+    variable which is later added is a change
+    \return 0 on success / -ve on failure
+  */
+{
+  ELog::RegMethod RegA("testBuildDepend","testHasChanged");
+
+  objectRegister& OR=objectRegister::Instance();
+  OR.reset();
+  OR.cell("shutter");
+  OR.cell("shutterBay");
+
+  FuncDataBase Control;
+  Control.addVariable("shutterLength",1.0);
+  Control.addVariable("shutterBayLength",2.0);
+  Control.addVariable("worldSize",3.0);
+
+  buildDepend BD;
+  std::vector<std::string> Changed;
+  if (!BD.hasChanged(Control,Changed) || !Changed.empty())
+    {
+      ELog::EM<<"Empty record not changed"<<ELog::endDiag;
+      return -1;
+    }
+
+  Control.clearReadSet();
+  Control.EvalVar<double>("shutterLength");
+  Control.EvalVar<double>("shutterBayLength");
+  Control.EvalVar<double>("worldSize");
+  Control.EvalDefVar<double>("shutterBayWidth",4.0);
+  BD.record(Control);
+  OR.reset();
+
+  // Variable : new value : changed component 
+  typedef boost::tuple<std::string,double,std::string> TTYPE;
+  std::vector<TTYPE> Tests;
+  Tests.push_back(TTYPE("shutterBayLength",5.0,"shutterBay"));
+  Tests.push_back(TTYPE("shutterLength",6.0,"shutter"));
+  Tests.push_back(TTYPE("worldSize",7.0,"global"));
+  Tests.push_back(TTYPE("shutterBayWidth",4.0,"shutterBay"));
+  Tests.push_back(TTYPE("shutterWidth",8.0,""));
+
+  if (BD.size()!=3 || BD.hasChanged(Control,Changed) || !Changed.empty())
+    {
+      ELog::EM<<"Unchanged DB : "<<BD.size()<<" "
+	      <<Changed.size()<<ELog::endDiag;
+      return -2;
+    }
+
+  std::vector<TTYPE>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      FuncDataBase CX(Control);
+      if (CX.hasVariable(tc->get<0>()))
+	CX.setVariable(tc->get<0>(),tc->get<1>());
+      else
+	CX.addVariable(tc->get<0>(),tc->get<1>());
+      const int flag=BD.hasChanged(CX,Changed);
+      const std::string Out=(Changed.size()==1) ? Changed[0] : "";
+      if (flag!=!tc->get<2>().empty() || 
+	  Changed.size()>1 || Out!=tc->get<2>())
+	{
+	  ELog::EM<<"Variable == "<<tc->get<0>()<<ELog::endDiag;
+	  ELog::EM<<"Changed  == "<<flag<<" "<<Changed.size()
+		  <<" "<<Out<<ELog::endDiag;
+	  ELog::EM<<"Expected == "<<tc->get<2>()<<ELog::endDiag;
+	  return -3;
+	}
+    }
+  return 0;
+}
+
+int
+testBuildDepend::testReadSet()
+  /*!
+    Test that the DataBase only records the variables read
+    between clearReadSet and stopReadSet
+    \return 0 on success / -ve on failure
+  */
+{
+  ELog::RegMethod RegA("testBuildDepend","testReadSet");
+
+  FuncDataBase Control;
+  Control.addVariable("A",1.0);
+  Control.addVariable("B",2.0);
+  Control.addVariable("C",3.0);
+
+  Control.EvalVar<double>("A");
+  const size_t NA=Control.getReadSet().size();
+  Control.clearReadSet();
+  Control.EvalVar<double>("B");
+  Control.EvalDefVar<double>("D",4.0);
+  Control.hasVariable("B");
+  Control.stopReadSet();
+  Control.EvalVar<double>("C");
+  
+  std::ostringstream cx;
+  const std::set<std::string>& RSet=Control.getReadSet();
+  std::set<std::string>::const_iterator sc;
+  for(sc=RSet.begin();sc!=RSet.end();sc++)
+    cx<<*sc<<" ";
+  if (NA || cx.str()!="B D ")
+    {
+      ELog::EM<<"Before clear == "<<NA<<ELog::endDiag;
+      ELog::EM<<"Read set     == "<<cx.str()<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
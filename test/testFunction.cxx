@@ -27,6 +27,7 @@
 #include <cmath>
 #include <list>
 #include <vector>
+#include <set>
 #include <map>
 #include <string>
 #include <algorithm>
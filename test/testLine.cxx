@@ -31,6 +31,7 @@
 #include <string>
 #include <algorithm>
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/tuple/tuple.hpp>
 
 #include "Exception.h"
@@ -55,6 +56,7 @@
 #include "Sphere.h"
 #include "General.h"
 #include "Line.h"
+#include "neutron.h"
 #include "LineIntersectVisit.h"
 #include "SurInter.h"
 
@@ -90,12 +92,14 @@ testLine::applyTest(const int extra)
   testPtr TPtr[]=
     {
       &testLine::testIntersection,
-      &testLine::testInterDistance
+      &testLine::testInterDistance,
+      &testLine::testScratch
     };
   const std::string TestName[]=
     {
       "Intersection",
-      "InterDistance"
+      "InterDistance",
+      "Scratch"
     };
   
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
@@ -257,3 +261,100 @@ testLine::testInterDistance()
 }
   
   
+
+int
+testLine::testScratch()
+  /*!
+    Test that the per-thread scratch object gives the same
+    points, distances and surfaces as a new LineIntersectVisit
+    when it is reused for a sequence of tracks, and that a
+    nested scratch object does not change it
+    \return 0 sucess / -ve on failure
+  */
+{
+  ELog::RegMethod RegItem("testLine","testScratch");
+
+  std::vector<boost::shared_ptr<Geometry::Surface> > SurList;
+  SurList.push_back(boost::shared_ptr<Geometry::Surface>
+		    (new Geometry::Plane(1,0)));
+  SurList.back()->setSurface("px 8");
+  SurList.push_back(boost::shared_ptr<Geometry::Surface>
+		    (new Geometry::Cylinder(2,0)));
+  SurList.back()->setSurface("c/z 3 5 10");
+  SurList.push_back(boost::shared_ptr<Geometry::Surface>
+		    (new Geometry::Sphere(3,0)));
+  SurList.back()->setSurface("so 4");
+  SurList.push_back(boost::shared_ptr<Geometry::Surface>
+		    (new Geometry::Cone(4,0)));
+  SurList.back()->setSurface("kz 2 0.5");
+  SurList.push_back(boost::shared_ptr<Geometry::Surface>
+		    (new Geometry::General(5,0)));
+  SurList.back()->setSurface("gq 1 1 0 0 0 0 0 0 0 -36");
+
+  // Origin : Axis [many then few intersections]
+  typedef boost::tuple<Geometry::Vec3D,Geometry::Vec3D> TTYPE;
+  std::vector<TTYPE> Tests;
+  Tests.push_back(TTYPE(Geometry::Vec3D(0,0,0),Geometry::Vec3D(1,0,0)));
+  Tests.push_back(TTYPE(Geometry::Vec3D(0,30,0),Geometry::Vec3D(1,0,0)));
+  Tests.push_back(TTYPE(Geometry::Vec3D(-20,1,1),Geometry::Vec3D(1,1,0)));
+  Tests.push_back(TTYPE(Geometry::Vec3D(0,0,-10),Geometry::Vec3D(0,0,1)));
+  Tests.push_back(TTYPE(Geometry::Vec3D(1,2,3),Geometry::Vec3D(0,-1,0)));
+
+  const MonteCarlo::LineIntersectVisit* firstPtr(0);
+  std::vector<TTYPE>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      const long int index(tc-Tests.begin());
+      // Alternate the point and neutron forms
+      const MonteCarlo::neutron N(static_cast<int>(index),
+				  tc->get<0>(),tc->get<1>());
+      MonteCarlo::LineIntersectVisit LA(tc->get<0>(),tc->get<1>());
+      boost::scoped_ptr<MonteCarlo::LineIntersectVisit::Scratch> 
+	SPtr((index % 2) ?
+	     new MonteCarlo::LineIntersectVisit::Scratch(N) :
+	     new MonteCarlo::LineIntersectVisit::Scratch
+	     (tc->get<0>(),tc->get<1>()));
+      MonteCarlo::LineIntersectVisit& LB=SPtr->item();
+      if (!firstPtr)
+	firstPtr=&LB;
+      else if (firstPtr!=&LB)
+	{
+	  ELog::EM<<"Scratch object not reused"<<ELog::endDiag;
+	  return -1;
+	}
+      for(size_t i=0;i<SurList.size();i++)
+	{
+	  SurList[i]->acceptVisitor(LA);
+	  SurList[i]->acceptVisitor(LB);
+	  // Nested track on the same thread
+	  MonteCarlo::LineIntersectVisit::Scratch 
+	    NS(Geometry::Vec3D(0,0,0),Geometry::Vec3D(0,1,0));
+	  if (&NS.item()==&LB)
+	    {
+	      ELog::EM<<"Nested scratch object shared"<<ELog::endDiag;
+	      return -3;
+	    }
+	  SurList[i]->acceptVisitor(NS.item());
+	}
+
+      const std::vector<Geometry::Vec3D>& PA=LA.getPoints();
+      const std::vector<Geometry::Vec3D>& PB=LB.getPoints();
+      const std::vector<double>& DA=LA.getDistance();
+      const std::vector<double>& DB=LB.getDistance();
+      int flag(PA.size()!=PB.size() || DA.size()!=DB.size() ||
+	       LA.getSurfIndex()!=LB.getSurfIndex() ||
+	       PA.size()!=DA.size());
+      for(size_t i=0;!flag && i<PA.size();i++)
+	if (PA[i]!=PB[i] || DA[i]!=DB[i])
+	  flag=1;
+      if (flag)
+	{
+	  ELog::EM<<"Test "<<index+1<<" : "<<tc->get<0>()<<" :: "
+		  <<tc->get<1>()<<ELog::endDiag;
+	  ELog::EM<<"New     "<<LA<<ELog::endDiag;
+	  ELog::EM<<"Scratch "<<LB<<ELog::endDiag;
+	  return -2;
+	}
+    }
+  return 0;
+}
@@ -30,11 +30,16 @@
 #include <complex>
 #include <string>
 #include <algorithm>
+#include <boost/tuple/tuple.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
 
 #include "Exception.h"
 #include "FileReport.h"
 #include "GTKreport.h"
 #include "NameStack.h"
+#include "MethodProfile.h"
 #include "RegMethod.h"
 #include "OutputLog.h"
 
@@ -65,11 +70,21 @@ testLog::applyTest(const int extra)
   typedef int (testLog::*testPtr)();
   testPtr TPtr[]=
     {
-      &testLog::testENDL
+      &testLog::testENDL,
+      &testLog::testMethodProfile,
+      &testLog::testNameStack,
+      &testLog::testNameStackDepth,
+      &testLog::testRegMethod,
+      &testLog::testThreadHold
     };
   const std::string TestName[]=
     {
-      "ENDL"
+      "ENDL",
+      "MethodProfile",
+      "NameStack",
+      "NameStackDepth",
+      "RegMethod",
+      "ThreadHold"
     };
   
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
@@ -120,3 +135,372 @@ testLog::testENDL()
   ELog::EM<<"END of  ::3 EMPTY LINE:"<<ELog::endDebug;
   return 0;
 }
+
+int
+testLog::testMethodProfile()
+  /*!
+    Test the call tree, the inclusive/exclusive times 
+    with a recursive call and the output formats
+    \return 0 on success / -ve on failure
+   */
+{
+  ELog::RegMethod RegA("testLog","testMethodProfile");
+
+  const std::string AN("Aclass::amethod");
+  const std::string BN("Bclass::bmethod");
+  // A [0-10] calls B [1-3] and A [4-9] which calls B [5-6]
+  ELog::profTree TA;
+  TA.enter(AN,0.0);
+  TA.enter(BN,1.0);
+  TA.leave(3.0);
+  TA.enter(AN,4.0);
+  TA.enter(BN,5.0);
+  TA.leave(6.0);
+  TA.leave(9.0);
+  TA.leave(10.0);
+  // Second thread : B called 3 times for 8s
+  ELog::profTree TB;
+  TB.enter(BN,0.0);
+  TB.leave(2.0);
+  TB.enter(BN,2.0);
+  TB.leave(5.0);
+  TB.enter(BN,5.0);
+  TB.leave(8.0);
+
+  // Node : name parent count inc child
+  typedef boost::tuple<std::string,size_t,size_t,double,double> NTYPE;
+  std::vector<NTYPE> Nodes;
+  Nodes.push_back(NTYPE("",0,0,0.0,10.0));
+  Nodes.push_back(NTYPE(AN,0,1,10.0,7.0));
+  Nodes.push_back(NTYPE(BN,1,1,2.0,0.0));
+  Nodes.push_back(NTYPE(AN,1,1,5.0,1.0));
+  Nodes.push_back(NTYPE(BN,3,1,1.0,0.0));
+  const std::vector<ELog::profNode>& PN=TA.getNodes();
+  if (PN.size()!=Nodes.size())
+    {
+      ELog::EM<<"Nodes == "<<PN.size()<<ELog::endTrace;
+      return -1;
+    }
+  for(size_t i=0;i<Nodes.size();i++)
+    {
+      const ELog::profNode& Item=PN[i];
+      if (Item.Name!=Nodes[i].get<0>() ||
+	  Item.parent!=Nodes[i].get<1>() ||
+	  Item.count!=Nodes[i].get<2>() ||
+	  std::abs(Item.incTime-Nodes[i].get<3>())>1e-12 ||
+	  std::abs(Item.childTime-Nodes[i].get<4>())>1e-12)
+	{
+	  ELog::EM<<"Node["<<i<<"] == "<<Item.Name<<" "<<Item.parent
+		  <<" "<<Item.count<<" "<<Item.incTime<<" "
+		  <<Item.childTime<<ELog::endTrace;
+	  return -2;
+	}
+    }
+
+  ELog::MethodProfile& MP=ELog::MethodProfile::Instance();
+  MP.clear();
+  MP.insertTree(TA);
+  MP.insertTree(TB);
+  std::ostringstream FlatOut;
+  std::ostringstream TreeOut;
+  std::ostringstream FoldOut;
+  MP.writeFlat(FlatOut);
+  MP.writeTree(TreeOut);
+  MP.writeFolded(FoldOut);
+  MP.clear();
+
+  // Flat : calls incl excl name [decreasing excl]
+  // A inclusive is only the outer call
+  std::vector<std::string> Flat;
+  std::istringstream FlatIn(FlatOut.str());
+  std::string Line;
+  while(std::getline(FlatIn,Line))
+    if (!Line.empty() && Line[0]!='#')
+      {
+	std::istringstream cx(Line);
+	size_t count;
+	double incT,excT;
+	std::string Name;
+	cx>>count>>incT>>excT>>Name;
+	std::ostringstream ox;
+	ox<<count<<" "<<incT<<" "<<excT<<" "<<Name;
+	Flat.push_back(ox.str());
+      }
+  const std::string FlatHead("# Method profile : threads 2");
+  if (Flat.size()!=2 || 
+      FlatOut.str().compare(0,FlatHead.size(),FlatHead) ||
+      Flat[0]!="5 11 11 "+BN ||
+      Flat[1]!="2 10 7 "+AN)
+    {
+      ELog::EM<<"Flat == \n"<<FlatOut.str()<<ELog::endTrace;
+      return -3;
+    }
+
+  const std::string TreeItem=
+    "# Call tree : thread 0\n"
+    "  "+AN+" : 1 10 3\n"
+    "    "+AN+" : 1 5 4\n"
+    "      "+BN+" : 1 1 1\n"
+    "    "+BN+" : 1 2 2\n"
+    "# Call tree : thread 1\n"
+    "  "+BN+" : 3 8 8\n";
+  if (TreeOut.str()!=TreeItem)
+    {
+      ELog::EM<<"Tree     == \n"<<TreeOut.str()<<ELog::endTrace;
+      ELog::EM<<"Expected == \n"<<TreeItem<<ELog::endTrace;
+      return -4;
+    }
+
+  // Path : exclusive time [us]
+  const std::string FoldItem=
+    AN+" 3000000\n"+
+    AN+";"+BN+" 2000000\n"+
+    AN+";"+AN+" 4000000\n"+
+    AN+";"+AN+";"+BN+" 1000000\n"+
+    BN+" 8000000\n";
+  if (FoldOut.str()!=FoldItem)
+    {
+      ELog::EM<<"Folded   == \n"<<FoldOut.str()<<ELog::endTrace;
+      ELog::EM<<"Expected == \n"<<FoldItem<<ELog::endTrace;
+      return -5;
+    }
+  return 0;
+}
+
+int
+testLog::testNameStack()
+  /*!
+    Test that the names are rebuilt from held pointers
+    and copied names, including after a copy of the stack
+    \return 0 on success / -ve on failure
+   */
+{
+  ELog::RegMethod RegA("testLog","testNameStack");
+
+  ELog::NameStack* NPtr=new ELog::NameStack();
+  std::string Name("Bclass");
+  NPtr->addComp("Aclass","amethod");
+  NPtr->addComp(Name,"bmethod");
+  NPtr->addComp("Cclass","cmethod");
+  // Copied name must not follow the caller string
+  Name="Xclass";
+
+  ELog::NameStack B(*NPtr);
+  ELog::NameStack C;
+  C.addComp("Zclass","zmethod");
+  C=*NPtr;
+  delete NPtr;
+
+  const std::string FullItem("Aclass::amethod#Bclass::bmethod#"
+			     "Cclass::cmethod");
+  const ELog::NameStack* NS[]={&B,&C};
+  for(size_t i=0;i<2;i++)
+    {
+      const ELog::NameStack& A(*NS[i]);
+      if (A.getFull()!=FullItem ||
+	  A.getBase()!="Cclass::cmethod" ||
+	  A.getItem(0)!="Cclass::cmethod" ||
+	  A.getItem(1)!="Bclass::bmethod" ||
+	  A.getItem(-1)!="Bclass::bmethod" ||
+	  A.getItem(-2)!="Aclass::amethod" ||
+	  A.getItem(3)!="" ||
+	  A.getStoreSize()!=2)
+	{
+	  ELog::EM<<"Stack    == "<<i<<ELog::endTrace;
+	  ELog::EM<<"Full     == "<<A.getFull()<<ELog::endTrace;
+	  ELog::EM<<"Expected == "<<FullItem<<ELog::endTrace;
+	  ELog::EM<<"Item     == "<<A.getItem(1)<<" : "
+		  <<A.getItem(-1)<<ELog::endTrace;
+	  ELog::EM<<"Store    == "<<A.getStoreSize()<<ELog::endTrace;
+	  return -1;
+	}
+    }
+  
+  // Held name replaces a copied name at the same level
+  B.popBack();
+  B.popBack();
+  B.addComp("Dclass","dmethod");
+  if (B.getFull()!="Aclass::amethod#Dclass::dmethod" ||
+      B.getFullTree()!="Aclass::amethod\n  Dclass::dmethod")
+    {
+      ELog::EM<<"Full == "<<B.getFull()<<ELog::endTrace;
+      ELog::EM<<"Tree == "<<B.getFullTree()<<ELog::endTrace;
+      return -2;
+    }
+  B.clear();
+  if (B.getDepth() || B.getStoreSize() || !B.getFull().empty())
+    {
+      ELog::EM<<"Clear failed :"<<B.getFull()<<ELog::endTrace;
+      return -3;
+    }
+  return 0;
+}
+
+int
+testLog::testNameStackDepth()
+  /*!
+    Test levels beyond maxDepth are counted but not held
+    \return 0 on success / -ve on failure
+   */
+{
+  ELog::RegMethod RegA("testLog","testNameStackDepth");
+
+  const size_t MD(ELog::NameStack::maxDepth);
+  ELog::NameStack A;
+  for(size_t i=0;i<MD-1;i++)
+    A.addComp("Lclass","lmethod");
+  A.addComp(std::string("Sclass"),"smethod");
+  for(size_t i=0;i<5;i++)
+    {
+      A.addComp("Oclass","omethod");
+      A.addComp(std::string("Oclass"),"omethod");
+    }
+  const std::string Full=A.getFull();
+  const size_t nItem=
+    static_cast<size_t>(std::count(Full.begin(),Full.end(),'#'))+1;
+  if (A.getDepth()!=MD+10 || nItem!=MD ||
+      A.getStoreSize()!=MD ||
+      A.getBase()!="" ||
+      A.getItem(static_cast<long int>(MD-1))!="Sclass::smethod" ||
+      A.getItem(static_cast<long int>(MD+2))!="" ||
+      Full.find("Oclass")!=std::string::npos)
+    {
+      ELog::EM<<"Depth == "<<A.getDepth()<<ELog::endTrace;
+      ELog::EM<<"Items == "<<nItem<<ELog::endTrace;
+      ELog::EM<<"Store == "<<A.getStoreSize()<<ELog::endTrace;
+      ELog::EM<<"Item  == "<<A.getItem(static_cast<long int>(MD-1))
+	      <<ELog::endTrace;
+      return -1;
+    }
+
+  // Copy keeps the count and the held levels
+  ELog::NameStack B(A);
+  for(size_t i=0;i<10;i++)
+    B.popBack();
+  if (B.getDepth()!=MD || B.getBase()!="Sclass::smethod" ||
+      B.getFull()!=Full)
+    {
+      ELog::EM<<"Depth == "<<B.getDepth()<<ELog::endTrace;
+      ELog::EM<<"Base  == "<<B.getBase()<<ELog::endTrace;
+      return -2;
+    }
+  return 0;
+}
+
+int
+testLog::testRegMethod()
+  /*!
+    Test that RegMethod copies names that are not 
+    string literals
+    \return 0 on success / -ve on failure
+   */
+{
+  ELog::RegMethod RegA("testLog","testRegMethod");
+
+  const std::string Base("testLog::testRegMethod");
+  if (ELog::RegMethod::getBase()!=Base)
+    {
+      ELog::EM<<"Base == "<<ELog::RegMethod::getBase()<<ELog::endTrace;
+      return -1;
+    }
+  
+  {
+    std::string CN("dynClass");
+    std::string MN("dynMethod");
+    ELog::RegMethod RegB(CN.c_str(),MN.c_str());
+    CN="xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
+    MN.clear();
+    ELog::RegMethod RegC("litClass","litMethod");
+    if (ELog::RegMethod::getBase()!="litClass::litMethod" ||
+	ELog::RegMethod::getItem(-1)!="dynClass::dynMethod" ||
+	ELog::RegMethod::getItem(-2)!=Base ||
+	ELog::RegMethod::getFull().find("dynClass::dynMethod")==
+	std::string::npos)
+      {
+	ELog::EM<<"Full == "<<ELog::RegMethod::getFull()<<ELog::endTrace;
+	return -2;
+      }
+  }
+  if (ELog::RegMethod::getBase()!=Base)
+    {
+      ELog::EM<<"Base == "<<ELog::RegMethod::getBase()<<ELog::endTrace;
+      return -3;
+    }
+  return 0;
+}
+
+void
+testLog::holdMessages(ELog::OutputLog<ELog::StreamReport>& OL,
+		      ELog::ThreadHold* HPtr,const int ID)
+  /*!
+    Write three messages from a worker thread
+    \param OL :: Log to write to
+    \param HPtr :: Holder for the thread
+    \param ID :: Thread number
+   */
+{
+  OL.holdThread(HPtr);
+  for(int i=0;i<3;i++)
+    {
+      OL<<"Thread "<<ID<<" : "<<i;
+      OL.diagnostic();
+    }
+  OL.holdThread(0);
+  return;
+}
+
+int
+testLog::testThreadHold()
+  /*!
+    Test that the messages of worker threads are held
+    in order for each thread and do not use the stream
+    of the main thread
+    \return 0 on success / -ve on failure
+   */
+{
+  ELog::RegMethod RegA("testLog","testThreadHold");
+
+  ELog::OutputLog<ELog::StreamReport> OL;
+  OL<<"Main";
+  ELog::ThreadHold HA;
+  ELog::ThreadHold HB;
+  boost::thread_group TGroup;
+  TGroup.create_thread(boost::bind(&testLog::holdMessages,boost::ref(OL),&HA,1));
+  TGroup.create_thread(boost::bind(&testLog::holdMessages,boost::ref(OL),&HB,2));
+  TGroup.join_all();
+
+  ELog::ThreadHold* HVec[]={&HA,&HB};
+  for(int i=0;i<2;i++)
+    {
+      const ELog::ThreadHold& H(*HVec[i]);
+      if (H.EText.size()!=3 || H.EType.size()!=3)
+	{
+	  ELog::EM<<"Hold "<<i+1<<" size == "<<H.EText.size()<<ELog::endTrace;
+	  return -1;
+	}
+      for(int j=0;j<3;j++)
+	{
+	  std::ostringstream cx;
+	  cx<<"Thread "<<i+1<<" : "<<j;
+	  if (H.EText[static_cast<size_t>(j)]!=cx.str())
+	    {
+	      ELog::EM<<"Hold "<<i+1<<" == "
+		      <<H.EText[static_cast<size_t>(j)]<<ELog::endTrace;
+	      return -2;
+	    }
+	}
+    }
+  if (OL.Estream().str()!="Main")
+    {
+      ELog::EM<<"Main stream == "<<OL.Estream().str()<<ELog::endTrace;
+      return -3;
+    }
+  OL.Estream().str("");
+  OL.dispatchHold(HA);
+  if (!HA.EText.empty() || !HA.EType.empty())
+    {
+      ELog::EM<<"Hold not cleared"<<ELog::endTrace;
+      return -4;
+    }
+  return 0;
+}
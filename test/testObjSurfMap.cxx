@@ -35,6 +35,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/bind.hpp>
 #include <boost/format.hpp>
+#include <boost/tuple/tuple.hpp>
 
 #include "Exception.h"
 #include "FileReport.h"
@@ -48,6 +49,7 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "SenseCache.h"
 #include "Quaternion.h"
 #include "Surface.h"
 #include "Quadratic.h"
@@ -98,12 +100,16 @@ testObjSurfMap::applyTest(const int extra)
   typedef int (testObjSurfMap::*testPtr)();
   testPtr TPtr[]=
     {
-      &testObjSurfMap::testMap
+      &testObjSurfMap::testGraph,
+      &testObjSurfMap::testMap,
+      &testObjSurfMap::testUpdate
     };
 
   const std::string TestName[]=
     {
-      "Map"
+      "Graph",
+      "Map",
+      "Update"
     };
 
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
@@ -148,10 +154,80 @@ testObjSurfMap::createSurfaces()
   SurI.createSurface(5,"pz -1");
   SurI.createSurface(6,"pz 1");
 
+  SurI.createSurface(7,"px 3");
+  SurI.createSurface(10,"py 5");
+  SurI.createSurface(11,"py 7");
+
 
   return;
 }
 
+int
+testObjSurfMap::testGraph()
+  /*!
+    Test the adjacency graph gives the same cells
+    as the surface map and learns the order
+    \returns 0 on succes and -ve on failure
+  */
+{
+  ELog::RegMethod RegA("testObjSurfMap","testGraph");
+
+  // Cell 3 is on +2 but its box is away from cell 1
+  std::vector<boost::shared_ptr<MonteCarlo::Object> > OVec;
+  OVec.push_back(boost::shared_ptr<MonteCarlo::Object>
+		 (new MonteCarlo::Object(1,1,0.1,"1 -2 3 -4 5 -6")));
+  OVec.push_back(boost::shared_ptr<MonteCarlo::Object>
+		 (new MonteCarlo::Object(3,1,0.1,"2 -7 10 -11 5 -6")));
+  OVec.push_back(boost::shared_ptr<MonteCarlo::Object>
+		 (new MonteCarlo::Object(2,1,0.1,"2 -7 3 -4 5 -6")));
+
+  ObjSurfMap OM;
+  for(size_t i=0;i<OVec.size();i++)
+    {
+      OVec[i]->populate();
+      OVec[i]->createSurfaceList();
+      OVec[i]->calcBoundBox();
+      OM.addSurfaces(OVec[i].get());
+    }
+
+  typedef boost::tuple<int,Geometry::Vec3D,int,int> TTYPE;
+  std::vector<TTYPE> Tests;
+  Tests.push_back(TTYPE(2,Geometry::Vec3D(1,0,0),1,2));
+  Tests.push_back(TTYPE(2,Geometry::Vec3D(1,6,0),1,3));
+  Tests.push_back(TTYPE(2,Geometry::Vec3D(1,6,0),4,3));
+  Tests.push_back(TTYPE(-2,Geometry::Vec3D(1,0,0),2,1));
+  Tests.push_back(TTYPE(-2,Geometry::Vec3D(1,6,0),3,0));
+
+  Geometry::SenseCache SC;
+  for(int learnFlag=0;learnFlag<3;learnFlag++)
+    {
+      if (learnFlag==1)
+	OM.buildGraph();
+      else if (learnFlag==2)
+	{
+	  OM.addHit(2,1,OVec[2].get());
+	  OM.orderGraph();
+	}
+
+      std::vector<TTYPE>::const_iterator tc;
+      for(tc=Tests.begin();tc!=Tests.end();tc++)
+	{
+	  const MonteCarlo::Object* OPtr=
+	    OM.findNextObject(tc->get<0>(),tc->get<1>(),tc->get<2>(),SC);
+	  const int cellN=(OPtr) ? OPtr->getName() : 0;
+	  if (cellN!=tc->get<3>())
+	    {
+	      ELog::EM<<"Test "<<(tc-Tests.begin())+1
+		      <<" [graph "<<OM.hasGraph()<<"]"<<ELog::endDiag;
+	      ELog::EM<<"Cell == "<<cellN<<" ("<<tc->get<3>()<<")"
+		      <<ELog::endDiag;
+	      return -1;
+	    }
+	}
+    }
+  return 0;
+}
+
 int
 testObjSurfMap::testMap()
   /*!
@@ -201,6 +277,74 @@ testObjSurfMap::testMap()
   return 0;
 }
 
+int
+testObjSurfMap::testUpdate()
+  /*!
+    Test the threaded build and the incremental
+    update of the map against a serial build
+    \returns 0 on succes and -ve on failure
+  */
+{
+  ELog::RegMethod RegA("testObjSurfMap","testUpdate");
 
+  std::vector<boost::shared_ptr<MonteCarlo::Object> > OVec;
+  std::vector<MonteCarlo::Object*> PVec;
+  for(int i=0;i<9;i++)
+    {
+      std::ostringstream cx;
+      cx<<((i % 2) ? "-" : "")<<(i % 6)+1<<" "
+	<<((i % 3) ? "2" : "-2")<<" 3 -4";
+      OVec.push_back(boost::shared_ptr<MonteCarlo::Object>
+		     (new MonteCarlo::Object(i+1,1,0.1,cx.str())));
+      OVec.back()->createSurfaceList();
+      PVec.push_back(OVec.back().get());
+    }
 
+  ObjSurfMap SerialOM;
+  for(size_t i=0;i<PVec.size();i++)
+    SerialOM.addSurfaces(PVec[i]);
 
+  ObjSurfMap OM;
+  OM.addObjects(PVec,4);
+
+  const int SN[]={-6,-4,-2,-1,1,2,3,4,5};
+  const size_t NSN(sizeof(SN)/sizeof(int));
+  for(size_t i=0;i<NSN;i++)
+    if (OM.getObjects(SN[i])!=SerialOM.getObjects(SN[i]))
+      {
+	ELog::EM<<"Threaded build failed on "<<SN[i]<<ELog::endDiag;
+	return -1;
+      }
+
+  // Remove a cell and change a cell
+  OM.removeObject(PVec[2]);
+  SerialOM.removeObject(PVec[2]);
+  PVec[4]->removeSurface(4);
+  PVec[4]->addSurfString(" 6");
+  PVec[4]->populate();
+  PVec[4]->createSurfaceList();
+  OM.updateObject(PVec[4]);
+
+  ObjSurfMap NewOM;
+  for(size_t i=0;i<PVec.size();i++)
+    if (i!=2)
+      NewOM.addSurfaces(PVec[i]);
+
+  const int SNB[]={-6,-4,-2,-1,1,2,3,4,5,6};
+  const size_t NSNB(sizeof(SNB)/sizeof(int));
+  for(size_t i=0;i<NSNB;i++)
+    {
+      ObjSurfMap::STYPE AVec=OM.getObjects(SNB[i]);
+      ObjSurfMap::STYPE BVec=NewOM.getObjects(SNB[i]);
+      std::sort(AVec.begin(),AVec.end());
+      std::sort(BVec.begin(),BVec.end());
+      if (AVec!=BVec)
+	{
+	  ELog::EM<<"Update failed on "<<SNB[i]<<ELog::endDiag;
+	  for(size_t j=0;j<AVec.size();j++)
+	    ELog::EM<<"Map cell "<<AVec[j]->getName()<<ELog::endDiag;
+	  return -2;
+	}
+    }
+  return 0;
+}
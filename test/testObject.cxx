@@ -46,6 +46,8 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "BoundBox.h"
+#include "SenseCache.h"
 #include "Transform.h"
 #include "Surface.h"
 #include "Rules.h"
@@ -57,7 +59,9 @@
 #include "HeadRule.h"
 #include "Object.h"
 #include "Qhull.h"
+#include "RuleBDD.h"
 #include "neutron.h"
+#include "TrackCache.h"
 
 #include "testFunc.h"
 #include "testObject.h"
@@ -177,24 +181,32 @@ testObject::applyTest(const int extra)
   typedef int (testObject::*testPtr)();
   testPtr TPtr[]=
     {
+      &testObject::testBoundBox,
       &testObject::testCellStr,
       &testObject::testComplement,
       &testObject::testIsValid,
       &testObject::testIsOnSide,
       &testObject::testMakeComplement,
       &testObject::testRemoveComplement,
+      &testObject::testRuleBDD,
+      &testObject::testSenseCache,
       &testObject::testSetObject,
+      &testObject::testTrackCache,
       &testObject::testTrackCell
     };
   const std::string TestName[]=
     {
+      "BoundBox",
       "CellStr",
       "Complement",
       "IsValid",
       "IsOnSide",
       "MakeComplement",
       "RemoveComplement",
+      "RuleBDD",
+      "SenseCache",
       "SetObject",
+      "TrackCache",
       "TrackCell"
     };
   
@@ -223,6 +235,99 @@ testObject::applyTest(const int extra)
 }
 
 
+int
+testObject::testBoundBox()
+  /*!
+    Test the conservative bounding box of a cell
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testObject","testBoundBox");
+
+  createSurfaces();
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  SurI.createSurface(200,"cz 2");
+  SurI.createSurface(300,"p 1 1 0 4");
+
+  const double U(1e38);
+  // Object : Low : High
+  typedef boost::tuple<std::string,Geometry::Vec3D,Geometry::Vec3D> TTYPE;
+  std::vector<TTYPE> Tests;
+  Tests.push_back(TTYPE("4 10 0.05 1 -2 3 -4 5 -6",
+			Geometry::Vec3D(-1,-1,-1),Geometry::Vec3D(1,1,1)));
+  Tests.push_back(TTYPE("5 10 0.05 -100",Geometry::Vec3D(-25,-25,-25),
+			Geometry::Vec3D(25,25,25)));
+  Tests.push_back(TTYPE("6 0 100",Geometry::Vec3D(-U,-U,-U),
+			Geometry::Vec3D(U,U,U)));
+  Tests.push_back(TTYPE("7 0 1 -2 (3:-4)",Geometry::Vec3D(-1,-U,-U),
+			Geometry::Vec3D(1,U,U)));
+  Tests.push_back(TTYPE("8 0 -100 21",Geometry::Vec3D(10,-25,-25),
+			Geometry::Vec3D(25,25,25)));
+  Tests.push_back(TTYPE("9 0 -200 5 -6",Geometry::Vec3D(-2,-2,-1),
+			Geometry::Vec3D(2,2,1)));
+  Tests.push_back(TTYPE("10 0 -300 11 13 5 -6",Geometry::Vec3D(-3,-3,-1),
+			Geometry::Vec3D(7,7,1)));
+  Tests.push_back(TTYPE("11 0 (1 -2 3 -4 5 -6) : (-100 21)",
+			Geometry::Vec3D(-1,-25,-25),
+			Geometry::Vec3D(25,25,25)));
+
+  std::vector<TTYPE>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      Qhull A;
+      A.setObject(tc->get<0>());
+      A.populate();
+      A.calcBoundBox();
+      const Geometry::BoundBox ABox=A.getBoundBox();
+      const Geometry::Vec3D& LX=tc->get<1>();
+      const Geometry::Vec3D& HX=tc->get<2>();
+      for(size_t i=0;i<3;i++)
+	{
+	  const double LErr=std::abs(ABox.getLow()[i]-LX[i]);
+	  const double HErr=std::abs(ABox.getHigh()[i]-HX[i]);
+	  if (LErr>1e-3*std::max(1.0,std::abs(LX[i])) ||
+	      HErr>1e-3*std::max(1.0,std::abs(HX[i])))
+	    {
+	      ELog::EM<<"Failed on test "<<(tc-Tests.begin())+1
+		      <<ELog::endDiag;
+	      ELog::EM<<"Cell == "<<tc->get<0>()<<ELog::endDiag;
+	      ELog::EM<<"Box == "<<ABox<<ELog::endDiag;
+	      ELog::EM<<"Expected == "<<LX<<" : "<<HX<<ELog::endDiag;
+	      return -1;
+	    }
+	}
+    }
+
+  // Reject tests:
+  Qhull A;
+  A.setObject("4 10 0.05 1 -2 3 -4 5 -6");
+  A.populate();
+  A.calcBoundBox();
+  if (A.isValid(Geometry::Vec3D(0,0,1.01)) ||
+      !A.isValid(Geometry::Vec3D(0,0,1.0)) ||
+      A.lineBoundBox(Geometry::Vec3D(2,0,0),Geometry::Vec3D(1,0,0)) ||
+      !A.lineBoundBox(Geometry::Vec3D(2,0,0),Geometry::Vec3D(-1,0,0)) ||
+      A.lineBoundBox(Geometry::Vec3D(-2,2,0),Geometry::Vec3D(1,0,0)))
+    {
+      ELog::EM<<"Failed on reject test "<<A.getBoundBox()<<ELog::endDiag;
+      return -2;
+    }
+
+  // Moving a surface in place must stop the old box rejecting:
+  Geometry::Surface* SPtr=SurI.getSurf(6);
+  SPtr->displace(Geometry::Vec3D(0,0,1));
+  const int validMoved=A.isValid(Geometry::Vec3D(0,0,1.5));
+  const int lineMoved=
+    A.lineBoundBox(Geometry::Vec3D(-2,2,0),Geometry::Vec3D(1,0,0));
+  SPtr->displace(Geometry::Vec3D(0,0,-1));
+  if (!validMoved || !lineMoved)
+    {
+      ELog::EM<<"Failed on moved surface test "<<ELog::endDiag;
+      return -3;
+    }
+  return 0;
+}
+
 int
 testObject::testCellStr()
   /*!
@@ -276,6 +381,146 @@ testObject::testCellStr()
 }
 
 
+int
+testObject::testRuleBDD()
+  /*!
+    Test the removal of complements through the BDD
+    \retval -1 :: failed
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testObject","testRuleBDD");
+
+  populateMObj();
+
+  typedef boost::tuple<std::string,std::string> TTYPE;
+  std::vector<TTYPE> Tests;
+  Tests.push_back(TTYPE("4 10 0.0552 -5 8 #3",
+			"( 60006 : -60005 : 60004 : -60003 : 60002 : -60001 ) 8 -5"));
+  Tests.push_back(TTYPE("5 0 1 -2 #(1 3)","-3 1 -2"));
+  Tests.push_back(TTYPE("6 0 60001 #3",
+			"( 60006 : -60005 : 60004 : -60003 : 60002 ) 60001"));
+  Tests.push_back(TTYPE("7 0 -4 #2 #8",
+			"( 63 : -62 : 61 : -60 : ( ( -13 : 12 ) -5 ) ) -4"));
+
+  std::vector<TTYPE>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      MonteCarlo::RuleBDD BX;
+      Qhull A;
+      A.setObject(tc->get<0>());
+      const size_t NA=BX.build(A.topRule(),MObj);
+      Rule* RX=BX.removeComplement(A.topRule(),MObj);
+      const std::string Out=RX->display();
+      const size_t NB=BX.build(RX,MObj);
+      delete RX;
+      if (NA!=NB || Out!=tc->get<1>())
+	{
+	  ELog::EM<<"Init Obj:"<<tc->get<0>()<<ELog::endDiag;
+	  ELog::EM<<"Out Obj:"<<Out<<ELog::endDiag;
+	  ELog::EM<<"Expect :"<<tc->get<1>()<<ELog::endDiag;
+	  ELog::EM<<"Nodes :"<<NA<<" "<<NB<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  return 0;
+}
+
+int
+testObject::testSenseCache()
+  /*!
+    Test that cells sharing a surface sense cache give
+    the same results as the direct tests and that each
+    surface is only evaluated once per point
+    \retval -1 :: failed
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testObject","testSenseCache");
+
+  createSurfaces();
+  std::vector<std::string> CStr;
+  CStr.push_back("1 10 0.05 1 -2 3 -4 5 -6");
+  CStr.push_back("2 10 0.05 11 -12 13 -14 15 -16 (-1:2:-3:4:-5:6)");
+  CStr.push_back("3 10 0.05 21 -22 3 -4 5 -6");
+  CStr.push_back("4 10 0.05 -100 (-11:12:-13:14:-15:16) #(21 -22 3 -4 5 -6)");
+
+  std::vector<Qhull> Cells(CStr.size());
+  for(size_t i=0;i<CStr.size();i++)
+    {
+      Cells[i].setObject(CStr[i]);
+      Cells[i].populate();
+      Cells[i].createSurfaceList();
+    }
+
+  const int SNum[]={1,-2,4,-12,16,21,-22};
+  const size_t NSN(sizeof(SNum)/sizeof(int));
+
+  Geometry::SenseCache SC;
+  for(int i=0;i<9;i++)
+    for(int j=0;j<5;j++)
+      {
+	const Geometry::Vec3D Pt(-4.0+2.0*i,-3.0+1.5*j,1.0);
+	SC.setPoint(Pt);
+	SC.resetCount();
+	for(size_t k=0;k<Cells.size();k++)
+	  {
+	    int flag(Cells[k].isValid(Pt)!=Cells[k].isValid(SC));
+	    for(size_t sn=0;!flag && sn<NSN;sn++)
+	      if (Cells[k].isDirectionValid(Pt,SNum[sn])!=
+		  Cells[k].isDirectionValid(SC,SNum[sn]))
+		flag=static_cast<int>(sn)+2;
+	    if (flag)
+	      {
+		ELog::EM<<"Cell "<<Cells[k].getName()<<" failed at "
+			<<Pt<<" : "<<flag<<ELog::endDiag;
+		return -1;
+	      }
+	  }
+	// 15 surfaces in all the cells
+	if (SC.getEval()>15 || SC.getEval()>=SC.getCall())
+	  {
+	    ELog::EM<<"Point "<<Pt<<" : evaluations == "<<SC.getEval()
+		    <<" [calls == "<<SC.getCall()<<"]"<<ELog::endDiag;
+	    return -2;
+	  }
+      }
+
+  // A moved surface is evaluated again : a moved temporary 
+  // and a new surface in a reused index do not use the memo
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  Geometry::Surface* SPtr=SurI.getSurf(2);
+  SC.setPoint(Geometry::Vec3D(0.5,0,0));
+  SC.resetCount();
+  std::vector<int> Side;
+  Side.push_back(SC.side(SPtr));
+  Geometry::Surface* TPtr=SPtr->clone();
+  TPtr->displace(Geometry::Vec3D(1,0,0));
+  delete TPtr;
+  Side.push_back(SC.side(SPtr));
+  SPtr->displace(Geometry::Vec3D(-1,0,0));
+  Side.push_back(SC.side(SPtr));
+  SPtr->displace(Geometry::Vec3D(1,0,0));
+  TPtr=SPtr->clone();
+  Side.push_back(SC.side(TPtr));
+  delete TPtr;
+  TPtr=SurI.getSurf(1)->clone();
+  Side.push_back(SC.side(TPtr));
+  delete TPtr;
+
+  const int SideExpect[]={-1,-1,1,-1,1};
+  if (SC.getEval()!=4 || 
+      !std::equal(Side.begin(),Side.end(),SideExpect))
+    {
+      ELog::EM<<"Evaluations == "<<SC.getEval()<<ELog::endDiag;
+      for(size_t i=0;i<Side.size();i++)
+	ELog::EM<<"Side["<<i<<"] == "<<Side[i]<<" ["
+		<<SideExpect[i]<<"]"<<ELog::endDiag;
+      return -3;
+    }
+  return 0;
+}
+
 int
 testObject::testSetObject() 
   /*!
@@ -290,6 +535,13 @@ testObject::testSetObject()
   std::vector<TTYPE> Tests;
   Tests.push_back(TTYPE(" 4 10 0.05524655  -5  8  60  -61  62  -63 #3",
 			"4 10 0.0552465 #3 -63 62 -61 60 8 -5"));
+  Tests.push_back(TTYPE("5 0  1 -2 fill=3 u=4",
+			"5 0 -2 1 fill=3 u=4"));
+  Tests.push_back(TTYPE("5 0  (1 : -2) FILL = 7 trcl=2",
+			"5 0 (1 : -2) fill=7 trcl=2"));
+  // regex keywords 
+  Tests.push_back(TTYPE("6 0  1 -2fill=3",
+			"6 0 -2 1 fill=3"));
 
   std::vector<TTYPE>::const_iterator tc;
   for(tc=Tests.begin();tc!=Tests.end();tc++)
@@ -491,6 +743,84 @@ testObject::testIsOnSide()
   return 0;
 }
 
+int
+testObject::testTrackCache()
+  /*!
+    Test that tracking through cells with the ray 
+    intersection cache gives the same exit surfaces and
+    distances as the direct tracking, and that shared
+    surfaces are only solved once
+    \retval -1 :: failed
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testObject","testTrackCache");
+
+  createSurfaces();
+  std::vector<std::string> CStr;
+  CStr.push_back("1 10 0.05 1 -2 3 -4 5 -6");
+  CStr.push_back("2 10 0.05 11 -12 13 -14 15 -16 (-1:2:-3:4:-5:6)");
+  CStr.push_back("3 10 0.05 21 -22 3 -4 5 -6");
+  CStr.push_back("4 10 0.05 -100 (-11:12:-13:14:-15:16) #(21 -22 3 -4 5 -6)");
+
+  std::vector<Qhull> Cells(CStr.size());
+  for(size_t i=0;i<CStr.size();i++)
+    {
+      Cells[i].setObject(CStr[i]);
+      Cells[i].populate();
+      Cells[i].createSurfaceList();
+    }
+
+  std::vector<Geometry::Vec3D> Dir;
+  Dir.push_back(Geometry::Vec3D(1,0,0));
+  Dir.push_back(Geometry::Vec3D(1,0.05,0.02));
+  Dir.push_back(Geometry::Vec3D(-1,0.3,0.1));
+  Dir.push_back(Geometry::Vec3D(0.2,-1,0.4));
+
+  MonteCarlo::TrackCache TC;
+  const Geometry::Surface* SPtr;
+  const Geometry::Surface* TPtr;
+  double aDist,bDist;
+  for(size_t i=0;i<Dir.size();i++)
+    {
+      neutron TNeut(1,Geometry::Vec3D(0,0.1,0.2),Dir[i]);
+      TC.setRay(TNeut.Pos,TNeut.uVec);
+      TC.resetCount();
+      const Qhull* OPtr= &Cells[0];
+      int SN(0);
+      int nStep(0);
+      while(OPtr && nStep<10)
+	{
+	  const int SA= -OPtr->trackOutCell(TNeut,aDist,SPtr,-SN);
+	  const int SB= -OPtr->trackOutCell(TNeut,bDist,TPtr,-SN,TC);
+	  if (SA!=SB || SPtr!=TPtr || fabs(aDist-bDist)>1e-8)
+	    {
+	      ELog::EM<<"Failed on ray "<<i<<" cell "<<OPtr->getName()
+		      <<" : "<<SA<<" "<<SB<<" : "<<aDist<<" "<<bDist
+		      <<ELog::endDiag;
+	      return -1;
+	    }
+	  SN=SA;
+	  if (!SN) break;
+	  TNeut.moveForward(aDist);
+	  const Qhull* NPtr(0);
+	  for(size_t k=0;!NPtr && k<Cells.size();k++)
+	    if (&Cells[k]!=OPtr && Cells[k].isDirectionValid(TNeut.Pos,SN))
+	      NPtr= &Cells[k];
+	  OPtr=NPtr;
+	  nStep++;
+	}
+      if (nStep<2 || TC.getEval()>=TC.getCall())
+	{
+	  ELog::EM<<"Ray "<<i<<" : steps == "<<nStep<<" evaluations == "
+		  <<TC.getEval()<<" [calls == "<<TC.getCall()<<"]"
+		  <<ELog::endDiag;
+	  return -2;
+	}
+    }
+  return 0;
+}
+
 int
 testObject::testTrackCell() 
   /*!
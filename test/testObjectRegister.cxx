@@ -103,12 +103,14 @@ testObjectRegister::applyTest(const int extra)
   testPtr TPtr[]=
     {
       &testObjectRegister::testExcludeItem,
-      &testObjectRegister::testGetObject
+      &testObjectRegister::testGetObject,
+      &testObjectRegister::testInRange
     };
   const std::string TestName[]=
     {
       "ExcludeItem",
-      "GetObject"
+      "GetObject",
+      "InRange"
     };
   
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
@@ -173,5 +175,65 @@ testObjectRegister::testGetObject()
   return 0;
 }
 
+int
+testObjectRegister::testInRange()
+  /*!
+    Test the cell number to component lookup. The end 
+    of a range [start+size] is inclusive unless the next 
+    block starts there. A reset removes all the ranges.
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testObjectRegister","testInRange");
 
+  ModelSupport::objectRegister& OR=
+    ModelSupport::objectRegister::Instance();
+
+  const int AStart=OR.cell("rangeA",-1,100);
+  const int BStart=OR.cell("rangeB",2,20);
+  const int CStart=OR.cell("rangeC",-1,1);
+  if (OR.cell("rangeA",-1,100)!=AStart)
+    {
+      ELog::EM<<"Re-registration of rangeA changed start"<<ELog::endTrace;
+      return -1;
+    }
 
+  // Cell : Name
+  typedef boost::tuple<int,std::string> TTYPE;
+  std::vector<TTYPE> Tests;
+  Tests.push_back(TTYPE(AStart,"rangeA"));
+  Tests.push_back(TTYPE(AStart+99,"rangeA"));
+  Tests.push_back(TTYPE(AStart+100,"rangeB2"));
+  Tests.push_back(TTYPE(BStart+19,"rangeB2"));
+  Tests.push_back(TTYPE(CStart,"rangeC"));
+  Tests.push_back(TTYPE(BStart+20,"rangeC"));
+  Tests.push_back(TTYPE(CStart+1,"rangeC"));
+  Tests.push_back(TTYPE(CStart+2,""));
+  Tests.push_back(TTYPE(1,""));
+
+  std::vector<TTYPE>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      const int compID=OR.inRangeID(tc->get<0>());
+      const std::string& Name=OR.inRange(tc->get<0>());
+      if (Name!=tc->get<1>() ||
+	  OR.getRegionName(compID)!=Name ||
+	  (compID>=0 && OR.getRegionID(Name)!=compID))
+	{
+	  ELog::EM<<"Test "<<(tc-Tests.begin())+1<<ELog::endTrace;
+	  ELog::EM<<"Cell "<<tc->get<0>()<<" : "<<Name
+		  <<" ["<<compID<<"]"<<ELog::endTrace;
+	  ELog::EM<<"Expected "<<tc->get<1>()<<ELog::endTrace;
+	  return -1;
+	}
+    }
+
+  OR.reset();
+  if (OR.inRangeID(AStart)!=-1 || !OR.inRange(CStart).empty() ||
+      OR.getRegionID("rangeA")!=-1)
+    {
+      ELog::EM<<"Ranges kept after reset"<<ELog::endTrace;
+      return -2;
+    }
+  return 0;
+}
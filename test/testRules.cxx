@@ -23,6 +23,7 @@
 #include <iomanip>
 #include <iostream>
 #include <cmath>
+#include <complex>
 #include <vector>
 #include <set>
 #include <map>
@@ -50,11 +51,16 @@
 #include "Vec3D.h"
 #include "Transform.h"
 #include "Surface.h"
+#include "Quadratic.h"
+#include "Cylinder.h"
 #include "Rules.h"
 #include "RuleBinary.h"
+#include "RuleCode.h"
 #include "HeadRule.h"
 #include "Object.h"
 #include "surfIndex.h"
+#include "Line.h"
+#include "LineIntersectVisit.h"
 #include "mapIterator.h"
 
 #include "testFunc.h"
@@ -99,6 +105,28 @@ testRules::createSurfaces()
   return;
 }
 
+void
+testRules::createTrackSurfaces()
+  /*!
+    Create surfaces of each line type for the track tests
+   */
+{
+  ELog::RegMethod RegA("testRules","createTrackSurfaces");
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  SurI.reset();
+  SurI.createSurface(21,"p 1 1 0 0.5");
+  SurI.createSurface(22,"cx 1");
+  SurI.createSurface(23,"c/y 0.5 0.5 1");
+  SurI.createSurface(24,"so 1.5");
+  SurI.createSurface(25,"s 0.5 0 0 1");
+  SurI.createSurface(26,"gq 1 2 1 0 0 0 0 0 0 -4");
+  SurI.createSurface(28,"kx 0 1");
+  // Cylinder off the axes [general equation]
+  Geometry::Cylinder* CPtr=SurI.createSurf<Geometry::Cylinder>(27);
+  CPtr->setCylinder(Geometry::Vec3D(0,0,0),Geometry::Vec3D(1,1,1),1.0);
+  return;
+}
+
 int 
 testRules::applyTest(const int extra)
   /*!
@@ -120,8 +148,12 @@ testRules::applyTest(const int extra)
       &testRules::testHeadRule,
       &testRules::testIsValid,
       &testRules::testMakeCNF,
+      &testRules::testProcString,
       &testRules::testRemoveComplement,
-      &testRules::testRuleBinary
+      &testRules::testRuleBinary,
+      &testRules::testRuleCode,
+      &testRules::testTrackPair,
+      &testRules::testTrackStale
     };
   const std::string TestName[]=
     {
@@ -130,8 +162,12 @@ testRules::applyTest(const int extra)
       "HeadRule",
       "IsValid",
       "MakeCNF",
+      "ProcString",
       "RemoveComplement",
-      "RuleBinary"
+      "RuleBinary",
+      "RuleCode",
+      "TrackPair",
+      "TrackStale"
     };
   
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
@@ -388,6 +424,45 @@ testRules::testMakeCNF()
   return 0;
 }
 
+int
+testRules::testProcString()
+  /*!
+    Check that the single pass parser of HeadRule 
+    makes the same tree as the full parser
+    \return 0 :: success / -ve on error
+  */
+{
+  ELog::RegMethod RegA("testRules","testProcString");
+
+  std::vector<std::string> Tests;
+  Tests.push_back("1 -2 3");
+  Tests.push_back("1 -2 : 3 4 : -5");
+  Tests.push_back(" ( 1 : -2 ) 3 (4:5 6)");
+  Tests.push_back("1 #(2 : -3) #5 -4");
+  Tests.push_back("1 # ( (2 3) : 4 (5 : 6) ) -7");
+  Tests.push_back("1-2(3)#4");
+
+  std::vector<std::string>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      HeadRule A;
+      Rule* BPtr=Rule::procString(*tc);
+      if (!A.procString(*tc) || !BPtr || 
+	  A.getTopRule()->display()!=BPtr->display())
+	{
+	  ELog::EM<<"Test "<<(tc-Tests.begin())+1<<" :"
+		  <<*tc<<ELog::endTrace;
+	  ELog::EM<<"Head == "<<A.display()<<ELog::endTrace;
+	  if (BPtr)
+	    ELog::EM<<"Rule == "<<BPtr->display()<<ELog::endTrace;
+	  delete BPtr;
+	  return -1;
+	}
+      delete BPtr;
+    }
+  return 0;
+}
+
 int
 testRules::testRemoveComplement()
   /*!
@@ -457,3 +532,255 @@ testRules::testRuleBinary()
   return 0;
 }
 
+
+int
+testRules::testRuleCode()
+  /*!
+    Check that the compiled rule gives the same
+    results as the rule tree
+    \return 0 :: success / -ve on error
+  */
+{
+  ELog::RegMethod RegA("testRules","testRuleCode");
+
+  createSurfaces();
+
+  std::vector<std::string> Tests;
+  Tests.push_back("1 -2 3 -4 5 -6");
+  Tests.push_back("1 -2 3 -4 5 -6 (11:(12 14))");
+  Tests.push_back("(1 -2 3 -4) : (-11 : 12) : 5 ");
+  Tests.push_back("1 -2 3 -4 5 -6 #(11 -12 (13:-14) 15 -16)");
+  Tests.push_back("#(1 -2 3 -4 5 -6) (-11 : 12 : -13 : 14) ");
+  Tests.push_back("(1:-12) (-2:11) (3 : (-4 #(5 -6)))");
+
+  const int SNum[]={0,1,-1,2,-2,4,-4,6,11,-12,14,-16};
+  const size_t NSN(sizeof(SNum)/sizeof(int));
+
+  std::vector<std::string>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      HeadRule HR;
+      if (!HR.procString(*tc))
+	{
+	  ELog::EM<<"Failed to process :"<<*tc<<ELog::endDiag;
+	  return -1;
+	}
+      HR.populateSurf();
+      if (!HR.hasCode())
+	{
+	  ELog::EM<<"Failed to compile :"<<HR.display()<<ELog::endDiag;
+	  return -2;
+	}
+      const Rule* TRule=HR.getTopRule();
+      for(int i=0;i<7;i++)
+	for(int j=0;j<7;j++)
+	  for(int k=0;k<7;k++)
+	    {
+	      const Geometry::Vec3D Pt(-1.5+0.5*i,-1.5+0.5*j,-1.5+0.5*k);
+	      int flag(TRule->isValid(Pt)!=HR.isValid(Pt));
+	      for(size_t sn=0;!flag && sn<NSN;sn++)
+		{
+		  const int SN(SNum[sn]);
+		  if (TRule->isValid(Pt,SN)!=HR.isValid(Pt,SN) ||
+		      TRule->isDirectionValid(Pt,SN)!=
+		      HR.isDirectionValid(Pt,SN) ||
+		      TRule->pairValid(SN,Pt)!=HR.pairValid(SN,Pt))
+		    flag=static_cast<int>(sn)+1;
+		}
+	      if (flag)
+		{
+		  RuleCode RC;
+		  RC.build(TRule);
+		  ELog::EM<<"Rule == "<<HR.display()<<ELog::endDiag;
+		  ELog::EM<<"Pt   == "<<Pt<<" "<<flag<<ELog::endDiag;
+		  ELog::EM<<"Code == \n"<<RC<<ELog::endDiag;
+		  return -3;
+		}
+	    }
+    }
+  return 0;
+}
+
+int
+testRules::testTrackPair()
+  /*!
+    Check that the track form of pairValid gives the 
+    same results as pairValid for planes, spheres, axis 
+    and general cylinders and quadratics. The tracks 
+    include tangent lines and lines parallel to or in
+    a surface.
+    \return 0 :: success / -ve on error
+  */
+{
+  ELog::RegMethod RegA("testRules","testTrackPair");
+
+  createTrackSurfaces();
+  const ModelSupport::surfIndex& SurI=
+    ModelSupport::surfIndex::Instance();
+
+  std::vector<std::string> Rules;
+  Rules.push_back("-24 21");
+  Rules.push_back("22 : -23");
+  Rules.push_back("-25 -26 (21 : -27)");
+  Rules.push_back("-24 28 #(-22 21)");
+  Rules.push_back("(-26 23) : (-24 27 -25) : -21");
+
+  const double r2(sqrt(0.5));
+  // Origin : Direction
+  typedef boost::tuple<Geometry::Vec3D,Geometry::Vec3D> TTYPE;
+  std::vector<TTYPE> Tracks;
+  Tracks.push_back(TTYPE(Geometry::Vec3D(-3,0.1,0.2),
+			 Geometry::Vec3D(1,0,0)));
+  Tracks.push_back(TTYPE(Geometry::Vec3D(-2,-2,-2),
+			 Geometry::Vec3D(1,1.1,0.9)));
+  Tracks.push_back(TTYPE(Geometry::Vec3D(0.3,-3,0.1),
+			 Geometry::Vec3D(0,1,0)));
+  // Tangent to the sphere 24 / cylinder 22 
+  Tracks.push_back(TTYPE(Geometry::Vec3D(-3,0,1.5),
+			 Geometry::Vec3D(1,0,0)));
+  Tracks.push_back(TTYPE(Geometry::Vec3D(0.2,-3,1),
+			 Geometry::Vec3D(0,1,0)));
+  // Parallel to cylinder 22 / in plane 21 / on cylinder 22
+  Tracks.push_back(TTYPE(Geometry::Vec3D(-3,0.5,0.2),
+			 Geometry::Vec3D(1,0,0)));
+  Tracks.push_back(TTYPE(Geometry::Vec3D(0.5*r2,0.5*r2,0.3),
+			 Geometry::Vec3D(r2,-r2,0)));
+  Tracks.push_back(TTYPE(Geometry::Vec3D(-3,0,1),
+			 Geometry::Vec3D(1,0,0)));
+  // Along the general cylinder 27 axis
+  Tracks.push_back(TTYPE(Geometry::Vec3D(-2,-2,-2),
+			 Geometry::Vec3D(1,1,1)));
+
+  const int SNum[]={0,21,-22,23,24,-25,26,27,28};
+  const size_t NSN(sizeof(SNum)/sizeof(int));
+
+  std::vector<std::string>::const_iterator rc;
+  for(rc=Rules.begin();rc!=Rules.end();rc++)
+    {
+      HeadRule HR;
+      HR.procString(*rc);
+      HR.populateSurf();
+      RuleCode RC;
+      if (!RC.build(HR.getTopRule()))
+	{
+	  ELog::EM<<"Failed to compile :"<<*rc<<ELog::endDiag;
+	  return -1;
+	}
+      std::vector<TTYPE>::const_iterator tc;
+      for(tc=Tracks.begin();tc!=Tracks.end();tc++)
+	{
+	  const Geometry::Vec3D& Org(tc->get<0>());
+	  const Geometry::Vec3D uVec(tc->get<1>().unit());
+	  MonteCarlo::LineIntersectVisit LI(Org,uVec);
+	  const ModelSupport::surfIndex::STYPE& SMap=SurI.surMap();
+	  ModelSupport::surfIndex::STYPE::const_iterator sc;
+	  for(sc=SMap.begin();sc!=SMap.end();sc++)
+	    sc->second->acceptVisitor(LI);
+	  RC.setTrack(Org,uVec);
+
+	  // Intersections and points between them
+	  std::vector<Geometry::Vec3D> Pts(LI.getPoints());
+	  std::vector<double> DPts(LI.getDistance());
+	  std::vector<int> SPts;
+	  for(size_t i=0;i<Pts.size();i++)
+	    SPts.push_back(LI.getSurfIndex()[i]->getName());
+	  for(int i=0;i<25;i++)
+	    {
+	      const double D(-3.0+0.25*i);
+	      Pts.push_back(Org+uVec*D);
+	      DPts.push_back(D);
+	      SPts.push_back(0);
+	    }
+
+	  for(size_t i=0;i<Pts.size();i++)
+	    for(size_t sn=0;sn<=NSN;sn++)
+	      {
+		const int SN((sn==NSN) ? SPts[i] : SNum[sn]);
+		const int pA=RC.pairValid(SN,Pts[i]);
+		const int pB=RC.trackPairValid(SN,Pts[i],DPts[i]);
+		if (pA!=pB || !RC.hasTrack())
+		  {
+		    ELog::EM<<"Rule  == "<<*rc<<ELog::endDiag;
+		    ELog::EM<<"Track == "<<Org<<" : "<<uVec<<ELog::endDiag;
+		    ELog::EM<<"Pt    == "<<Pts[i]<<" ["<<DPts[i]
+			    <<"] SN == "<<SN<<ELog::endDiag;
+		    ELog::EM<<"Pair  == "<<pA<<" "<<pB<<ELog::endDiag;
+		    return -2;
+		  }
+	      }
+	}
+    }
+  return 0;
+}
+
+int
+testRules::testTrackStale()
+  /*!
+    Check that a track is not used once it is stale
+    \return 0 :: success / -ve on error
+  */
+{
+  ELog::RegMethod RegA("testRules","testTrackStale");
+
+  createTrackSurfaces();
+  HeadRule HR;
+  HR.procString("-24 21 (22 : -23)");
+  HR.populateSurf();
+  RuleCode RC;
+  RuleCode RCB;
+  RC.build(HR.getTopRule());
+  RCB.build(HR.getTopRule());
+
+  const Geometry::Vec3D Org(-3,0.1,0.2);
+  const Geometry::Vec3D uVec(1,0,0);
+  // Result : test number
+  std::vector<int> Result;
+  RC.setTrack(Org,uVec);
+  Result.push_back(RC.hasTrack() ? 1 : 0);
+  // Other program sets a track
+  RCB.setTrack(Org,uVec);
+  Result.push_back(RC.hasTrack() ? 0 : 1);
+  // Rebuilt in place 
+  RC.setTrack(Org,uVec);
+  RC.build(HR.getTopRule());
+  Result.push_back(RC.hasTrack() ? 0 : 1);
+  // Surface not in the rule moved [25]
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  RC.setTrack(Org,uVec);
+  SurI.getSurf(25)->displace(Geometry::Vec3D(0.1,0,0));
+  Result.push_back(RC.hasTrack() ? 1 : 0);
+  SurI.getSurf(25)->displace(Geometry::Vec3D(-0.1,0,0));
+  // Surface of the rule moved
+  RC.setTrack(Org,uVec);
+  SurI.getSurf(22)->displace(Geometry::Vec3D(0.1,0,0));
+  Result.push_back(RC.hasTrack() ? 0 : 1);
+  SurI.getSurf(22)->displace(Geometry::Vec3D(-0.1,0,0));
+  // Copy does not take the track
+  RC.setTrack(Org,uVec);
+  const RuleCode RCC(RC);
+  Result.push_back((RC.hasTrack() && !RCC.hasTrack()) ? 1 : 0);
+
+  for(size_t i=0;i<Result.size();i++)
+    if (!Result[i])
+      {
+	ELog::EM<<"Failed on stale test "<<i+1<<ELog::endDiag;
+	return -1;
+      }
+
+  // Point off the track : same as pairValid
+  const Geometry::Vec3D Pt(0.2,0.3,0.1);
+  const int SNum[]={0,21,22,-24};
+  for(size_t i=0;i<4;i++)
+    {
+      const int pA=RC.pairValid(SNum[i],Pt);
+      const int pB=RC.trackPairValid(SNum[i],Pt,0.0);
+      const int pC=RC.trackPairValid(SNum[i],Pt,3.2);
+      if (pA!=pB || pA!=pC)
+	{
+	  ELog::EM<<"Off track "<<SNum[i]<<" == "<<pA<<" "<<pB
+		  <<" "<<pC<<ELog::endDiag;
+	  return -2;
+	}
+    }
+  return 0;
+}
@@ -40,6 +40,7 @@
 #include <boost/array.hpp>
 
 #include "Exception.h"
+#include "MersenneTwister.h"
 #include "FileReport.h"
 #include "GTKreport.h"
 #include "NameStack.h"
@@ -53,6 +54,7 @@
 #include "MatrixBase.h"
 #include "Matrix.h"
 #include "Vec3D.h"
+#include "BoundBox.h"
 #include "Quaternion.h"
 #include "localRotate.h"
 #include "masterRotate.h"
@@ -86,6 +88,7 @@
 #include "WForm.h"
 #include "weightManager.h"
 #include "ObjSurfMap.h"
+#include "ObjBVH.h"
 #include "ModeCard.h"
 #include "PhysCard.h"
 #include "PhysImp.h"
@@ -101,10 +104,13 @@
 #include "ModelSupport.h"
 #include "neutron.h"
 #include "Simulation.h"
+#include "SimValid.h"
 
 #include "testFunc.h"
 #include "testSimulation.h"
 
+extern MTRand RNG;
+
 testSimulation::testSimulation() 
   /*!
     Constructor
@@ -214,15 +220,23 @@ testSimulation::applyTest(const int extra)
   typedef int (testSimulation::*testPtr)();
   testPtr TPtr[]=
     {
+      &testSimulation::testBVH,
+      &testSimulation::testCellThreads,
       &testSimulation::testCreateObjSurfMap,
       &testSimulation::testInCell,
-      &testSimulation::testTrackNeutron
+      &testSimulation::testSurfaceChange,
+      &testSimulation::testTrackNeutron,
+      &testSimulation::testValidThreads
     };
   const std::string TestName[]=
     {
+      "BVH",
+      "CellThreads",
       "CreateObjSurfMap",
       "InCell",
-      "TrackNeutron"
+      "SurfaceChange",
+      "TrackNeutron",
+      "ValidThreads"
     };
   
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
@@ -306,6 +320,144 @@ testSimulation::testTrackNeutron()
             
 }
 
+int
+testSimulation::testBVH()
+  /*!
+    Test the cell box tree gives the same cell
+    as the linear search
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testSimulation","testBVH");
+
+  std::vector<Geometry::Vec3D> Pts;
+  Pts.push_back(Geometry::Vec3D(0,0,0));
+  Pts.push_back(Geometry::Vec3D(0,26,0));
+  Pts.push_back(Geometry::Vec3D(0,2,0));
+  Pts.push_back(Geometry::Vec3D(12.5,0.3,0));
+  Pts.push_back(Geometry::Vec3D(0,5,0));
+  Pts.push_back(Geometry::Vec3D(1,1,1));
+  Pts.push_back(Geometry::Vec3D(10,-1,0));
+  Pts.push_back(Geometry::Vec3D(-24.9,0,0));
+  Pts.push_back(Geometry::Vec3D(3,-3,3));
+
+  std::vector<int> CellN;
+  for(size_t i=0;i<Pts.size();i++)
+    CellN.push_back(ASim.findCellNumber(Pts[i],0));
+
+  ASim.createBVH();
+  const ModelSupport::ObjBVH* BPtr=ASim.getBVH();
+  // Only the outer void [1] is unbounded
+  if (!BPtr->isActive() || BPtr->size()!=5 || BPtr->unBoundSize()!=1)
+    {
+      ELog::EM<<"BVH == "<<BPtr->isActive()<<" "<<BPtr->size()
+	      <<" "<<BPtr->unBoundSize()<<ELog::endDiag;
+      return -1;
+    }
+
+  const Geometry::BoundBox ABox=ASim.findQhull(4)->getBoundBox();
+  if (!ABox.isValid(Geometry::Vec3D(12.5,0.3,0)) ||
+      ABox.isValid(Geometry::Vec3D(9.0,0,0)) ||
+      ABox.isValid(Geometry::Vec3D(12.5,1.1,0)))
+    {
+      ELog::EM<<"Cell 4 box == "<<ABox<<ELog::endDiag;
+      return -2;
+    }
+
+  for(size_t i=0;i<Pts.size();i++)
+    {
+      const int cN=ASim.findCellNumber(Pts[i],0);
+      if (cN!=CellN[i])
+	{
+	  ELog::EM<<"Failed on point:"<<Pts[i]<<ELog::endDiag;
+	  ELog::EM<<"  Cell == "<<CellN[i]<<" != "<<cN<<ELog::endDiag;
+	  return -3;
+	}
+    }
+
+  // Cell removal rebuilds the tree
+  Simulation BSim(ASim);
+  BSim.removeCell(4);
+  const ModelSupport::ObjBVH* BPtrB=BSim.getBVH();
+  const int cN=BSim.findCellNumber(Geometry::Vec3D(12.5,0.3,0),0);
+  if (cN || BPtrB->isDirty() || BPtrB->size()!=4)
+    {
+      ELog::EM<<"BVH rebuild == "<<cN<<" "<<BPtrB->isDirty()<<" "
+	      <<BPtrB->size()<<ELog::endDiag;
+      return -4;
+    }
+  return 0;
+}
+
+int
+testSimulation::testCellThreads()
+  /*!
+    Test that removeComplements and calcAllVertex give
+    the same cells and vertexes for any number of threads
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testSimulation","testCellThreads");
+
+  const std::string CellStr[]=
+    {
+      "100",
+      "1 -2 3 -4 5 -6",
+      "11 -12 13 -14 15 -16 #2",
+      "21 -22 3 -4 5 -6",
+      "-100 #3 #4",
+      "11 -12 #(1 -2 3) -4 15 -16",
+      "13 -14 #2 #4 -16 15",
+      "-100 #(11 -12 13) #2",
+      "-22 11 #4 #2 3 -4 15 -16"
+    };
+  const size_t NCell(sizeof(CellStr)/sizeof(std::string));
+  const int Mat[]={0,3,5};
+
+  std::vector<std::string> RuleA;
+  std::vector<std::vector<Geometry::Vec3D> > VertexA;
+  const size_t nThreads[]={1,3,4};
+  for(size_t i=0;i<3;i++)
+    {
+      Simulation BSim;
+      BSim.setThreads(nThreads[i]);
+      for(size_t j=0;j<NCell;j++)
+	BSim.addCell(MonteCarlo::Qhull(static_cast<int>(j+1),Mat[j%3],
+				       0.0,CellStr[j]));
+      BSim.removeComplements();
+      BSim.calcAllVertex();
+      for(size_t j=0;j<NCell;j++)
+	{
+	  const MonteCarlo::Qhull* QH=
+	    BSim.findQhull(static_cast<int>(j+1));
+	  const std::string RX=QH->topRule()->display();
+	  const std::vector<Geometry::Vec3D> VX=QH->getVertex();
+	  if (!i)
+	    {
+	      RuleA.push_back(RX);
+	      VertexA.push_back(VX);
+	      continue;
+	    }
+	  size_t vIndex(0);
+	  if (RX==RuleA[j] && VX.size()==VertexA[j].size())
+	    for(;vIndex<VX.size() && 
+		  (VX[vIndex]-VertexA[j][vIndex]).abs()<=0.0;vIndex++) ;
+	  if (RX!=RuleA[j] || vIndex!=VertexA[j].size() ||
+	      RX.find('#')!=std::string::npos)
+	    {
+	      ELog::EM<<"Threads "<<nThreads[i]<<" cell "<<j+1
+		      <<ELog::endDiag;
+	      ELog::EM<<"Rule   == "<<RX<<ELog::endDiag;
+	      ELog::EM<<"Serial == "<<RuleA[j]<<ELog::endDiag;
+	      ELog::EM<<"Vertex == "<<VX.size()<<" "
+		      <<VertexA[j].size()<<" "<<vIndex<<ELog::endDiag;
+	      return -1;
+	    }
+	}
+    }
+  return 0;
+}
+
 int
 testSimulation::testCreateObjSurfMap()
   /*!
@@ -387,3 +539,120 @@ testSimulation::testInCell()
       
   return 0;
 }
+
+int
+testSimulation::testSurfaceChange()
+  /*!
+    Test that a surface moved in place is seen by
+    findCell at the same point [sense memo dropped]
+    with and without the cell box tree. The tree 
+    must be rebuilt after the move [updateBVH]: 
+    findCell fails on a tree that is out of date.
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testSimulation","testSurfaceChange");
+
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  const Geometry::Vec3D Pt(1.5,0,0);
+
+  Simulation BSim(ASim);
+  BSim.createBVH();
+  Simulation* SimVec[]={&ASim,&BSim};
+  for(size_t i=0;i<2;i++)
+    {
+      Simulation& Sim(*SimVec[i]);
+      // Surface 2 is shared : moved by the previous pass
+      Sim.updateBVH();
+      const int cellA=Sim.findCellNumber(Pt,0);
+      Geometry::Surface* SPtr=SurI.getSurf(2);
+      SPtr->displace(Geometry::Vec3D(1,0,0));
+      // Out of date tree : find must fail
+      int failFlag(0);
+      try
+	{
+	  Sim.findCellNumber(Pt,0);
+	}
+      catch (ColErr::ExitAbort&)
+	{
+	  failFlag=1;
+	}
+      Sim.updateBVH();
+      const int cellB=Sim.findCellNumber(Pt,0);
+      SPtr->displace(Geometry::Vec3D(-1,0,0));
+      Sim.updateBVH();
+      const int cellC=Sim.findCellNumber(Pt,0);
+
+      if (cellA!=3 || cellB!=2 || cellC!=3 || 
+	  failFlag!=Sim.getBVH()->isActive())
+	{
+	  ELog::EM<<"BVH   == "<<Sim.getBVH()->isActive()
+		  <<" [fail == "<<failFlag<<"]"<<ELog::endDiag;
+	  ELog::EM<<"Cells == "<<cellA<<" "<<cellB<<" "
+		  <<cellC<<ELog::endDiag;
+	  return -1;
+	}
+    }
+
+  // A moved temporary surface keeps the cell boxes and the tree
+  Geometry::Surface* TPtr=SurI.getSurf(2)->clone();
+  TPtr->displace(Geometry::Vec3D(1,0,0));
+  delete TPtr;
+  if (!BSim.findQhull(4)->boxCurrent() || BSim.getBVH()->isDirty())
+    {
+      ELog::EM<<"Temporary surface moved the cell boxes"<<ELog::endDiag;
+      return -2;
+    }
+  return 0;
+}
+
+int
+testSimulation::testValidThreads()
+  /*!
+    Test that SimValid gives the same result for any 
+    number of threads : both on a valid model and on 
+    one with a missing cell. The serial run must draw
+    its tracks from RNG in order.
+    \retval 0 :: success
+  */
+{
+  ELog::RegMethod RegA("testSimulation","testValidThreads");
+
+  Simulation BSim(ASim);
+  BSim.findQhull(1)->setImp(0);
+  Simulation CSim(BSim);
+  CSim.removeCell(3);
+
+  const size_t nThreads[]={1,3};
+  for(size_t i=0;i<2;i++)
+    {
+      ModelSupport::SimValid SV;
+      SV.setThreads(nThreads[i]);
+      RNG.seed(12345UL);
+      const int validB=SV.run(BSim,1000);
+      RNG.seed(12345UL);
+      const int validC=SV.run(CSim,1000);
+      if (validB!=1 || validC!=0)
+	{
+	  ELog::EM<<"Threads "<<nThreads[i]<<" == "<<validB<<" "
+		  <<validC<<ELog::endDiag;
+	  return -1;
+	}
+    }
+
+  // Serial run keeps the old sequence : two draws per track
+  ModelSupport::SimValid SV;
+  RNG.seed(12345UL);
+  SV.run(BSim,100);
+  const double RA=RNG.rand();
+  RNG.seed(12345UL);
+  for(size_t i=0;i<200;i++)
+    RNG.rand();
+  const double RB=RNG.rand();
+  if (std::abs(RA-RB)>1e-12)
+    {
+      ELog::EM<<"Serial draws == "<<RA<<" "<<RB<<ELog::endDiag;
+      return -2;
+    }
+  return 0;
+}
@@ -98,6 +98,13 @@ testSurfEqual::createSurfaces()
   SurI.createSurface(5,"pz -1");
   SurI.createSurface(6,"pz 1");
   SurI.createSurface(11,"p -1 0 0 1");
+
+  // Range to remove
+  SurI.createSurface(101,"px 1");
+  SurI.createSurface(102,"cz 5");
+  SurI.createSurface(103,"gq 1 1 0 0 0 0 0 0 0 -25");
+  SurI.createSurface(104,"pz 7");
+  SurI.createSurface(105,"so 2");
   
   return;
 }
@@ -116,13 +123,15 @@ testSurfEqual::applyTest(const int extra)
   testPtr TPtr[]=
     {
       &testSurfEqual::testBasicPair,
-      &testSurfEqual::testEqualSurfNum
+      &testSurfEqual::testEqualSurfNum,
+      &testSurfEqual::testFindEqualSurf
     };
 
   const std::string TestName[]=
     {
       "BasicPair",
-      "EqualSurfNum"
+      "EqualSurfNum",
+      "FindEqualSurf"
     };
 
   const int TSize(sizeof(TPtr)/sizeof(testPtr));
@@ -215,3 +224,40 @@ testSurfEqual::testEqualSurfNum()
   return flag;
 }
 
+
+int
+testSurfEqual::testFindEqualSurf()
+  /*!
+    Test the equal surfaces found in a range
+    \return -ve on error 
+  */
+{
+  ELog::RegMethod RegA("testSurfEqual","testFindEqualSurf");
+
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  
+  std::map<int,int> Result;
+  Result[101]=2;          // outside range
+  Result[102]=103;        // later in range [different type]
+
+  std::map<int,Geometry::Surface*> EQMap;
+  const int nEqual=SurI.findEqualSurf(100,200,EQMap);
+
+  int flag(0);
+  std::map<int,Geometry::Surface*>::const_iterator mc;
+  for(mc=EQMap.begin();mc!=EQMap.end() && !flag;mc++)
+    {
+      std::map<int,int>::const_iterator rc=Result.find(mc->first);
+      if (rc==Result.end() || rc->second!=mc->second->getName())
+	flag=-1;
+    }
+  if (flag || nEqual!=static_cast<int>(Result.size()))
+    {
+      ELog::EM<<"Number found == "<<nEqual<<ELog::endCrit;
+      for(mc=EQMap.begin();mc!=EQMap.end();mc++)
+	ELog::EM<<"Equal :  "<<mc->first<<" "
+		<<mc->second->getName()<<ELog::endCrit;
+      return -1;
+    }
+  return 0;
+}
@@ -0,0 +1,404 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   test/testSurfHash.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <map>
+#include <set>
+#include <list>
+#include <string>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "support.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Triple.h"
+#include "Quaternion.h"
+#include "localRotate.h"
+#include "masterRotate.h"
+#include "NRange.h"
+#include "NList.h"
+#include "Surface.h"
+#include "surfIndex.h"
+#include "surfHash.h"
+#include "surfEqual.h"
+#include "Quadratic.h"
+#include "Plane.h"
+#include "Cylinder.h"
+#include "Rules.h"
+#include "varList.h"
+#include "Code.h"
+#include "FuncDataBase.h"
+#include "HeadRule.h"
+#include "Object.h"
+#include "Qhull.h"
+#include "KGroup.h"
+#include "Source.h"
+#include "Simulation.h"
+
+#include "testFunc.h"
+#include "testSurfHash.h"
+
+using namespace ModelSupport;
+
+testSurfHash::testSurfHash()
+  /*!
+    Constructor
+  */
+{}
+
+testSurfHash::~testSurfHash() 
+  /*!
+    Destructor
+  */
+{
+  ModelSupport::surfIndex::Instance().reset();
+}
+
+int
+testSurfHash::hasCandidate(const CVEC& CVec,const int SN)
+  /*!
+    Determine if a surface is in any of the candidate sets
+    \param CVec :: Candidate sets
+    \param SN :: Surface number
+    \return 1 if found
+  */
+{
+  CVEC::const_iterator vc;
+  for(vc=CVec.begin();vc!=CVec.end();vc++)
+    if ((*vc)->find(SN)!=(*vc)->end())
+      return 1;
+  return 0;
+}
+
+size_t
+testSurfHash::nCandidate(const CVEC& CVec)
+  /*!
+    Count the surfaces in the candidate sets
+    \param CVec :: Candidate sets
+    \return number of surfaces
+  */
+{
+  size_t cnt(0);
+  CVEC::const_iterator vc;
+  for(vc=CVec.begin();vc!=CVec.end();vc++)
+    cnt+=(*vc)->size();
+  return cnt;
+}
+
+int 
+testSurfHash::applyTest(const int extra)
+  /*!
+    Applies all the tests and returns 
+    the error number
+    \param extra :: Index of test
+    \returns -ve on error 0 on success.
+  */
+{
+  ELog::RegMethod RegA("testSurfHash","applyTest");
+  TestFunc::regSector("testSurfHash");
+
+  typedef int (testSurfHash::*testPtr)();
+  testPtr TPtr[]=
+    {
+      &testSurfHash::testLoose,
+      &testSurfHash::testMoved,
+      &testSurfHash::testOpposite,
+      &testSurfHash::testQuantumEdge,
+      &testSurfHash::testRehash
+    };
+
+  const std::string TestName[]=
+    {
+      "Loose",
+      "Moved",
+      "Opposite",
+      "QuantumEdge",
+      "Rehash"
+    };
+
+  const int TSize(sizeof(TPtr)/sizeof(testPtr));
+  if (!extra)
+    {
+      std::ios::fmtflags flagIO=std::cout.setf(std::ios::left);
+      for(int i=0;i<TSize;i++)
+        {
+	  std::cout<<std::setw(30)<<TestName[i]<<"("<<i+1<<")"<<std::endl;
+	}
+      std::cout.flags(flagIO);
+      return 0;
+    }
+  for(int i=0;i<TSize;i++)
+    {
+      if (extra<0 || extra==i+1)
+        {
+	  TestFunc::regTest(TestName[i]);
+	  const int retValue= (this->*TPtr[i])();
+	  if (retValue || extra>0)
+	    return retValue;
+	}
+    }
+  return 0;
+}
+
+int
+testSurfHash::testLoose()
+  /*!
+    Test that a surface from createSurf is a candidate 
+    once it is set, even though it was not hashed
+    \return -ve on error 
+  */
+{
+  ELog::RegMethod RegA("testSurfHash","testLoose");
+
+  surfIndex& SurI=surfIndex::Instance();
+  SurI.reset();
+  SurI.createSurface(52,"px 9");
+  Geometry::Plane* PPtr=SurI.createSurf<Geometry::Plane>(51);
+  PPtr->setPlane(Geometry::Vec3D(1,0,0),5.0);
+
+  Geometry::Plane PA(0,0);
+  PA.setPlane(Geometry::Vec3D(1,0,0),5.0);
+  CVEC CVec;
+  SurI.equalCandidates(&PA,CVec);
+  if (!hasCandidate(CVec,51) || hasCandidate(CVec,52))
+    {
+      ELog::EM<<"Candidates sets == "<<CVec.size()<<ELog::endDiag;
+      return -1;
+    }
+
+  Geometry::Plane PB(0,0);
+  PB.setPlane(Geometry::Vec3D(-1,0,0),-5.0);
+  const int SN=SurI.findOpposite(&PB);
+  if (SN!=51)
+    {
+      ELog::EM<<"Opposite == "<<SN<<ELog::endDiag;
+      return -2;
+    }
+  return 0;
+}
+
+int
+testSurfHash::testMoved()
+  /*!
+    Test that a surface moved in place is found by
+    equalSurface at its new position [no rehash] and 
+    is no longer found at the old one
+    \return -ve on error 
+  */
+{
+  ELog::RegMethod RegA("testSurfHash","testMoved");
+
+  surfIndex& SurI=surfIndex::Instance();
+  SurI.reset();
+  SurI.createSurface(71,"px 3");
+  SurI.createSurface(72,"py 4");
+  Geometry::Surface* SPtr=SurI.getSurf(71);
+  SPtr->displace(Geometry::Vec3D(5,0,0));
+  dynamic_cast<Geometry::Plane*>(SurI.getSurf(72))->
+    setPlane(Geometry::Vec3D(0,0,1),2.0);
+
+  // Plane : expected equal surface
+  typedef boost::tuple<std::string,int> TTYPE;
+  std::vector<TTYPE> Tests;
+  Tests.push_back(TTYPE("px 8",71));
+  Tests.push_back(TTYPE("px 3",0));
+  Tests.push_back(TTYPE("pz 2",72));
+  Tests.push_back(TTYPE("py 4",0));
+
+  std::vector<TTYPE>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      Geometry::Plane PA(0,0);
+      PA.setSurface(tc->get<0>());
+      const Geometry::Surface* OutPtr=
+	ModelSupport::equalSurface(static_cast<const Geometry::Surface*>(&PA));
+      const int SN=(OutPtr==&PA) ? 0 : OutPtr->getName();
+      if (SN!=tc->get<1>())
+	{
+	  ELog::EM<<"Test "<<(tc-Tests.begin())+1<<" : "
+		  <<tc->get<0>()<<ELog::endDiag;
+	  ELog::EM<<"Equal == "<<SN<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  return 0;
+}
+
+int
+testSurfHash::testOpposite()
+  /*!
+    Test that reversed planes and cylinders share a bucket
+    but different surface types do not
+    \return -ve on error 
+  */
+{
+  ELog::RegMethod RegA("testSurfHash","testOpposite");
+
+  Geometry::Plane PA(1,0);
+  PA.setPlane(Geometry::Vec3D(1,0,0),5.0);
+  Geometry::Cylinder CA(2,0);
+  CA.setCylinder(Geometry::Vec3D(0,0,0),Geometry::Vec3D(1,0,0),3.0);
+  Geometry::Plane PB(3,0);
+  PB.setPlane(Geometry::Vec3D(0,1,0),5.0);
+
+  std::map<int,Geometry::Surface*> SMap;
+  SMap[1]=&PA;
+  SMap[2]=&CA;
+  SMap[3]=&PB;
+  surfHash SH;
+  SH.build(SMap);
+
+  Geometry::Plane PRev(0,0);
+  PRev.setPlane(Geometry::Vec3D(-1,0,0),-5.0);
+  Geometry::Cylinder CRev(0,0);
+  CRev.setCylinder(Geometry::Vec3D(0,0,0),Geometry::Vec3D(-1,0,0),3.0);
+
+  // Surface : expected candidates
+  typedef boost::tuple<const Geometry::Surface*,int> TTYPE;
+  std::vector<TTYPE> Tests;
+  Tests.push_back(TTYPE(&PRev,1));
+  Tests.push_back(TTYPE(&CRev,2));
+
+  CVEC Out;
+  std::vector<TTYPE>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      if (!SH.findCandidates(tc->get<0>(),Out) ||
+	  nCandidate(Out)!=1 || !hasCandidate(Out,tc->get<1>()))
+	{
+	  ELog::EM<<"Test "<<(tc-Tests.begin())+1<<" : "
+		  <<*tc->get<0>()<<ELog::endDiag;
+	  ELog::EM<<"Candidates == "<<nCandidate(Out)<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  return 0;
+}
+
+int
+testSurfHash::testQuantumEdge()
+  /*!
+    Test planes within hashTol of a bucket edge are 
+    found from the next bucket, and that planes 
+    further away are not candidates
+    \return -ve on error 
+  */
+{
+  ELog::RegMethod RegA("testSurfHash","testQuantumEdge");
+
+  // Distances either side of the 3e-3 bucket edge
+  const double dist[]={3e-3-2e-6,3e-3+2e-6,3e-3+5e-5,3e-3-5e-5};
+  std::vector<Geometry::Plane> PVec;
+  for(size_t i=0;i<4;i++)
+    {
+      PVec.push_back(Geometry::Plane(static_cast<int>(i+1),0));
+      PVec.back().setPlane(Geometry::Vec3D(1,0,0),dist[i]);
+    }
+  
+  // Hashed : query : expect found 
+  typedef boost::tuple<size_t,size_t,int> TTYPE;
+  std::vector<TTYPE> Tests;
+  Tests.push_back(TTYPE(0,1,1));
+  Tests.push_back(TTYPE(1,0,1));
+  Tests.push_back(TTYPE(0,2,0));
+  Tests.push_back(TTYPE(1,3,0));
+
+  CVEC Out;
+  std::vector<TTYPE>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      std::map<int,Geometry::Surface*> SMap;
+      Geometry::Surface* SPtr=&PVec[tc->get<0>()];
+      SMap[SPtr->getName()]=SPtr;
+      surfHash SH;
+      SH.build(SMap);
+      SH.findCandidates(&PVec[tc->get<1>()],Out);
+      if (static_cast<int>(nCandidate(Out))!=tc->get<2>())
+	{
+	  ELog::EM<<"Test "<<(tc-Tests.begin())+1<<" : "
+		  <<dist[tc->get<0>()]<<" "<<dist[tc->get<1>()]
+		  <<ELog::endDiag;
+	  ELog::EM<<"Candidates == "<<nCandidate(Out)<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  return 0;
+}
+
+int
+testSurfHash::testRehash()
+  /*!
+    Test that the index follows surfaces rotated in place
+    by the master rotation
+    \return -ve on error 
+  */
+{
+  ELog::RegMethod RegA("testSurfHash","testRehash");
+
+  surfIndex& SurI=surfIndex::Instance();
+  SurI.reset();
+  SurI.createSurface(61,"px 7");
+
+  masterRotate& MR=masterRotate::Instance();
+  MR.reset();
+  MR.addRotation(Geometry::Vec3D(0,0,1),Geometry::Vec3D(0,0,0),90.0);
+  Geometry::Plane PA(0,0);
+  PA.setPlane(*dynamic_cast<const Geometry::Plane*>(SurI.getSurf(61)));
+  MR.applyFull(&PA);
+
+  CVEC CVec;
+  SurI.equalCandidates(&PA,CVec);
+  const int beforeFlag=hasCandidate(CVec,61);
+
+  Simulation ASim;
+  ASim.masterRotation();
+  MR.reset();
+  MR.clearGlobal();
+
+  SurI.equalCandidates(&PA,CVec);
+  const int afterFlag=hasCandidate(CVec,61);
+  const Geometry::Plane* PPtr=
+    dynamic_cast<const Geometry::Plane*>(SurI.getSurf(61));
+  if (beforeFlag || !afterFlag || !PPtr || !(*PPtr==PA))
+    {
+      ELog::EM<<"Rotated == "<<PA<<ELog::endDiag;
+      ELog::EM<<"Surface == "<<*SurI.getSurf(61)<<ELog::endDiag;
+      ELog::EM<<"Found == "<<beforeFlag<<" "<<afterFlag<<ELog::endDiag;
+      return -1;
+    }
+  return 0;
+}
@@ -54,6 +54,10 @@
 #include "Cylinder.h"
 #include "surfIndex.h"
 #include "surfRegister.h"
+#include "Rules.h"
+#include "HeadRule.h"
+#include "ModelSupport.h"
+#include "RuleBuild.h"
 
 #include "testFunc.h"
 #include "testSurfRegister.h"
@@ -90,6 +94,7 @@ testSurfRegister::applyTest(const int extra)
     {
       &testSurfRegister::testIdentical,
       &testSurfRegister::testPlaneReflection,
+      &testSurfRegister::testRuleBuild,
       &testSurfRegister::testUnique
     };
 
@@ -97,6 +102,7 @@ testSurfRegister::applyTest(const int extra)
     {
       "Identical",
       "PlaneReflection",
+      "RuleBuild",
       "Unique"
     };
 
@@ -174,6 +180,50 @@ testSurfRegister::testIdentical()
   return flag;
 }
 
+int
+testSurfRegister::testRuleBuild()
+  /*!
+    Test that the rule builder gives the same tree 
+    as the getComposite string.
+    \returns 0 on succes and -ve on failure
+  */
+{
+  ELog::RegMethod RegA("testSurfRegister","testRuleBuild");
+
+  surfRegister SMap;
+  SMap.addMatch(105,7);
+  const int offset(100);
+
+  std::vector<RuleBuild> Tests;
+  std::vector<std::string> Comp;
+
+  RuleBuild A(SMap,offset);
+  A.inter(1).inter(-2).unite(3).inter(-5);
+  Tests.push_back(A);
+  Comp.push_back(" 1 -2 : 3 -5 ");
+
+  RuleBuild B(SMap,offset);
+  B.inter(6).unite(-5);
+  RuleBuild C(SMap,offset);
+  C.inter(1).inter(B).interComp(A).interTrue(-8);
+  Tests.push_back(C);
+  Comp.push_back(" 1 (6 : -5) #( 1 -2 : 3 -5 ) -8T ");
+
+  for(size_t i=0;i<Tests.size();i++)
+    {
+      HeadRule HR;
+      HR.procString(ModelSupport::getComposite(SMap,offset,Comp[i]));
+      if (Tests[i].display()!=HR.display())
+	{
+	  ELog::EM<<"Test "<<i+1<<" :"<<Comp[i]<<ELog::endTrace;
+	  ELog::EM<<"Build     == "<<Tests[i].display()<<ELog::endTrace;
+	  ELog::EM<<"Composite == "<<HR.display()<<ELog::endTrace;
+	  return -1;
+	}
+    }
+  return 0;
+}
+
 int
 testSurfRegister::testPlaneReflection()
   /*!
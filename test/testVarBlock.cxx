@@ -27,6 +27,7 @@
 #include <complex>
 #include <list>
 #include <vector>
+#include <set>
 #include <map>
 #include <string>
 #include <boost/tuple/tuple.hpp>
@@ -0,0 +1,553 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   test/testVisit.cxx
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <complex> 
+#include <vector>
+#include <list> 
+#include <map> 
+#include <set>
+#include <string>
+#include <algorithm>
+#include <zlib.h>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/multi_array.hpp>
+
+#include "Exception.h"
+#include "FileReport.h"
+#include "NameStack.h"
+#include "RegMethod.h"
+#include "OutputLog.h"
+#include "BaseVisit.h"
+#include "BaseModVisit.h"
+#include "support.h"
+#include "MatrixBase.h"
+#include "Matrix.h"
+#include "Vec3D.h"
+#include "Triple.h"
+#include "NRange.h"
+#include "NList.h"
+#include "Surface.h"
+#include "surfIndex.h"
+#include "Rules.h"
+#include "varList.h"
+#include "Code.h"
+#include "FuncDataBase.h"
+#include "HeadRule.h"
+#include "Object.h"
+#include "Qhull.h"
+#include "KGroup.h"
+#include "Source.h"
+#include "surfRegister.h"
+#include "ModelSupport.h"
+#include "Simulation.h"
+#include "Visit.h"
+
+#include "testFunc.h"
+#include "testVisit.h"
+
+testVisit::testVisit() 
+  /*!
+    Constructor
+  */
+{
+  initSim();
+}
+
+testVisit::~testVisit() 
+  /*!
+    Destructor
+  */
+{}
+
+void
+testVisit::initSim()
+  /*!
+    Set all the objects in the simulation:
+  */
+{
+  ASim.resetAll();
+  createSurfaces();
+  createObjects();
+  ASim.createObjSurfMap();
+  return;
+}
+
+void 
+testVisit::createSurfaces()
+  /*!
+    Create the surface list
+   */
+{
+  ELog::RegMethod RegA("testVisit","createSurfaces");
+
+  ModelSupport::surfIndex& SurI=ModelSupport::surfIndex::Instance();
+  
+  // First box :
+  SurI.createSurface(1,"px -1");
+  SurI.createSurface(2,"px 1");
+  SurI.createSurface(3,"py -1");
+  SurI.createSurface(4,"py 1");
+  SurI.createSurface(5,"pz -1");
+  SurI.createSurface(6,"pz 1");
+
+  // Second box :
+  SurI.createSurface(11,"px -3");
+  SurI.createSurface(12,"px 3");
+  SurI.createSurface(13,"py -3");
+  SurI.createSurface(14,"py 3");
+  SurI.createSurface(15,"pz -3");
+  SurI.createSurface(16,"pz 3");
+
+  // Far box :
+  SurI.createSurface(21,"px 10");
+  SurI.createSurface(22,"px 15");
+
+  // Sphere :
+  SurI.createSurface(100,"so 25");
+  
+  return;
+}
+  
+void
+testVisit::createObjects()
+  /*!
+    Create Object for test
+   */
+{
+  std::string Out;
+  int cellIndex(1);
+  const int surIndex(0);
+  Out=ModelSupport::getComposite(surIndex,"100");
+  ASim.addCell(MonteCarlo::Qhull(cellIndex++,0,0.0,Out));      // Outside void Void
+
+  Out=ModelSupport::getComposite(surIndex,"1 -2 3 -4 5 -6");
+  ASim.addCell(MonteCarlo::Qhull(cellIndex++,3,0.0,Out));      // steel object
+
+  Out=ModelSupport::getComposite(surIndex,"11 -12 13 -14 15 -16"
+				 " (-1:2:-3:4:-5:6) ");
+  ASim.addCell(MonteCarlo::Qhull(cellIndex++,5,0.0,Out));      // Al container
+
+  Out=ModelSupport::getComposite(surIndex,"21 -22 3 -4 5 -6");
+  ASim.addCell(MonteCarlo::Qhull(cellIndex++,8,0.0,Out));      // Gd box 
+
+  Out=ModelSupport::getComposite(surIndex,"-100 (-11:12:-13:14:-15:16)"
+				 " #4");
+  ASim.addCell(MonteCarlo::Qhull(cellIndex++,0,0.0,Out));      // Void
+  
+  ASim.removeComplements();
+  return;
+}
+  
+std::string
+testVisit::readFile(const std::string& FName)
+  /*!
+    Read a file as bytes and remove it
+    \param FName :: File name
+    \return file contents
+  */
+{
+  std::ifstream IX(FName.c_str(),std::ios::in | std::ios::binary);
+  std::ostringstream cx;
+  cx<<IX.rdbuf();
+  IX.close();
+  std::remove(FName.c_str());
+  return cx.str();
+}
+
+void
+testVisit::addBigEndian(std::string& Out,const char* V)
+  /*!
+    Append a 4 byte native value as big-endian
+    \param Out :: String to add to
+    \param V :: Value bytes
+  */
+{
+  const boost::uint32_t testValue(1);
+  char cTest[4];
+  memcpy(cTest,&testValue,4);
+  for(size_t b=0;b<4;b++)
+    Out+=(cTest[0]) ? V[3-b] : V[b];
+  return;
+}
+
+int 
+testVisit::applyTest(const int extra)
+  /*!
+    Applies all the tests and returns 
+    the error number
+    \param extra :: Test number to run
+    \retval -1 : SetObject 
+    \retval 0 : All succeeded
+  */
+{
+  ELog::RegMethod RegA("testVisit","applyTest");
+  TestFunc::regSector("testVisit");
+
+  typedef int (testVisit::*testPtr)();
+  testPtr TPtr[]=
+    {
+      &testVisit::testOctree,
+      &testVisit::testTrackRow,
+      &testVisit::testWriteVTI,
+      &testVisit::testWriteVTKBinary
+    };
+  const std::string TestName[]=
+    {
+      "Octree",
+      "TrackRow",
+      "WriteVTI",
+      "WriteVTKBinary"
+    };
+  
+  const int TSize(sizeof(TPtr)/sizeof(testPtr));
+  if (!extra)
+    {
+      std::ios::fmtflags flagIO=std::cout.setf(std::ios::left);
+      for(int i=0;i<TSize;i++)
+        {
+	  std::cout<<std::setw(30)<<TestName[i]<<"("<<i+1<<")"<<std::endl;
+	}
+      std::cout.flags(flagIO);
+      return 0;
+    }
+  for(int i=0;i<TSize;i++)
+    {
+      if (extra<0 || extra==i+1)
+        {
+	  TestFunc::regTest(TestName[i]);
+	  const int retValue= (this->*TPtr[i])();
+	  if (retValue || extra>0)
+	    return retValue;
+	}
+    }
+  return 0;
+}
+
+int
+testVisit::testOctree()
+  /*!
+    Test the octree leaf split and merge on a single voxel.
+    A voxel in one cell stays one leaf. A voxel cut by
+    the plane at x=1 splits down to the depth limit.
+    \return 0 on success and -ve on error
+  */
+{
+  ELog::RegMethod RegA("testVisit","testOctree");
+
+  // Box : depth : leaves
+  typedef boost::tuple<Geometry::Vec3D,size_t,size_t> TTYPE;
+  std::vector<TTYPE> Tests;
+  Tests.push_back(TTYPE(Geometry::Vec3D(-0.5,-0.5,-0.5),3,1));
+  Tests.push_back(TTYPE(Geometry::Vec3D(0.6,-0.5,-0.5),1,8));
+  Tests.push_back(TTYPE(Geometry::Vec3D(0.6,-0.5,-0.5),2,36));
+  Tests.push_back(TTYPE(Geometry::Vec3D(0.6,-0.5,-0.5),3,148));
+
+  std::vector<TTYPE>::const_iterator tc;
+  for(tc=Tests.begin();tc!=Tests.end();tc++)
+    {
+      Visit VT;
+      VT.setType(Visit::cellID);
+      VT.setOctree(tc->get<1>());
+      VT.setBox(tc->get<0>(),tc->get<0>()+Geometry::Vec3D(1,1,1));
+      VT.setIndex(1,1,1);
+      VT.populate(&ASim);
+      if (VT.nLeaves()!=tc->get<2>())
+	{
+	  ELog::EM<<"Test "<<(tc-Tests.begin())+1<<" leaves == "
+		  <<VT.nLeaves()<<" ("<<tc->get<2>()<<")"<<ELog::endDiag;
+	  return -1;
+	}
+      // No uniform mesh is kept in octree mode
+      if (VT.getMesh().num_elements())
+	{
+	  ELog::EM<<"Test "<<(tc-Tests.begin())+1<<" mesh size == "
+		  <<VT.getMesh().num_elements()<<ELog::endDiag;
+	  return -3;
+	}
+    }
+
+  // Depth limit
+  Visit VT;
+  VT.setOctree(20);
+  try
+    {
+      VT.setOctree(21);
+    }
+  catch (ColErr::RangeError<size_t>&)
+    {
+      return 0;
+    }
+  ELog::EM<<"Octree depth 21 accepted"<<ELog::endDiag;
+  return -2;
+}
+
+int
+testVisit::testTrackRow()
+  /*!
+    Test that the line tracking fill gives the same mesh
+    as a point test of each voxel. The mesh points avoid
+    the surfaces and the rows cross all the cells.
+    \return 0 on success and -ve on error
+  */
+{
+  ELog::RegMethod RegA("testVisit","testTrackRow");
+
+  // Rows on x / reversed x / z 
+  const Geometry::Vec3D APt[]={Geometry::Vec3D(-4.95,-3.95,-3.95),
+			       Geometry::Vec3D(15.55,4.05,4.05),
+			       Geometry::Vec3D(-4.95,-3.95,-4.95)};
+  const Geometry::Vec3D BPt[]={Geometry::Vec3D(15.55,4.05,4.05),
+			       Geometry::Vec3D(-4.95,-3.95,-3.95),
+			       Geometry::Vec3D(15.55,4.05,15.55)};
+  const size_t nX[]={41,41,8};
+  const size_t nY[]={16,16,4};
+  const size_t nZ[]={16,16,41};
+  for(size_t index=0;index<3;index++)
+    {
+      Visit VPoint;
+      VPoint.setType(Visit::cellID);
+      VPoint.setBox(APt[index],BPt[index]);
+      VPoint.setIndex(nX[index],nY[index],nZ[index]);
+      VPoint.populate(&ASim);
+
+      Visit VLine;
+      VLine.setType(Visit::cellID);
+      VLine.setLineTrack(1);
+      VLine.setBox(APt[index],BPt[index]);
+      VLine.setIndex(nX[index],nY[index],nZ[index]);
+      VLine.populate(&ASim);
+
+      const boost::multi_array<double,3>& MA=VPoint.getMesh();
+      const boost::multi_array<double,3>& MB=VLine.getMesh();
+      std::set<int> CellSet;
+      for(size_t i=0;i<=nX[index];i++)
+	for(size_t j=0;j<=nY[index];j++)
+	  for(size_t k=0;k<=nZ[index];k++)
+	    {
+	      CellSet.insert(static_cast<int>(MA[i][j][k]));
+	      if (MA[i][j][k]!=MB[i][j][k])
+		{
+		  ELog::EM<<"Mesh "<<index<<" at "<<i<<" "<<j<<" "<<k
+			  <<" :: "<<MA[i][j][k]<<" "<<MB[i][j][k]
+			  <<ELog::endDiag;
+		  return -1;
+		}
+	    }
+      // Rows must cross cells 2,3,4,5 
+      if (CellSet.size()!=4)
+	{
+	  ELog::EM<<"Mesh "<<index<<" cells == "<<CellSet.size()
+		  <<ELog::endDiag;
+	  return -2;
+	}
+    }
+  return 0;
+}
+
+int
+testVisit::testWriteVTKBinary()
+  /*!
+    Test the bytes of a binary legacy VTK file of a 
+    2x2x2 mesh [cells 2 and 3 on x]
+    \return 0 on success and -ve on error
+  */
+{
+  ELog::RegMethod RegA("testVisit","testWriteVTKBinary");
+
+  Visit VT;
+  VT.setType(Visit::cellID);
+  VT.setBox(Geometry::Vec3D(-0.5,-0.5,-0.5),Geometry::Vec3D(1.5,0.5,0.5));
+  VT.setIndex(1,1,1);
+  VT.populate(&ASim);
+  VT.writeVTKBinary("testVisit.vtk");
+  const std::string Data=readFile("testVisit.vtk");
+
+  std::string Expect("# vtk DataFile Version 2.0\n"
+		     "chipIR Data\n"
+		     "BINARY\n"
+		     "DATASET RECTILINEAR_GRID\n"
+		     "DIMENSIONS 2 2 2\n");
+  const char* axisName[3]={"X","Y","Z"};
+  const float coord[3][2]={{-0.5f,1.5f},{-0.5f,0.5f},{-0.5f,0.5f}};
+  for(size_t i=0;i<3;i++)
+    {
+      Expect+=std::string(axisName[i])+"_COORDINATES 2 float\n";
+      for(size_t j=0;j<2;j++)
+	addBigEndian(Expect,reinterpret_cast<const char*>(&coord[i][j]));
+      Expect+="\n";
+    }
+  Expect+="POINT_DATA 8\n"
+    "SCALARS cellID int 1\n"
+    "LOOKUP_TABLE default\n";
+  // x fastest 
+  for(size_t i=0;i<8;i++)
+    {
+      const boost::int32_t IV((i % 2) ? 3 : 2);
+      addBigEndian(Expect,reinterpret_cast<const char*>(&IV));
+    }
+  Expect+="\n";
+
+  if (Data!=Expect)
+    {
+      ELog::EM<<"Size "<<Data.size()<<" "<<Expect.size()<<ELog::endDiag;
+      for(size_t i=0;i<Data.size() && i<Expect.size();i++)
+	if (Data[i]!=Expect[i])
+	  {
+	    ELog::EM<<"First difference at byte "<<i<<ELog::endDiag;
+	    break;
+	  }
+      return -1;
+    }
+  return 0;
+}
+
+int
+testVisit::testWriteVTI()
+  /*!
+    Test the appended data of a raw and a compressed VTI file
+    of a 2x2x2 mesh. The box is given both ways round
+    and the reversed axes must give the same file.
+    \return 0 on success and -ve on error
+  */
+{
+  ELog::RegMethod RegA("testVisit","testWriteVTI");
+
+  const Geometry::Vec3D APt(-0.5,-0.5,-0.5);
+  const Geometry::Vec3D BPt(1.5,0.5,0.5);
+
+  // Native int32 slab values [x fastest] 
+  std::string Slab;
+  for(size_t i=0;i<4;i++)
+    {
+      const boost::int32_t IV((i % 2) ? 3 : 2);
+      Slab+=std::string(reinterpret_cast<const char*>(&IV),4);
+    }
+  const std::string appendTag("<AppendedData encoding=\"raw\">\n_");
+  const std::string endTag("\n  </AppendedData>\n</VTKFile>\n");
+
+  std::string RawFile;
+  for(size_t index=0;index<4;index++)
+    {
+      const int compFlag(static_cast<int>(index/2));
+      Visit VT;
+      VT.setType(Visit::cellID);
+      if (index % 2)
+	VT.setBox(BPt,APt);
+      else
+	VT.setBox(APt,BPt);
+      VT.setIndex(1,1,1);
+      VT.populate(&ASim);
+      VT.writeVTI("testVisit.vti",compFlag);
+      const std::string Data=readFile("testVisit.vti");
+
+      if (Data.find("header_type=\"UInt64\"")==std::string::npos ||
+	  Data.find("WholeExtent=\"0 1 0 1 0 1\"")==std::string::npos ||
+	  Data.find("Origin=\"-0.5 -0.5 -0.5\"")==std::string::npos ||
+	  Data.find("Spacing=\"2 1 1\"")==std::string::npos ||
+	  Data.find("type=\"Int32\" Name=\"cellID\"")==std::string::npos ||
+	  (compFlag && Data.find("vtkZLibDataCompressor")==std::string::npos))
+	{
+	  ELog::EM<<"Header "<<index<<" == "<<
+	    Data.substr(0,Data.find(appendTag))<<ELog::endDiag;
+	  return -1;
+	}
+
+      const size_t aPos=Data.find(appendTag);
+      if (aPos==std::string::npos ||
+	  Data.size()<aPos+appendTag.size()+endTag.size() ||
+	  Data.substr(Data.size()-endTag.size())!=endTag)
+	{
+	  ELog::EM<<"Appended block "<<index<<" not found"<<ELog::endDiag;
+	  return -2;
+	}
+      const std::string Block=
+	Data.substr(aPos+appendTag.size(),
+		    Data.size()-(aPos+appendTag.size()+endTag.size()));
+
+      // Reversed box must give the same file
+      if (!(index % 2))
+	RawFile=Data;
+      else if (Data!=RawFile)
+	{
+	  ELog::EM<<"Reversed box differs "<<index<<ELog::endDiag;
+	  return -3;
+	}
+
+      std::vector<boost::uint64_t> Header;
+      if (!compFlag)
+	{
+	  // size / data
+	  boost::uint64_t nByte;
+	  memcpy(&nByte,Block.c_str(),8);
+	  if (Block.size()!=40 || nByte!=32 ||
+	      Block.substr(8)!=Slab+Slab)
+	    {
+	      ELog::EM<<"Raw block == "<<Block.size()<<" "
+		      <<nByte<<ELog::endDiag;
+	      return -4;
+	    }
+	}
+      else
+	{
+	  // nBlock / block size / last size / compressed sizes / data
+	  boost::uint64_t Head[5];
+	  if (Block.size()<40)
+	    return -5;
+	  memcpy(Head,Block.c_str(),40);
+	  if (Head[0]!=2 || Head[1]!=16 || Head[2]!=0 ||
+	      Block.size()!=40+Head[3]+Head[4])
+	    {
+	      ELog::EM<<"Compressed header == "<<Head[0]<<" "<<Head[1]
+		      <<" "<<Head[2]<<" "<<Head[3]<<" "<<Head[4]
+		      <<" : "<<Block.size()<<ELog::endDiag;
+	      return -6;
+	    }
+	  size_t offset(40);
+	  for(size_t i=0;i<2;i++)
+	    {
+	      char Out[32];
+	      uLongf outSize(32);
+	      const int flag=uncompress
+		(reinterpret_cast<Bytef*>(Out),&outSize,
+		 reinterpret_cast<const Bytef*>(Block.c_str()+offset),
+		 static_cast<uLong>(Head[3+i]));
+	      if (flag!=Z_OK || outSize!=16 ||
+		  std::string(Out,16)!=Slab)
+		{
+		  ELog::EM<<"Compressed slab "<<i<<" == "<<flag
+			  <<" "<<outSize<<ELog::endDiag;
+		  return -7;
+		}
+	      offset+=static_cast<size_t>(Head[3+i]);
+	    }
+	}
+    }
+  return 0;
+}
@@ -40,6 +40,7 @@
 #include <boost/array.hpp>
 
 #include "Exception.h"
+#include "MersenneTwister.h"
 #include "FileReport.h"
 #include "GTKreport.h"
 #include "NameStack.h"
@@ -105,6 +106,8 @@
 #include "testFunc.h"
 #include "testVolumes.h"
 
+extern MTRand RNG;
+
 using namespace ModelSupport;
 
 testVolumes::testVolumes() 
@@ -239,11 +242,13 @@ testVolumes::applyTest(const int extra)
   typedef int (testVolumes::*testPtr)();
   testPtr TPtr[]=
     {
+      &testVolumes::testPointThreads,
       &testVolumes::testPointVolume,
       &testVolumes::testVolume
     };
   const std::string TestName[]=
     {
+      "PointThreads",
       "PointVolume",
       "Volume"
     };
@@ -347,3 +352,59 @@ testVolumes::testPointVolume()
   return 0;
 }
 
+
+int
+testVolumes::testPointThreads()
+  /*!
+    Test that the threaded point volume calculation gives
+    the same result for any number of threads and that
+    the serial run draws its points from RNG in order
+    \return 0 on success and -ve on error
+  */
+{
+  ELog::RegMethod RegA("testVolumes","testPointThreads");
+
+  // sphere of radius 6.0
+  const double VSphere(4.0*M_PI*216.0/3.0);
+  const size_t nThreads[]={1,2,3,4};
+  std::vector<double> VA;
+  std::vector<double> VB;
+  std::vector<double> RVal;
+  for(size_t i=0;i<4;i++)
+    {
+      RNG.seed(12345UL);
+      VolSum VTally(Geometry::Vec3D(0,0,0),8.0);
+      VTally.addTallyCell(4,2);
+      VTally.addTallyCell(5,3);
+      VTally.setThreads(nThreads[i]);
+      VTally.pointRun(ASim,20000);
+      VA.push_back(VTally.calcVolume(4));
+      VB.push_back(VTally.calcVolume(5));
+      RVal.push_back(RNG.rand());
+      if (std::abs(VA[i]-VSphere)>0.05*VSphere)
+	{
+	  ELog::EM<<"Threads "<<nThreads[i]<<" : Volume == "
+		  <<VA[i]<<" ("<<VSphere<<")"<<ELog::endDiag;
+	  return -1;
+	}
+    }
+  for(size_t i=2;i<4;i++)
+    if (VA[i]!=VA[1] || VB[i]!=VB[1])
+      {
+	ELog::EM<<"Threads "<<nThreads[i]<<" == "<<VA[i]<<" "
+		<<VB[i]<<ELog::endDiag;
+	ELog::EM<<"Threads 2 == "<<VA[1]<<" "<<VB[1]<<ELog::endDiag;
+	return -2;
+      }
+
+  // Serial run keeps the old sequence : three draws per point
+  RNG.seed(12345UL);
+  for(size_t i=0;i<60000;i++)
+    RNG.rand();
+  if (std::abs(RVal[0]-RNG.rand())>1e-12)
+    {
+      ELog::EM<<"Serial run did not use 3 draws per point"<<ELog::endDiag;
+      return -3;
+    }
+  return 0;
+}
@@ -42,6 +42,7 @@ private:
   //Tests 
   int testIntersection();
   int testInterDistance();
+  int testScratch();
  
 public:
 
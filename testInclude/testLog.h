@@ -22,6 +22,13 @@
 #ifndef testLog_h
 #define testLog_h 
 
+namespace ELog
+{
+  class StreamReport;
+  struct ThreadHold;
+  template<typename RepClass> class OutputLog;
+}
+
 /*!
   \class testLog
   \brief Tests the OutputLog class
@@ -35,9 +42,16 @@ class testLog
 {
 private:
 
+  static void holdMessages(ELog::OutputLog<ELog::StreamReport>&,
+			   ELog::ThreadHold*,const int);
 
   //Tests 
   int testENDL();
+  int testMethodProfile();
+  int testNameStack();
+  int testNameStackDepth();
+  int testRegMethod();
+  int testThreadHold();
  
 public:
 
@@ -38,7 +38,9 @@ class testObjSurfMap
 
   void createSurfaces();
   //Tests 
+  int testGraph();
   int testMap();
+  int testUpdate();
 
  
  public:
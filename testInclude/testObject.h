@@ -46,6 +46,7 @@ private:
   void createSurfaces();
 
   //Tests 
+  int testBoundBox();
   int testSetObject();
   int testCellStr();
   int testComplement();
@@ -54,6 +55,9 @@ private:
   int testIsOnSide();
   int testMakeComplement();
   int testRemoveComplement();
+  int testRuleBDD();
+  int testSenseCache();
+  int testTrackCache();
   int testTrackCell();
 
 public:
@@ -38,6 +38,7 @@ class testRules
 private:
 
   void createSurfaces();
+  void createTrackSurfaces();
 
   //Tests 
   int testCreateDNF();
@@ -45,8 +46,12 @@ private:
   int testHeadRule();
   int testIsValid();
   int testMakeCNF();
+  int testProcString();
   int testRemoveComplement();
   int testRuleBinary();
+  int testRuleCode();
+  int testTrackPair();
+  int testTrackStale();
  
 public:
 
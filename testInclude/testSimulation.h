@@ -43,9 +43,13 @@ private:
   void createObjects();
 
   //Tests 
+  int testBVH();
+  int testCellThreads();
   int testCreateObjSurfMap();
   int testInCell();
+  int testSurfaceChange();
   int testTrackNeutron();
+  int testValidThreads();
 
 public:
   
@@ -0,0 +1,60 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   testInclude/testSurfHash.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#ifndef testSurfHash_h
+#define testSurfHash_h 
+
+/*!
+  \class testSurfHash
+  \brief Tests the surfHash class
+  \author S. Ansell
+  \date December 2013
+  \version 1.0
+  
+  Test of the bucket index for equal surfaces
+*/
+
+class testSurfHash 
+{
+ private:
+  
+  /// Candidate sets
+  typedef std::vector<const std::map<int,Geometry::Surface*>*> CVEC;
+
+  static int hasCandidate(const CVEC&,const int);
+  static size_t nCandidate(const CVEC&);
+
+  //Tests 
+  int testLoose();
+  int testMoved();
+  int testOpposite();
+  int testQuantumEdge();
+  int testRehash();
+ 
+ public:
+
+  testSurfHash();
+  ~testSurfHash();
+
+  int applyTest(const int);     
+};
+
+#endif
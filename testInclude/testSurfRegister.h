@@ -40,6 +40,7 @@ class testSurfRegister
   //Tests 
   int testIdentical();
   int testPlaneReflection();
+  int testRuleBuild();
   int testUnique();
  
  public:
@@ -0,0 +1,62 @@
+/********************************************************************* 
+  CombLayer : MNCPX Input builder
+ 
+ * File:   testInclude/testVisit.h
+*
+ * Copyright (c) 2004-2013 by Stuart Ansell
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ ****************************************************************************/
+#ifndef testVisit_h
+#define testVisit_h 
+
+/*!
+  \class testVisit
+  \brief Tests the VTK mesh output
+  \author S. Ansell
+  \date December 2013
+  \version 1.0
+
+  Test the mesh population and the file writers
+*/
+
+class testVisit
+{
+private:
+  
+  Simulation ASim;       ///< Simulation to build tests in
+
+  void initSim();
+  void createSurfaces();
+  void createObjects();
+  static std::string readFile(const std::string&);
+  static void addBigEndian(std::string&,const char*);
+
+  //Tests 
+  int testOctree();
+  int testTrackRow();
+  int testWriteVTKBinary();
+  int testWriteVTI();
+
+public:
+  
+  testVisit();
+  ~testVisit();
+  
+  int applyTest(const int);       
+
+};
+
+#endif
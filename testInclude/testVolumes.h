@@ -43,6 +43,7 @@ private:
   void createObjects();
 
   //Tests 
+  int testPointThreads();
   int testPointVolume();
   int testVolume();
 
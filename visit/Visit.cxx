@@ -30,6 +30,10 @@
 #include <map>
 #include <set>
 #include <vector>
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+#include <boost/cstdint.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/format.hpp>
 #include <boost/multi_array.hpp>
@@ -59,6 +63,9 @@
 #include "HeadRule.h"
 #include "Object.h"
 #include "Qhull.h"
+#include "neutron.h"
+#include "ObjSurfMap.h"
+#include "SenseCache.h"
 #include "KGroup.h"
 #include "Source.h"
 #include "SimProcess.h"
@@ -66,15 +73,18 @@
 #include "Simulation.h"
 #include "Visit.h"
 
+const size_t Visit::maxOctDepth(20);
+
 Visit::Visit() :
-  nPts(0,0,0)
+  lineTrack(0),octDepth(0),nPts(0,0,0)
   /*!
     Constructor
   */
 {}
 
 Visit::Visit(const Visit& A) : 
-  Origin(A.Origin),XYZ(A.XYZ),nPts(A.nPts),mesh(A.mesh)
+  lineTrack(A.lineTrack),octDepth(A.octDepth),Origin(A.Origin),
+  XYZ(A.XYZ),nPts(A.nPts),mesh(A.mesh),Leaves(A.Leaves)
   /*!
     Copy constructor
     \param A :: Visit to copy
@@ -91,10 +101,13 @@ Visit::operator=(const Visit& A)
 {
   if (this!=&A)
     {
+      lineTrack=A.lineTrack;
+      octDepth=A.octDepth;
       Origin=A.Origin;
       XYZ=A.XYZ;
       nPts=A.nPts;
       mesh=A.mesh;
+      Leaves=A.Leaves;
     }
   return *this;
 }
@@ -123,7 +136,7 @@ void
 Visit::setIndex(const size_t A,const size_t B,const size_t C)
   /*!
     Set the index values , checks to ensure that 
-    they are greater than zero
+    they are greater than zero. The mesh is sized in populate.
     \param A :: Xcoordinate division
     \param B :: Ycoordinate division
     \param C :: Zcoordinate division
@@ -132,7 +145,20 @@ Visit::setIndex(const size_t A,const size_t B,const size_t C)
   nPts=Triple<long int>(static_cast<long int>(A)+1,
 			static_cast<long int>(B)+1,
 			static_cast<long int>(C)+1);
-  mesh.resize(boost::extents[nPts[0]][nPts[1]][nPts[2]]);
+  return;
+}
+
+void
+Visit::setOctree(const size_t D)
+  /*!
+    Set the max octree levels. The finest lattice has
+    2^(D+1) units per mesh step so the depth is limited.
+    \param D :: Depth [0 for a uniform mesh]
+  */
+{
+  if (D>maxOctDepth)
+    throw ColErr::RangeError<size_t>(D,0,maxOctDepth,"Visit::setOctree");
+  octDepth=D;
   return;
 }
 
@@ -171,6 +197,40 @@ Visit::getResult(const MonteCarlo::Object* ObjPtr) const
   return 0.0;
 }
 
+std::set<int>
+Visit::activeID(const std::set<std::string>& Active)
+  /*!
+    Convert the active names to component ids
+    \param Active :: Active set
+    \return set of registered component ids
+   */
+{
+  const ModelSupport::objectRegister& OR=
+    ModelSupport::objectRegister::Instance();
+
+  std::set<int> Out;
+  std::set<std::string>::const_iterator sc;
+  for(sc=Active.begin();sc!=Active.end();sc++)
+    {
+      const int compID=OR.getRegionID(*sc);
+      if (compID>=0)
+	Out.insert(compID);
+    }
+  return Out;
+}
+
+double
+Visit::stepSize(const size_t index) const
+  /*!
+    Distance between mesh points on an axis
+    \param index :: Axis [0-2]
+    \return step [full extent for a single point]
+  */
+{
+  return (nPts[index]>1) ? 
+    XYZ[index]/static_cast<double>(nPts[index]-1) : XYZ[index];
+}
+
 void
 Visit::populate(const Simulation* SimPtr,
 		const std::set<std::string>& Active)
@@ -181,6 +241,20 @@ Visit::populate(const Simulation* SimPtr,
    */
 {
   ELog::RegMethod RegA("Visit","populate");
+
+  if (octDepth)
+    {
+      // Octree results are in Leaves only
+      mesh.resize(boost::extents[0][0][0]);
+      populateOctree(SimPtr,Active);
+      return;
+    }
+  mesh.resize(boost::extents[nPts[0]][nPts[1]][nPts[2]]);
+  if (lineTrack)
+    {
+      populateLine(SimPtr,Active);
+      return;
+    }
   MonteCarlo::Object* ObjPtr(0);
   Geometry::Vec3D aVec;
 
@@ -188,27 +262,28 @@ Visit::populate(const Simulation* SimPtr,
     ModelSupport::objectRegister::Instance();
   
   const bool aEmptyFlag=Active.empty();
+  const std::set<int> ActiveID=activeID(Active);
 
   double stepXYZ[3];
   for(size_t i=0;i<3;i++)
-    stepXYZ[i]=(nPts[i]>1) ? XYZ[i]/(nPts[i]-1.0) : XYZ[i];
+    stepXYZ[i]=stepSize(i);
 
   for(long int i=0;i<nPts[0];i++)
     {
-      aVec[0]=stepXYZ[0]*i;
+      aVec[0]=stepXYZ[0]*static_cast<double>(i);
       for(long int j=0;j<nPts[1];j++)
         {
-	  aVec[1]=stepXYZ[1]*j;
+	  aVec[1]=stepXYZ[1]*static_cast<double>(j);
 	  for(long int k=0;k<nPts[2];k++)
 	    {
-	      aVec[2]=stepXYZ[2]*k;
+	      aVec[2]=stepXYZ[2]*static_cast<double>(k);
 	      const Geometry::Vec3D Pt=Origin+aVec;
 	      ObjPtr=SimPtr->findCell(Pt,ObjPtr);
 	      // Active Set Code:
 	      if (!aEmptyFlag)
 		{
-		  const std::string rangeStr=OR.inRange(ObjPtr->getName());
-		  if (Active.find(rangeStr)!=Active.end())
+		  const int rangeID=OR.inRangeID(ObjPtr->getName());
+		  if (ActiveID.find(rangeID)!=ActiveID.end())
 		    mesh[i][j][k]=getResult(ObjPtr);
 		  else
 		    mesh[i][j][k]=0.0;
@@ -222,6 +297,268 @@ Visit::populate(const Simulation* SimPtr,
   return;
 }
 
+void
+Visit::trackRow(const Simulation& System,
+		const Geometry::Vec3D& StartPt,
+		const Geometry::Vec3D& UVec,
+		const double step,
+		MonteCarlo::Object* initObj,
+		std::vector<MonteCarlo::Object*>& Row) const
+  /*!
+    Fill a row of voxels by tracking a line through the
+    model. Voxels between two boundary crossings take the
+    cell of the track. Voxels on a crossing, and the rest
+    of the row if no exit is found, use findCell.
+    \param System :: Simulation
+    \param StartPt :: First voxel point
+    \param UVec :: Unit vector along the row
+    \param step :: Distance between voxels
+    \param initObj :: Guess for the first cell
+    \param Row :: Cells of the voxels [sized]
+  */
+{
+  const ModelSupport::ObjSurfMap* OSMPtr=System.getOSM();
+  const size_t NRow(Row.size());
+
+  MonteCarlo::Object* OPtr=System.findCell(StartPt,initObj);
+  Row[0]=OPtr;
+  size_t index(1);
+
+  Geometry::SenseCache SC;
+  MonteCarlo::neutron TNeut(1,StartPt,UVec);
+  const Geometry::Surface* SPtr;
+  double aDist;
+  double trackDist(0.0);
+  int SN(0);
+  while(OPtr && index<NRow)
+    {
+      // Note: Need OPPOSITE Sign on exiting surface
+      SN= -OPtr->trackOutCell(TNeut,aDist,SPtr,-SN);
+      if (!SN) break;
+      trackDist+=aDist;
+      for(;index<NRow && 
+	    step*static_cast<double>(index)<trackDist-Geometry::zeroTol;
+	  index++)
+	Row[index]=OPtr;
+      for(;index<NRow && 
+	    step*static_cast<double>(index)<=trackDist+Geometry::zeroTol;
+	  index++)
+	Row[index]=System.findCell(StartPt+UVec*
+				   (step*static_cast<double>(index)),
+				   Row[index-1]);
+	
+      TNeut.moveForward(aDist);
+      OPtr=OSMPtr->findNextObject(SN,TNeut.Pos,OPtr->getName(),SC);
+    }
+  // No exit / failed track : test each point
+  for(;index<NRow;index++)
+    Row[index]=System.findCell(StartPt+UVec*
+			       (step*static_cast<double>(index)),
+			       Row[index-1]);
+  return;
+}
+
+void
+Visit::populateLine(const Simulation* SimPtr,
+		    const std::set<std::string>& Active)
+  /*!
+    Population by tracking a line along each row of
+    the mesh [on the axis with most points]. The cost
+    is by boundary crossing rather than by voxel.
+    \param SimPtr :: Simulation system
+    \param Active :: Active set
+   */
+{
+  ELog::RegMethod RegA("Visit","populateLine");
+
+  if (nPts[0]<1 || nPts[1]<1 || nPts[2]<1) return;
+  const ModelSupport::objectRegister& OR=
+    ModelSupport::objectRegister::Instance();
+  const bool aEmptyFlag=Active.empty();
+  const std::set<int> ActiveID=activeID(Active);
+
+  double stepXYZ[3];
+  for(size_t i=0;i<3;i++)
+    stepXYZ[i]=stepSize(i);
+
+  // Row axis / other axis
+  size_t axis(2);
+  for(size_t i=0;i<2;i++)
+    if (nPts[i]>nPts[axis])
+      axis=i;
+  const size_t aA((axis+1) % 3);
+  const size_t aB((axis+2) % 3);
+
+  Geometry::Vec3D UVec;
+  UVec[axis]=(stepXYZ[axis]<0.0) ? -1.0 : 1.0;
+  const double step(std::abs(stepXYZ[axis]));
+
+  std::vector<MonteCarlo::Object*> Row(static_cast<size_t>(nPts[axis]));
+  MonteCarlo::Object* ObjPtr(0);
+  long int index[3];
+  Geometry::Vec3D aVec;
+  for(index[aA]=0;index[aA]<nPts[aA];index[aA]++)
+    {
+      aVec[aA]=stepXYZ[aA]*static_cast<double>(index[aA]);
+      for(index[aB]=0;index[aB]<nPts[aB];index[aB]++)
+	{
+	  aVec[aB]=stepXYZ[aB]*static_cast<double>(index[aB]);
+	  trackRow(*SimPtr,Origin+aVec,UVec,step,ObjPtr,Row);
+	  ObjPtr=Row.back();
+
+	  const MonteCarlo::Object* prevPtr(0);
+	  double value(0.0);
+	  for(index[axis]=0;index[axis]<nPts[axis];index[axis]++)
+	    {
+	      const MonteCarlo::Object* OPtr=
+		Row[static_cast<size_t>(index[axis])];
+	      if (OPtr!=prevPtr || !index[axis])
+		{
+		  value=getResult(OPtr);
+		  // Active Set Code:
+		  if (!aEmptyFlag && OPtr &&
+		      ActiveID.find(OR.inRangeID(OPtr->getName()))==
+		      ActiveID.end())
+		    value=0.0;
+		  prevPtr=OPtr;
+		}
+	      mesh[index[0]][index[1]][index[2]]=value;
+	    }
+	}
+    }
+  return;
+}
+
+Geometry::Vec3D
+Visit::octPoint(const Triple<long int>& LPt) const
+  /*!
+    Convert a point on the finest octree lattice to a position.
+    The lattice starts at the low corner of the box and has
+    2^(octDepth+1) units per mesh step, so the centre of the
+    smallest leaf is still a lattice point.
+    \param LPt :: Lattice point
+    \return Position
+  */
+{
+  const double scale=static_cast<double>(1L << (octDepth+1));
+  Geometry::Vec3D Pt;
+  for(size_t i=0;i<3;i++)
+    {
+      const double low=(XYZ[i]<0.0) ? Origin[i]+XYZ[i] : Origin[i];
+      const double unit=(nPts[i]>1) ? 
+	fabs(XYZ[i])/(static_cast<double>(nPts[i]-1)*scale) : 0.0;
+      Pt[i]=low+unit*static_cast<double>(LPt[i]);
+    }
+  return Pt;
+}
+
+void
+Visit::populateOctree(const Simulation* SimPtr,
+		      const std::set<std::string>& Active)
+  /*!
+    Fill the octree leaves. Each mesh voxel is tested at its
+    eight corners and centre, and is split into eight while
+    the results differ and the depth limit is not reached.
+    The leaf takes the result at its centre. Lattice
+    results are kept for the current x-slab of voxels and its
+    low face, so shared corners are found once without holding
+    the whole lattice.
+    \param SimPtr :: Simulation system
+    \param Active :: Active set
+   */
+{
+  ELog::RegMethod RegA("Visit","populateOctree");
+
+  const ModelSupport::objectRegister& OR=
+    ModelSupport::objectRegister::Instance();
+  const bool aEmptyFlag=Active.empty();
+  const std::set<int> ActiveID=activeID(Active);
+
+  Leaves.clear();
+  const long int topSize(1L << (octDepth+1));
+  long int NBase[3];
+  for(size_t i=0;i<3;i++)
+    NBase[i]=(nPts[i]>1) ? nPts[i]-1 : 1;
+
+  std::map<Triple<long int>,double> PtValue;
+  std::map<Triple<long int>,double>::const_iterator mc;
+  MonteCarlo::Object* ObjPtr(0);
+  double sample[9];
+
+  std::vector<octLeaf> Stack;
+  for(long int i=0;i<NBase[0];i++)
+    {
+      // Drop points behind the low face of this slab
+      PtValue.erase(PtValue.begin(),
+		    PtValue.lower_bound(Triple<long int>(i*topSize,-1,-1)));
+      for(long int j=0;j<NBase[1];j++)
+	for(long int k=0;k<NBase[2];k++)
+	  {
+	    octLeaf Base;
+	    Base.Corner=Triple<long int>(i*topSize,j*topSize,k*topSize);
+	    Base.size=topSize;
+	    Base.value=0.0;
+	    Stack.push_back(Base);
+	    while(!Stack.empty())
+	      {
+		octLeaf Item=Stack.back();
+		Stack.pop_back();
+		const long int half(Item.size/2);
+		// Corners [0-7] and centre [8]
+		for(size_t index=0;index<9;index++)
+		  {
+		    Triple<long int> LPt(Item.Corner);
+		    for(size_t a=0;a<3;a++)
+		      if (index==8)
+			LPt[a]+=half;
+		      else if (index & (1UL << a))
+			LPt[a]+=Item.size;
+
+		    mc=PtValue.find(LPt);
+		    if (mc==PtValue.end())
+		      {
+			ObjPtr=SimPtr->findCell(octPoint(LPt),ObjPtr);
+			double V(0.0);
+			if (ObjPtr && 
+			    (aEmptyFlag || 
+			     ActiveID.find(OR.inRangeID(ObjPtr->getName()))!=
+			     ActiveID.end()))
+			  V=getResult(ObjPtr);
+			mc=PtValue.insert
+			  (std::map<Triple<long int>,double>::
+			   value_type(LPt,V)).first;
+		      }
+		    sample[index]=mc->second;
+		  }
+		Item.value=sample[8];
+
+		int splitFlag(0);
+		for(size_t index=0;half>1 && !splitFlag && index<8;index++)
+		  if (sample[index]!=sample[8])
+		    splitFlag=1;
+
+		if (!splitFlag)
+		  Leaves.push_back(Item);
+		else
+		  {
+		    for(size_t index=0;index<8;index++)
+		      {
+			octLeaf Child(Item);
+			Child.size=half;
+			for(size_t a=0;a<3;a++)
+			  if (index & (1UL << a))
+			    Child.Corner[a]+=half;
+			Stack.push_back(Child);
+		      }
+		  }
+	      }
+	  }
+    }
+  ELog::EM<<"Octree leaves == "<<Leaves.size()<<" from "
+	  <<NBase[0]*NBase[1]*NBase[2]<<" voxels"<<ELog::endBasic;
+  return;
+}
+
 void
 Visit::populate(const Simulation* SimPtr)
   /*!
@@ -250,7 +587,7 @@ Visit::writeVTK(const std::string& FName) const
   // Calculate steps
   double stepXYZ[3];
   for(size_t i=0;i<3;i++)
-    stepXYZ[i]=(nPts[i]>1) ? XYZ[i]/(nPts[i]-1.0) : XYZ[i];
+    stepXYZ[i]=stepSize(i);
 
 
   OX<<"# vtk DataFile Version 2.0"<<std::endl;
@@ -287,3 +624,372 @@ Visit::writeVTK(const std::string& FName) const
   OX.close();
   return;
 }
+
+std::string
+Visit::typeName() const
+  /*!
+    Name of the output data field
+    \return field name
+  */
+{
+  switch(outType)
+    {
+    case cellID:
+      return "cellID";
+    case material:
+      return "material";
+    case density:
+      return "density";
+    case weight:
+      return "weight";
+    }
+  return "cellID";
+}
+
+int
+Visit::isBigEndian()
+  /*!
+    Determine the byte order of this machine
+    \return 1 if big-endian
+  */
+{
+  const boost::uint32_t testValue(1);
+  char cTest[4];
+  memcpy(cTest,&testValue,4);
+  return (cTest[0]) ? 0 : 1;
+}
+
+void
+Visit::fillSlab(const long int kIndex,const int swapFlag,
+		const int flipFlag,std::vector<char>& Buffer) const
+  /*!
+    Convert one z-slab of the mesh into 4 byte values [x fastest].
+    The cellID/material types are written as int32 and the
+    others as float32.
+    \param kIndex :: z index of slab
+    \param swapFlag :: Reverse the byte order
+    \param flipFlag :: Reverse x [bit 1] / y [bit 2] index order
+    \param Buffer :: Output buffer [resized]
+  */
+{
+  const int intFlag=isIntType();
+  const size_t NX(static_cast<size_t>(nPts[0]));
+  const size_t NY(static_cast<size_t>(nPts[1]));
+  Buffer.resize(NX*NY*4);
+
+  char cValue[4];
+  size_t index(0);
+  for(long int j=0;j<nPts[1];j++)
+    {
+      const long int jIndex=(flipFlag & 2) ? nPts[1]-(j+1) : j;
+      for(long int i=0;i<nPts[0];i++)
+	{
+	  const long int iIndex=(flipFlag & 1) ? nPts[0]-(i+1) : i;
+	  const double V=mesh[iIndex][jIndex][kIndex];
+	  if (intFlag)
+	    {
+	      const boost::int32_t IV=static_cast<boost::int32_t>(V);
+	      memcpy(cValue,&IV,4);
+	    }
+	  else
+	    {
+	      const float FV=static_cast<float>(V);
+	      memcpy(cValue,&FV,4);
+	    }
+	  for(size_t b=0;b<4;b++)
+	    Buffer[index+b]=(swapFlag) ? cValue[3-b] : cValue[b];
+	  index+=4;
+	}
+    }
+  return;
+}
+
+void
+Visit::writeVTKBinary(const std::string& FName) const
+  /*!
+    Write out a binary legacy VTK file [big-endian]. 
+    Data is converted and written one z-slab at a time.
+    \param FName :: filename 
+  */
+{
+  ELog::RegMethod RegA("Visit","writeVTKBinary");
+  if (FName.empty()) return;
+
+  std::ofstream OX(FName.c_str(),std::ios::out | std::ios::binary);
+  if (!OX.good())
+    throw ColErr::FileError(0,FName,"Visit::writeVTKBinary");
+  const int swapFlag=!isBigEndian();
+
+  OX<<"# vtk DataFile Version 2.0\n";
+  OX<<"chipIR Data\n";
+  OX<<"BINARY\n";
+  OX<<"DATASET RECTILINEAR_GRID\n";
+  OX<<"DIMENSIONS "<<nPts[0]<<" "<<nPts[1]<<" "<<nPts[2]<<"\n";
+
+  const char* axisName[3]={"X_COORDINATES ","Y_COORDINATES ",
+			   "Z_COORDINATES "};
+  for(size_t i=0;i<3;i++)
+    {
+      const double step=stepSize(i);
+      OX<<axisName[i]<<nPts[i]<<" float\n";
+      for(long int j=0;j<nPts[i];j++)
+	writeFloat(OX,Origin[i]+step*static_cast<double>(j),1);
+      OX<<"\n";
+    }
+
+  OX<<"POINT_DATA "<<nPts[0]*nPts[1]*nPts[2]<<"\n";
+  OX<<"SCALARS "<<typeName()<<((isIntType()) ? " int" : " float")<<" 1\n";
+  OX<<"LOOKUP_TABLE default\n";
+
+  std::vector<char> Buffer;
+  for(long int k=0;k<nPts[2];k++)
+    {
+      fillSlab(k,swapFlag,0,Buffer);
+      OX.write(&Buffer[0],static_cast<std::streamsize>(Buffer.size()));
+    }
+  OX<<"\n";
+  OX.close();
+  return;
+}
+
+void
+Visit::writeVTI(const std::string& FName,const int compFlag) const
+  /*!
+    Write out a VTK XML image file with the data as appended 
+    raw values [native byte order]. If compFlag is set each
+    z-slab is a separately zlib compressed block and the block
+    header is written once the compressed sizes are known.
+    \param FName :: filename 
+    \param compFlag :: Compress the data
+  */
+{
+  ELog::RegMethod RegA("Visit","writeVTI");
+  if (FName.empty()) return;
+
+  std::ofstream OX(FName.c_str(),std::ios::out | std::ios::binary);
+  if (!OX.good())
+    throw ColErr::FileError(0,FName,"Visit::writeVTI");
+
+  // Image data needs a positive spacing : reverse negative axes
+  double step[3];
+  double origin[3];
+  int flipFlag(0);
+  for(size_t i=0;i<3;i++)
+    {
+      step[i]=stepSize(i);
+      origin[i]=Origin[i];
+      if (step[i]<0.0)
+	{
+	  origin[i]+=step[i]*static_cast<double>(nPts[i]-1);
+	  step[i]= -step[i];
+	  flipFlag |= 1 << i;
+	}
+    }
+
+  OX<<"<?xml version=\"1.0\"?>\n";
+  OX<<"<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\""
+    <<((isBigEndian()) ? "BigEndian" : "LittleEndian")
+    <<"\" header_type=\"UInt64\"";
+  if (compFlag)
+    OX<<" compressor=\"vtkZLibDataCompressor\"";
+  OX<<">\n";
+
+  std::ostringstream cx;
+  cx<<"0 "<<nPts[0]-1<<" 0 "<<nPts[1]-1<<" 0 "<<nPts[2]-1;
+  OX<<"  <ImageData WholeExtent=\""<<cx.str()<<"\" "
+    <<"Origin=\""<<origin[0]<<" "<<origin[1]<<" "<<origin[2]<<"\" "
+    <<"Spacing=\""<<step[0]<<" "<<step[1]<<" "<<step[2]<<"\">\n";
+  OX<<"    <Piece Extent=\""<<cx.str()<<"\">\n";
+  OX<<"      <PointData Scalars=\""<<typeName()<<"\">\n";
+  OX<<"        <DataArray type=\""<<((isIntType()) ? "Int32" : "Float32")
+    <<"\" Name=\""<<typeName()<<"\" format=\"appended\" offset=\"0\"/>\n";
+  OX<<"      </PointData>\n";
+  OX<<"    </Piece>\n";
+  OX<<"  </ImageData>\n";
+  OX<<"  <AppendedData encoding=\"raw\">\n";
+  OX<<"_";
+
+  const long int NZ(nPts[2]);
+  const boost::uint64_t slabSize=
+    static_cast<boost::uint64_t>(nPts[0]*nPts[1])*4;
+  std::vector<char> Buffer;
+  if (!compFlag)
+    {
+      const boost::uint64_t totalSize=slabSize*
+	static_cast<boost::uint64_t>(NZ);
+      OX.write(reinterpret_cast<const char*>(&totalSize),8);
+      for(long int k=0;k<NZ;k++)
+	{
+	  fillSlab((flipFlag & 4) ? NZ-(k+1) : k,0,flipFlag,Buffer);
+	  OX.write(&Buffer[0],static_cast<std::streamsize>(Buffer.size()));
+	}
+    }
+  else
+    {
+      // Header : nBlock / block size / last block size [0:full] / sizes
+      std::vector<boost::uint64_t> Header(3+static_cast<size_t>(NZ),0);
+      Header[0]=static_cast<boost::uint64_t>(NZ);
+      Header[1]=slabSize;
+      const std::streampos headPos=OX.tellp();
+      const std::streamsize headSize=
+	static_cast<std::streamsize>(Header.size()*8);
+      OX.write(reinterpret_cast<const char*>(&Header[0]),headSize);
+
+      std::vector<Bytef> CBuffer(compressBound(static_cast<uLong>(slabSize)));
+      for(long int k=0;k<NZ;k++)
+	{
+	  fillSlab((flipFlag & 4) ? NZ-(k+1) : k,0,flipFlag,Buffer);
+	  uLongf compSize(static_cast<uLongf>(CBuffer.size()));
+	  const int flag=compress2(&CBuffer[0],&compSize,
+				   reinterpret_cast<const Bytef*>(&Buffer[0]),
+				   static_cast<uLong>(Buffer.size()),
+				   Z_DEFAULT_COMPRESSION);
+	  if (flag!=Z_OK)
+	    throw ColErr::FileError(flag,FName,"Visit::writeVTI::compress");
+	  OX.write(reinterpret_cast<const char*>(&CBuffer[0]),
+		   static_cast<std::streamsize>(compSize));
+	  Header[3+static_cast<size_t>(k)]=compSize;
+	}
+      const std::streampos endPos=OX.tellp();
+      OX.seekp(headPos);
+      OX.write(reinterpret_cast<const char*>(&Header[0]),headSize);
+      OX.seekp(endPos);
+    }
+  OX<<"\n  </AppendedData>\n";
+  OX<<"</VTKFile>\n";
+  OX.close();
+  return;
+}
+
+void
+Visit::writeInt(std::ostream& OX,const int V,const int binFlag)
+  /*!
+    Write an integer value to a legacy VTK file
+    \param OX :: Output stream
+    \param V :: Value
+    \param binFlag :: Write as big-endian int32 [else ASCII]
+  */
+{
+  if (!binFlag)
+    OX<<V<<" ";
+  else
+    {
+      const boost::int32_t IV(V);
+      char cValue[4];
+      memcpy(cValue,&IV,4);
+      if (!isBigEndian())
+	std::reverse(cValue,cValue+4);
+      OX.write(cValue,4);
+    }
+  return;
+}
+
+void
+Visit::writeFloat(std::ostream& OX,const double V,const int binFlag)
+  /*!
+    Write a real value to a legacy VTK file
+    \param OX :: Output stream
+    \param V :: Value
+    \param binFlag :: Write as big-endian float32 [else ASCII]
+  */
+{
+  if (!binFlag)
+    OX<<V<<" ";
+  else
+    {
+      const float FV=static_cast<float>(V);
+      char cValue[4];
+      memcpy(cValue,&FV,4);
+      if (!isBigEndian())
+	std::reverse(cValue,cValue+4);
+      OX.write(cValue,4);
+    }
+  return;
+}
+
+void
+Visit::writeOctreeVTK(const std::string& FName,const int binFlag) const
+  /*!
+    Write out the octree leaves as a legacy VTK unstructured
+    grid of voxels with the result as cell data.
+    Leaf corners are shared between leaves.
+    \param FName :: filename 
+    \param binFlag :: Write binary data [else ASCII]
+  */
+{
+  ELog::RegMethod RegA("Visit","writeOctreeVTK");
+  if (FName.empty()) return;
+
+  std::ofstream OX(FName.c_str(),std::ios::out | std::ios::binary);
+  if (!OX.good())
+    throw ColErr::FileError(0,FName,"Visit::writeOctreeVTK");
+  OX.precision(8);
+
+  // Corner points [VTK_VOXEL order : x fastest]
+  std::map<Triple<long int>,int> PtIndex;
+  std::vector<Triple<long int> > PtList;
+  std::vector<int> CellPts;
+  std::vector<octLeaf>::const_iterator vc;
+  for(vc=Leaves.begin();vc!=Leaves.end();vc++)
+    for(size_t index=0;index<8;index++)
+      {
+	Triple<long int> LPt(vc->Corner);
+	for(size_t a=0;a<3;a++)
+	  if (index & (1UL << a))
+	    LPt[a]+=vc->size;
+	std::map<Triple<long int>,int>::const_iterator mc=PtIndex.find(LPt);
+	if (mc==PtIndex.end())
+	  {
+	    mc=PtIndex.insert(std::map<Triple<long int>,int>::
+			      value_type(LPt,static_cast<int>(PtList.size())))
+	      .first;
+	    PtList.push_back(LPt);
+	  }
+	CellPts.push_back(mc->second);
+      }
+
+  const size_t NCell(Leaves.size());
+  OX<<"# vtk DataFile Version 2.0\n";
+  OX<<"chipIR Data\n";
+  OX<<((binFlag) ? "BINARY\n" : "ASCII\n");
+  OX<<"DATASET UNSTRUCTURED_GRID\n";
+  OX<<"POINTS "<<PtList.size()<<" float\n";
+  for(size_t i=0;i<PtList.size();i++)
+    {
+      const Geometry::Vec3D Pt=octPoint(PtList[i]);
+      for(size_t a=0;a<3;a++)
+	writeFloat(OX,Pt[a],binFlag);
+      if (!binFlag) OX<<"\n";
+    }
+
+  OX<<"\nCELLS "<<NCell<<" "<<NCell*9<<"\n";
+  for(size_t i=0;i<NCell;i++)
+    {
+      writeInt(OX,8,binFlag);
+      for(size_t index=0;index<8;index++)
+	writeInt(OX,CellPts[i*8+index],binFlag);
+      if (!binFlag) OX<<"\n";
+    }
+
+  OX<<"\nCELL_TYPES "<<NCell<<"\n";
+  for(size_t i=0;i<NCell;i++)
+    {
+      writeInt(OX,11,binFlag);            // VTK_VOXEL
+      if (!binFlag && (i % 10)==9) OX<<"\n";
+    }
+
+  OX<<"\nCELL_DATA "<<NCell<<"\n";
+  OX<<"SCALARS "<<typeName()<<((isIntType()) ? " int" : " float")<<" 1\n";
+  OX<<"LOOKUP_TABLE default\n";
+  for(size_t i=0;i<NCell;i++)
+    {
+      if (isIntType())
+	writeInt(OX,static_cast<int>(Leaves[i].value),binFlag);
+      else
+	writeFloat(OX,Leaves[i].value,binFlag);
+      if (!binFlag && (i % 10)==9) OX<<"\n";
+    }
+  OX<<"\n";
+  OX.close();
+  return;
+}
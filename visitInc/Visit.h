@@ -34,10 +34,14 @@ class Object;
   \date August 2010
   \author S. Ansell
   \version 1.0
-  \todo Move to a binary/xml output schema
 
-  This allows comparison of the vector for removing non-unique
-  Vec3D from a list
+  The mesh can be written as ASCII or binary legacy VTK
+  or as an XML image (vti) file with optional zlib
+  compression. The binary writers output one z-slab at a time.
+
+  In octree mode each mesh voxel is split while its corner
+  and centre samples differ, down to octDepth levels. The
+  leaves are written as a VTK unstructured grid.
 */
 						
 class Visit
@@ -48,15 +52,46 @@ class Visit
   enum VISITenum { cellID=0,material=1,density=2,weight=3};
 
  private:
+
+  static const size_t maxOctDepth;   ///< Largest octree depth
+
+  /// Octree leaf [finest lattice units]
+  struct octLeaf
+  {
+    Triple<long int> Corner;    ///< Low corner
+    long int size;              ///< Side length
+    double value;               ///< Result at centre
+  };
   
   VISITenum outType;          ///< Output type
+  int lineTrack;              ///< Fill by tracking lines
+  size_t octDepth;            ///< Max octree split levels [0 : uniform]
   Geometry::Vec3D Origin;     ///< Origin
   Geometry::Vec3D XYZ;        ///< XYZ extent
 
   Triple<long int> nPts;        ///< Number x points
   boost::multi_array<double,3> mesh;  ///< results mesh
+  std::vector<octLeaf> Leaves;        ///< Octree leaves
 
   double getResult(const MonteCarlo::Object*) const;
+  double stepSize(const size_t) const;
+  static std::set<int> activeID(const std::set<std::string>&);
+  /// Output values are integers [cellID/material]
+  int isIntType() const { return (outType==cellID || outType==material); }
+  std::string typeName() const;
+  static int isBigEndian();
+  void fillSlab(const long int,const int,const int,
+		std::vector<char>&) const;
+  void trackRow(const Simulation&,const Geometry::Vec3D&,
+		const Geometry::Vec3D&,const double,
+		MonteCarlo::Object*,
+		std::vector<MonteCarlo::Object*>&) const;
+  void populateLine(const Simulation*,const std::set<std::string>&);
+
+  Geometry::Vec3D octPoint(const Triple<long int>&) const;
+  void populateOctree(const Simulation*,const std::set<std::string>&);
+  static void writeInt(std::ostream&,const int,const int);
+  static void writeFloat(std::ostream&,const double,const int);
 
  public:
 
@@ -66,6 +101,13 @@ class Visit
   ~Visit();
 
   void setType(const VISITenum&);
+  /// Set line tracking fill [rather than a point test per voxel]
+  void setLineTrack(const int F) { lineTrack=F; }
+  void setOctree(const size_t);
+  /// Access the results mesh
+  const boost::multi_array<double,3>& getMesh() const { return mesh; }
+  /// Number of octree leaves
+  size_t nLeaves() const { return Leaves.size(); }
   void setBox(const Geometry::Vec3D&,
               const Geometry::Vec3D&);
   void setIndex(const size_t,const size_t,const size_t);
@@ -73,6 +115,9 @@ class Visit
   void populate(const Simulation*);
   void populate(const Simulation*,const std::set<std::string>&);
   void writeVTK(const std::string&) const;
+  void writeVTKBinary(const std::string&) const;
+  void writeVTI(const std::string&,const int) const;
+  void writeOctreeVTK(const std::string&,const int) const;
 };
 
 